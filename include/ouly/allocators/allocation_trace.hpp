@@ -0,0 +1,351 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/default_allocator.hpp"
+#include "ouly/allocators/detail/custom_allocator.hpp"
+#include "ouly/utility/common.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ouly
+{
+
+/** @brief Operation recorded by a trace event */
+enum class allocation_trace_op : std::uint8_t
+{
+  allocate,
+  deallocate
+};
+
+/**
+ * @brief One allocation or deallocation of a recorded trace
+ *
+ * Ids name an allocation for its lifetime: the deallocate event of an allocation carries the id of
+ * its allocate event. Ids are dense and reused once freed, so a replay can keep its handles in an
+ * array of `allocation_trace::id_count_` entries.
+ */
+struct allocation_trace_event
+{
+  /** @brief Nanoseconds since recording began */
+  std::uint64_t       timestamp_      = 0;
+  std::uint64_t       size_           = 0;
+  std::uint32_t       id_             = 0;
+  allocation_trace_op op_             = allocation_trace_op::allocate;
+  std::uint8_t        alignment_log2_ = 0;
+
+  [[nodiscard]] auto alignment() const noexcept -> std::size_t
+  {
+    return std::size_t{1} << alignment_log2_;
+  }
+
+  auto operator<=>(allocation_trace_event const&) const noexcept = default;
+};
+
+/** @brief A recorded sequence of allocations and deallocations */
+struct allocation_trace
+{
+  std::vector<allocation_trace_event> events_;
+  /** @brief Every event id is below this value */
+  std::uint32_t id_count_ = 0;
+
+  auto operator==(allocation_trace const&) const noexcept -> bool = default;
+};
+
+/**
+ * @brief Write a trace in its compact binary form
+ *
+ * The log starts with a small header and stores every event as a tag byte holding the operation and
+ * the log2 of the alignment, followed by the timestamp delta to the previous event, the size and
+ * the id, each as a LEB128 varint. A typical event takes 4 to 8 bytes and the format is the same on
+ * every platform.
+ */
+OULY_API void write_trace(std::ostream& stream, allocation_trace const& trace);
+
+/**
+ * @brief Read a trace written by write_trace
+ * @throws std::invalid_argument if the stream does not hold a trace
+ * @throws std::out_of_range if the stream ends before the last event
+ */
+OULY_API auto read_trace(std::istream& stream) -> allocation_trace;
+
+/**
+ * @brief Allocator adaptor that records every allocation and deallocation it forwards
+ *
+ * Wraps the underlying allocator of `Config` (cfg::underlying_allocator, default_allocator when
+ * none is given) and appends an allocation_trace_event for every call. Recording takes a lock and a
+ * hash map lookup per call, which is cheap next to capturing a frame but not free; wrap the
+ * allocators whose pattern is of interest, not all of them.
+ *
+ * Example usage:
+ * @code
+ * ouly::allocation_recorder<> recorder;
+ * run_frames(recorder);                       // allocate/deallocate as usual
+ * std::ofstream file("frame.trace", std::ios::binary);
+ * ouly::write_trace(file, recorder.take_trace());
+ * @endcode
+ *
+ * @note Thread-safe as long as the underlying allocator is
+ */
+template <typename Config = ouly::config<>>
+class allocation_recorder
+{
+public:
+  using underlying_allocator = ouly::detail::underlying_allocator_t<Config>;
+  using size_type            = typename underlying_allocator::size_type;
+  using address              = typename underlying_allocator::address;
+  using clock                = std::chrono::steady_clock;
+
+  template <typename... Args>
+  explicit allocation_recorder(Args&&... args) : allocator_(std::forward<Args>(args)...)
+  {}
+
+  allocation_recorder(allocation_recorder const&)                    = delete;
+  allocation_recorder(allocation_recorder&&)                         = delete;
+  auto operator=(allocation_recorder const&) -> allocation_recorder& = delete;
+  auto operator=(allocation_recorder&&) -> allocation_recorder&      = delete;
+  ~allocation_recorder() noexcept                                    = default;
+
+  static constexpr auto null() -> address
+  {
+    return underlying_allocator::null();
+  }
+
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto allocate(size_type size, Alignment alignment = {}) -> address
+  {
+    auto ptr = allocator_.allocate(size, alignment);
+    if (ptr != null())
+    {
+      record_allocate(ptr, size, ouly::detail::alignment_of(alignment));
+    }
+    return ptr;
+  }
+
+  template <typename Alignment = alignment<>>
+  [[nodiscard]] auto zero_allocate(size_type size, Alignment alignment = {}) -> address
+  {
+    auto ptr = allocator_.zero_allocate(size, alignment);
+    if (ptr != null())
+    {
+      record_allocate(ptr, size, ouly::detail::alignment_of(alignment));
+    }
+    return ptr;
+  }
+
+  template <typename Alignment = alignment<>>
+  void deallocate(address ptr, size_type size, Alignment alignment = {})
+  {
+    if (ptr != null())
+    {
+      record_deallocate(ptr, size, ouly::detail::alignment_of(alignment));
+    }
+    allocator_.deallocate(ptr, size, alignment);
+  }
+
+  /** @brief Events recorded so far; only stable while no other thread allocates */
+  [[nodiscard]] auto trace() const noexcept -> allocation_trace const&
+  {
+    return trace_;
+  }
+
+  /**
+   * @brief Hand over the events recorded so far and start a new trace
+   *
+   * Allocations still live keep their ids, so their deallocations in the next trace pair up with
+   * the allocate events of this one.
+   */
+  auto take_trace() -> allocation_trace
+  {
+    std::scoped_lock lock{mutex_};
+    auto             result = std::move(trace_);
+    trace_                  = {};
+    trace_.id_count_        = result.id_count_;
+    return result;
+  }
+
+  [[nodiscard]] auto get_underlying_allocator() noexcept -> underlying_allocator&
+  {
+    return allocator_;
+  }
+
+private:
+  void record_allocate(address ptr, size_type size, std::size_t align)
+  {
+    auto const       now = timestamp();
+    std::scoped_lock lock{mutex_};
+    std::uint32_t    id = 0;
+    if (free_ids_.empty())
+    {
+      id = trace_.id_count_++;
+    }
+    else
+    {
+      id = free_ids_.back();
+      free_ids_.pop_back();
+    }
+    live_.emplace(ptr, id);
+    push(now, size, id, allocation_trace_op::allocate, align);
+  }
+
+  void record_deallocate(address ptr, size_type size, std::size_t align)
+  {
+    auto const       now = timestamp();
+    std::scoped_lock lock{mutex_};
+    auto             it = live_.find(ptr);
+    OULY_ASSERT(it != live_.end() && "allocation_recorder: deallocating an address that was not allocated");
+    if (it == live_.end())
+    {
+      return;
+    }
+    auto const id = it->second;
+    live_.erase(it);
+    free_ids_.push_back(id);
+    push(now, size, id, allocation_trace_op::deallocate, align);
+  }
+
+  void push(std::uint64_t now, size_type size, std::uint32_t id, allocation_trace_op op, std::size_t align)
+  {
+    // Timestamps are taken before the lock, so threads may append them slightly out of order
+    now             = std::max(now, last_timestamp_);
+    last_timestamp_ = now;
+    auto const log2 = static_cast<std::uint8_t>(std::bit_width(std::max<std::size_t>(align, 1)) - 1);
+    trace_.events_.push_back({.timestamp_      = now,
+                              .size_           = static_cast<std::uint64_t>(size),
+                              .id_             = id,
+                              .op_             = op,
+                              .alignment_log2_ = log2});
+  }
+
+  [[nodiscard]] auto timestamp() const noexcept -> std::uint64_t
+  {
+    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_);
+    return static_cast<std::uint64_t>(elapsed.count());
+  }
+
+  underlying_allocator                       allocator_;
+  std::mutex                                 mutex_;
+  clock::time_point                          start_          = clock::now();
+  std::uint64_t                              last_timestamp_ = 0;
+  allocation_trace                           trace_;
+  std::unordered_map<address, std::uint32_t> live_;
+  std::vector<std::uint32_t>                 free_ids_;
+};
+
+/**
+ * @brief Target a trace is replayed against
+ *
+ * A target adapts one allocator, with its memory manager, to the replay: `allocate` returns
+ * whatever handle the allocator needs to free the block again, and `footprint` reports the bytes
+ * of backing memory (arenas) the allocator currently holds.
+ */
+template <typename T>
+concept TraceReplayTarget = requires(T target, typename T::handle handle, std::size_t size, std::size_t align) {
+  { target.allocate(size, align) } -> std::same_as<typename T::handle>;
+  target.deallocate(handle, size, align);
+  { target.footprint() } -> std::convertible_to<std::size_t>;
+};
+
+/** @brief Result of replaying a trace against one target */
+struct replay_stats
+{
+  std::uint64_t allocations_   = 0;
+  std::uint64_t deallocations_ = 0;
+  /** @brief Time spent inside the target's allocate and deallocate calls */
+  std::uint64_t total_ns_ = 0;
+  /** @brief Slowest single allocate or deallocate */
+  std::uint64_t worst_latency_ns_ = 0;
+  /** @brief Most bytes the trace had live at once, the footprint of a perfect allocator */
+  std::uint64_t peak_live_ = 0;
+  /** @brief Most backing memory the target held at once */
+  std::uint64_t peak_footprint_ = 0;
+
+  /** @brief Allocations and deallocations per second */
+  [[nodiscard]] auto throughput() const noexcept -> double
+  {
+    return total_ns_ == 0 ? 0.0
+                          : static_cast<double>(allocations_ + deallocations_) * 1e9 / static_cast<double>(total_ns_);
+  }
+
+  /**
+   * @brief Share of the peak footprint that never held live data: 1 - peak_live / peak_footprint
+   *
+   * 0 means the target never needed more memory than the trace had live; fragmentation, alignment
+   * padding and arena granularity all push it towards 1.
+   */
+  [[nodiscard]] auto fragmentation_ratio() const noexcept -> double
+  {
+    return peak_footprint_ == 0 ? 0.0
+                                : 1.0 - (static_cast<double>(peak_live_) / static_cast<double>(peak_footprint_));
+  }
+};
+
+/**
+ * @brief Replay a recorded trace against a target and measure it
+ *
+ * Events are replayed back to back in recorded order; the timestamps are kept for analysis but do
+ * not pace the replay, so throughput measures the allocator and nothing else. Every call is timed
+ * on its own and the footprint is sampled after it, outside the timed region. Deallocations of ids
+ * the trace never allocated (allocations that predate the recording) are skipped, and allocations
+ * the trace leaves live are not freed: the target owns them once the replay returns.
+ */
+template <TraceReplayTarget Target>
+auto replay_trace(allocation_trace const& trace, Target& target) -> replay_stats
+{
+  using clock = std::chrono::steady_clock;
+
+  replay_stats                         stats;
+  std::vector<typename Target::handle> handles(trace.id_count_);
+  std::vector<bool>                    is_live(trace.id_count_, false);
+  std::uint64_t                        live = 0;
+  for (auto const& event : trace.events_)
+  {
+    OULY_ASSERT(event.id_ < trace.id_count_);
+    if (event.op_ == allocation_trace_op::deallocate && !is_live[event.id_])
+    {
+      continue;
+    }
+    is_live[event.id_] = event.op_ == allocation_trace_op::allocate;
+
+    auto const size  = static_cast<std::size_t>(event.size_);
+    auto const align = event.alignment();
+    auto const start = clock::now();
+    if (event.op_ == allocation_trace_op::allocate)
+    {
+      handles[event.id_] = target.allocate(size, align);
+    }
+    else
+    {
+      target.deallocate(handles[event.id_], size, align);
+    }
+    auto const elapsed =
+     static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+
+    if (event.op_ == allocation_trace_op::allocate)
+    {
+      ++stats.allocations_;
+      live += event.size_;
+    }
+    else
+    {
+      ++stats.deallocations_;
+      live -= event.size_;
+    }
+    stats.total_ns_ += elapsed;
+    stats.worst_latency_ns_ = std::max(stats.worst_latency_ns_, elapsed);
+    stats.peak_live_        = std::max(stats.peak_live_, live);
+    stats.peak_footprint_   = std::max(stats.peak_footprint_, static_cast<std::uint64_t>(target.footprint()));
+  }
+  return stats;
+}
+
+} // namespace ouly
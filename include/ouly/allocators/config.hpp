@@ -129,7 +129,8 @@ enum class advice : std::uint8_t
   random,     // Random access pattern
   sequential, // Sequential access pattern
   will_need,  // Will need this memory soon
-  dont_need   // Don't need this memory soon
+  dont_need,  // Don't need this memory soon
+  huge_page   // Back with transparent huge pages where the system supports them
 };
 
 enum class protection : std::uint8_t
@@ -144,6 +145,25 @@ enum class protection : std::uint8_t
   // read_write_execute = read | write | execute
 };
 
+/**
+ * @brief How memory taken straight from the system is backed by huge pages
+ *
+ * Huge pages (2 MiB on most targets) cut dTLB misses on large arenas that are accessed randomly.
+ * Allocations made under a policy other than `none` are rounded up to the huge page size.
+ */
+enum class huge_page_policy : std::uint8_t
+{
+  none,        // Regular pages
+  transparent, // Huge page aligned mappings the kernel is asked to back with transparent huge pages
+  dedicated    // Reserved huge pages (MAP_HUGETLB, MEM_LARGE_PAGES), falling back to transparent
+};
+
+template <huge_page_policy Policy>
+struct huge_pages
+{
+  static constexpr huge_page_policy huge_page_policy_v = Policy;
+};
+
 enum class memory_stat_type : uint8_t
 {
   e_none,
@@ -68,9 +68,35 @@ struct guaranteed_alignment<Allocator>
 template <typename Allocator>
 constexpr std::size_t guaranteed_alignment_v = guaranteed_alignment<Allocator>::value;
 
+/**
+ * @brief Size arenas taken from `Allocator` are best rounded up to
+ *
+ * Allocators backed by whole pages advertise it through a static `page_size()`; every byte of the
+ * last page is paid for anyway, so an arena might as well use it. Anything else has no granularity.
+ */
+template <typename Allocator>
+auto arena_granularity() noexcept -> std::size_t
+{
+  if constexpr (requires {
+                  { Allocator::page_size() } -> std::convertible_to<std::size_t>;
+                })
+  {
+    return Allocator::page_size();
+  }
+  else
+  {
+    return 1;
+  }
+}
+
 template <typename T>
 concept HasProtection = requires { typename T::protection_t; };
 
+template <typename T>
+concept HasHugePagePolicy = requires {
+  { T::huge_page_policy_v } -> std::convertible_to<cfg::huge_page_policy>;
+};
+
 template <typename T>
 struct debug_tracer
 {
@@ -136,4 +162,19 @@ using protection_t = protection<T>::type;
 template <typename T>
 constexpr auto protection_v = protection<T>::value;
 
+template <typename T>
+struct huge_page_policy
+{
+  static constexpr auto value = cfg::huge_page_policy::none;
+};
+
+template <HasHugePagePolicy T>
+struct huge_page_policy<T>
+{
+  static constexpr auto value = T::huge_page_policy_v;
+};
+
+template <typename T>
+constexpr auto huge_page_policy_v = huge_page_policy<T>::value;
+
 } // namespace ouly::detail
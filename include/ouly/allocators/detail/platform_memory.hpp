@@ -24,6 +24,7 @@ struct memory_info
 {
   std::size_t page_size_              = 0;
   std::size_t allocation_granularity_ = 0;
+  std::size_t huge_page_size_         = 0; // Huge page size, or the assumed 2 MiB where it cannot be queried
 };
 
 struct mapped_file_info
@@ -53,6 +54,20 @@ OULY_API auto get_memory_info() noexcept -> memory_info;
 OULY_API auto virtual_alloc(std::size_t size, cfg::protection prot = cfg::protection::read_write,
                             void* preferred_address = nullptr) noexcept -> void*;
 
+/**
+ * @brief Allocate virtual memory backed by huge pages according to `policy`
+ * @param size Size in bytes to allocate, a multiple of memory_info::huge_page_size_
+ * @param policy cfg::huge_page_policy::dedicated tries reserved huge pages first and falls back to
+ *        transparent huge pages; cfg::huge_page_policy::transparent maps a huge page aligned region
+ *        and advises the kernel to back it with huge pages
+ * @param prot Memory cfg::protection flags
+ * @return Pointer to allocated memory or nullptr on failure
+ * @note Huge pages are a best effort: when the system has none to give, the memory is still
+ *       returned, backed by regular pages. Release it with virtual_free() and the same size.
+ */
+OULY_API auto virtual_alloc_huge(std::size_t size, cfg::huge_page_policy policy,
+                                 cfg::protection prot = cfg::protection::read_write) noexcept -> void*;
+
 /**
  * @brief Deallocate virtual memory
  * @param ptr Pointer to memory to deallocate
@@ -61,6 +76,36 @@ OULY_API auto virtual_alloc(std::size_t size, cfg::protection prot = cfg::protec
  */
 OULY_API auto virtual_free(void* ptr, std::size_t size) noexcept -> bool;
 
+/**
+ * @brief Reserve address space without committing any memory to it
+ * @param size Size in bytes to reserve
+ * @param policy With a policy other than none the reservation is huge page aligned and marked for
+ *        transparent huge pages, so committed ranges can be backed by them (POSIX only)
+ * @return Pointer to the reserved, inaccessible region or nullptr on failure
+ * @note Release the reservation with virtual_free()
+ */
+OULY_API auto virtual_reserve(std::size_t size, cfg::huge_page_policy policy = cfg::huge_page_policy::none) noexcept
+ -> void*;
+
+/**
+ * @brief Commit a page aligned range of a reservation, making it accessible
+ * @param ptr Page aligned start of the range
+ * @param size Size of the range, a multiple of the page size
+ * @param prot Memory cfg::protection flags for the committed pages
+ * @return true on success, false on failure
+ * @note Committed pages read as zero until written
+ */
+OULY_API auto virtual_commit(void* ptr, std::size_t size, cfg::protection prot = cfg::protection::read_write) noexcept
+ -> bool;
+
+/**
+ * @brief Return the memory of a page aligned range to the system, keeping the address space reserved
+ * @param ptr Page aligned start of the range
+ * @param size Size of the range, a multiple of the page size
+ * @return true on success, false on failure
+ */
+OULY_API auto virtual_decommit(void* ptr, std::size_t size) noexcept -> bool;
+
 /**
  * @brief Change memory cfg::protection on a region
  * @param ptr Pointer to memory region
@@ -22,7 +22,8 @@ namespace ouly
  * - Memory can be deallocated in LIFO order within arenas
  * - Ability to rewind memory state
  * - Optional statistics tracking
- * - Configurable arena size (default 4MB)
+ * - Configurable arena size (default 4MB), rounded up to the page size of page backed underlying
+ *   allocators such as page_allocator, which can also back arenas with huge pages
  * - Move constructible but not copy constructible
  *
  * Memory management:
@@ -313,6 +314,10 @@ private:
   {
     statistics::report_new_arena();
 
+    // The last page is paid for in full either way, so the arena gets all of it
+    auto const granule = static_cast<size_type>(ouly::detail::arena_granularity<underlying_allocator>());
+    size               = ((size + granule - 1) / granule) * granule;
+
     auto index = static_cast<size_type>(arenas_.size());
     arenas_.emplace_back(underlying_allocator::allocate(size), size, size);
     return index;
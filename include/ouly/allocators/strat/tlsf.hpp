@@ -0,0 +1,294 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/config.hpp"
+#include "ouly/allocators/detail/arena.hpp"
+#include "ouly/utility/optional_val.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+namespace ouly::strat
+{
+
+/**
+ * @brief Two-level segregated fit (TLSF) strategy for arena_allocator
+ * @tparam Config accepted config are only cfg::basic_size_type
+ *
+ * Free blocks are kept in segregated lists. The first level splits sizes by powers of two and the
+ * second level splits every power of two into `second_level_count` equal steps. A bitmap per level
+ * records which lists hold blocks, so finding a list whose blocks all fit a request takes two bit
+ * scans, and adding or removing a free block is a push or unlink on a list threaded through the
+ * blocks themselves. Deallocation and merging are O(1) whatever the number of blocks, and so is
+ * allocation whenever a list above the request holds a block.
+ *
+ * Requests are rounded up to the next list boundary before the search, which is what makes any
+ * block of the list found a fit. Blocks are still split at the exact requested size, so the
+ * rounding costs no memory; the block picked is within one second level step of the best fit
+ * whenever such a block exists. Only when every list above the request is empty is the request's
+ * own list walked for a block that still fits, so an arena can be filled to the last byte. That
+ * walk is the one step that is not constant time: it is linear in the length of that single list,
+ * which only holds blocks within one second level step of the request, and it runs only when the
+ * allocation would otherwise fail and need a new arena.
+ */
+template <typename Config = ouly::config<>>
+class tlsf
+{
+  static constexpr uint32_t k_null_0 = 0;
+  using optional_addr                = ouly::optional_val<k_null_0>;
+
+public:
+  using extension       = uint64_t;
+  using size_type       = ouly::detail::choose_size_t<uint32_t, Config>;
+  using arena_bank      = ouly::detail::arena_bank<size_type, extension>;
+  using block_bank      = ouly::detail::block_bank<size_type, extension>;
+  using block           = ouly::detail::block<size_type, extension>;
+  using bank_data       = ouly::detail::bank_data<size_type, extension>;
+  using block_link      = typename block_bank::link;
+  using allocate_result = optional_addr;
+
+  static constexpr size_type min_granularity = 4;
+
+  /** @brief log2 of the number of lists every power of two is split into */
+  static constexpr uint32_t second_level_log2  = 5;
+  static constexpr uint32_t second_level_count = 1U << second_level_log2;
+  /** @brief Sizes below second_level_count share the first list row, one list per size */
+  static constexpr uint32_t first_level_count = (sizeof(size_type) * 8) - second_level_log2 + 1;
+
+  static_assert(first_level_count <= 64, "First level bitmap is 64 bits wide");
+
+  tlsf() noexcept       = default;
+  tlsf(tlsf const&)     = default;
+  tlsf(tlsf&&) noexcept = default;
+  ~tlsf() noexcept      = default;
+
+  auto operator=(tlsf const&) -> tlsf&     = default;
+  auto operator=(tlsf&&) noexcept -> tlsf& = default;
+
+  /**
+   * @brief Find a free block of at least size bytes
+   *
+   * Two bit scans when a list above the request holds a block; otherwise a walk of the request's
+   * own list, linear in its length.
+   */
+  [[nodiscard]] auto try_allocate(bank_data& bank, size_type size) -> optional_addr
+  {
+    auto const rounded = round_up_to_list(size);
+    if (rounded >= size)
+    {
+      auto [fl, sl] = mapping(rounded);
+      if (auto head = find_list(fl, sl); head != 0)
+      {
+        return {head};
+      }
+    }
+
+    // Nothing in the lists above: the request's own list may still hold a block that fits
+    auto [fl, sl] = mapping(size);
+    for (uint32_t i = heads_[fl][sl]; i != 0;)
+    {
+      auto const& blk = bank.blocks_[block_link(i)];
+      if (blk.size_ >= size)
+      {
+        return {i};
+      }
+      i = blk.list_.next_;
+    }
+    return {};
+  }
+
+  auto commit(bank_data& bank, size_type size, optional_addr found) -> std::uint32_t
+  {
+    auto& blk = bank.blocks_[block_link(found.value_)];
+    // Marker
+    blk.is_free_ = false;
+
+    erase(bank.blocks_, found.value_);
+    auto remaining = blk.size_ - size;
+    blk.size_      = size;
+    if (remaining > 0)
+    {
+      auto& list   = bank.arenas_[blk.arena_].block_order();
+      auto  arena  = blk.arena_;
+      auto  newblk = bank.blocks_.emplace(blk.offset_ + size, remaining, arena, extension(), true);
+      list.insert_after(bank.blocks_, found.value_, (uint32_t)newblk);
+      add_free(bank.blocks_, (uint32_t)newblk);
+    }
+    return found.value_;
+  }
+
+  void add_free_arena(block_bank& blocks, std::uint32_t block)
+  {
+    add_free(blocks, block);
+  }
+
+  void add_free(block_bank& blocks, std::uint32_t block)
+  {
+    auto& blk     = blocks[block_link(block)];
+    auto [fl, sl] = mapping(blk.size_);
+    auto& head    = heads_[fl][sl];
+    blk.list_     = {.next_ = head, .prev_ = 0};
+    if (head != 0)
+    {
+      blocks[block_link(head)].list_.prev_ = block;
+    }
+    head = block;
+    fl_bitmap_ |= uint64_t{1} << fl;
+    sl_bitmap_[fl] |= 1U << sl;
+  }
+
+  void grow_free_node(block_bank& blocks, std::uint32_t block, size_type new_size)
+  {
+    erase(blocks, block);
+    blocks[block_link(block)].size_ = new_size;
+    add_free(blocks, block);
+  }
+
+  void replace_and_grow(block_bank& blocks, std::uint32_t block, std::uint32_t new_block, size_type new_size)
+  {
+    erase(blocks, block);
+    blocks[block_link(new_block)].size_ = new_size;
+    add_free(blocks, new_block);
+  }
+
+  void erase(block_bank& blocks, std::uint32_t node)
+  {
+    auto& blk = blocks[block_link(node)];
+    if (blk.list_.next_)
+    {
+      blocks[block_link(blk.list_.next_)].list_.prev_ = blk.list_.prev_;
+    }
+    if (blk.list_.prev_)
+    {
+      blocks[block_link(blk.list_.prev_)].list_.next_ = blk.list_.next_;
+    }
+    else
+    {
+      auto [fl, sl] = mapping(blk.size_);
+      heads_[fl][sl] = blk.list_.next_;
+      if (blk.list_.next_ == 0)
+      {
+        sl_bitmap_[fl] &= ~(1U << sl);
+        if (sl_bitmap_[fl] == 0)
+        {
+          fl_bitmap_ &= ~(uint64_t{1} << fl);
+        }
+      }
+    }
+    blk.list_ = {};
+  }
+
+  auto total_free_nodes(block_bank const& blocks) const -> std::uint32_t
+  {
+    uint32_t count = 0;
+    for_each_free(blocks,
+                  [&count](block const&)
+                  {
+                    count++;
+                  });
+    return count;
+  }
+
+  auto total_free_size(block_bank const& blocks) const -> size_type
+  {
+    size_type sz = 0;
+    for_each_free(blocks,
+                  [&sz](block const& blk)
+                  {
+                    sz += blk.size_;
+                  });
+    return sz;
+  }
+
+  void validate_integrity(block_bank const& blocks) const
+  {
+    for (uint32_t fl = 0; fl < first_level_count; ++fl)
+    {
+      OULY_ASSERT(((fl_bitmap_ >> fl) & 1U) == (sl_bitmap_[fl] != 0 ? 1U : 0U));
+      for (uint32_t sl = 0; sl < second_level_count; ++sl)
+      {
+        OULY_ASSERT(((sl_bitmap_[fl] >> sl) & 1U) == (heads_[fl][sl] != 0 ? 1U : 0U));
+        [[maybe_unused]] uint32_t p = 0;
+        for (uint32_t i = heads_[fl][sl]; i != 0;)
+        {
+          [[maybe_unused]] auto const& blk = blocks[block_link(i)];
+          OULY_ASSERT(blk.is_free_);
+          OULY_ASSERT(blk.list_.prev_ == p);
+          OULY_ASSERT(mapping(blk.size_) == std::make_pair(fl, sl));
+          p = i;
+          i = blk.list_.next_;
+        }
+      }
+    }
+  }
+
+  template <typename Owner>
+  void init([[maybe_unused]] Owner const& owner)
+  {}
+
+private:
+  /** @brief First and second level list of the blocks of `size` */
+  static constexpr auto mapping(size_type size) noexcept -> std::pair<uint32_t, uint32_t>
+  {
+    if (size < second_level_count)
+    {
+      return {0, static_cast<uint32_t>(size)};
+    }
+    auto const msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+    auto const sl  = static_cast<uint32_t>(size >> (msb - second_level_log2)) ^ second_level_count;
+    return {msb - second_level_log2 + 1, sl};
+  }
+
+  /** @brief Smallest size of the first list whose blocks all fit `size`; wraps below `size` on overflow */
+  static constexpr auto round_up_to_list(size_type size) noexcept -> size_type
+  {
+    if (size < second_level_count)
+    {
+      return size;
+    }
+    auto const msb  = static_cast<uint32_t>(std::bit_width(size)) - 1;
+    auto const step = size_type{1} << (msb - second_level_log2);
+    return size + step - 1;
+  }
+
+  /** @brief Head of the first non-empty list at or above (fl, sl), 0 when there is none */
+  [[nodiscard]] auto find_list(uint32_t fl, uint32_t sl) const noexcept -> uint32_t
+  {
+    uint32_t sl_map = sl_bitmap_[fl] & (~0U << sl);
+    if (sl_map == 0)
+    {
+      uint64_t const fl_map = fl + 1 < first_level_count ? fl_bitmap_ & (~uint64_t{0} << (fl + 1)) : 0;
+      if (fl_map == 0)
+      {
+        return 0;
+      }
+      fl     = static_cast<uint32_t>(std::countr_zero(fl_map));
+      sl_map = sl_bitmap_[fl];
+    }
+    return heads_[fl][static_cast<uint32_t>(std::countr_zero(sl_map))];
+  }
+
+  template <typename Fn>
+  void for_each_free(block_bank const& blocks, Fn&& fn) const
+  {
+    for (auto const& row : heads_)
+    {
+      for (auto head : row)
+      {
+        for (uint32_t i = head; i != 0;)
+        {
+          auto const& blk = blocks[block_link(i)];
+          fn(blk);
+          i = blk.list_.next_;
+        }
+      }
+    }
+  }
+
+  std::array<std::array<uint32_t, second_level_count>, first_level_count> heads_     = {};
+  std::array<uint32_t, first_level_count>                                 sl_bitmap_ = {};
+  uint64_t                                                                fl_bitmap_ = 0;
+};
+
+} // namespace ouly::strat
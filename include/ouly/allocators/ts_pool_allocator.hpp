@@ -0,0 +1,278 @@
+/**
+ * @file ts_pool_allocator.hpp
+ * @brief Thread-safe general purpose pool allocator with per-thread caches
+ */
+#pragma once
+
+#include "ouly/allocators/alignment.hpp"
+#include "ouly/utility/common.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace ouly
+{
+
+/**
+ * @class ts_pool_allocator
+ * @brief A thread-safe size-class pool allocator that supports any free order from any thread
+ *
+ * Requests up to `max_small_size` are rounded up to one of `size_class_count` size classes, four per
+ * power of two, and served from slabs of `slab_size` bytes that each hold blocks of a single class.
+ * Slabs are cut from pages of `default_page_size` bytes. Larger or over-aligned requests go straight
+ * to the global operator new.
+ *
+ * Every thread that touches the allocator gets its own cache, which owns the slabs it carved. Each
+ * size class of a cache keeps a magazine of free blocks, so the common allocate and deallocate are
+ * a thread-local push or pop with no synchronization at all.
+ *
+ * - A cache whose magazine overflows hands a full magazine to the central per-class depot; a cache
+ *   that runs dry takes one back before it carves new blocks.
+ * - A block freed by a thread other than the one owning its slab is a remote free. Remote frees are
+ *   collected per size class and pushed home as a batch with a single compare-and-swap onto the lock
+ *   free remote list of the owning cache, which the owner drains in one exchange when it runs dry.
+ *   A batch is handed over once it fills, when the owner changes or on flush_thread_cache().
+ *
+ * Like the other allocators, deallocate() needs the size and alignment the block was allocated
+ * with; no per-block header is stored.
+ *
+ * Thread Safety:
+ * - allocate() and deallocate() are thread-safe and may be called from any thread, in any order
+ * - flush_thread_cache() only touches the calling thread's cache
+ * - release() must be called from a single thread once no allocation is live
+ *
+ * @note Thread caches live as long as the allocator. The cache of a thread that exits is orphaned:
+ *       the next thread to attach takes it over, and until then a thread about to cut a new slab
+ *       first takes the blocks the orphan holds and those freed back to it. A thread that stops
+ *       using the allocator but keeps running should call flush_thread_cache(). Threads must not
+ *       use the allocator from thread_local destructors.
+ * @note Plugs into standard containers through allocator_ref<T, ts_pool_allocator> and into
+ *       polymorphic containers through memory_resource<ts_pool_allocator> or memory_resource_ref.
+ */
+class ts_pool_allocator
+{
+public:
+  /** @brief Size of the pages slabs are cut from (1 MiB) */
+  static constexpr std::size_t default_page_size = 1024 * 1024;
+
+  /** @brief Size of a slab; slabs are aligned to their size so a block finds its slab by masking */
+  static constexpr std::size_t slab_size = 64 * 1024;
+
+  /** @brief Every block is aligned to at least this boundary */
+  static constexpr std::size_t alignment = 16;
+
+  /** @brief Largest alignment served from slabs, over-aligned requests use operator new */
+  static constexpr std::size_t max_slab_alignment = 64;
+
+  /** @brief Largest request served from slabs */
+  static constexpr std::size_t max_small_size = 8 * 1024;
+
+  /** @brief Number of size classes between `alignment` and `max_small_size` */
+  static constexpr uint32_t size_class_count = 32;
+
+  /** @brief Default number of blocks moved between a thread cache and the depot at once */
+  static constexpr uint32_t default_magazine_size = 64;
+
+  /**
+   * @brief Default constructor
+   * Uses default_magazine_size blocks per magazine
+   */
+  ts_pool_allocator() noexcept = default;
+
+  /**
+   * @brief Constructor with custom magazine size
+   * @param magazine_size Blocks per magazine and per remote batch (must be > 0)
+   */
+  explicit ts_pool_allocator(uint32_t magazine_size) noexcept : magazine_size_{magazine_size}
+  {
+    OULY_ASSERT(magazine_size > 0);
+  }
+
+  ts_pool_allocator(ts_pool_allocator const&)                    = delete;
+  ts_pool_allocator(ts_pool_allocator&&)                         = delete;
+  auto operator=(ts_pool_allocator const&) -> ts_pool_allocator& = delete;
+  auto operator=(ts_pool_allocator&&) -> ts_pool_allocator&      = delete;
+
+  /**
+   * @brief Destructor
+   * Automatically releases all pages and thread caches
+   */
+  ~ts_pool_allocator() noexcept
+  {
+    release();
+  }
+
+  /**
+   * @brief Allocate `size` bytes aligned to `align`
+   * @param size Number of bytes to allocate
+   * @param align Requested alignment, an ouly::alignment tag, a std::align_val_t or a power of two
+   * @return Pointer to the allocated block, aligned to at least `alignment`
+   * @note Thread-safe, lock free unless the calling thread's cache has to be refilled
+   */
+  template <typename Alignment = ouly::alignment<>>
+  [[nodiscard]] auto allocate(std::size_t size, Alignment align = {}) -> void*
+  {
+    return allocate_block(size, ouly::detail::alignment_of(align));
+  }
+
+  /**
+   * @brief Return a block to the pool, from any thread
+   * @param ptr Block to release, nullptr is ignored
+   * @param size Size the block was allocated with
+   * @param align Alignment the block was allocated with
+   */
+  template <typename Alignment = ouly::alignment<>>
+  void deallocate(void* ptr, std::size_t size, Alignment align = {})
+  {
+    deallocate_block(ptr, size, ouly::detail::alignment_of(align));
+  }
+
+  /**
+   * @brief Hand the calling thread's cached blocks and pending remote batches back to the pool
+   * @note Call it before a worker thread exits or goes idle for long
+   */
+  OULY_API void flush_thread_cache() noexcept;
+
+  /**
+   * @brief Free every page and thread cache
+   * @warning Must be called from a single thread once no allocation is live and no other thread
+   *          uses the allocator
+   * @note Blocks larger than max_small_size are owned by the caller and not released here
+   */
+  OULY_API void release() noexcept;
+
+  /** @brief Number of slabs carved so far; grows only when no cached or depot block fits */
+  [[nodiscard]] auto slab_count() const noexcept -> std::size_t
+  {
+    return slab_count_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Size in bytes of the blocks of a size class */
+  static constexpr auto size_class_size(uint32_t size_class) noexcept -> std::size_t
+  {
+    if (size_class < small_class_count)
+    {
+      return (size_class + 1) * alignment;
+    }
+    auto const        group = (size_class - small_class_count) / classes_per_group;
+    auto const        step  = (size_class - small_class_count) % classes_per_group;
+    std::size_t const base  = std::size_t{1} << (small_class_shift + group);
+    return base + (step + 1) * (base >> 2U);
+  }
+
+  /**
+   * @brief Size class serving a request, or size_class_count when the request bypasses the slabs
+   * @param size Requested size
+   * @param align Requested alignment, 0 or 1 for none
+   */
+  static constexpr auto size_class_of(std::size_t size, std::size_t align) noexcept -> uint32_t
+  {
+    if (size > max_small_size || align > max_slab_alignment)
+    {
+      return size_class_count;
+    }
+    uint32_t size_class = 0;
+    if (size > small_limit)
+    {
+      auto const last  = size - 1;
+      auto const shift = static_cast<uint32_t>(std::bit_width(last)) - 1;
+      auto const step  = static_cast<uint32_t>(last >> (shift - 2)) & (classes_per_group - 1);
+      size_class       = small_class_count + ((shift - small_class_shift) * classes_per_group) + step;
+    }
+    else if (size > 0)
+    {
+      size_class = static_cast<uint32_t>((size - 1) / alignment);
+    }
+    // Blocks are laid out at multiples of the class size from a max_slab_alignment boundary, so
+    // any class that is a multiple of the alignment serves it; the power-of-two classes always do
+    while (align > alignment && size_class_size(size_class) % align != 0)
+    {
+      ++size_class;
+    }
+    return size_class;
+  }
+
+  struct free_block;
+  struct slab_t;
+  struct thread_cache;
+
+private:
+  static constexpr uint32_t    small_class_count = 8;
+  static constexpr uint32_t    small_class_shift = 7;
+  static constexpr uint32_t    classes_per_group = 4;
+  static constexpr std::size_t small_limit       = small_class_count * alignment;
+
+  /**
+   * @brief Central per-class store of full magazines, each a chain of free blocks
+   */
+  struct alignas(ouly_cache_line_size) depot_t
+  {
+    std::mutex  mutex_;
+    free_block* magazines_ = nullptr;
+  };
+
+  OULY_API auto allocate_block(std::size_t size, std::size_t align) -> void*;
+  OULY_API void deallocate_block(void* ptr, std::size_t size, std::size_t align);
+
+  /**
+   * @brief Cache of the calling thread, created on its first use of this allocator
+   */
+  auto local_cache() -> thread_cache*;
+  auto attach_thread() -> thread_cache*;
+
+  /**
+   * @brief Refill an empty magazine from remote frees, the depot, an orphaned cache or a fresh slab
+   */
+  auto refill(thread_cache& cache, uint32_t size_class) -> void*;
+  /**
+   * @brief Take the free blocks, or the uncarved rest of a slab, of one class from the cache of a
+   * thread that exited
+   */
+  auto adopt_orphaned(thread_cache& cache, uint32_t size_class) -> free_block*;
+  void carve_slab(thread_cache& cache, uint32_t size_class);
+  void push_magazine(uint32_t size_class, free_block* magazine) noexcept;
+  void flush_remote(thread_cache& cache, uint32_t size_class) noexcept;
+  void flush_cache(thread_cache& cache) noexcept;
+
+  static OULY_API auto next_id() noexcept -> uint64_t;
+
+  /* ---------- Data members -------------------------------------------- */
+
+  /** @brief Identifies this allocator in the thread-local cache lookup; changes on release() */
+  uint64_t id_ = next_id();
+
+  /** @brief Blocks per magazine and per remote batch */
+  uint32_t magazine_size_ = default_magazine_size;
+
+  /** @brief Number of slabs carved from pages */
+  std::atomic_size_t slab_count_ = 0;
+
+  /** @brief Mutex protecting the page and cache lists */
+  std::mutex mutex_;
+
+  /** @brief Every thread cache created so far */
+  thread_cache* caches_ = nullptr;
+
+  /** @brief Pages slabs are cut from, linked through the header of their first slab */
+  slab_t* pages_ = nullptr;
+
+  /** @brief Next uncut slab of the current page */
+  std::byte* page_cursor_ = nullptr;
+
+  /** @brief End of the current page */
+  std::byte* page_end_ = nullptr;
+
+  /** @brief Full magazines per size class */
+  std::array<depot_t, size_class_count> depots_;
+};
+
+static_assert(ts_pool_allocator::size_class_size(ts_pool_allocator::size_class_count - 1) ==
+              ts_pool_allocator::max_small_size);
+static_assert(ts_pool_allocator::size_class_of(ts_pool_allocator::max_small_size, 0) ==
+              ts_pool_allocator::size_class_count - 1);
+
+} // namespace ouly
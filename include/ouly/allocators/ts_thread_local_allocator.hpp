@@ -5,6 +5,7 @@
 #pragma once
 
 #include "ouly/allocators/alignment.hpp"
+#include "ouly/allocators/config.hpp"
 #include "ouly/utility/common.hpp"
 #include <cstddef>
 #include <cstdint>
@@ -28,6 +29,7 @@ namespace ouly
  * - Generation-based invalidation for safe reset
  * - Optional stack-style deallocation for the most recent allocation
  * - All allocations are aligned to alignof(std::max_align_t)
+ * - Optional huge page backed arenas, sized in whole huge pages, to cut dTLB misses on large frames
  *
  * Thread Safety:
  * - allocate() and deallocate() are thread-safe
@@ -63,12 +65,23 @@ public:
    */
   explicit ts_thread_local_allocator(std::size_t page_size) noexcept : default_page_size_{page_size} {}
 
+  /**
+   * @brief Constructor with custom page size and huge page backing
+   * @param page_size Size in bytes for new arenas (must be > 0)
+   * @param policy How arenas are backed by huge pages; under a policy other than none arenas come
+   *        straight from the system and are rounded up to whole huge pages
+   */
+  ts_thread_local_allocator(std::size_t page_size, cfg::huge_page_policy policy) noexcept
+      : default_page_size_{page_size}, huge_pages_{policy}
+  {}
+
   /**
    * @brief Move constructor
    * @param other Source allocator (will be reset)
    */
   ts_thread_local_allocator(ts_thread_local_allocator&& other) noexcept
       : default_page_size_{std::exchange(other.default_page_size_, default_page_size)},
+        huge_pages_{std::exchange(other.huge_pages_, cfg::huge_page_policy::none)},
         page_list_head_{std::exchange(other.page_list_head_, nullptr)},
         page_list_tail_{std::exchange(other.page_list_tail_, nullptr)},
         available_pages_(std::exchange(other.available_pages_, nullptr)),
@@ -88,6 +101,7 @@ public:
     }
     reset(); // free any existing arenas
     default_page_size_ = std::exchange(other.default_page_size_, default_page_size);
+    huge_pages_        = std::exchange(other.huge_pages_, cfg::huge_page_policy::none);
     page_list_head_    = std::exchange(other.page_list_head_, nullptr);
     page_list_tail_    = std::exchange(other.page_list_tail_, nullptr);
     pages_to_free_     = std::exchange(other.pages_to_free_, nullptr);
@@ -209,10 +223,17 @@ private:
 
   /**
    * @brief Create a new arena with specified payload size
-   * @param payload_size Size of the data portion in bytes
+   * @param payload_size Size of the data portion in bytes, grown to fill whole huge pages when they
+   *        back the arena
    * @return Pointer to newly created arena
    */
-  static auto create_page(std::size_t payload_size) -> arena_t*;
+  auto create_page(std::size_t payload_size) -> arena_t*;
+
+  /**
+   * @brief Return an arena to the system
+   * @param page Arena created by create_page()
+   */
+  void destroy_page(arena_t* page) const noexcept;
 
   /**
    * @brief Try to reuse an arena from the free list
@@ -241,6 +262,9 @@ private:
   /** @brief Default size for new arenas */
   std::size_t default_page_size_ = default_page_size;
 
+  /** @brief How arenas are backed by huge pages */
+  cfg::huge_page_policy huge_pages_ = cfg::huge_page_policy::none;
+
   /** @brief Mutex protecting shared data structures */
   std::shared_mutex page_mutex_;
 
@@ -8,6 +8,8 @@
 #include "ouly/allocators/detail/platform_memory.hpp"
 #include "ouly/allocators/tags.hpp"
 #include <cstddef>
+#include <cstdint>
+#include <new>
 
 namespace ouly
 {
@@ -28,6 +30,8 @@ namespace ouly
  * - Supports memory protection flags (read/write/execute combinations)
  * - Page-aligned allocations (automatically rounds up to page boundaries)
  * - Zero-initialized memory by default
+ * - Reserve-then-commit: reserve() takes address space only, commit()/decommit() back ranges of it
+ * - Optional huge page backing through cfg::huge_pages, see backing_page_size()
  * - Cross-platform (Windows and POSIX systems)
  * - Move constructible/assignable but not copy constructible/assignable
  *
@@ -47,9 +51,16 @@ namespace ouly
  *
  * alloc.deallocate(ptr, 1024 * 1024);
  * exec_alloc.deallocate(code_ptr, 4096);
+ *
+ * // Back a large, randomly accessed arena with transparent huge pages
+ * using HugeConfig = ouly::config<ouly::cfg::huge_pages<ouly::cfg::huge_page_policy::transparent>>;
+ * virtual_allocator<HugeConfig> huge_alloc;
+ * void* arena = huge_alloc.allocate(64 * 1024 * 1024);
+ * huge_alloc.deallocate(arena, 64 * 1024 * 1024);
  * @endcode
  *
- * @note All allocations are rounded up to the system page size
+ * @note All allocations are rounded up to backing_page_size(): the system page size, or the huge
+ *       page size under a huge page policy
  * @note Memory is automatically zeroed on allocation
  * @warning Deallocating with wrong size or pointer may cause undefined behavior
  */
@@ -64,6 +75,7 @@ public:
 
   static constexpr auto align              = ouly::detail::min_alignment_v<Config>;
   static constexpr auto default_protection = cfg::protection::read_write;
+  static constexpr auto page_policy        = ouly::detail::huge_page_policy_v<Config>;
 
   static constexpr auto null() -> address
   {
@@ -80,6 +92,7 @@ public:
     auto info               = detail::get_memory_info();
     page_size_              = info.page_size_;
     allocation_granularity_ = info.allocation_granularity_;
+    huge_page_size_         = info.huge_page_size_;
   }
 
   /**
@@ -92,7 +105,7 @@ public:
    */
   virtual_allocator(virtual_allocator&& other) noexcept
       : statistics(std::move(other)), page_size_(other.page_size_),
-        allocation_granularity_(other.allocation_granularity_)
+        allocation_granularity_(other.allocation_granularity_), huge_page_size_(other.huge_page_size_)
   {}
 
   /**
@@ -110,6 +123,7 @@ public:
       statistics::operator=(std::move(other));
       page_size_              = other.page_size_;
       allocation_granularity_ = other.allocation_granularity_;
+      huge_page_size_         = other.huge_page_size_;
     }
     return *this;
   }
@@ -122,7 +136,7 @@ public:
   /**
    * @brief Allocate virtual memory
    *
-   * @param size Size in bytes to allocate (will be rounded up to page size)
+   * @param size Size in bytes to allocate (will be rounded up to backing_page_size())
    * @param alignment Memory alignment requirement
    * @return Pointer to allocated memory or nullptr on failure
    */
@@ -139,12 +153,20 @@ public:
     OULY_ASSERT(ouly::detail::alignment_of(alignment_hint) <= page_size_);
 
     // Round up to page size for virtual memory allocation
-    size_type aligned_size = round_up_to_page_size(size);
+    size_type aligned_size = round_up_to_backing_page_size(size);
 
     // Get protection from config or use default
     auto protection = get_protection_from_config();
 
-    void* ptr = detail::virtual_alloc(aligned_size, protection);
+    void* ptr = nullptr;
+    if constexpr (page_policy == cfg::huge_page_policy::none)
+    {
+      ptr = detail::virtual_alloc(aligned_size, protection);
+    }
+    else
+    {
+      ptr = detail::virtual_alloc_huge(aligned_size, page_policy, protection);
+    }
 
     if (ptr != nullptr)
     {
@@ -185,7 +207,7 @@ public:
       return;
     }
 
-    size_type aligned_size = round_up_to_page_size(size);
+    size_type aligned_size = round_up_to_backing_page_size(size);
 
     if (detail::virtual_free(ptr, aligned_size))
     {
@@ -193,6 +215,90 @@ public:
     }
   }
 
+  /**
+   * @brief Reserve address space without committing memory to it
+   *
+   * The region is inaccessible until ranges of it are committed with commit(). Reserving costs
+   * address space only, so a container can reserve far more than it will ever use and grow in
+   * place. Release the reservation with deallocate() and the reserved size. Under a huge page
+   * policy the reservation is huge page aligned so committed ranges can be backed by huge pages.
+   *
+   * @param size Size in bytes to reserve (will be rounded up to the allocation granularity)
+   * @return Pointer to the reserved region or nullptr on failure
+   */
+  [[nodiscard]] auto reserve(size_type size) noexcept -> address
+  {
+    if (size == 0)
+    {
+      return nullptr;
+    }
+
+    size_type aligned_size = round_up_to_granularity(size);
+    if constexpr (page_policy != cfg::huge_page_policy::none)
+    {
+      aligned_size = round_up_to_backing_page_size(aligned_size);
+    }
+    void* ptr = detail::virtual_reserve(aligned_size, page_policy);
+    if (ptr != nullptr)
+    {
+      [[maybe_unused]] auto measure = statistics::report_allocate(aligned_size);
+    }
+    return ptr;
+  }
+
+  /**
+   * @brief Commit a range of a reservation, making it accessible with the configured protection
+   *
+   * @param ptr Start of the range, rounded down to a page boundary
+   * @param size Size of the range, the end is rounded up to a page boundary
+   * @return true on success, false on failure
+   * @note Freshly committed pages read as zero
+   */
+  [[nodiscard]] auto commit(address ptr, size_type size) noexcept -> bool
+  {
+    if (ptr == nullptr)
+    {
+      return false;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const first = reinterpret_cast<std::uintptr_t>(ptr) & ~(page_size_ - 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const last = reinterpret_cast<std::uintptr_t>(ptr) + size;
+    // NOLINTNEXTLINE(performance-no-int-to-ptr)
+    return detail::virtual_commit(reinterpret_cast<void*>(first), round_up_to_page_size(last - first),
+                                  get_protection_from_config());
+  }
+
+  /**
+   * @brief Return the memory of a committed range to the system, keeping it reserved
+   *
+   * Only the pages lying entirely inside the range are decommitted, so partially used pages at
+   * either end stay intact. Decommitted pages are inaccessible until committed again.
+   *
+   * @param ptr Start of the range
+   * @param size Size of the range
+   * @return true on success or when no whole page lies in the range, false on failure
+   */
+  [[nodiscard]] auto decommit(address ptr, size_type size) noexcept -> bool
+  {
+    if (ptr == nullptr)
+    {
+      return false;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const first = (reinterpret_cast<std::uintptr_t>(ptr) + page_size_ - 1) & ~(page_size_ - 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto const last = (reinterpret_cast<std::uintptr_t>(ptr) + size) & ~(page_size_ - 1);
+    if (last <= first)
+    {
+      return true;
+    }
+    // NOLINTNEXTLINE(performance-no-int-to-ptr)
+    return detail::virtual_decommit(reinterpret_cast<void*>(first), last - first);
+  }
+
   /**
    * @brief Change memory protection on a region
    *
@@ -239,6 +345,25 @@ public:
     return page_size_;
   }
 
+  /**
+   * @brief Get the huge page size of the system
+   */
+  [[nodiscard]] auto huge_page_size() const noexcept -> size_type
+  {
+    return huge_page_size_;
+  }
+
+  /**
+   * @brief Size allocations are rounded up to: the huge page size under a huge page policy,
+   *        otherwise the page size
+   *
+   * Size arenas taken from this allocator in multiples of it; the rounding is paid for anyway.
+   */
+  [[nodiscard]] auto backing_page_size() const noexcept -> size_type
+  {
+    return page_policy == cfg::huge_page_policy::none ? page_size_ : huge_page_size_;
+  }
+
   /**
    * @brief Get system allocation granularity
    */
@@ -250,12 +375,24 @@ public:
 private:
   size_type page_size_{0};
   size_type allocation_granularity_{0};
+  size_type huge_page_size_{0};
 
   [[nodiscard]] auto round_up_to_page_size(size_type size) const noexcept -> size_type
   {
     return ((size + page_size_ - 1) / page_size_) * page_size_;
   }
 
+  [[nodiscard]] auto round_up_to_backing_page_size(size_type size) const noexcept -> size_type
+  {
+    auto const page = backing_page_size();
+    return ((size + page - 1) / page) * page;
+  }
+
+  [[nodiscard]] auto round_up_to_granularity(size_type size) const noexcept -> size_type
+  {
+    return ((size + allocation_granularity_ - 1) / allocation_granularity_) * allocation_granularity_;
+  }
+
   [[nodiscard]] auto get_protection_from_config() const noexcept -> cfg::protection
   {
     // Check if config specifies protection, otherwise use default
@@ -270,4 +407,99 @@ private:
   }
 };
 
+/**
+ * @brief Stateless allocator handing out whole pages straight from the system
+ *
+ * The static counterpart of virtual_allocator, meant to be the cfg::underlying_allocator of arena
+ * allocators such as linear_arena_allocator. It honours cfg::huge_pages and advertises page_size(),
+ * which arena allocators round their arena sizes up to.
+ *
+ * Example usage:
+ * @code
+ * using huge_pages   = ouly::cfg::huge_pages<ouly::cfg::huge_page_policy::transparent>;
+ * using arena_config = ouly::config<ouly::cfg::underlying_allocator<ouly::page_allocator<ouly::config<huge_pages>>>>;
+ * ouly::linear_arena_allocator<arena_config> frame_arena; // 4 MiB arenas, each backed by two 2 MiB pages
+ * @endcode
+ *
+ * @note Like the default allocator, a failed allocation throws std::bad_alloc
+ */
+template <typename Config = ouly::config<>>
+struct page_allocator
+{
+  using tag       = virtual_memory_allocator_tag;
+  using size_type = std::size_t;
+  using address   = void*;
+
+  /** @brief Smallest page size of the supported targets, every block is aligned to it */
+  static constexpr std::size_t align       = 4096;
+  static constexpr auto        page_policy = ouly::detail::huge_page_policy_v<Config>;
+
+  static constexpr auto null() -> address
+  {
+    return nullptr;
+  }
+
+  /**
+   * @brief Size blocks are rounded up to: the huge page size under a huge page policy, otherwise the
+   *        system page size
+   */
+  [[nodiscard]] static auto page_size() noexcept -> size_type
+  {
+    auto const info = detail::get_memory_info();
+    return page_policy == cfg::huge_page_policy::none ? info.page_size_ : info.huge_page_size_;
+  }
+
+  template <typename Alignment = alignment<align>>
+  [[nodiscard]] static auto allocate(size_type size, [[maybe_unused]] Alignment alignment_hint = {}) -> address
+  {
+    OULY_ASSERT(ouly::detail::alignment_of(alignment_hint) <= page_size());
+
+    void* ptr = nullptr;
+    if constexpr (page_policy == cfg::huge_page_policy::none)
+    {
+      ptr = detail::virtual_alloc(round_up_to_page_size(size));
+    }
+    else
+    {
+      ptr = detail::virtual_alloc_huge(round_up_to_page_size(size), page_policy);
+    }
+
+    if (ptr == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  /** @brief Pages come zeroed from the system, so this is allocate() */
+  template <typename Alignment = alignment<align>>
+  [[nodiscard]] static auto zero_allocate(size_type size, Alignment alignment_hint = {}) -> address
+  {
+    return allocate(size, alignment_hint);
+  }
+
+  template <typename Alignment = alignment<align>>
+  static void deallocate(address ptr, size_type size, Alignment /* alignment_hint */ = {}) noexcept
+  {
+    detail::virtual_free(ptr, round_up_to_page_size(size));
+  }
+
+  constexpr auto operator==(page_allocator const& /*unused*/) const -> bool
+  {
+    return true;
+  }
+
+  constexpr auto operator!=(page_allocator const& /*unused*/) const -> bool
+  {
+    return false;
+  }
+
+private:
+  [[nodiscard]] static auto round_up_to_page_size(size_type size) noexcept -> size_type
+  {
+    auto const page = page_size();
+    return ((size + page - 1) / page) * page;
+  }
+};
+
 } // namespace ouly
@@ -0,0 +1,480 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/allocators/virtual_allocator.hpp"
+#include "ouly/utility/common.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ouly
+{
+
+/**
+ * @brief Contiguous vector that grows in place inside a fixed address space reservation
+ *
+ * virtual_vector reserves address space for `max_size()` elements the first time it grows, and
+ * commits pages at the end of the reservation as the vector grows. Elements never move:
+ * growing is a page commit instead of a reallocate-and-copy, pointers and iterators stay valid
+ * across push_back() and resize(), and the cost of growth is O(1) amortized without ever copying
+ * an element. This suits multi-million element arrays whose final size is not known up front.
+ *
+ * Reservations cost no memory, only address space, so the default is generous: 64 GiB on 64-bit
+ * targets. Committing uses geometric steps so the number of commit calls stays logarithmic in the
+ * final size; the pages are only backed once they are touched.
+ *
+ * @tparam Ty Element type
+ * @tparam Config Configuration forwarded to the underlying virtual_allocator (protection, stats)
+ *
+ * Example usage:
+ * @code
+ * ouly::virtual_vector<particle> particles;      // nothing reserved yet
+ * particles.emplace_back(...);                    // reserves 64 GiB, commits the first pages
+ * particle* first = particles.data();
+ * particles.resize(10'000'000);                   // commits more pages, first stays valid
+ * @endcode
+ *
+ * @note Growing past max_size() throws std::bad_alloc, as does a failed commit
+ * @note Moving the vector moves the reservation; the elements themselves stay where they are
+ * @note Copy construction and copy assignment both take the max_size() of the source
+ */
+template <typename Ty, typename Config = ouly::config<>>
+class virtual_vector
+{
+public:
+  using value_type             = Ty;
+  using size_type              = std::size_t;
+  using difference_type        = std::ptrdiff_t;
+  using reference              = Ty&;
+  using const_reference        = Ty const&;
+  using pointer                = Ty*;
+  using const_pointer          = Ty const*;
+  using iterator               = Ty*;
+  using const_iterator         = Ty const*;
+  using reverse_iterator       = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using allocator_type         = virtual_allocator<Config>;
+
+  /** @brief Address space reserved by default */
+  static constexpr size_type default_reserved_bytes =
+   sizeof(void*) >= 8 ? size_type{64} * 1024 * 1024 * 1024 : size_type{256} * 1024 * 1024;
+
+  /** @brief Smallest commit step, so small vectors do not commit one page at a time */
+  static constexpr size_type min_commit_bytes = size_type{64} * 1024;
+
+  virtual_vector() noexcept = default;
+
+  /**
+   * @brief Construct an empty vector that can grow to `max_elements`
+   * @param max_elements Number of elements to reserve address space for
+   */
+  explicit virtual_vector(size_type max_elements) noexcept : max_size_(max_elements) {}
+
+  virtual_vector(std::initializer_list<Ty> values)
+  {
+    reserve(values.size());
+    for (auto const& value : values)
+    {
+      std::construct_at(data_ + size_, value);
+      ++size_;
+    }
+  }
+
+  virtual_vector(virtual_vector const& other) : max_size_(other.max_size_)
+  {
+    reserve(other.size_);
+    for (auto const& value : other)
+    {
+      std::construct_at(data_ + size_, value);
+      ++size_;
+    }
+  }
+
+  virtual_vector(virtual_vector&& other) noexcept
+      : allocator_(std::move(other.allocator_)), data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)), committed_bytes_(std::exchange(other.committed_bytes_, 0)),
+        max_size_(other.max_size_)
+  {}
+
+  auto operator=(virtual_vector const& other) -> virtual_vector&
+  {
+    if (this != &other)
+    {
+      if (max_size_ == other.max_size_)
+      {
+        clear();
+      }
+      else
+      {
+        // The reservation is sized for max_size(), so a different limit needs a new one
+        release();
+        max_size_ = other.max_size_;
+      }
+      reserve(other.size_);
+      for (auto const& value : other)
+      {
+        std::construct_at(data_ + size_, value);
+        ++size_;
+      }
+    }
+    return *this;
+  }
+
+  auto operator=(virtual_vector&& other) noexcept -> virtual_vector&
+  {
+    if (this != &other)
+    {
+      release();
+      allocator_       = std::move(other.allocator_);
+      data_            = std::exchange(other.data_, nullptr);
+      size_            = std::exchange(other.size_, 0);
+      committed_bytes_ = std::exchange(other.committed_bytes_, 0);
+      max_size_        = other.max_size_;
+    }
+    return *this;
+  }
+
+  ~virtual_vector() noexcept
+  {
+    release();
+  }
+
+  [[nodiscard]] auto size() const noexcept -> size_type
+  {
+    return size_;
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return size_ == 0;
+  }
+
+  /** @brief Elements that fit in the committed pages */
+  [[nodiscard]] auto capacity() const noexcept -> size_type
+  {
+    return std::min(committed_bytes_ / sizeof(Ty), max_size_);
+  }
+
+  /** @brief Elements that fit in the address space reservation */
+  [[nodiscard]] auto max_size() const noexcept -> size_type
+  {
+    return max_size_;
+  }
+
+  /** @brief Bytes of the reservation currently committed */
+  [[nodiscard]] auto committed_bytes() const noexcept -> size_type
+  {
+    return committed_bytes_;
+  }
+
+  [[nodiscard]] auto data() noexcept -> pointer
+  {
+    return data_;
+  }
+
+  [[nodiscard]] auto data() const noexcept -> const_pointer
+  {
+    return data_;
+  }
+
+  auto operator[](size_type index) noexcept -> reference
+  {
+    OULY_ASSERT(index < size_);
+    return data_[index];
+  }
+
+  auto operator[](size_type index) const noexcept -> const_reference
+  {
+    OULY_ASSERT(index < size_);
+    return data_[index];
+  }
+
+  auto at(size_type index) noexcept -> reference
+  {
+    OULY_ASSERT(index < size_);
+    return data_[index];
+  }
+
+  [[nodiscard]] auto at(size_type index) const noexcept -> const_reference
+  {
+    OULY_ASSERT(index < size_);
+    return data_[index];
+  }
+
+  auto front() noexcept -> reference
+  {
+    return at(0);
+  }
+
+  [[nodiscard]] auto front() const noexcept -> const_reference
+  {
+    return at(0);
+  }
+
+  auto back() noexcept -> reference
+  {
+    return at(size_ - 1);
+  }
+
+  [[nodiscard]] auto back() const noexcept -> const_reference
+  {
+    return at(size_ - 1);
+  }
+
+  auto begin() noexcept -> iterator
+  {
+    return data_;
+  }
+
+  auto end() noexcept -> iterator
+  {
+    return data_ + size_;
+  }
+
+  [[nodiscard]] auto begin() const noexcept -> const_iterator
+  {
+    return data_;
+  }
+
+  [[nodiscard]] auto end() const noexcept -> const_iterator
+  {
+    return data_ + size_;
+  }
+
+  [[nodiscard]] auto cbegin() const noexcept -> const_iterator
+  {
+    return data_;
+  }
+
+  [[nodiscard]] auto cend() const noexcept -> const_iterator
+  {
+    return data_ + size_;
+  }
+
+  auto rbegin() noexcept -> reverse_iterator
+  {
+    return reverse_iterator(end());
+  }
+
+  auto rend() noexcept -> reverse_iterator
+  {
+    return reverse_iterator(begin());
+  }
+
+  [[nodiscard]] auto rbegin() const noexcept -> const_reverse_iterator
+  {
+    return const_reverse_iterator(end());
+  }
+
+  [[nodiscard]] auto rend() const noexcept -> const_reverse_iterator
+  {
+    return const_reverse_iterator(begin());
+  }
+
+  void push_back(Ty const& value)
+  {
+    emplace_back(value);
+  }
+
+  void push_back(Ty&& value)
+  {
+    emplace_back(std::move(value));
+  }
+
+  /**
+   * @brief Construct an element at the end
+   * @note Arguments may refer to elements of this vector: growing never moves them
+   */
+  template <typename... Args>
+  auto emplace_back(Args&&... args) -> reference
+  {
+    if (size_ == capacity()) [[unlikely]]
+    {
+      grow(size_ + 1);
+    }
+    auto* value = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+    ++size_;
+    return *value;
+  }
+
+  void pop_back() noexcept
+  {
+    OULY_ASSERT(size_ > 0);
+    --size_;
+    std::destroy_at(data_ + size_);
+  }
+
+  void resize(size_type count)
+  {
+    resize_with(count,
+                [](Ty* where)
+                {
+                  std::construct_at(where);
+                });
+  }
+
+  void resize(size_type count, Ty const& value)
+  {
+    resize_with(count,
+                [&value](Ty* where)
+                {
+                  std::construct_at(where, value);
+                });
+  }
+
+  /**
+   * @brief Commit pages for at least `count` elements
+   */
+  void reserve(size_type count)
+  {
+    if (count > capacity())
+    {
+      if (count > max_size_)
+      {
+        throw std::bad_alloc();
+      }
+      commit_bytes(count * sizeof(Ty));
+    }
+  }
+
+  /**
+   * @brief Decommit the pages past the last element, returning their memory to the system
+   */
+  void shrink_to_fit() noexcept
+  {
+    if (data_ == nullptr)
+    {
+      return;
+    }
+    auto const keep = round_up_to_page(size_ * sizeof(Ty));
+    if (keep < committed_bytes_ && allocator_.decommit(byte_data() + keep, committed_bytes_ - keep))
+    {
+      committed_bytes_ = keep;
+    }
+  }
+
+  /**
+   * @brief Destroy all elements; the committed pages are kept for reuse
+   */
+  void clear() noexcept
+  {
+    if constexpr (!std::is_trivially_destructible_v<Ty>)
+    {
+      std::destroy(data_, data_ + size_);
+    }
+    size_ = 0;
+  }
+
+  void swap(virtual_vector& other) noexcept
+  {
+    std::swap(allocator_, other.allocator_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(committed_bytes_, other.committed_bytes_);
+    std::swap(max_size_, other.max_size_);
+  }
+
+  friend void swap(virtual_vector& lhs, virtual_vector& rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+  friend auto operator==(virtual_vector const& lhs, virtual_vector const& rhs) -> bool
+  {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  template <typename Construct>
+  void resize_with(size_type count, Construct&& construct)
+  {
+    if (count < size_)
+    {
+      if constexpr (!std::is_trivially_destructible_v<Ty>)
+      {
+        std::destroy(data_ + count, data_ + size_);
+      }
+      size_ = count;
+      return;
+    }
+
+    if (count > capacity())
+    {
+      grow(count);
+    }
+    for (; size_ < count; ++size_)
+    {
+      construct(data_ + size_);
+    }
+  }
+
+  void grow(size_type count)
+  {
+    if (count > max_size_)
+    {
+      throw std::bad_alloc();
+    }
+    // Geometric steps keep the number of commits logarithmic; untouched pages cost nothing
+    auto const needed = count * sizeof(Ty);
+    commit_bytes(std::max({needed, committed_bytes_ + (committed_bytes_ / 2), min_commit_bytes}));
+  }
+
+  void commit_bytes(size_type bytes)
+  {
+    auto const reserved = max_size_ * sizeof(Ty);
+    if (data_ == nullptr)
+    {
+      data_ = static_cast<Ty*>(allocator_.reserve(reserved));
+      if (data_ == nullptr)
+      {
+        throw std::bad_alloc();
+      }
+    }
+
+    auto const target = round_up_to_page(std::min(bytes, reserved));
+    if (target > committed_bytes_)
+    {
+      if (!allocator_.commit(byte_data() + committed_bytes_, target - committed_bytes_))
+      {
+        throw std::bad_alloc();
+      }
+      committed_bytes_ = target;
+    }
+  }
+
+  void release() noexcept
+  {
+    clear();
+    if (data_ != nullptr)
+    {
+      allocator_.deallocate(data_, max_size_ * sizeof(Ty));
+      data_            = nullptr;
+      committed_bytes_ = 0;
+    }
+  }
+
+  [[nodiscard]] auto byte_data() const noexcept -> std::byte*
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<std::byte*>(data_);
+  }
+
+  [[nodiscard]] auto round_up_to_page(size_type bytes) const noexcept -> size_type
+  {
+    auto const page = allocator_.page_size();
+    return ((bytes + page - 1) / page) * page;
+  }
+
+  allocator_type allocator_;
+  Ty*            data_            = nullptr;
+  size_type      size_            = 0;
+  size_type      committed_bytes_ = 0;
+  size_type      max_size_        = default_reserved_bytes / sizeof(Ty);
+};
+
+} // namespace ouly
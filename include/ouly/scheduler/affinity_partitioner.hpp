@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/auto_parallel_for.hpp"
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/chunked_range.hpp"
+#include "ouly/scheduler/detail/parallel_executer.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly
+{
+
+/**
+ * @brief Stateful partitioner that replays the previous call's chunk-to-worker assignment.
+ *
+ * The range is cut into a fixed number of chunks (`chunks_per_worker` per member of the calling
+ * workgroup, at least `Traits::grain_size` elements each). The partitioner remembers which member
+ * ran every chunk. On the next call with the same object, range size and group size, each member
+ * first works through the chunks it ran last time, so per-frame loops over the same arrays find
+ * their data still in that core's caches. A member that runs out of its own chunks steals the
+ * remaining chunks of the others, one at a time, so imbalance is still corrected; the stolen
+ * chunks then belong to the thief on the following call.
+ *
+ * The object must outlive the call and must not be used by two loops at the same time. Changing
+ * the range size or the group size starts over with a round robin assignment.
+ *
+ * ```cpp
+ * ouly::affinity_partitioner partitioner; // kept across frames
+ * ouly::parallel_for([](particle& p, auto const&) { p.integrate(); }, particles, ctx, partitioner);
+ * ```
+ */
+template <typename Traits = auto_partitioner_traits>
+class basic_affinity_partitioner
+{
+public:
+  static constexpr uint32_t chunks_per_worker = 4;
+  static constexpr uint32_t no_owner          = ~0U;
+
+  /**
+   * @brief Number of chunks the recorded assignment covers, 0 before the first parallel call.
+   */
+  [[nodiscard]] auto get_chunk_count() const noexcept -> uint32_t
+  {
+    return static_cast<uint32_t>(owners_.size());
+  }
+
+  /**
+   * @brief Chunks of the last call that ran on the same member as in the call before.
+   */
+  [[nodiscard]] auto get_affinity_hits() const noexcept -> uint32_t
+  {
+    return hits_;
+  }
+
+  /**
+   * @brief Forget the recorded assignment.
+   */
+  void reset() noexcept
+  {
+    owners_.clear();
+    count_   = 0;
+    members_ = 0;
+    hits_    = 0;
+  }
+
+  /**
+   * @brief Run `lambda` over `range`, see parallel_for(lambda, range, ctx, partitioner).
+   */
+  template <typename L, typename FwIt, TaskContext WC>
+  void execute(L& lambda, FwIt&& range, WC const& this_context)
+  {
+    auto const count   = ouly::detail::it_size_type<FwIt>::size(range);
+    auto const members = this_context.get_scheduler().get_worker_count(this_context.get_workgroup());
+    auto const chunks  = std::min(count / std::max(Traits::grain_size, 1U), members * chunks_per_worker);
+    if (count <= Traits::sequential_threshold || members <= 1 || chunks <= 1)
+    {
+      execute_sequential_auto(lambda, std::forward<FwIt>(range), this_context);
+      return;
+    }
+
+    auto const chunk_size = (count + chunks - 1) / chunks;
+    auto const plan       = detail::chunk_plan{.count_       = count,
+                                               .chunk_size_  = chunk_size,
+                                               .chunk_count_ = (count + chunk_size - 1) / chunk_size};
+    if (count != count_ || members != members_ || plan.chunk_count_ != owners_.size())
+    {
+      owners_.assign(plan.chunk_count_, no_owner);
+      count_   = count;
+      members_ = members;
+    }
+
+    // Bucket the chunks by the member that ran them last; new chunks are dealt round robin
+    std::vector<uint32_t> order(plan.chunk_count_);
+    std::vector<uint32_t> starts(members + 1, 0);
+    auto const            preferred = [&](uint32_t chunk)
+    {
+      auto const owner = ouly::detail::vector_access(owners_, chunk);
+      return owner < members ? owner : chunk % members;
+    };
+    for (uint32_t chunk = 0; chunk < plan.chunk_count_; ++chunk)
+    {
+      ++ouly::detail::vector_access(starts, preferred(chunk) + 1);
+    }
+    for (uint32_t m = 0; m < members; ++m)
+    {
+      ouly::detail::vector_access(starts, m + 1) += ouly::detail::vector_access(starts, m);
+    }
+    std::vector<uint32_t> fill(starts.begin(), std::prev(starts.end()));
+    for (uint32_t chunk = 0; chunk < plan.chunk_count_; ++chunk)
+    {
+      ouly::detail::vector_access(order, ouly::detail::vector_access(fill, preferred(chunk))++) = chunk;
+    }
+
+    auto cursors = std::make_unique<ouly::detail::cache_aligned_atomic<uint32_t>[]>(members);
+    for (uint32_t m = 0; m < members; ++m)
+    {
+      ouly::detail::vector_access(cursors, m).get().store(ouly::detail::vector_access(starts, m),
+                                                          std::memory_order_relaxed);
+    }
+
+    auto                  first = std::begin(range);
+    std::atomic<uint32_t> hits{0};
+
+    auto const drain = [&](uint32_t list, uint32_t self, WC const& ctx)
+    {
+      auto&      cursor = ouly::detail::vector_access(cursors, list).get();
+      auto const end    = ouly::detail::vector_access(starts, list + 1);
+      for (uint32_t i = cursor.fetch_add(1, std::memory_order_relaxed); i < end;
+           i          = cursor.fetch_add(1, std::memory_order_relaxed))
+      {
+        auto const chunk = ouly::detail::vector_access(order, i);
+        auto&      owner = ouly::detail::vector_access(owners_, chunk);
+        if (owner == self)
+        {
+          hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        owner = self;
+        run_chunk(lambda, first, plan.begin(chunk), plan.end(chunk), ctx);
+      }
+    };
+
+    auto const work = [&](WC const& ctx)
+    {
+      auto const self = ctx.get_group_offset();
+      if (self < members)
+      {
+        drain(self, self, ctx);
+      }
+      for (uint32_t k = 1; k <= members; ++k)
+      {
+        drain((self + k) % members, self, ctx);
+      }
+    };
+
+    basic_task_scope<WC> scope;
+    for (uint32_t m = 1; m < members; ++m)
+    {
+      scope.run(this_context,
+                [&work](WC const& ctx)
+                {
+                  work(ctx);
+                });
+    }
+
+    std::exception_ptr exception;
+    try
+    {
+      work(this_context);
+    }
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+    try
+    {
+      scope.join(this_context);
+    }
+    catch (...)
+    {
+      if (!exception)
+      {
+        exception = std::current_exception();
+      }
+    }
+    hits_ = hits.load(std::memory_order_relaxed);
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+
+private:
+  template <typename L, typename It, TaskContext WC>
+  static void run_chunk(L& lambda, It first, uint32_t begin, uint32_t end, WC const& ctx)
+  {
+    auto chunk_first = detail::advance_by(first, begin);
+    auto chunk_last  = detail::advance_by(first, end);
+    if constexpr (ouly::detail::RangeExecutor<L, It, WC>)
+    {
+      lambda(chunk_first, chunk_last, ctx);
+    }
+    else
+    {
+      for (; chunk_first != chunk_last; ++chunk_first)
+      {
+        lambda(detail::element_at(chunk_first), ctx);
+      }
+    }
+  }
+
+  std::vector<uint32_t> owners_; // Group offset of the member that ran each chunk last
+  uint32_t              count_   = 0;
+  uint32_t              members_ = 0;
+  uint32_t              hits_    = 0;
+};
+
+using affinity_partitioner = basic_affinity_partitioner<>;
+
+} // namespace ouly
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
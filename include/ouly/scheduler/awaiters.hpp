@@ -4,6 +4,7 @@
 
 #include "ouly/scheduler/detail/coro_state.hpp"
 
+#include <concepts>
 #include <exception>
 
 namespace ouly
@@ -44,6 +45,15 @@ auto dispatch_coroutine(std::coroutine_handle<> coroutine) noexcept -> std::coro
   {
     group = ctx->get_workgroup();
   }
+  // Symmetric transfer: with inline continuations enabled, a coroutine bound to the current
+  // workgroup is resumed directly by the caller's resume() without growing the stack. Detached
+  // frames are only destroyed by the resume_coroutine() that resumed them, so they still go through
+  // the queue.
+  if (!typed.promise().detached_ && group == ctx->get_workgroup() &&
+      ctx->get_scheduler().get_inline_continuation_depth() != 0)
+  {
+    return coroutine;
+  }
   ctx->get_scheduler().submit(*ctx, group,
                               [typed](context_type const& run_ctx) noexcept -> void
                               {
@@ -122,6 +132,15 @@ public:
     {
       state.continuation_dispatch_.store(nullptr, std::memory_order_release);
     }
+    if constexpr (std::derived_from<AwaitingPromise, ouly::detail::coro_state>)
+    {
+      // Not started yet means nobody else can be reading it: a submitted task claims its start when
+      // it is submitted
+      if (!state.cancellation_ && !state.started_.load(std::memory_order_acquire))
+      {
+        state.cancellation_ = awaiting_coro.promise().cancellation_;
+      }
+    }
     // Try to install ourselves as the continuation.
     std::coroutine_handle<> expected = nullptr;
     if (state.continuation_.compare_exchange_strong(expected, awaiting_coro, std::memory_order_acq_rel,
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/utility/user_config.hpp"
+
+#include <atomic>
+#include <exception>
+
+namespace ouly
+{
+
+/**
+ * @brief Result of a task, co_task or continuation that was skipped because its cancellation token
+ * was cancelled before it started.
+ *
+ * Travels like any other task exception: get() rethrows it, then() continuations forward it and
+ * when_all() completes with it.
+ */
+class task_cancelled : public std::exception
+{
+public:
+  [[nodiscard]] auto what() const noexcept -> char const* override
+  {
+    return "ouly::task_cancelled";
+  }
+};
+
+class cancellation_source;
+
+/**
+ * @brief Non-owning, trivially copyable view of a cancellation_source.
+ *
+ * Attach it to submit_task(), basic_task_scope, co_task::set_cancellation_token() or a flow graph run.
+ * Work that has not started when its source is cancelled is skipped where the scheduler picks it up;
+ * work that is already running may poll is_cancelled() or call throw_if_cancelled() to leave early.
+ * A default constructed token can never be cancelled.
+ *
+ * The source must outlive every piece of work holding one of its tokens.
+ */
+class cancellation_token
+{
+public:
+  cancellation_token() noexcept = default;
+
+  [[nodiscard]] auto is_cancelled() const noexcept -> bool
+  {
+    return flag_ != nullptr && flag_->load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] auto can_be_cancelled() const noexcept -> bool
+  {
+    return flag_ != nullptr;
+  }
+
+  void throw_if_cancelled() const
+  {
+    if (is_cancelled())
+    {
+      throw task_cancelled();
+    }
+  }
+
+  [[nodiscard]] explicit operator bool() const noexcept
+  {
+    return flag_ != nullptr;
+  }
+
+  auto operator==(cancellation_token const&) const noexcept -> bool = default;
+
+private:
+  friend class cancellation_source;
+
+  explicit cancellation_token(std::atomic_bool const* flag) noexcept : flag_(flag) {}
+
+  std::atomic_bool const* flag_ = nullptr;
+};
+
+/**
+ * @brief Owner of a cancellation flag shared by every token handed out from it.
+ *
+ * Cancelling is a single store; it never waits for running work. Typically one source per level,
+ * request or frame; reset() rearms it once the work it governed has drained.
+ */
+class cancellation_source
+{
+public:
+  cancellation_source() noexcept                                     = default;
+  cancellation_source(cancellation_source const&)                    = delete;
+  cancellation_source(cancellation_source&&)                         = delete;
+  auto operator=(cancellation_source const&) -> cancellation_source& = delete;
+  auto operator=(cancellation_source&&) -> cancellation_source&      = delete;
+  ~cancellation_source() noexcept                                    = default;
+
+  [[nodiscard]] auto get_token() const noexcept -> cancellation_token
+  {
+    return cancellation_token(&cancelled_);
+  }
+
+  /**
+   * @brief Cancel every token of this source; returns false if it was cancelled already.
+   */
+  auto request_cancel() noexcept -> bool
+  {
+    return !cancelled_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  [[nodiscard]] auto is_cancellation_requested() const noexcept -> bool
+  {
+    return cancelled_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Make the source usable again; only once no work holding its tokens is pending.
+   */
+  void reset() noexcept
+  {
+    cancelled_.store(false, std::memory_order_release);
+  }
+
+private:
+  std::atomic_bool cancelled_{false};
+};
+
+namespace detail
+{
+inline auto cancelled_exception() noexcept -> std::exception_ptr
+{
+  return std::make_exception_ptr(task_cancelled());
+}
+} // namespace detail
+
+} // namespace ouly
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/auto_parallel_for.hpp"
+#include "ouly/scheduler/detail/parallel_executer.hpp"
+#include "ouly/utility/subrange.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace ouly::detail
+{
+
+/**
+ * @brief Upper bound on the number of chunks a reduction or scan is cut into. Also the number of
+ * cache-line padded partial slots it needs.
+ */
+constexpr uint32_t max_range_chunks = 256;
+
+/**
+ * @brief Fixed cut of [0, count) into equally sized chunks, the last one possibly shorter.
+ *
+ * The cut depends only on the element count and the traits, never on the worker count or on which
+ * worker runs what, so folding chunks and then combining chunk partials in index order is
+ * reproducible from run to run, even for floating point.
+ */
+struct chunk_plan
+{
+  uint32_t count_       = 0;
+  uint32_t chunk_size_  = 0;
+  uint32_t chunk_count_ = 0;
+
+  [[nodiscard]] auto begin(uint32_t chunk) const noexcept -> uint32_t
+  {
+    return chunk * chunk_size_;
+  }
+
+  [[nodiscard]] auto end(uint32_t chunk) const noexcept -> uint32_t
+  {
+    return std::min(count_, (chunk + 1) * chunk_size_);
+  }
+};
+
+template <typename Traits>
+[[nodiscard]] auto make_chunk_plan(uint32_t count) noexcept -> chunk_plan
+{
+  if (count <= Traits::sequential_threshold)
+  {
+    return {.count_ = count, .chunk_size_ = std::max(count, 1U), .chunk_count_ = count == 0 ? 0U : 1U};
+  }
+  auto const chunk_size =
+   std::max<uint32_t>({Traits::grain_size, 1U, (count + max_range_chunks - 1) / max_range_chunks});
+  return {.count_ = count, .chunk_size_ = chunk_size, .chunk_count_ = (count + chunk_size - 1) / chunk_size};
+}
+
+/**
+ * @brief Traits for algorithms whose per-element work is a handful of instructions (sorting,
+ * partitioning), raising the chunk size and sequential cutoff so that every chunk amortizes its task.
+ */
+template <typename Traits, uint32_t MinChunk = 2048>
+struct min_chunk_traits : Traits
+{
+  static constexpr uint32_t grain_size           = std::max<uint32_t>(Traits::grain_size, MinChunk);
+  static constexpr uint32_t sequential_threshold = std::max<uint32_t>(Traits::sequential_threshold, MinChunk);
+};
+
+/**
+ * @brief Partitioner traits used to spread chunk indices over the workers. Every chunk is already
+ * worth a task, so the auto partitioner may split down to single chunks.
+ */
+template <typename Traits>
+struct chunk_partitioner_traits : Traits
+{
+  static constexpr uint32_t grain_size           = 1;
+  static constexpr uint32_t sequential_threshold = 1;
+};
+
+/**
+ * @brief Run `function(chunk, begin, end, ctx)` for every chunk of `plan`, spread over the
+ * workers through auto_parallel_for's range_pool splitting.
+ */
+template <typename Traits, typename F, TaskContext WC>
+void for_each_chunk(chunk_plan const& plan, F&& function, WC const& this_context)
+{
+  auto run_chunk = [&plan, &function](uint32_t chunk, WC const& ctx)
+  {
+    function(chunk, plan.begin(chunk), plan.end(chunk), ctx);
+  };
+
+  if (plan.chunk_count_ <= 1)
+  {
+    if (plan.chunk_count_ == 1)
+    {
+      run_chunk(0, this_context);
+    }
+    return;
+  }
+  auto_parallel_for(run_chunk, ouly::subrange<uint32_t>(0, plan.chunk_count_), this_context,
+                    chunk_partitioner_traits<Traits>{});
+}
+
+/**
+ * @brief `first` advanced by `offset` elements; integral "iterators" are indices.
+ */
+template <typename It>
+[[nodiscard]] auto advance_by(It first, uint32_t offset) -> It
+{
+  if constexpr (std::is_integral_v<It>)
+  {
+    return static_cast<It>(first + static_cast<It>(offset));
+  }
+  else
+  {
+    return first + static_cast<std::iter_difference_t<It>>(offset);
+  }
+}
+
+/**
+ * @brief The element an iterator designates: the index itself for integral ranges.
+ */
+template <typename It>
+[[nodiscard]] auto element_at(It const& it) -> decltype(auto)
+{
+  if constexpr (std::is_integral_v<It>)
+  {
+    return it;
+  }
+  else
+  {
+    return *it;
+  }
+}
+
+/**
+ * @brief Move the `plan.count_` elements at `src` to `dst`, chunk by chunk in parallel.
+ */
+template <typename Traits, typename SrcIt, typename DstIt, TaskContext WC>
+void move_chunks(chunk_plan const& plan, SrcIt src, DstIt dst, WC const& this_context)
+{
+  for_each_chunk<Traits>(
+   plan,
+   [src, dst](uint32_t /*chunk*/, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     std::move(advance_by(src, begin), advance_by(src, end), advance_by(dst, begin));
+   },
+   this_context);
+}
+
+} // namespace ouly::detail
@@ -81,6 +81,17 @@ public:
     coro_.resume();
   }
 
+  /**
+   * @brief Skip the body, completing with ouly::task_cancelled, if `token` is cancelled before the
+   * task starts. co_tasks awaited by this one without a token of their own inherit it.
+   */
+  void set_cancellation_token(cancellation_token token) noexcept
+  {
+    OULY_ASSERT(coro_ && !coro_.promise().started_.load(std::memory_order_relaxed) &&
+                "Attach a cancellation token before the task is started");
+    coro_.promise().cancellation_ = token;
+  }
+
   /**
    * @brief Returns result after waiting for the task to finish, blocks the current thread until work is done
    */
@@ -1,10 +1,12 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 
 #include <atomic>
 #include <coroutine>
+#include <cstdint>
 #include <utility>
 
 namespace ouly::detail
@@ -23,9 +25,35 @@ struct coro_state
   std::atomic_bool                     started_{false};
   std::atomic<continuation_dispatch>   continuation_dispatch_{nullptr};
   workgroup_id                         resume_group_;
+  cancellation_token                   cancellation_;
   bool                                 detached_ = false;
 };
 
+/**
+ * @brief Initial suspend point of a co_task: the body is skipped, and the task completes with
+ * ouly::task_cancelled, when its token was cancelled while it waited to be started.
+ */
+class cancellable_start
+{
+public:
+  explicit cancellable_start(coro_state const& state) noexcept : state_(&state) {}
+
+  [[nodiscard]] static auto await_ready() noexcept -> bool
+  {
+    return false;
+  }
+
+  static void await_suspend(std::coroutine_handle<> /*coroutine*/) noexcept {}
+
+  void await_resume() const
+  {
+    state_->cancellation_.throw_if_cancelled();
+  }
+
+private:
+  coro_state const* state_ = nullptr;
+};
+
 template <TaskContext WC>
 struct coroutine_context_slot
 {
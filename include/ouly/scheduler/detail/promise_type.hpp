@@ -59,9 +59,9 @@ public:
     scheduler_allocator::deallocate_bytes(ptr);
   }
 
-  static auto initial_suspend() noexcept
+  auto initial_suspend() noexcept
   {
-    return std::suspend_always();
+    return cancellable_start(*this);
   }
 
   static auto final_suspend() noexcept
@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/pause.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly::detail
+{
+
+/**
+ * @brief Unbounded multi-producer / multi-consumer queue built from chained fixed-size segments.
+ *
+ * Intended as the overflow path behind a bounded ring: it never reports "full", so producers
+ * that hit a saturated ring append here instead of spinning.
+ *
+ * - Producers claim a slot with a single fetch_add on the tail segment's write index. Only the
+ *   producer that runs off the end of a segment links (or helps link) the next one.
+ * - Consumers claim slots in order with a CAS on the read index. A consumer that reaches a
+ *   claimed-but-unpublished slot waits briefly and then marks it skipped, so a preempted
+ *   producer never blocks consumers; the producer simply claims another slot.
+ * - Drained segments are retired and recycled through a free list once no thread can still
+ *   reference them, so steady state overflow traffic does not allocate. Every segment counts
+ *   the operations holding it, and a retired segment is recycled as soon as its own count drops
+ *   to zero: a thread stalled inside an operation only holds back the one segment it is on.
+ *
+ * Ordering between items is FIFO per producer only as far as the scheduler needs: no ordering
+ * is guaranteed between this queue and the ring it backs.
+ */
+template <typename T, std::size_t SegmentCapacity>
+  requires(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>)
+class segmented_queue
+{
+  static_assert(SegmentCapacity > 0, "Segment capacity must be > 0");
+
+  static constexpr uint32_t slot_empty   = 0;
+  static constexpr uint32_t slot_ready   = 1;
+  static constexpr uint32_t slot_skipped = 2;
+
+  // Pause iterations a consumer waits on a claimed-but-unpublished slot before skipping it.
+  static constexpr uint32_t publish_spin_count = 64;
+
+  struct slot
+  {
+    std::atomic<uint32_t> state_{slot_empty};
+    T                     value_;
+  };
+
+  struct segment
+  {
+    alignas(cache_line_size) std::atomic<std::size_t> write_{0};
+    alignas(cache_line_size) std::atomic<std::size_t> read_{0};
+    // Operations holding the segment. Never reset: recycling must not erase a late increment.
+    std::atomic<uint32_t> refs_{0};
+    std::atomic<segment*> next_{nullptr};
+    // Link used while the segment sits in the retired or free list.
+    segment* link_ = nullptr;
+    // Link through every segment ever allocated, walked by the destructor.
+    segment*                            owned_next_ = nullptr;
+    std::array<slot, SegmentCapacity> slots_;
+
+    void reset() noexcept
+    {
+      write_.store(0, std::memory_order_relaxed);
+      read_.store(0, std::memory_order_relaxed);
+      next_.store(nullptr, std::memory_order_relaxed);
+      link_ = nullptr;
+      for (auto& s : slots_)
+      {
+        s.state_.store(slot_empty, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  // Holds the segment `head_` or `tail_` points at. The count is raised before the pointer is
+  // checked again, so a segment that was retired in between is never used; one that was recycled
+  // and linked again in between is live, and just as good.
+  class segment_ref
+  {
+  public:
+    explicit segment_ref(std::atomic<segment*>& source) noexcept
+    {
+      acquire(source);
+    }
+
+    ~segment_ref() noexcept
+    {
+      release();
+    }
+
+    segment_ref(segment_ref const&)                    = delete;
+    segment_ref(segment_ref&&)                         = delete;
+    auto operator=(segment_ref const&) -> segment_ref& = delete;
+    auto operator=(segment_ref&&) -> segment_ref&      = delete;
+
+    void reset(std::atomic<segment*>& source) noexcept
+    {
+      release();
+      acquire(source);
+    }
+
+    [[nodiscard]] auto get() const noexcept -> segment*
+    {
+      return seg_;
+    }
+
+    auto operator->() const noexcept -> segment*
+    {
+      return seg_;
+    }
+
+  private:
+    void acquire(std::atomic<segment*>& source) noexcept
+    {
+      seg_ = source.load(std::memory_order_acquire);
+      for (;;)
+      {
+        seg_->refs_.fetch_add(1, std::memory_order_seq_cst);
+        segment* current = source.load(std::memory_order_seq_cst);
+        if (current == seg_)
+        {
+          return;
+        }
+        seg_->refs_.fetch_sub(1, std::memory_order_release);
+        seg_ = current;
+      }
+    }
+
+    void release() noexcept
+    {
+      seg_->refs_.fetch_sub(1, std::memory_order_release);
+    }
+
+    segment* seg_ = nullptr;
+  };
+
+public:
+  segmented_queue() noexcept
+  {
+    segment* first = allocate_segment();
+    head_.store(first, std::memory_order_relaxed);
+    tail_.store(first, std::memory_order_relaxed);
+  }
+
+  ~segmented_queue() noexcept
+  {
+    segment* seg = owned_.load(std::memory_order_acquire);
+    while (seg != nullptr)
+    {
+      segment* next = seg->owned_next_;
+      delete seg;
+      seg = next;
+    }
+  }
+
+  segmented_queue(segmented_queue const&)                    = delete;
+  auto operator=(segmented_queue const&) -> segmented_queue& = delete;
+  segmented_queue(segmented_queue&&)                         = delete;
+  auto operator=(segmented_queue&&) -> segmented_queue&      = delete;
+
+  /**
+   * @brief Append an item. Safe from any thread; never fails.
+   */
+  void push(T const& value) noexcept
+  {
+    // Counted before publication so a consumer never observes an item with a zero count.
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    segment_ref seg(tail_);
+    for (;;)
+    {
+      std::size_t idx = seg->write_.fetch_add(1, std::memory_order_acq_rel);
+      if (idx < SegmentCapacity)
+      {
+        auto& target  = ouly::detail::vector_access(seg->slots_, idx);
+        target.value_ = value;
+
+        uint32_t expected = slot_empty;
+        if (target.state_.compare_exchange_strong(expected, slot_ready, std::memory_order_release,
+                                                  std::memory_order_relaxed))
+        {
+          return;
+        }
+        // A consumer gave up on this slot before we published; claim another one.
+        continue;
+      }
+      advance_tail(seg.get());
+      seg.reset(tail_);
+    }
+  }
+
+  /**
+   * @brief Remove one item. Safe from any thread.
+   */
+  [[nodiscard]] auto pop(T& out) noexcept -> bool
+  {
+    if (empty())
+    {
+      return false;
+    }
+
+    segment_ref seg(head_);
+    for (;;)
+    {
+      std::size_t idx = seg->read_.load(std::memory_order_acquire);
+      if (idx >= SegmentCapacity)
+      {
+        segment* next = seg->next_.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+          return false;
+        }
+        // The tail must never point at a retired segment; help it forward first.
+        segment* expected_tail = seg.get();
+        tail_.compare_exchange_strong(expected_tail, next, std::memory_order_seq_cst, std::memory_order_relaxed);
+        segment* unlinked = seg.get();
+        bool     won      = head_.compare_exchange_strong(unlinked, next, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+        seg.reset(head_);
+        if (won)
+        {
+          retire(unlinked);
+        }
+        continue;
+      }
+
+      if (idx >= seg->write_.load(std::memory_order_acquire))
+      {
+        return false;
+      }
+
+      if (!seg->read_.compare_exchange_weak(idx, idx + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        continue;
+      }
+
+      auto&    source = ouly::detail::vector_access(seg->slots_, idx);
+      uint32_t state  = source.state_.load(std::memory_order_acquire);
+      for (uint32_t spin = 0; state == slot_empty && spin < publish_spin_count; ++spin)
+      {
+        ouly::detail::pause_exec();
+        state = source.state_.load(std::memory_order_acquire);
+      }
+
+      if (state == slot_empty && source.state_.compare_exchange_strong(
+                                  state, slot_skipped, std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        continue;
+      }
+
+      out = source.value_;
+      count_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  /**
+   * @brief Drop every queued item. Safe to call concurrently with push/pop.
+   */
+  void clear() noexcept
+  {
+    T discard{};
+    while (pop(discard))
+    {
+    }
+  }
+
+  /**
+   * @brief Approximate emptiness check; may briefly report items that are still being published.
+   */
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return count_.load(std::memory_order_relaxed) <= 0;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    auto count = count_.load(std::memory_order_relaxed);
+    return count > 0 ? static_cast<std::size_t>(count) : 0;
+  }
+
+  /**
+   * @brief Segments allocated so far, whether linked, retired or free.
+   */
+  [[nodiscard]] auto segment_count() const noexcept -> std::size_t
+  {
+    return segment_count_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void advance_tail(segment* seg) noexcept
+  {
+    segment* next = seg->next_.load(std::memory_order_acquire);
+    if (next == nullptr)
+    {
+      segment* fresh = acquire_segment();
+      if (seg->next_.compare_exchange_strong(next, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        next = fresh;
+      }
+      else
+      {
+        // Never published, so it can go straight back to the free list.
+        push_list(free_, fresh);
+      }
+    }
+    tail_.compare_exchange_strong(seg, next, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  // Called by the pop that unlinked `seg`, once it dropped its own hold on it. Recycles every
+  // retired segment no operation holds any more; the ones still held are looked at again by the
+  // next retirement. No lock is taken, so a stalled thread never holds back reclamation.
+  void retire(segment* seg) noexcept
+  {
+    seg->link_        = retired_.exchange(nullptr, std::memory_order_acquire);
+    segment* held     = nullptr;
+    segment* recycled = nullptr;
+    while (seg != nullptr)
+    {
+      segment* next = seg->link_;
+      // Pairs with the increment in segment_ref: a holder that saw the segment linked is counted
+      // here, since the segment was unlinked before it was retired
+      auto& target = seg->refs_.load(std::memory_order_seq_cst) == 0 ? recycled : held;
+      seg->link_   = target;
+      target       = seg;
+      seg          = next;
+    }
+    push_list(retired_, held);
+    push_list(free_, recycled);
+  }
+
+  auto acquire_segment() noexcept -> segment*
+  {
+    // Pop-all then push back the remainder: only whole-list exchanges are used to take from the
+    // free list, which avoids the ABA hazard of a single-node Treiber pop.
+    segment* seg = free_.exchange(nullptr, std::memory_order_acq_rel);
+    if (seg == nullptr)
+    {
+      return allocate_segment();
+    }
+    push_list(free_, seg->link_);
+    seg->reset();
+    return seg;
+  }
+
+  auto allocate_segment() noexcept -> segment*
+  {
+    auto* seg        = new segment();
+    seg->owned_next_ = owned_.load(std::memory_order_relaxed);
+    segment_count_.fetch_add(1, std::memory_order_relaxed);
+    while (!owned_.compare_exchange_weak(seg->owned_next_, seg, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    return seg;
+  }
+
+  static void push_list(std::atomic<segment*>& list, segment* first) noexcept
+  {
+    if (first == nullptr)
+    {
+      return;
+    }
+    segment* last = first;
+    while (last->link_ != nullptr)
+    {
+      last = last->link_;
+    }
+    last->link_ = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(last->link_, first, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  alignas(cache_line_size) std::atomic<segment*> head_{nullptr};
+  alignas(cache_line_size) std::atomic<segment*> tail_{nullptr};
+  alignas(cache_line_size) std::atomic<int64_t> count_{0};
+  alignas(cache_line_size) std::atomic<segment*> retired_{nullptr};
+  std::atomic<segment*>    free_{nullptr};
+  std::atomic<segment*>    owned_{nullptr};
+  std::atomic<std::size_t> segment_count_{0};
+};
+
+} // namespace ouly::detail
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
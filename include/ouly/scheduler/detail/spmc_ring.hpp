@@ -8,6 +8,7 @@
 #include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <span>
 #include <type_traits>
 
 #ifdef _MSC_VER
@@ -60,6 +61,27 @@ public:
     return true;
   }
 
+  /**
+   * Push as many of `items` as fit, publishing them with a single store to `bottom`. Only from the
+   * producer thread. Returns the number of items pushed.
+   */
+  auto push_back_bulk(std::span<T const> items) noexcept -> size_t
+  {
+    const size_t b     = bottom_.load(std::memory_order_relaxed);
+    const size_t t     = top_.load(std::memory_order_acquire);
+    const size_t count = std::min(items.size(), Capacity - (b - t));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      ouly::detail::vector_access(buffer_, (b + i) & module_mask) = ouly::detail::vector_access(items, i);
+    }
+    if (count > 0)
+    {
+      bottom_.store(b + count, std::memory_order_release);
+    }
+    return count;
+  }
+
   /** Pop item only from a single thread, same thread as `push_back` */
   auto pop_back(T& out) noexcept -> bool // owner only
   {
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/scheduler_stats.hpp"
+#include "ouly/utility/config.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly::detail
+{
+
+enum class worker_counter : uint8_t
+{
+  tasks_executed,
+  local_pops,
+  mailbox_pops,
+  steals,
+  failed_steals,
+  parks,
+  unparks,
+  parked_ns,
+  count
+};
+
+/**
+ * @brief Per-worker telemetry block, empty unless OULY_SCHEDULER_STATS is defined.
+ *
+ * Only the thread running as the owning worker writes, so counters are bumped with a relaxed
+ * load/store pair instead of a locked RMW. The block sits on its own cache line(s), so readers
+ * (snapshot_stats) never share a line with the worker's hot scheduling state.
+ */
+template <bool Enabled>
+class basic_worker_counters
+{
+  static constexpr auto counter_count = static_cast<std::size_t>(worker_counter::count);
+
+  struct disabled_storage
+  {};
+
+  using counter_array = std::array<std::atomic<uint64_t>, counter_count>;
+  using storage       = std::conditional_t<Enabled, cache_optimized_data<counter_array>, disabled_storage>;
+
+public:
+  void add([[maybe_unused]] worker_counter counter, [[maybe_unused]] uint64_t value = 1) noexcept
+  {
+    if constexpr (Enabled)
+    {
+      auto& slot = ouly::detail::vector_access(values_.get(), static_cast<std::size_t>(counter));
+      slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] auto read() const noexcept -> ouly::worker_stats
+  {
+    ouly::worker_stats stats;
+    if constexpr (Enabled)
+    {
+      stats.tasks_executed_ = get(worker_counter::tasks_executed);
+      stats.local_pops_     = get(worker_counter::local_pops);
+      stats.mailbox_pops_   = get(worker_counter::mailbox_pops);
+      stats.steals_         = get(worker_counter::steals);
+      stats.failed_steals_  = get(worker_counter::failed_steals);
+      stats.parks_          = get(worker_counter::parks);
+      stats.unparks_        = get(worker_counter::unparks);
+      stats.parked_ns_      = get(worker_counter::parked_ns);
+    }
+    return stats;
+  }
+
+private:
+  [[nodiscard]] auto get(worker_counter counter) const noexcept -> uint64_t
+  {
+    return ouly::detail::vector_access(values_.get(), static_cast<std::size_t>(counter))
+     .load(std::memory_order_relaxed);
+  }
+
+  OULY_POTENTIAL_EMPTY_MEMBER storage values_;
+};
+
+/**
+ * @brief Per-workgroup telemetry block, empty unless OULY_SCHEDULER_STATS is defined.
+ *
+ * Written by every producer, but the high-water mark only takes a CAS when it actually rises,
+ * which stops happening once the group reaches its steady-state depth.
+ */
+template <bool Enabled>
+class basic_workgroup_counters
+{
+  struct disabled_storage
+  {};
+
+  using storage = std::conditional_t<Enabled, cache_aligned_atomic<int64_t>, disabled_storage>;
+
+public:
+  void record_depth([[maybe_unused]] int64_t depth) noexcept
+  {
+    if constexpr (Enabled)
+    {
+      auto& high = high_water_.get();
+      auto  seen = high.load(std::memory_order_relaxed);
+      while (depth > seen && !high.compare_exchange_weak(seen, depth, std::memory_order_relaxed))
+      {
+      }
+    }
+  }
+
+  [[nodiscard]] auto read() const noexcept -> ouly::workgroup_stats
+  {
+    ouly::workgroup_stats stats;
+    if constexpr (Enabled)
+    {
+      stats.queued_high_water_ = static_cast<uint64_t>(high_water_.get().load(std::memory_order_relaxed));
+    }
+    return stats;
+  }
+
+private:
+  OULY_POTENTIAL_EMPTY_MEMBER storage high_water_;
+};
+
+using worker_counters    = basic_worker_counters<ouly::scheduler_stats_enabled>;
+using workgroup_counters = basic_workgroup_counters<ouly::scheduler_stats_enabled>;
+
+/**
+ * @brief Counts one park of the owning worker and the time it spent blocked. Reads no clock when
+ * statistics are compiled out.
+ */
+class park_scope
+{
+  using clock = std::chrono::steady_clock;
+
+public:
+  explicit park_scope(worker_counters& counters) noexcept : counters_(counters)
+  {
+    if constexpr (ouly::scheduler_stats_enabled)
+    {
+      counters_.add(worker_counter::parks);
+      start_ = clock::now();
+    }
+  }
+
+  ~park_scope() noexcept
+  {
+    if constexpr (ouly::scheduler_stats_enabled)
+    {
+      auto parked = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_);
+      counters_.add(worker_counter::unparks);
+      counters_.add(worker_counter::parked_ns, static_cast<uint64_t>(parked.count()));
+    }
+  }
+
+  park_scope(park_scope const&)                    = delete;
+  park_scope(park_scope&&)                         = delete;
+  auto operator=(park_scope const&) -> park_scope& = delete;
+  auto operator=(park_scope&&) -> park_scope&      = delete;
+
+private:
+  worker_counters&  counters_;
+  clock::time_point start_;
+};
+
+} // namespace ouly::detail
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
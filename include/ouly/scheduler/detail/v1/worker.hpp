@@ -7,12 +7,18 @@
 #include "ouly/scheduler/co_task.hpp"
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
 #include "ouly/scheduler/detail/mpmc_ring.hpp"
+#include "ouly/scheduler/detail/stats_counters.hpp"
 #include "ouly/scheduler/detail/v1/workgroup.hpp"
 #include "ouly/scheduler/spin_lock.hpp"
 #include "ouly/scheduler/v1/task_context.hpp"
 #include <array>
 #include <cstdint>
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
 namespace ouly::detail::v1
 {
 static constexpr uint32_t max_worker_groups = 32;
@@ -56,8 +62,15 @@ struct worker
 
   ouly::v1::task_context* current_context_ = nullptr;
 
+  // Telemetry, compiled out unless OULY_SCHEDULER_STATS is defined
+  OULY_POTENTIAL_EMPTY_MEMBER ouly::detail::worker_counters stats_;
+
   // No local queues needed - work is organized per workgroup per worker
   // This eliminates the complexity of multiple queue types and work validation
 };
 
 } // namespace ouly::detail::v1
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
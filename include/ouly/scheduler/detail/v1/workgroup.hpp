@@ -5,6 +5,7 @@
 #include "ouly/scheduler/co_task.hpp"
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
 #include "ouly/scheduler/detail/mpmc_ring.hpp"
+#include "ouly/scheduler/detail/stats_counters.hpp"
 #include "ouly/scheduler/spin_lock.hpp"
 #include "ouly/scheduler/v1/task_context.hpp"
 #include "ouly/utility/user_config.hpp"
@@ -49,6 +50,9 @@ struct workgroup
   // Cold data: Configuration set once during initialization
   uint32_t priority_ = 0;
 
+  // Telemetry, compiled out unless OULY_SCHEDULER_STATS is defined
+  OULY_POTENTIAL_EMPTY_MEMBER ouly::detail::workgroup_counters stats_;
+
   auto create_group(uint32_t start, uint32_t count, uint32_t priority) noexcept -> uint32_t
   {
     thread_count_     = count;
@@ -111,7 +115,7 @@ struct workgroup
     {
       // Publish the increase in available work with release semantics so
       // threads performing acquire loads observe the update reliably.
-      tally_.fetch_add(1, std::memory_order_release);
+      stats_.record_depth(tally_.fetch_add(1, std::memory_order_release) + 1);
       return true;
     }
 
@@ -2,9 +2,15 @@
 
 #pragma once
 
+#include "ouly/scheduler/detail/stats_counters.hpp"
 #include "ouly/scheduler/v2/task_context.hpp"
 #include <cstdint>
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
 namespace ouly::detail::v2
 {
 
@@ -45,6 +51,13 @@ private:
   ouly::v2::task_context current_context_;
   // Per-worker adaptive backoff counter for busy-wait
   uint32_t busy_backoff_ = 0;
+
+  // Telemetry, compiled out unless OULY_SCHEDULER_STATS is defined
+  OULY_POTENTIAL_EMPTY_MEMBER ouly::detail::worker_counters stats_;
 };
 
 } // namespace ouly::detail::v2
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -5,6 +5,7 @@
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
 #include "ouly/scheduler/detail/mpmc_ring.hpp"
 #include "ouly/scheduler/detail/spmc_ring.hpp"
+#include "ouly/scheduler/detail/stats_counters.hpp"
 #include "ouly/scheduler/v2/task_context.hpp"
 #include "ouly/utility/user_config.hpp"
 #include <atomic>
@@ -218,7 +219,8 @@ public:
    */
   void advertise_work_available() noexcept
   {
-    has_work_.fetch_add(1, std::memory_order_seq_cst);
+    auto depth = has_work_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    stats_.record_depth(static_cast<int64_t>(depth));
   }
 
   /**
@@ -364,6 +366,9 @@ private:
   alignas(cache_line_size) std::shared_mutex slot_mutex_;
   alignas(cache_line_size) std::unique_ptr<uint64_t[]> bitfield_; // for >64 threads
   uint32_t bitfield_words_{0};
+
+  // Telemetry, compiled out unless OULY_SCHEDULER_STATS is defined
+  OULY_POTENTIAL_EMPTY_MEMBER ouly::detail::workgroup_counters stats_;
 };
 
 } // namespace ouly::detail::v2
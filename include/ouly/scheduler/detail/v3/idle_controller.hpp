@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/utility/user_config.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace ouly::detail::v3
+{
+
+/**
+ * @brief Per-worker adaptive spin-then-park controller.
+ *
+ * Every idle period of a worker (from failing to find work to finding it again, whether by
+ * spinning or after parking) is fed into an exponentially weighted moving average of the idle gap.
+ * The next spin window is derived from that prediction:
+ * - predicted gap above the spin limit: park at once. The gap between frames of a 60/120 Hz loop
+ *   lands here, so workers stop burning CPU between frames.
+ * - otherwise spin for twice the predicted gap, capped at the spin limit. Gaps inside a frame's
+ *   bursts land here, so workers pick up the next job without a park/unpark round trip.
+ * Parked periods keep feeding the average, so a worker that starts parking during a burst
+ * learns the short gaps again and resumes spinning.
+ *
+ * Only the owning worker updates the controller; counters are single-writer relaxed atomics so
+ * they can be sampled from other threads.
+ */
+class idle_controller
+{
+public:
+  static constexpr uint32_t ewma_shift      = 3;      // Weight of a new sample: 1/8
+  static constexpr int64_t  initial_gap_ns  = 10'000; // Prediction before the first idle period
+  static constexpr int64_t  min_spin_ns     = 500;    // Smallest window worth spinning for
+  static constexpr uint32_t spin_multiplier = 2;
+
+  /**
+   * @brief Spin window for the next idle period in nanoseconds, 0 to park immediately.
+   */
+  [[nodiscard]] auto spin_budget(int64_t max_spin_ns) const noexcept -> int64_t
+  {
+    auto predicted = predicted_gap_.load(std::memory_order_relaxed);
+    if (predicted > max_spin_ns)
+    {
+      return 0;
+    }
+    return std::clamp<int64_t>(predicted * spin_multiplier, min_spin_ns, max_spin_ns);
+  }
+
+  /**
+   * @brief Record a finished idle period.
+   * @param gap_ns Time from running out of work to finding work again.
+   * @param spun   Nanoseconds spent spinning in this period.
+   * @param parked Whether the worker had to park.
+   */
+  void record(int64_t gap_ns, int64_t spun, bool parked) noexcept
+  {
+    auto predicted = predicted_gap_.load(std::memory_order_relaxed);
+    predicted += (std::max<int64_t>(gap_ns, 0) - predicted) / (int64_t{1} << ewma_shift);
+    predicted_gap_.store(predicted, std::memory_order_relaxed);
+
+    if (!parked)
+    {
+      bump(spin_hits_);
+    }
+    else if (spun > 0)
+    {
+      bump(spin_misses_);
+    }
+    else
+    {
+      bump(direct_parks_);
+    }
+    spin_ns_.store(spin_ns_.load(std::memory_order_relaxed) + static_cast<uint64_t>(std::max<int64_t>(spun, 0)),
+                   std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_predicted_gap_ns() const noexcept -> int64_t
+  {
+    return predicted_gap_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_spin_hits() const noexcept -> uint64_t
+  {
+    return spin_hits_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_spin_misses() const noexcept -> uint64_t
+  {
+    return spin_misses_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_direct_parks() const noexcept -> uint64_t
+  {
+    return direct_parks_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_spin_ns() const noexcept -> uint64_t
+  {
+    return spin_ns_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static void bump(std::atomic<uint64_t>& counter) noexcept
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  std::atomic<int64_t>  predicted_gap_{initial_gap_ns};
+  std::atomic<uint64_t> spin_hits_{0};
+  std::atomic<uint64_t> spin_misses_{0};
+  std::atomic<uint64_t> direct_parks_{0};
+  std::atomic<uint64_t> spin_ns_{0};
+};
+
+} // namespace ouly::detail::v3
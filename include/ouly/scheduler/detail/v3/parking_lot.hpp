@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly::detail::v3
+{
+
+/**
+ * @brief Per-worker futex parking with targeted wakeups.
+ *
+ * Every worker sleeps on its own epoch word with std::atomic::wait, and advertises itself in an
+ * idle bitmask (one bit per worker). Wakers scan the bits of the workers they want, e.g. the
+ * members of one workgroup, claim a bit with an atomic AND and bump that worker's epoch. There is
+ * no shared lock: submitters touch one mask word and, only when a sleeper exists, one epoch.
+ *
+ * Threads blocked in wait_for_tasks() also set a bit in the waiter mask, so the final task
+ * completion wakes exactly those threads.
+ *
+ * Lost-wakeup freedom follows the usual Dekker pattern. A parking worker reads its epoch, sets its
+ * bit(s), issues a seq_cst fence and only then re-checks for work. A producer publishes work with a
+ * seq_cst RMW (the workgroup's queued count, or pending_ for waiters) before scanning the masks
+ * with seq_cst loads. Either the producer sees the bit and bumps the epoch (the wait returns at
+ * once if the epoch moved after it was read), or the worker's re-check sees the work.
+ */
+class parking_lot
+{
+  static constexpr uint32_t word_bits = 64;
+
+public:
+  void reset(uint32_t worker_count)
+  {
+    worker_count_ = worker_count;
+    word_count_   = (worker_count + word_bits - 1) / word_bits;
+    epochs_       = std::make_unique<cache_aligned_atomic<uint32_t>[]>(worker_count);
+    idle_         = std::make_unique<std::atomic<uint64_t>[]>(word_count_);
+    waiters_      = std::make_unique<std::atomic<uint64_t>[]>(word_count_);
+  }
+
+  /**
+   * @brief Advertise `worker` as parked. Returns the epoch to pass to park(). The caller must
+   * re-check its wake condition afterwards and call cancel() instead of park() if it holds.
+   */
+  [[nodiscard]] auto prepare(uint32_t worker, bool waiter) noexcept -> uint32_t
+  {
+    auto token = ouly::detail::vector_access(epochs_, worker).get().load(std::memory_order_acquire);
+    ouly::detail::vector_access(idle_, worker / word_bits).fetch_or(bit_of(worker), std::memory_order_seq_cst);
+    if (waiter)
+    {
+      ouly::detail::vector_access(waiters_, worker / word_bits).fetch_or(bit_of(worker), std::memory_order_seq_cst);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return token;
+  }
+
+  /**
+   * @brief Block until a waker bumps the epoch past `token`.
+   */
+  void park(uint32_t worker, uint32_t token) noexcept
+  {
+    ouly::detail::vector_access(epochs_, worker).get().wait(token, std::memory_order_acquire);
+    cancel(worker);
+  }
+
+  /**
+   * @brief Withdraw the bits published by prepare().
+   */
+  void cancel(uint32_t worker) noexcept
+  {
+    auto const keep = ~bit_of(worker);
+    ouly::detail::vector_access(idle_, worker / word_bits).fetch_and(keep, std::memory_order_relaxed);
+    ouly::detail::vector_access(waiters_, worker / word_bits).fetch_and(keep, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Wake up to `max_wakes` parked workers with index in [first, first + count).
+   * @return Number of workers woken.
+   */
+  auto wake_range(uint32_t first, uint32_t count, uint32_t max_wakes) noexcept -> uint32_t
+  {
+    uint32_t woken = 0;
+    uint32_t last  = std::min(first + count, worker_count_);
+    for (uint32_t word = first / word_bits; first < last && word <= (last - 1) / word_bits && woken < max_wakes;
+         ++word)
+    {
+      auto& mask = ouly::detail::vector_access(idle_, word);
+      auto  bits = mask.load(std::memory_order_seq_cst) & range_bits(word, first, last);
+      while (bits != 0 && woken < max_wakes)
+      {
+        auto index = static_cast<uint32_t>(std::countr_zero(bits));
+        auto bit   = uint64_t{1} << index;
+        bits &= bits - 1;
+        // Claim the sleeper; a concurrent waker or the worker itself may have cleared it first.
+        if ((mask.fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0)
+        {
+          wake((word * word_bits) + index);
+          ++woken;
+        }
+      }
+    }
+    return woken;
+  }
+
+  /**
+   * @brief Wake every thread blocked in wait_for_tasks().
+   */
+  void wake_waiters() noexcept
+  {
+    for (uint32_t word = 0; word < word_count_; ++word)
+    {
+      auto& mask = ouly::detail::vector_access(waiters_, word);
+      if (mask.load(std::memory_order_seq_cst) == 0)
+      {
+        continue;
+      }
+      auto bits = mask.exchange(0, std::memory_order_acq_rel);
+      for (; bits != 0; bits &= bits - 1)
+      {
+        wake((word * word_bits) + static_cast<uint32_t>(std::countr_zero(bits)));
+      }
+    }
+  }
+
+  /**
+   * @brief Wake every worker, parked or about to park (shutdown).
+   */
+  void wake_all() noexcept
+  {
+    for (uint32_t worker = 0; worker < worker_count_; ++worker)
+    {
+      wake(worker);
+    }
+  }
+
+  /**
+   * @brief Number of workers currently advertised as parked.
+   */
+  [[nodiscard]] auto get_idle_count() const noexcept -> uint32_t
+  {
+    uint32_t count = 0;
+    for (uint32_t word = 0; word < word_count_; ++word)
+    {
+      count += static_cast<uint32_t>(
+       std::popcount(ouly::detail::vector_access(idle_, word).load(std::memory_order_relaxed)));
+    }
+    return count;
+  }
+
+private:
+  static constexpr auto bit_of(uint32_t worker) noexcept -> uint64_t
+  {
+    return uint64_t{1} << (worker % word_bits);
+  }
+
+  static constexpr auto range_bits(uint32_t word, uint32_t first, uint32_t last) noexcept -> uint64_t
+  {
+    uint32_t base = word * word_bits;
+    uint32_t lo   = first > base ? first - base : 0;
+    uint32_t hi   = std::min(last - base, word_bits);
+    uint64_t high = hi == word_bits ? ~uint64_t{0} : (uint64_t{1} << hi) - 1;
+    return high & ~((uint64_t{1} << lo) - 1);
+  }
+
+  void wake(uint32_t worker) noexcept
+  {
+    auto& epoch = ouly::detail::vector_access(epochs_, worker).get();
+    epoch.fetch_add(1, std::memory_order_release);
+    epoch.notify_one();
+  }
+
+  std::unique_ptr<cache_aligned_atomic<uint32_t>[]> epochs_;
+  std::unique_ptr<std::atomic<uint64_t>[]>          idle_;
+  std::unique_ptr<std::atomic<uint64_t>[]>          waiters_;
+  uint32_t                                          worker_count_ = 0;
+  uint32_t                                          word_count_   = 0;
+};
+
+} // namespace ouly::detail::v3
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
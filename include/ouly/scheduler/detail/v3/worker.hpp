@@ -1,10 +1,22 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "ouly/scheduler/detail/stats_counters.hpp"
+#include "ouly/scheduler/detail/v3/idle_controller.hpp"
 #include "ouly/scheduler/detail/v3/workgroup.hpp"
+#include "ouly/scheduler/topology.hpp"
 #include "ouly/scheduler/v3/task_context.hpp"
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
 
 namespace ouly::detail::v3
 {
@@ -28,14 +40,110 @@ public:
     return context_.get_worker();
   }
 
+  /**
+   * @brief CPU this worker is placed on. Only meaningful when the scheduler has a topology.
+   */
+  [[nodiscard]] auto get_cpu() const noexcept -> cpu_info const&
+  {
+    return cpu_;
+  }
+
+  /**
+   * @brief Steal victims (offsets within `group`) in the order this worker tries them: same LLC
+   * first, then same NUMA node, then remote. Empty without a topology or if this worker is not a
+   * member of `group`, in which case victims are probed from a randomized start.
+   */
+  [[nodiscard]] auto get_victim_order(workgroup_id group) const noexcept -> std::span<uint32_t const>
+  {
+    if (!group || group.get_index() >= max_workgroup)
+    {
+      return {};
+    }
+    auto const& range = ouly::detail::vector_access(victim_ranges_, group.get_index());
+    return std::span<uint32_t const>(victims_).subspan(range.first, range.second);
+  }
+
+  /**
+   * @brief Steal probes this worker made (one per victim deque tried).
+   */
+  [[nodiscard]] auto get_steal_attempts() const noexcept -> uint64_t
+  {
+    return steal_attempts_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Steal probes that returned an item.
+   */
+  [[nodiscard]] auto get_steal_successes() const noexcept -> uint64_t
+  {
+    return steal_successes_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Adaptive idle state of this worker: predicted idle gap and spin/park counters.
+   */
+  [[nodiscard]] auto get_idle_controller() const noexcept -> idle_controller const&
+  {
+    return idle_;
+  }
+
+  /**
+   * @brief Telemetry counters of this worker. Steal counts are always collected; the rest read
+   * zero unless OULY_SCHEDULER_STATS is defined.
+   */
+  [[nodiscard]] auto get_stats() const noexcept -> ouly::worker_stats
+  {
+    auto stats           = stats_.read();
+    auto attempts        = get_steal_attempts();
+    stats.steals_        = get_steal_successes();
+    stats.failed_steals_ = attempts > stats.steals_ ? attempts - stats.steals_ : 0;
+    return stats;
+  }
+
 private:
   friend class ouly::v3::scheduler;
 
+  // Single-writer counters: only the thread running as this worker bumps them, so a plain
+  // load/store pair is enough and keeps lock-prefixed RMWs off the steal path.
+  void count_steal_attempt() noexcept
+  {
+    steal_attempts_.store(steal_attempts_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void count_steal_success() noexcept
+  {
+    steal_successes_.store(steal_successes_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
   ouly::v3::task_context context_;
 
   // Indices of workgroups this worker belongs to, sorted by descending priority.
   std::array<uint8_t, max_workgroup> group_order_{};
   uint32_t                           group_count_ = 0;
+
+  cpu_info cpu_;
+  // Victim offsets of every member group, packed; victim_ranges_[group] = (first, count).
+  std::vector<uint32_t>                                    victims_;
+  std::array<std::pair<uint32_t, uint32_t>, max_workgroup> victim_ranges_{};
+
+  // Offset of the last successfully robbed member, per group (steal_policy::last_victim_first).
+  std::array<uint32_t, max_workgroup> last_victim_{};
+
+  // Dequeue attempts, drives lane aging (scheduler::set_lane_aging_period()).
+  uint32_t lane_ticks_ = 0;
+
+  // Spin-then-park decisions of run_worker (scheduler::set_idle_policy()).
+  idle_controller idle_;
+
+  alignas(cache_line_size) std::atomic<uint64_t> steal_attempts_{0};
+  std::atomic<uint64_t>                          steal_successes_{0};
+
+  // Telemetry, compiled out unless OULY_SCHEDULER_STATS is defined
+  OULY_POTENTIAL_EMPTY_MEMBER ouly::detail::worker_counters stats_;
 };
 
 } // namespace ouly::detail::v3
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -3,12 +3,16 @@
 
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
 #include "ouly/scheduler/detail/mpmc_ring.hpp"
+#include "ouly/scheduler/detail/segmented_queue.hpp"
 #include "ouly/scheduler/detail/spmc_ring.hpp"
+#include "ouly/scheduler/detail/stats_counters.hpp"
 #include "ouly/scheduler/v3/task_context.hpp"
 #include "ouly/utility/user_config.hpp"
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <span>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -19,6 +23,10 @@ namespace ouly::detail::v3
 {
 static constexpr uint32_t max_workgroup    = 32;   // Maximum number of workgroups supported
 static constexpr uint32_t mailbox_capacity = 1024; // Capacity of the cross-thread mailbox
+static constexpr uint32_t overflow_segment = 128;  // Items per segment of the mailbox overflow queue
+static constexpr uint32_t no_member        = ~0U;  // push_batch() offset for non-member producers
+static constexpr uint32_t lane_count       = 3;    // Priority lanes per workgroup, see ouly::v3::task_lane
+static constexpr uint32_t default_lane     = 1;    // Lane of plain submit() calls
 
 using work_item = ouly::v3::task_delegate;
 
@@ -35,16 +43,25 @@ struct workgroup_desc
 /**
  * @brief v3 workgroup: fixed worker membership, per-member Chase-Lev deque + MPMC mailbox.
  *
- * Key difference from v2: the `queued_` counter tracks items *currently sitting in queues*.
- * It is incremented when an item is pushed and decremented when an item is successfully
- * dequeued (before execution). This makes `has_queued()` an accurate signal that idle
- * workers can use to decide to park, instead of spinning while unrelated tasks execute.
+ * The mailbox is a fixed ring; when it is full, submissions spill into an unbounded segmented
+ * overflow queue, so producers (IO/network threads in particular) never spin on a saturated
+ * group. Members drain the overflow right after the mailbox.
+ *
+ * Every queue exists once per priority lane (lane 0 most urgent). Lanes are independent; the
+ * scheduler decides which lane a worker serves first.
+ *
+ * Key difference from v2: the per-lane `queued_` counters track items *currently sitting in
+ * queues*. A counter is incremented when an item is pushed and decremented when an item is
+ * successfully dequeued (before execution). This makes `has_queued()` an accurate signal that idle
+ * workers can use to decide to park, instead of spinning while unrelated tasks execute, and lets
+ * workers skip empty lanes without probing their queues.
  */
 class workgroup
 {
 public:
-  using queue_type   = ouly::detail::spmc_ring<work_item>;
-  using mailbox_type = ouly::detail::mpmc_ring<work_item, mailbox_capacity>;
+  using queue_type    = ouly::detail::spmc_ring<work_item>;
+  using mailbox_type  = ouly::detail::mpmc_ring<work_item, mailbox_capacity>;
+  using overflow_type = ouly::detail::segmented_queue<work_item, overflow_segment>;
 
   workgroup() noexcept  = default;
   ~workgroup() noexcept = default;
@@ -59,26 +76,37 @@ public:
     start_        = start;
     thread_count_ = thread_count;
     priority_     = priority;
-    queues_       = std::make_unique<queue_type[]>(thread_count);
-    mailbox_      = std::make_unique<mailbox_type>();
-    queued_.store(0, std::memory_order_relaxed);
+    for (auto& lane : lanes_)
+    {
+      lane.queues_   = std::make_unique<queue_type[]>(thread_count);
+      lane.mailbox_  = std::make_unique<mailbox_type>();
+      lane.overflow_ = std::make_unique<overflow_type>();
+      lane.queued_.get().store(0, std::memory_order_relaxed);
+    }
   }
 
   void clear() noexcept
   {
     // Drop queued items; in-flight accounting is owned by the scheduler.
-    if (queues_)
+    for (auto& lane : lanes_)
     {
-      for (uint32_t i = 0; i < thread_count_; ++i)
+      if (lane.queues_)
       {
-        ouly::detail::vector_access(queues_, i).clear();
+        for (uint32_t i = 0; i < thread_count_; ++i)
+        {
+          ouly::detail::vector_access(lane.queues_, i).clear();
+        }
       }
+      if (lane.mailbox_)
+      {
+        lane.mailbox_->clear();
+      }
+      if (lane.overflow_)
+      {
+        lane.overflow_->clear();
+      }
+      lane.queued_.get().store(0, std::memory_order_relaxed);
     }
-    if (mailbox_)
-    {
-      mailbox_->clear();
-    }
-    queued_.store(0, std::memory_order_relaxed);
   }
 
   [[nodiscard]] auto contains(uint32_t worker_index) const noexcept -> bool
@@ -95,14 +123,13 @@ public:
    * @brief Push to the calling member worker's own deque. Single producer per deque:
    * only the worker owning `offset` may call this.
    */
-  [[nodiscard]] auto push_local(uint32_t offset, work_item const& item) noexcept -> bool
+  [[nodiscard]] auto push_local(uint32_t offset, work_item const& item, uint32_t lane = default_lane) noexcept
+   -> bool
   {
     OULY_ASSERT(offset < thread_count_);
-    if (ouly::detail::vector_access(queues_, offset).push_back(item))
+    if (ouly::detail::vector_access(get_lane(lane).queues_, offset).push_back(item))
     {
-      // seq_cst so the producer's later wake-epoch read/modify observes this in a total
-      // order with a parking worker's recheck of `queued_` (lost-wakeup prevention).
-      queued_.fetch_add(1, std::memory_order_seq_cst);
+      enqueue(lane, 1);
       return true;
     }
     return false;
@@ -111,73 +138,133 @@ public:
   /**
    * @brief Push from any thread (cross-group or external submission).
    */
-  [[nodiscard]] auto push_mailbox(work_item const& item) noexcept -> bool
+  [[nodiscard]] auto push_mailbox(work_item const& item, uint32_t lane = default_lane) noexcept -> bool
   {
-    if (mailbox_->emplace(item))
+    if (get_lane(lane).mailbox_->emplace(item))
     {
-      queued_.fetch_add(1, std::memory_order_seq_cst);
+      enqueue(lane, 1);
       return true;
     }
     return false;
   }
 
   /**
-   * @brief Take one item as the member worker at `offset`: own deque first, then the
-   * mailbox, then steal from sibling deques starting at a randomized position.
+   * @brief Push from any thread once the mailbox is full. Never fails: the overflow queue grows
+   * by chaining recycled segments.
    */
-  [[nodiscard]] auto take(work_item& out, uint32_t offset, uint32_t steal_seed) noexcept -> bool
+  void push_overflow(work_item const& item, uint32_t lane = default_lane) noexcept
   {
-    if (ouly::detail::vector_access(queues_, offset).pop_back(out))
+    get_lane(lane).overflow_->push(item);
+    enqueue(lane, 1);
+  }
+
+  /**
+   * @brief Push a batch and advertise it with a single `queued_` update. Items fill the member
+   * deque at `offset` first (only its owner may pass an offset other than no_member), then the
+   * mailbox, then the overflow queue, so the call never fails.
+   */
+  void push_batch(std::span<work_item const> items, uint32_t offset = no_member,
+                  uint32_t lane = default_lane) noexcept
+  {
+    auto&       target = get_lane(lane);
+    std::size_t pushed = 0;
+    if (offset != no_member)
+    {
+      OULY_ASSERT(offset < thread_count_);
+      pushed = ouly::detail::vector_access(target.queues_, offset).push_back_bulk(items);
+    }
+    for (; pushed < items.size() && target.mailbox_->emplace(ouly::detail::vector_access(items, pushed)); ++pushed)
     {
-      sink_one();
-      return true;
     }
-    if (mailbox_->pop(out))
+    for (; pushed < items.size(); ++pushed)
     {
-      sink_one();
+      target.overflow_->push(ouly::detail::vector_access(items, pushed));
+    }
+    // Consumers may already have taken some of the items and driven `queued_` below zero; this
+    // brings it back to the true depth, and has_queued() only reports positive depths.
+    enqueue(lane, static_cast<int64_t>(items.size()));
+  }
+
+  /**
+   * @brief Pop the newest item of the member deque at `offset`. Only the worker owning `offset`
+   * may call this.
+   */
+  [[nodiscard]] auto pop_local(work_item& out, uint32_t offset, uint32_t lane = default_lane) noexcept -> bool
+  {
+    if (ouly::detail::vector_access(get_lane(lane).queues_, offset).pop_back(out))
+    {
+      sink_one(lane);
       return true;
     }
-    for (uint32_t i = 0; i < thread_count_; ++i)
+    return false;
+  }
+
+  /**
+   * @brief Take one item from the mailbox, then its overflow. Safe from any thread.
+   */
+  [[nodiscard]] auto pop_mailbox(work_item& out, uint32_t lane = default_lane) noexcept -> bool
+  {
+    auto& source = get_lane(lane);
+    if (source.mailbox_->pop(out) || source.overflow_->pop(out))
     {
-      uint32_t victim = (steal_seed + i) % thread_count_;
-      if (victim == offset)
-      {
-        continue;
-      }
-      if (ouly::detail::vector_access(queues_, victim).steal(out))
-      {
-        sink_one();
-        return true;
-      }
+      sink_one(lane);
+      return true;
     }
     return false;
   }
 
   /**
-   * @brief Take one item using only multi-consumer-safe operations (mailbox pop and
-   * steals). Safe to call from any thread, unlike take().
+   * @brief Steal one item from the member deque at `victim`. Safe from any thread. Victim
+   * selection is the scheduler's steal policy.
    */
-  [[nodiscard]] auto take_any(work_item& out) noexcept -> bool
+  [[nodiscard]] auto steal_from(work_item& out, uint32_t victim, uint32_t lane = default_lane) noexcept -> bool
   {
-    if (mailbox_->pop(out))
+    if (ouly::detail::vector_access(get_lane(lane).queues_, victim).steal(out))
     {
-      sink_one();
+      sink_one(lane);
       return true;
     }
-    for (uint32_t i = 0; i < thread_count_; ++i)
+    return false;
+  }
+
+  /**
+   * @brief Take one item using only multi-consumer-safe operations (mailbox pops and
+   * steals), most urgent lane first. Safe to call from any thread, unlike pop_local().
+   */
+  [[nodiscard]] auto take_any(work_item& out) noexcept -> bool
+  {
+    for (uint32_t lane = 0; lane < lane_count; ++lane)
     {
-      if (ouly::detail::vector_access(queues_, i).steal(out))
+      if (pop_mailbox(out, lane))
       {
-        sink_one();
         return true;
       }
+      for (uint32_t i = 0; i < thread_count_; ++i)
+      {
+        if (steal_from(out, i, lane))
+        {
+          return true;
+        }
+      }
     }
     return false;
   }
 
   [[nodiscard]] auto has_queued() const noexcept -> bool
   {
-    return queued_.load(std::memory_order_acquire) > 0;
+    for (auto const& lane : lanes_)
+    {
+      if (lane.queued_.get().load(std::memory_order_acquire) > 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  [[nodiscard]] auto has_queued(uint32_t lane) const noexcept -> bool
+  {
+    return ouly::detail::vector_access(lanes_, lane).queued_.get().load(std::memory_order_acquire) > 0;
   }
 
   [[nodiscard]] auto get_start_thread_idx() const noexcept -> uint32_t
@@ -195,20 +282,55 @@ public:
     return priority_;
   }
 
+  [[nodiscard]] auto get_stats() const noexcept -> ouly::workgroup_stats
+  {
+    return stats_.read();
+  }
+
 private:
-  void sink_one() noexcept
+  struct lane_queues
+  {
+    ouly::detail::cache_aligned_atomic<int64_t> queued_{int64_t{0}};
+
+    std::unique_ptr<queue_type[]>  queues_;
+    std::unique_ptr<mailbox_type>  mailbox_;
+    std::unique_ptr<overflow_type> overflow_;
+  };
+
+  [[nodiscard]] auto get_lane(uint32_t lane) noexcept -> lane_queues&
+  {
+    OULY_ASSERT(lane < lane_count);
+    return ouly::detail::vector_access(lanes_, lane);
+  }
+
+  void enqueue(uint32_t lane, int64_t count) noexcept
   {
-    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    // seq_cst so the producer's later wake-epoch read/modify observes this in a total
+    // order with a parking worker's recheck of `queued_` (lost-wakeup prevention).
+    auto depth = get_lane(lane).queued_.get().fetch_add(count, std::memory_order_seq_cst) + count;
+    if constexpr (ouly::scheduler_stats_enabled)
+    {
+      for (uint32_t other = 0; other < lane_count; ++other)
+      {
+        depth += other != lane ? get_lane(other).queued_.get().load(std::memory_order_relaxed) : 0;
+      }
+    }
+    stats_.record_depth(depth);
   }
 
-  alignas(cache_line_size) std::atomic<int64_t> queued_{0};
+  void sink_one(uint32_t lane) noexcept
+  {
+    get_lane(lane).queued_.get().fetch_sub(1, std::memory_order_acq_rel);
+  }
 
-  std::unique_ptr<queue_type[]> queues_;
-  std::unique_ptr<mailbox_type> mailbox_;
+  std::array<lane_queues, lane_count> lanes_;
 
   uint32_t start_        = 0;
   uint32_t thread_count_ = 0;
   uint32_t priority_     = 0;
+
+  // Telemetry, compiled out unless OULY_SCHEDULER_STATS is defined
+  OULY_POTENTIAL_EMPTY_MEMBER ouly::detail::workgroup_counters stats_;
 };
 
 } // namespace ouly::detail::v3
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "ouly/containers/small_vector.hpp"
+#include "ouly/scheduler/cancellation.hpp"
+#include "ouly/scheduler/flow_channel.hpp"
 #include "ouly/scheduler/flow_graph_config.hpp"
 #include "ouly/scheduler/spin_lock.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/config.hpp"
 #include "ouly/utility/tagged_int.hpp"
@@ -12,10 +15,12 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace ouly
@@ -63,6 +68,64 @@ namespace ouly
  * A perpetual loop never becomes idle on its own; call request_stop() (typically from within a task)
  * to stop trigger propagation and let the currently running work drain, after which wait() returns.
  *
+ * ## Critical path scheduling
+ *
+ * With cfg::flow_graph_critical_path every firing is timed, from the start of its first task to the
+ * end of its last, and folded into a moving average (cost estimate) of the node; a node that never
+ * fired counts as one average task. Each node keeps an upward rank, its cost plus the largest rank
+ * of its successors. An edge that closes a cycle is a back edge and does not contribute, which keeps
+ * the ranks finite. The ranks are updated incrementally: connect() re-ranks the source and its
+ * ancestors, and so does a firing whose measured cost drifted by more than 1/8 from the cost its
+ * rank was computed with. Successors readied by the same firing are fired in ascending rank order:
+ * the worker's own queue is last in, first out on v2 and v3, so the successor heading the longest
+ * chain is the one it runs next while the others are left for thieves.
+ * A signal() to a node whose rank is within 1/8 of the highest rank seen starts a critical chain;
+ * every critical firing passes it on to its successors of (nearly) the highest rank. On schedulers
+ * with priority lanes (v3) the tasks of critical firings go to the critical lane.
+ *
+ * ## Typed edges and pipelines
+ *
+ * `connect<T>(from, to, capacity)` adds an edge that also carries one T per firing of `from` to a
+ * firing of `to`, through a channel of `capacity` slots allocated by connect(). Chains of typed
+ * edges form streaming pipelines (decode -> transform -> upload) whose stages work on different
+ * iterations at the same time: while `transform` processes value k, `decode` may already produce
+ * value k + 1, up to `capacity` values ahead. A firing of `from` first reserves a slot in each of its
+ * outgoing channels; when one is full the firing is parked, without blocking a worker, until a
+ * firing of the consumer completes and hands its slot back. Parked firings do not count as
+ * in-flight work, and messages are never allocated on the heap. Overlapping firings of the same
+ * consumer may process their values out of order.
+ *
+ * ```cpp
+ * auto frames = graph.connect<image>(decode, transform, 2);
+ * auto meshes = graph.connect<mesh>(transform, upload, 2);
+ * graph.add_source(decode, frames, [&](auto const&) { return read_image(next_file()); });
+ * graph.add_stage(transform, frames, meshes, [](auto const&, image img) { return build_mesh(img); });
+ * graph.add_sink(upload, meshes, [&](auto const&, mesh m) { gpu.upload(m); });
+ * for (auto i = 0; i < count; ++i) { graph.signal(decode, ctx); }
+ * ```
+ *
+ * ## Pipelined loops
+ *
+ * A loop closed with connect(present, update) runs one iteration at a time: update of frame N + 1
+ * waits for present of frame N. set_pipelined_loop(update, present, n) closes the loop instead with
+ * a token-gated trigger: update fires again as soon as its previous firing completed, as long as
+ * fewer than `n` iterations (update firings whose present has not completed yet) are in flight.
+ * Frame N + 1's update then overlaps frame N's render and present, hiding present latency. The
+ * nodes of the loop count the triggers of every iteration apart (per-edge iteration tokens), so a
+ * trigger of frame N + 1 never completes a firing of frame N. Each firing carries its iteration
+ * index, which tasks read through current_iteration() to pick per-frame resources. A node that must
+ * not overlap itself across iterations gets a loop-carried self edge:
+ *
+ * ```cpp
+ * graph.connect(update, render);
+ * graph.connect(render, present);
+ * graph.connect_next_iteration(render, render);   // render of frame N + 1 waits for frame N
+ * graph.connect_next_iteration(present, present);
+ * graph.set_pipelined_loop(update, present, 2);
+ * graph.add(render, [&](auto const&) { draw(frames[Graph::current_iteration() % 2]); });
+ * graph.signal(update, ctx); // kick the loop
+ * ```
+ *
  * ## Usage example (game loop)
  *
  * ```cpp
@@ -90,7 +153,8 @@ namespace ouly
  * @tparam NodeChunkSize  Number of nodes per stable storage chunk (default 32).
  * @tparam EdgeChunkSize  Number of edges per stable storage chunk (default 256).
  * @tparam Config Optional graph configuration. Add cfg::flow_graph_node_id to allow tasks with
- *                the `(context, node_id)` signature.
+ *                the `(context, node_id)` signature, cfg::flow_graph_critical_path to dispatch the
+ *                nodes on the critical path first.
  */
 constexpr uint32_t default_chunk_size      = 32;
 constexpr uint32_t default_edge_chunk_size = 256;
@@ -114,6 +178,8 @@ private:
 
 public:
   static constexpr uint32_t nil = std::numeric_limits<uint32_t>::max();
+  /// Iteration of a trigger that counts toward the node's next firing rather than a loop iteration.
+  static constexpr uint64_t next_firing = std::numeric_limits<uint64_t>::max();
 
   dynamic_flow_graph() noexcept                                    = default;
   dynamic_flow_graph(const dynamic_flow_graph&)                    = delete;
@@ -223,22 +289,108 @@ public:
    */
   void connect(node_id from, node_id to)
   {
-    OULY_ASSERT(from.value() < nodes_.size() && to.value() < nodes_.size());
-    nodes_[to.value()].in_degree_.fetch_add(1, std::memory_order_acq_rel);
+    add_edge(from, to, 0);
+  }
 
-    // Allocate a stable edge record and atomically prepend it to `from`'s successor list.
-    uint32_t edge_idx  = edges_.allocate();
-    auto&    edge      = edges_[edge_idx];
-    edge.target_       = to.value();
-    auto&    from_node = nodes_[from.value()];
-    uint32_t head      = from_node.first_edge_.load(std::memory_order_relaxed);
-    // NOLINTNEXTLINE
-    do
-    {
-      edge.next_.store(head, std::memory_order_relaxed);
-    }
-    while (!from_node.first_edge_.compare_exchange_weak(head, edge_idx, std::memory_order_acq_rel,
-                                                        std::memory_order_relaxed));
+  /**
+   * @brief Create a dependency edge that also carries one value of type T per firing of `from`.
+   *
+   * Connects the nodes like connect(from, to) and returns a port to a channel of `capacity` slots.
+   * A task of `from` pushes one value per firing, a task of `to` pops one per firing. A firing of
+   * `from` does not start while `capacity` of its values are still unconsumed, that is, while their
+   * firings of `to` have not completed. Connect typed edges before the producer first fires.
+   *
+   * @note Thread-safe.
+   */
+  template <typename T>
+  auto connect(node_id from, node_id to, uint32_t capacity = 1) -> flow_port<T>
+  {
+    OULY_ASSERT(capacity > 0);
+    uint32_t link_idx = links_.allocate();
+    auto&    link     = links_[link_idx];
+    auto     channel  = std::make_unique<flow_channel<T>>(capacity);
+    auto     port     = flow_port<T>(channel.get());
+    link.channel_     = std::move(channel);
+    link.credits_     = capacity;
+    link_edge(nodes_[from.value()].first_output_, link_idx, link.next_output_);
+    link_edge(nodes_[to.value()].first_input_, link_idx, link.next_input_);
+    connect(from, to);
+    return port;
+  }
+
+  /**
+   * @brief Add a task that pushes the result of `func(context)` to `out` on every firing.
+   */
+  template <typename Out, typename Func>
+  auto add_source(node_id id, flow_port<Out> out, Func&& func) -> task_id
+  {
+    return add(id,
+               [out, func = std::forward<Func>(func)](context_type const& ctx) mutable
+               {
+                 out.push(func(ctx));
+               });
+  }
+
+  /**
+   * @brief Add a task that pops a value from `in` and pushes `func(context, value)` to `out`.
+   */
+  template <typename In, typename Out, typename Func>
+  auto add_stage(node_id id, flow_port<In> in, flow_port<Out> out, Func&& func) -> task_id
+  {
+    return add(id,
+               [in, out, func = std::forward<Func>(func)](context_type const& ctx) mutable
+               {
+                 out.push(func(ctx, in.pop()));
+               });
+  }
+
+  /**
+   * @brief Add a task that pops a value from `in` and passes it to `func(context, value)`.
+   */
+  template <typename In, typename Func>
+  auto add_sink(node_id id, flow_port<In> in, Func&& func) -> task_id
+  {
+    return add(id,
+               [in, func = std::forward<Func>(func)](context_type const& ctx) mutable
+               {
+                 func(ctx, in.pop());
+               });
+  }
+
+  /**
+   * @brief Seed the cost estimate of a node, e.g. with a value saved from an earlier session.
+   *
+   * Measured firings are blended into the estimate from then on. Re-ranks the node's ancestors.
+   *
+   * @note Thread-safe.
+   */
+  void set_cost_estimate(node_id id, std::chrono::nanoseconds cost)
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    OULY_ASSERT(id.value() < nodes_.size());
+    nodes_[id.value()].cost_.store(static_cast<uint64_t>(std::max<int64_t>(cost.count(), 1)),
+                                   std::memory_order_relaxed);
+    std::lock_guard<spin_lock> lk(rank_lock_);
+    update_ranks(id.value());
+  }
+
+  /**
+   * @brief Current cost estimate of a node, zero until it was measured or seeded.
+   */
+  [[nodiscard]] auto get_cost_estimate(node_id id) const noexcept -> std::chrono::nanoseconds
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    return std::chrono::nanoseconds(static_cast<int64_t>(nodes_[id.value()].cost_.load(std::memory_order_relaxed)));
+  }
+
+  /**
+   * @brief Current upward rank of a node: its estimated cost plus the largest rank of its successors,
+   * back edges excluded.
+   */
+  [[nodiscard]] auto get_upward_rank(node_id id) const noexcept -> std::chrono::nanoseconds
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    return std::chrono::nanoseconds(static_cast<int64_t>(nodes_[id.value()].rank_.load(std::memory_order_relaxed)));
   }
 
   /**
@@ -256,7 +408,127 @@ public:
   void signal(node_id id, context_type const& ctx)
   {
     OULY_ASSERT(id.value() < nodes_.size());
-    deliver_trigger(id.value(), ctx);
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      auto& node = nodes_[id.value()];
+      if (ouly::detail::is_near_critical(node.rank_.load(std::memory_order_relaxed),
+                                         max_rank_.load(std::memory_order_relaxed)))
+      {
+        node.critical_.store(true, std::memory_order_relaxed);
+      }
+    }
+    auto& node = nodes_[id.value()];
+    // Loop members count the triggers of each iteration apart; the head's signal stands in for the
+    // loop trigger of the first iteration
+    OULY_ASSERT(node.iteration_arrivals_ == nullptr || node.loop_limit_ != 0);
+    deliver_trigger(id.value(),
+                    node.loop_limit_ != 0 ? node.loop_sent_.fetch_add(1, std::memory_order_acq_rel) : next_firing, ctx);
+  }
+
+  /**
+   * @brief Create a loop-carried dependency edge: firing k of `from` counts toward firing k + 1 of
+   * `to`.
+   *
+   * Only valid between members of a pipelined loop (see set_pipelined_loop()), which seeds the first
+   * iteration of `to` with the edge's trigger. A self edge keeps a node from overlapping itself
+   * across iterations.
+   *
+   * @note Thread-safe; connect before set_pipelined_loop().
+   */
+  void connect_next_iteration(node_id from, node_id to)
+  {
+    add_edge(from, to, 1);
+  }
+
+  /**
+   * @brief Close the cycle `head` -> ... -> `tail` as a loop running up to `max_inflight_iterations`
+   * iterations at once.
+   *
+   * Adds one trigger to `head`'s threshold, delivered by the loop instead of an edge: after each
+   * firing of `head`, once fewer than `max_inflight_iterations` iterations are in flight. An
+   * iteration starts when `head` fires and ends when `tail` completes a firing. With a limit of one
+   * this behaves like connect(tail, head). Kick the loop with signal(head).
+   *
+   * The nodes reachable from `head` up to `tail` become loop members. A member counts the triggers
+   * of every iteration separately, the k-th trigger over an incoming edge counting toward its
+   * iteration k, so triggers of overlapping iterations never mix. The limit only paces members
+   * that lead to `tail`, and nodes outside the loop that feed a member must not run more than
+   * `max_inflight_iterations` iterations ahead of it. Members other than `head` are not signal()ed.
+   *
+   * @note Call once the loop body is connected and before the loop is kicked; each node belongs to
+   *       at most one loop.
+   */
+  void set_pipelined_loop(node_id head, node_id tail, uint32_t max_inflight_iterations)
+  {
+    OULY_ASSERT(head.value() < nodes_.size() && tail.value() < nodes_.size() && max_inflight_iterations > 0);
+    auto& head_node = nodes_[head.value()];
+    auto& tail_node = nodes_[tail.value()];
+    OULY_ASSERT(head_node.loop_limit_ == 0 && tail_node.loop_head_ == nil);
+    {
+      std::lock_guard<spin_lock> lk(head_node.loop_lock_);
+      head_node.loop_limit_ = max_inflight_iterations;
+    }
+    tail_node.loop_head_ = head.value();
+    head_node.in_degree_.fetch_add(1, std::memory_order_acq_rel);
+
+    // Within the loop a member sees triggers of at most max_inflight_iterations + 1 iterations at
+    // once: the ones in flight, and the next one through loop-carried edges. Feeders outside the
+    // loop may run up to that many iterations further ahead, so the window spans twice as many.
+    uint32_t const                   window = 2 * (max_inflight_iterations + 1);
+    ouly::small_vector<uint32_t, 16> members;
+    members.push_back(head.value());
+    make_loop_member(head_node, window);
+    for (uint32_t i = 0; i < members.size(); ++i)
+    {
+      if (members[i] == tail.value())
+      {
+        continue;
+      }
+      for (uint32_t e = nodes_[members[i]].first_edge_.load(std::memory_order_acquire); e != nil;
+           e          = edges_[e].next_.load(std::memory_order_acquire))
+      {
+        auto& target = nodes_[edges_[e].target_];
+        if (target.iteration_arrivals_ == nullptr)
+        {
+          make_loop_member(target, window);
+          members.push_back(edges_[e].target_);
+        }
+      }
+    }
+    OULY_ASSERT(tail_node.iteration_arrivals_ != nullptr && "tail is not reachable from head");
+
+    // Loop-carried edges hold the trigger of the first iteration
+    for (auto member : members)
+    {
+      for (uint32_t e = nodes_[member].first_edge_.load(std::memory_order_acquire); e != nil;
+           e          = edges_[e].next_.load(std::memory_order_acquire))
+      {
+        auto& target = nodes_[edges_[e].target_];
+        if (edges_[e].iteration_offset_ != 0 && target.iteration_arrivals_ != nullptr)
+        {
+          target.iteration_arrivals_[0].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Number of iterations of the loop headed by `head` that completed.
+   */
+  [[nodiscard]] auto completed_iterations(node_id head) const noexcept -> uint64_t
+  {
+    return nodes_[head.value()].completed_iterations_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Iteration index of the firing the calling task belongs to: the loop iteration for members
+   * of a pipelined loop, the number of earlier firings of the node elsewhere.
+   *
+   * Only meaningful inside a task of this graph type.
+   */
+  [[nodiscard]] static auto current_iteration() noexcept -> uint64_t
+  {
+    return current_iteration_;
   }
 
   /**
@@ -281,6 +553,19 @@ public:
     return stop_.load(std::memory_order_acquire);
   }
 
+  /**
+   * @brief Abandon the graph's work when `token` is cancelled.
+   *
+   * Once cancelled the graph behaves as if request_stop() had been called, and in addition the
+   * tasks of firings that were already scheduled are skipped instead of run, so the graph drains
+   * without finishing doomed work. Attach the token while the graph is idle.
+   */
+  void set_cancellation_token(cancellation_token token) noexcept
+  {
+    OULY_ASSERT(is_idle() && "Attach a cancellation token while the graph is idle");
+    cancellation_ = token;
+  }
+
   /**
    * @brief Whether the graph currently has no in-flight work.
    */
@@ -403,6 +688,29 @@ private:
   {
     uint32_t              target_{nil};
     std::atomic<uint32_t> next_{nil};
+    // Critical path bookkeeping (cfg::flow_graph_critical_path):
+    uint32_t              source_{nil};
+    std::atomic<uint32_t> next_in_{nil}; ///< Next edge in the target's predecessor list.
+    bool                  back_{false};  ///< Closes a cycle; not part of the ranks or predecessor lists.
+    // Pipelined loops:
+    std::atomic<uint64_t> sent_{0};             ///< Triggers sent so far, the iteration of the next one.
+    uint32_t              iteration_offset_{0}; ///< 1 for a loop-carried edge, see connect_next_iteration().
+  };
+
+  struct fire_batch;
+
+  /// Channel of a typed edge plus its backpressure state, stored in a stable pool.
+  struct data_link
+  {
+    std::unique_ptr<ouly::detail::flow_channel_base> channel_;
+    std::atomic<uint32_t>                            next_output_{nil}; ///< Next link of the producer.
+    std::atomic<uint32_t>                            next_input_{nil};  ///< Next link of the consumer.
+
+    // Backpressure (guarded by lock_):
+    spin_lock   lock_;
+    uint32_t    credits_{0};           ///< Free slots not yet reserved by a producer firing.
+    fire_batch* parked_{nullptr};      ///< Oldest producer firing waiting for a slot.
+    fire_batch* parked_tail_{nullptr}; ///< Newest producer firing waiting for a slot.
   };
 
   /// A node: a set of tasks plus dependency / successor bookkeeping.
@@ -445,10 +753,35 @@ private:
     // Firing state:
     std::atomic<uint32_t> arrived_{0}; ///< Triggers accumulated toward the next firing.
 
+    std::atomic<uint64_t> firings_{0}; ///< Firings so far, the iteration index of the next one.
+
+    // Pipelined loop (set_pipelined_loop), loop_limit_ to loop_rearm_ guarded by loop_lock_:
+    spin_lock             loop_lock_;
+    uint32_t              loop_limit_{0};            ///< Max iterations in flight, 0 unless a loop head.
+    uint32_t              loop_inflight_{0};         ///< Iterations started and not completed.
+    bool                  loop_rearm_{false};        ///< Head done, its loop trigger waits for a slot.
+    uint32_t              loop_head_{nil};           ///< On a loop tail, the head whose iterations it ends.
+    std::atomic<uint64_t> completed_iterations_{0}; ///< On a loop head.
+    std::atomic<uint64_t> loop_sent_{0};            ///< On a loop head, loop triggers sent so far.
+    uint32_t              iteration_window_{0};     ///< Size of iteration_arrivals_.
+    std::unique_ptr<std::atomic<uint32_t>[]> iteration_arrivals_; ///< Loop members: triggers per iteration slot. NOLINT
+
+    // Typed edges:
+    std::atomic<uint32_t> first_output_{nil}; ///< Head of the outgoing data link list.
+    std::atomic<uint32_t> first_input_{nil};  ///< Head of the incoming data link list.
+
     // Task storage (guarded by task_lock_):
     spin_lock                       task_lock_;
     std::vector<task_delegate_type> tasks_; ///< Source task list (slots reused).
     uint32_t                        valid_task_count_{0};
+
+    // Critical path state (cfg::flow_graph_critical_path):
+    std::atomic<uint32_t> first_in_edge_{nil}; ///< Head of the predecessor edge list, back edges excluded.
+    std::atomic<uint64_t> cost_{0};            ///< Moving average of the firing duration in ns, 0 if unknown.
+    std::atomic<uint64_t> ranked_cost_{0};     ///< Cost the current rank_ was computed with.
+    std::atomic<uint64_t> rank_{0};            ///< Upward rank in ns.
+    std::atomic_bool      critical_{false};    ///< The next firing continues a critical chain.
+    uint32_t              visit_epoch_{0};     ///< Traversal mark (guarded by rank_lock_).
   };
 
   /**
@@ -462,8 +795,13 @@ private:
   struct fire_batch
   {
     std::atomic<uint32_t>           remaining_{0};       ///< Tasks left to complete in this firing.
+    std::atomic<int64_t>            started_{0};         ///< Start of the first task (critical path timing).
     uint32_t                        node_idx_{nil};      ///< Owning node.
+    uint64_t                        iteration_{0};       ///< See current_iteration().
+    bool                            critical_{false};    ///< Part of a critical chain.
     fire_batch*                     pool_next_{nullptr}; ///< Freelist link.
+    fire_batch*                     park_next_{nullptr}; ///< Next firing parked on the same data link.
+    uint32_t                        next_reserve_{nil};  ///< Data link to reserve when resumed.
     std::vector<task_delegate_type> tasks_;              ///< Snapshot of the node's valid tasks.
   };
 
@@ -490,33 +828,121 @@ private:
     batch_free_    = fb;
   }
 
-  /// Deliver one trigger to a node; fire it if its threshold is reached.
-  void deliver_trigger(uint32_t idx, context_type const& ctx)
+  /// Create an edge whose k-th trigger counts toward iteration k + iteration_offset of a loop member.
+  void add_edge(node_id from, node_id to, uint32_t iteration_offset)
+  {
+    OULY_ASSERT(from.value() < nodes_.size() && to.value() < nodes_.size());
+    nodes_[to.value()].in_degree_.fetch_add(1, std::memory_order_acq_rel);
+
+    // Allocate a stable edge record and atomically prepend it to `from`'s successor list.
+    uint32_t edge_idx      = edges_.allocate();
+    auto&    edge          = edges_[edge_idx];
+    edge.target_           = to.value();
+    edge.source_           = from.value();
+    edge.iteration_offset_ = iteration_offset;
+    auto&    from_node     = nodes_[from.value()];
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      std::lock_guard<spin_lock> lk(rank_lock_);
+      edge.back_ = reaches(to.value(), from.value());
+      link_edge(from_node.first_edge_, edge_idx, edge.next_);
+      if (!edge.back_)
+      {
+        link_edge(nodes_[to.value()].first_in_edge_, edge_idx, edge.next_in_);
+        update_ranks(from.value());
+      }
+    }
+    else
+    {
+      link_edge(from_node.first_edge_, edge_idx, edge.next_);
+    }
+  }
+
+  /// Allocate the per-iteration trigger counters of a pipelined loop member.
+  static void make_loop_member(task_node& node, uint32_t window)
+  {
+    OULY_ASSERT(node.iteration_arrivals_ == nullptr);
+    node.iteration_arrivals_ = std::make_unique<std::atomic<uint32_t>[]>(window); // NOLINT
+    node.iteration_window_   = window;
+  }
+
+  /// Iteration the next trigger over an edge counts toward: next_firing unless it enters a loop member.
+  auto edge_iteration(edge& e) -> uint64_t
+  {
+    if (nodes_[e.target_].iteration_arrivals_ == nullptr)
+    {
+      return next_firing;
+    }
+    return e.sent_.fetch_add(1, std::memory_order_acq_rel) + e.iteration_offset_;
+  }
+
+  /// Count one trigger toward a node's next firing, or toward `iteration` of a loop member; true when
+  /// its threshold is reached.
+  auto accept_trigger(uint32_t idx, uint64_t iteration) -> bool
   {
     auto&    node      = nodes_[idx];
     uint32_t threshold = std::max(node.in_degree_.load(std::memory_order_acquire), 1U);
+    if (iteration != next_firing)
+    {
+      auto& arrived = node.iteration_arrivals_[iteration % node.iteration_window_];
+      if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == threshold)
+      {
+        arrived.fetch_sub(threshold, std::memory_order_acq_rel);
+        return true;
+      }
+      return false;
+    }
     if (node.arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == threshold)
     {
       // Consume one threshold's worth of triggers, carrying any surplus to the next round.
       node.arrived_.fetch_sub(threshold, std::memory_order_acq_rel);
-      fire_node(idx, ctx);
+      return true;
+    }
+    return false;
+  }
+
+  /// Whether trigger propagation halts, after request_stop() or cancellation.
+  [[nodiscard]] auto stopping() const noexcept -> bool
+  {
+    return stop_.load(std::memory_order_acquire) || cancellation_.is_cancelled();
+  }
+
+  /// Deliver one trigger to a node; fire it if its threshold is reached.
+  void deliver_trigger(uint32_t idx, uint64_t iteration, context_type const& ctx)
+  {
+    if (accept_trigger(idx, iteration))
+    {
+      fire_node(idx, iteration, ctx);
     }
   }
 
   /// Begin a firing of a node: snapshot its tasks into a fresh batch and dispatch them.
-  void fire_node(uint32_t idx, context_type const& ctx)
+  void fire_node(uint32_t idx, uint64_t iteration, context_type const& ctx)
   {
-    if (stop_.load(std::memory_order_acquire))
+    if (stopping())
     {
       return;
     }
 
-    auto& node = nodes_[idx];
+    auto&             node = nodes_[idx];
+    ouly::trace_scope trace(ctx.get_scheduler().get_trace_recorder(), ctx.get_worker(), ctx.get_workgroup(),
+                            "dynamic_flow_graph.fire", idx);
 
     // Snapshot the current valid tasks into a private, immutable firing batch under the task lock.
     fire_batch* fb = acquire_batch();
     fb->node_idx_  = idx;
+    fb->iteration_ = iteration != next_firing ? iteration : node.firings_.fetch_add(1, std::memory_order_relaxed);
     fb->tasks_.clear();
+    if (node.loop_limit_ != 0)
+    {
+      std::lock_guard<spin_lock> lk(node.loop_lock_);
+      ++node.loop_inflight_;
+    }
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      fb->started_.store(0, std::memory_order_relaxed);
+      fb->critical_ = node.critical_.exchange(false, std::memory_order_relaxed);
+    }
     {
       std::lock_guard<spin_lock> lk(node.task_lock_);
       for (auto& t : node.tasks_)
@@ -527,7 +953,79 @@ private:
         }
       }
     }
-    auto valid = static_cast<uint32_t>(fb->tasks_.size());
+
+    // A full outgoing channel parks the firing; release_inputs() of the consumer resumes it.
+    if (!reserve_outputs(fb, node.first_output_.load(std::memory_order_acquire)))
+    {
+      return;
+    }
+    dispatch_batch(fb, ctx);
+  }
+
+  /// Reserve a slot in every data link from `link` on; false when the firing got parked on one.
+  auto reserve_outputs(fire_batch* fb, uint32_t link_idx) -> bool
+  {
+    for (; link_idx != nil; link_idx = links_[link_idx].next_output_.load(std::memory_order_acquire))
+    {
+      auto&                      link = links_[link_idx];
+      std::lock_guard<spin_lock> lk(link.lock_);
+      if (link.credits_ > 0)
+      {
+        --link.credits_;
+        continue;
+      }
+      fb->next_reserve_ = link.next_output_.load(std::memory_order_acquire);
+      fb->park_next_    = nullptr;
+      if (link.parked_tail_ != nullptr)
+      {
+        link.parked_tail_->park_next_ = fb;
+      }
+      else
+      {
+        link.parked_ = fb;
+      }
+      link.parked_tail_ = fb;
+      return false;
+    }
+    return true;
+  }
+
+  /// Hand the slot of every incoming data link back: to the oldest parked producer firing, which
+  /// resumes here, or to the link's free credits.
+  void release_inputs(uint32_t idx, context_type const& ctx)
+  {
+    for (uint32_t link_idx = nodes_[idx].first_input_.load(std::memory_order_acquire); link_idx != nil;
+         link_idx          = links_[link_idx].next_input_.load(std::memory_order_acquire))
+    {
+      auto&       link    = links_[link_idx];
+      fire_batch* resumed = nullptr;
+      {
+        std::lock_guard<spin_lock> lk(link.lock_);
+        resumed = link.parked_;
+        if (resumed == nullptr)
+        {
+          ++link.credits_;
+          continue;
+        }
+        link.parked_ = resumed->park_next_;
+        if (link.parked_ == nullptr)
+        {
+          link.parked_tail_ = nullptr;
+        }
+      }
+      // A stopped graph drops parked firings; the batch stays owned by batch_storage_.
+      if (!stopping() && reserve_outputs(resumed, resumed->next_reserve_))
+      {
+        dispatch_batch(resumed, ctx);
+      }
+    }
+  }
+
+  /// Run a firing whose tasks are snapshotted and whose output slots are reserved.
+  void dispatch_batch(fire_batch* fb, context_type const& ctx)
+  {
+    auto& node  = nodes_[fb->node_idx_];
+    auto  valid = static_cast<uint32_t>(fb->tasks_.size());
 
     // Hold a "fire token" until tasks complete and successors are notified, so the graph does not
     // appear idle mid hand-off.
@@ -549,22 +1047,24 @@ private:
     auto* graph = this;
     for (uint32_t i = 0; i < valid; ++i)
     {
-      ctx.get_scheduler().submit(ctx, node.workgroup_,
-                                 [graph, fb, i](context_type const& task_ctx) -> void
-                                 {
-                                   if constexpr (ouly::detail::flow_graph_node_id_v<config>)
-                                   {
-                                     fb->tasks_[i](task_ctx, node_id{fb->node_idx_});
-                                   }
-                                   else
-                                   {
-                                     fb->tasks_[i](task_ctx);
-                                   }
-                                   if (fb->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
-                                   {
-                                     graph->finish_fire(fb, task_ctx);
-                                   }
-                                 });
+      auto task = [graph, fb, i](context_type const& task_ctx) -> void
+      {
+        graph->run_task(fb, fb->tasks_[i], task_ctx);
+        if (fb->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          graph->finish_fire(fb, task_ctx);
+        }
+      };
+      if constexpr (requires { typename SchedulerType::lane_type; })
+      {
+        using lane_type = typename SchedulerType::lane_type;
+        ctx.get_scheduler().submit(ctx, node.workgroup_, fb->critical_ ? lane_type::critical : lane_type::normal,
+                                   task);
+      }
+      else
+      {
+        ctx.get_scheduler().submit(ctx, node.workgroup_, task);
+      }
     }
   }
 
@@ -573,30 +1073,110 @@ private:
   {
     for (auto& task : fb->tasks_)
     {
-      if constexpr (ouly::detail::flow_graph_node_id_v<config>)
-      {
-        task(ctx, node_id{fb->node_idx_});
-      }
-      else
+      run_task(fb, task, ctx);
+    }
+    finish_fire(fb, ctx);
+  }
+
+  /// Run one task of a firing, recording it when the scheduler has a trace recorder attached.
+  void run_task(fire_batch* fb, task_delegate_type& task, context_type const& ctx)
+  {
+    if (cancellation_.is_cancelled())
+    {
+      return;
+    }
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      if (int64_t expected = 0; fb->started_.load(std::memory_order_relaxed) == expected)
       {
-        task(ctx);
+        fb->started_.compare_exchange_strong(expected, ouly::detail::flow_graph_clock(), std::memory_order_relaxed);
       }
     }
-    finish_fire(fb, ctx);
+    ouly::trace_scope trace(ctx.get_scheduler().get_trace_recorder(), ctx.get_worker(), ctx.get_workgroup(),
+                            "dynamic_flow_graph.node", fb->node_idx_);
+    // Restored afterwards, the task may run other graph tasks while it waits
+    auto const outer_iteration = std::exchange(current_iteration_, fb->iteration_);
+    if constexpr (ouly::detail::flow_graph_node_id_v<config>)
+    {
+      task(ctx, node_id{fb->node_idx_});
+    }
+    else
+    {
+      task(ctx);
+    }
+    current_iteration_ = outer_iteration;
   }
 
-  /// Complete a node's firing: notify successors, release the fire token, recycle the batch.
+  /// Complete a node's firing: free its input slots, notify successors, release the fire token,
+  /// recycle the batch.
   void finish_fire(fire_batch* fb, context_type const& ctx)
   {
-    notify_successors(fb->node_idx_, ctx);
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      // Firings whose tasks were all cancelled were never timed
+      if (auto const started = fb->started_.load(std::memory_order_relaxed); started != 0)
+      {
+        record_cost(fb->node_idx_, ouly::detail::flow_graph_clock() - started,
+                    static_cast<uint32_t>(fb->tasks_.size()));
+      }
+    }
+    release_inputs(fb->node_idx_, ctx);
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      notify_successors_by_rank(fb->node_idx_, fb->critical_, ctx);
+    }
+    else
+    {
+      notify_successors(fb->node_idx_, ctx);
+    }
+    advance_loop(fb->node_idx_, ctx);
     release_batch(fb);
     inflight_.fetch_sub(1, std::memory_order_acq_rel);
   }
 
+  /// End an iteration when `idx` is a loop tail, then re-trigger the loop head when it is done with
+  /// its previous firing and an iteration slot is free.
+  void advance_loop(uint32_t idx, context_type const& ctx)
+  {
+    auto& node = nodes_[idx];
+    if (node.loop_head_ != nil)
+    {
+      auto& head    = nodes_[node.loop_head_];
+      bool  trigger = false;
+      {
+        std::lock_guard<spin_lock> lk(head.loop_lock_);
+        --head.loop_inflight_;
+        if (head.loop_rearm_ && head.loop_inflight_ < head.loop_limit_)
+        {
+          head.loop_rearm_ = false;
+          trigger          = true;
+        }
+      }
+      head.completed_iterations_.fetch_add(1, std::memory_order_acq_rel);
+      if (trigger)
+      {
+        deliver_trigger(node.loop_head_, head.loop_sent_.fetch_add(1, std::memory_order_acq_rel), ctx);
+      }
+    }
+    if (node.loop_limit_ != 0)
+    {
+      bool trigger = false;
+      {
+        std::lock_guard<spin_lock> lk(node.loop_lock_);
+        trigger          = node.loop_inflight_ < node.loop_limit_;
+        node.loop_rearm_ = !trigger;
+      }
+      if (trigger)
+      {
+        deliver_trigger(idx, node.loop_sent_.fetch_add(1, std::memory_order_acq_rel), ctx);
+      }
+    }
+  }
+
   /// Deliver a trigger to every successor of a node.
   void notify_successors(uint32_t idx, context_type const& ctx)
   {
-    if (stop_.load(std::memory_order_acquire))
+    if (stopping())
     {
       return;
     }
@@ -604,11 +1184,152 @@ private:
     while (e != nil)
     {
       auto& edge = edges_[e];
-      deliver_trigger(edge.target_, ctx);
+      deliver_trigger(edge.target_, edge_iteration(edge), ctx);
       e = edge.next_.load(std::memory_order_acquire);
     }
   }
 
+  /// Deliver a trigger to every successor, pass a critical chain on to the successors of (nearly) the
+  /// highest rank, then fire the readied successors in ascending rank order, the highest last.
+  void notify_successors_by_rank(uint32_t idx, bool critical, context_type const& ctx)
+  {
+    if (stopping())
+    {
+      return;
+    }
+    uint64_t best = 0;
+    for (uint32_t e = nodes_[idx].first_edge_.load(std::memory_order_acquire); e != nil;
+         e          = edges_[e].next_.load(std::memory_order_acquire))
+    {
+      best = std::max(best, nodes_[edges_[e].target_].rank_.load(std::memory_order_relaxed));
+    }
+
+    ouly::small_vector<std::pair<uint32_t, uint64_t>, 16> ready;
+    for (uint32_t e = nodes_[idx].first_edge_.load(std::memory_order_acquire); e != nil;
+         e          = edges_[e].next_.load(std::memory_order_acquire))
+    {
+      auto& target = nodes_[edges_[e].target_];
+      if (critical && ouly::detail::is_near_critical(target.rank_.load(std::memory_order_relaxed), best))
+      {
+        target.critical_.store(true, std::memory_order_relaxed);
+      }
+      if (auto iteration = edge_iteration(edges_[e]); accept_trigger(edges_[e].target_, iteration))
+      {
+        ready.emplace_back(edges_[e].target_, iteration);
+      }
+    }
+    std::ranges::sort(ready,
+                      [this](auto const& a, auto const& b)
+                      {
+                        return nodes_[a.first].rank_.load(std::memory_order_relaxed) <
+                               nodes_[b.first].rank_.load(std::memory_order_relaxed);
+                      });
+    for (auto [target, iteration] : ready)
+    {
+      fire_node(target, iteration, ctx);
+    }
+  }
+
+  /// Fold a measured firing into the node's estimate; re-rank when it drifted from the ranked cost.
+  void record_cost(uint32_t idx, int64_t duration, uint32_t task_count)
+  {
+    auto&      node = nodes_[idx];
+    auto const cost = ouly::detail::blend_cost(node.cost_.load(std::memory_order_relaxed), duration);
+    node.cost_.store(cost, std::memory_order_relaxed);
+    task_cost_.store(ouly::detail::blend_cost(task_cost_.load(std::memory_order_relaxed), duration / task_count),
+                     std::memory_order_relaxed);
+
+    auto const ranked = node.ranked_cost_.load(std::memory_order_relaxed);
+    auto const drift  = cost > ranked ? cost - ranked : ranked - cost;
+    // A busy lock means someone else is re-ranking; the drift is picked up by a later firing.
+    if (drift * ouly::detail::flow_graph_critical_slack > ranked && rank_lock_.try_lock())
+    {
+      update_ranks(idx);
+      rank_lock_.unlock();
+    }
+  }
+
+  /// Recompute the rank of `start`, then of every ancestor whose successor's rank changed.
+  /// The predecessor lists hold no back edges, so this terminates. Requires rank_lock_.
+  void update_ranks(uint32_t start)
+  {
+    ouly::small_vector<uint32_t, 16> pending;
+    pending.push_back(start);
+    while (!pending.empty())
+    {
+      auto const idx = pending.back();
+      pending.pop_back();
+      auto& node = nodes_[idx];
+
+      auto const cost = node.cost_.load(std::memory_order_relaxed);
+      uint64_t   rank = 0;
+      for (uint32_t e = node.first_edge_.load(std::memory_order_acquire); e != nil;
+           e          = edges_[e].next_.load(std::memory_order_acquire))
+      {
+        if (!edges_[e].back_)
+        {
+          rank = std::max(rank, nodes_[edges_[e].target_].rank_.load(std::memory_order_relaxed));
+        }
+      }
+      rank += cost != 0 ? cost : std::max<uint64_t>(task_cost_.load(std::memory_order_relaxed), 1);
+      node.ranked_cost_.store(cost, std::memory_order_relaxed);
+      if (node.rank_.exchange(rank, std::memory_order_relaxed) == rank)
+      {
+        continue;
+      }
+      if (rank > max_rank_.load(std::memory_order_relaxed))
+      {
+        max_rank_.store(rank, std::memory_order_relaxed);
+      }
+      for (uint32_t e = node.first_in_edge_.load(std::memory_order_acquire); e != nil;
+           e          = edges_[e].next_in_.load(std::memory_order_acquire))
+      {
+        pending.push_back(edges_[e].source_);
+      }
+    }
+  }
+
+  /// Whether `target` can be reached from `from` over forward edges. Requires rank_lock_.
+  auto reaches(uint32_t from, uint32_t target) -> bool
+  {
+    auto const                       epoch = ++rank_epoch_;
+    ouly::small_vector<uint32_t, 16> pending;
+    pending.push_back(from);
+    nodes_[from].visit_epoch_ = epoch;
+    while (!pending.empty())
+    {
+      auto const idx = pending.back();
+      pending.pop_back();
+      if (idx == target)
+      {
+        return true;
+      }
+      for (uint32_t e = nodes_[idx].first_edge_.load(std::memory_order_acquire); e != nil;
+           e          = edges_[e].next_.load(std::memory_order_acquire))
+      {
+        auto& next = nodes_[edges_[e].target_];
+        if (!edges_[e].back_ && next.visit_epoch_ != epoch)
+        {
+          next.visit_epoch_ = epoch;
+          pending.push_back(edges_[e].target_);
+        }
+      }
+    }
+    return false;
+  }
+
+  /// Atomically prepend edge `edge_idx` to the list headed by `head`, linked through `next`.
+  static void link_edge(std::atomic<uint32_t>& head, uint32_t edge_idx, std::atomic<uint32_t>& next)
+  {
+    uint32_t first = head.load(std::memory_order_relaxed);
+    // NOLINTNEXTLINE
+    do
+    {
+      next.store(first, std::memory_order_relaxed);
+    }
+    while (!head.compare_exchange_weak(first, edge_idx, std::memory_order_acq_rel, std::memory_order_relaxed));
+  }
+
   /// Queue a ready main-thread firing for the waiting thread to run.
   void enqueue_main_node(fire_batch* fb)
   {
@@ -637,9 +1358,19 @@ private:
 
   stable_pool<task_node, NodeChunkSize> nodes_;
   stable_pool<edge, EdgeChunkSize>      edges_;
+  stable_pool<data_link, EdgeChunkSize> links_;
+
+  inline static thread_local uint64_t current_iteration_ = 0; ///< Iteration of the running task's firing.
 
   std::atomic<uint32_t> inflight_{0}; ///< In-flight fires + running tasks; zero means idle.
   std::atomic_bool      stop_{false}; ///< When set, trigger propagation halts and the graph drains.
+  cancellation_token    cancellation_; ///< Acts as stop_ once cancelled, and skips scheduled tasks.
+
+  // Critical path state (cfg::flow_graph_critical_path):
+  spin_lock             rank_lock_;     ///< Serializes rank updates and cycle checks.
+  uint32_t              rank_epoch_{0}; ///< Traversal epoch of reaches() (guarded by rank_lock_).
+  std::atomic<uint64_t> max_rank_{0};   ///< Highest rank seen; decreases are not tracked.
+  std::atomic<uint64_t> task_cost_{0};  ///< Moving average cost of one task, the estimate of unmeasured nodes.
 
   // Batch pool (guarded by batch_lock_):
   spin_lock                                batch_lock_;
@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly::detail
+{
+/// Type-erased owner handle, lets a graph keep channels of different value types in one list
+struct flow_channel_base
+{
+  flow_channel_base() noexcept                                   = default;
+  flow_channel_base(flow_channel_base const&)                    = delete;
+  flow_channel_base(flow_channel_base&&)                         = delete;
+  auto operator=(flow_channel_base const&) -> flow_channel_base& = delete;
+  auto operator=(flow_channel_base&&) -> flow_channel_base&      = delete;
+  virtual ~flow_channel_base() noexcept                          = default;
+
+  /// Drop every queued value
+  virtual void clear() noexcept = 0;
+};
+} // namespace ouly::detail
+
+namespace ouly
+{
+
+/**
+ * @brief Bounded multi-producer/multi-consumer value buffer behind a typed flow graph edge
+ *
+ * The slots are allocated once, when the channel is created; pushing and popping values never
+ * allocates. A capacity of one is a single slot. Values are constructed in place and may have
+ * non-trivial destructors; values still queued when the channel is destroyed are destroyed with it.
+ * Uses Dmitry Vyukov's bounded MPMC queue algorithm (see detail/mpmc_ring.hpp) with an arbitrary
+ * capacity instead of a power of two. The algorithm cannot tell a full single-cell ring from an
+ * empty one, so a capacity of one still gets two cells.
+ *
+ * Channels are created by flow_graph::connect<T>() and dynamic_flow_graph::connect<T>(), which
+ * hand out flow_port handles to them.
+ */
+template <typename T>
+class flow_channel final : public ouly::detail::flow_channel_base
+{
+  static_assert(std::is_move_constructible_v<T>, "Flow channel values must be move constructible");
+
+public:
+  explicit flow_channel(uint32_t capacity)
+      : capacity_(capacity), cell_count_(std::max<uint32_t>(capacity, 2)),
+        cells_(std::make_unique<cell[]>(cell_count_)) // NOLINT
+  {
+    OULY_ASSERT(capacity > 0);
+    for (uint32_t i = 0; i < cell_count_; ++i)
+    {
+      cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~flow_channel() noexcept override
+  {
+    flow_channel::clear();
+  }
+
+  void clear() noexcept override
+  {
+    while (try_pop())
+    {
+    }
+  }
+
+  flow_channel(flow_channel const&)                    = delete;
+  flow_channel(flow_channel&&)                         = delete;
+  auto operator=(flow_channel const&) -> flow_channel& = delete;
+  auto operator=(flow_channel&&) -> flow_channel&      = delete;
+
+  /// Construct a value in the next free slot; false when the channel is full
+  template <typename... Args>
+  auto try_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) -> bool
+  {
+    cell*  slot = nullptr;
+    size_t pos  = head_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      // The spare cell of a capacity of one must stay unused
+      if (capacity_ < cell_count_ &&
+          static_cast<intptr_t>(pos - tail_.load(std::memory_order_acquire)) >= static_cast<intptr_t>(capacity_))
+      {
+        return false; // full
+      }
+      slot            = &cells_[pos % cell_count_];
+      size_t   seq    = slot->sequence_.load(std::memory_order_acquire);
+      intptr_t diff   = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false; // full
+      }
+      else
+      {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+
+    std::construct_at(slot->value(), std::forward<Args>(args)...);
+    slot->sequence_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Take the oldest value; empty when the channel is empty
+  auto try_pop() noexcept(std::is_nothrow_move_constructible_v<T>) -> std::optional<T>
+  {
+    cell*  slot = nullptr;
+    size_t pos  = tail_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      slot            = &cells_[pos % cell_count_];
+      size_t   seq    = slot->sequence_.load(std::memory_order_acquire);
+      intptr_t diff   = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return std::nullopt; // empty
+      }
+      else
+      {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    std::optional<T> result(std::move(*slot->value()));
+    std::destroy_at(slot->value());
+    slot->sequence_.store(pos + cell_count_, std::memory_order_release);
+    return result;
+  }
+
+  /// Number of queued values; approximate while producers or consumers are active
+  [[nodiscard]] auto size() const noexcept -> uint32_t
+  {
+    return static_cast<uint32_t>(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> uint32_t
+  {
+    return capacity_;
+  }
+
+private:
+  struct cell
+  {
+    std::atomic<size_t> sequence_{0};
+    alignas(T) std::byte storage_[sizeof(T)]; // NOLINT
+
+    auto value() noexcept -> T*
+    {
+      return std::launder(reinterpret_cast<T*>(&storage_[0])); // NOLINT
+    }
+  };
+
+  uint32_t                                                   capacity_;
+  uint32_t                                                   cell_count_;
+  std::unique_ptr<cell[]>                                    cells_; // NOLINT
+  alignas(ouly::detail::cache_line_size) std::atomic<size_t> head_{0};
+  alignas(ouly::detail::cache_line_size) std::atomic<size_t> tail_{0};
+};
+
+/**
+ * @brief Handle to the channel of a typed flow graph edge
+ *
+ * Copyable and trivially cheap; capture it by value in the tasks of the two connected nodes. The
+ * producing node pushes one value per run (flow_graph) or firing (dynamic_flow_graph) and the
+ * consuming node pops it. The graph orders the pop after the push, so inside graph tasks push()
+ * and pop() never find the channel full or empty.
+ */
+template <typename T>
+class flow_port
+{
+public:
+  using value_type = T;
+
+  flow_port() noexcept = default;
+  explicit flow_port(flow_channel<T>* channel) noexcept : channel_(channel) {}
+
+  /// Hand a value to the consuming node
+  template <typename... Args>
+  void push(Args&&... args) const
+  {
+    [[maybe_unused]] bool const pushed = channel_->try_emplace(std::forward<Args>(args)...);
+    OULY_ASSERT(pushed && "flow_port::push: more values than the edge capacity");
+  }
+
+  /// Take the value handed over by the producing node
+  auto pop() const -> T
+  {
+    auto value = channel_->try_pop();
+    OULY_ASSERT(value.has_value() && "flow_port::pop: no value from the producing node");
+    return std::move(*value); // NOLINT(bugprone-unchecked-optional-access)
+  }
+
+  template <typename... Args>
+  auto try_push(Args&&... args) const -> bool
+  {
+    return channel_->try_emplace(std::forward<Args>(args)...);
+  }
+
+  auto try_pop() const -> std::optional<T>
+  {
+    return channel_->try_pop();
+  }
+
+  [[nodiscard]] auto size() const noexcept -> uint32_t
+  {
+    return channel_->size();
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> uint32_t
+  {
+    return channel_->capacity();
+  }
+
+  [[nodiscard]] auto channel() const noexcept -> flow_channel<T>*
+  {
+    return channel_;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return channel_ != nullptr;
+  }
+
+private:
+  flow_channel<T>* channel_ = nullptr;
+};
+
+} // namespace ouly
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
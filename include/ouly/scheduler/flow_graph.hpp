@@ -3,18 +3,26 @@
 #pragma once
 
 #include "ouly/containers/small_vector.hpp"
+#include "ouly/scheduler/cancellation.hpp"
+#include "ouly/scheduler/flow_channel.hpp"
 #include "ouly/scheduler/flow_graph_config.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/config.hpp"
 #include "ouly/utility/tagged_int.hpp"
 #include "ouly/utility/user_config.hpp"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <mutex>
+#include <ranges>
 #include <semaphore>
 #include <span>
 #include <thread>
+#include <type_traits>
 #include <vector>
 namespace ouly
 {
@@ -45,7 +53,8 @@ namespace ouly
  * @tparam AvgNodeCount Expected average number of nodes for optimization (default: 4)
  * @tparam AvgDepCount Expected average number of dependencies per node (default: 4)
  * @tparam Config Optional graph configuration. Add cfg::flow_graph_node_id to allow tasks with
- *                the `(context, node_id)` signature.
+ *                the `(context, node_id)` signature, cfg::flow_graph_critical_path to dispatch the
+ *                nodes on the critical path first.
  *
  * ## Key Features:
  *
@@ -137,6 +146,40 @@ namespace ouly
  * - Tasks can be added dynamically up until `start()` is called
  * - The graph can be reused by calling `start()` multiple times
  * - Empty nodes (nodes without tasks) are supported and will trigger their successors
+ * - `start()` runs from an execution plan built by `compile()`, rebuilt automatically after the
+ *   graph was modified; call `compile()` up front to keep that cost out of the first frame
+ *
+ * ## Critical Path Scheduling:
+ *
+ * With cfg::flow_graph_critical_path every run measures each node, from the start of its first task
+ * to the end of its last, and folds the duration into a moving average (cost estimate) of the
+ * node. Nodes that never ran are estimated from the average per-task cost of the measured ones.
+ * Every start() then computes the upward rank of each node, its cost plus the largest rank of its
+ * successors, and orders the roots and every successor list by ascending rank. Of the nodes readied
+ * together the one heading the longest remaining chain is submitted last, which makes it the next
+ * one the submitting worker runs on schedulers whose own queue is last in, first out (v2, v3). Nodes
+ * whose longest path through the graph is within 1/8 of the critical path are submitted to the
+ * critical lane of schedulers that have priority lanes (v3).
+ *
+ * ## Typed Edges:
+ *
+ * `connect<T>(from, to)` adds a dependency that also carries a T from `from` to `to` through a
+ * preallocated channel, so producers hand data to consumers without shared globals or per-message
+ * allocation:
+ *
+ * ```cpp
+ * auto decode    = graph.create_node();
+ * auto transform = graph.create_node();
+ * auto upload    = graph.create_node();
+ * auto frames    = graph.connect<image>(decode, transform);
+ * auto meshes    = graph.connect<mesh>(transform, upload);
+ * graph.add_source(decode, frames, [&](auto const&) { return read_image(file); });
+ * graph.add_stage(transform, frames, meshes, [](auto const&, image img) { return build_mesh(img); });
+ * graph.add_sink(upload, meshes, [&](auto const&, mesh m) { gpu.upload(m); });
+ * ```
+ *
+ * A flow_graph run moves one value across each typed edge. To pipeline a stream of values across
+ * iterations, with backpressure, use the typed edges of dynamic_flow_graph.
  */
 
 template <typename SchedulerType, size_t AvgNodeCount = 4, size_t AvgDepCount = 4, typename Config = ouly::config<>>
@@ -174,6 +217,11 @@ public:
     auto id = static_cast<node_id>(nodes_.size());
     nodes_.emplace_back(workgroup);
     dependency_counts_.emplace_back(0);
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      priorities_.emplace_back();
+    }
+    compiled_ = false;
     return id;
   }
 
@@ -212,6 +260,7 @@ public:
     OULY_ASSERT(id.value() < nodes_.size() && !started_.load(std::memory_order_acquire));
     if (id.value() < nodes_.size())
     {
+      compiled_ = false;
       if constexpr (ouly::detail::flow_graph_node_id_v<config>)
       {
         if constexpr (std::is_invocable_r_v<void, Func, context_type const&, node_id>)
@@ -253,6 +302,7 @@ public:
     if (id.value() < nodes_.size())
     {
       nodes_[id.value()].remove(task_id);
+      compiled_ = false;
     }
   }
 
@@ -277,9 +327,238 @@ public:
     {
       nodes_[from.value()].add_successor(to.value());
       dependency_counts_[to.value()]++;
+      compiled_ = false;
+    }
+  }
+
+  /**
+   * @brief Create a dependency that also carries a value of type T from `from` to `to`
+   *
+   * Connects the nodes like connect(from, to) and returns a port to a channel of `capacity` slots,
+   * allocated here and reused by every run. A task of `from` pushes one value per run, a task of
+   * `to` pops it; the dependency orders the two. add_source(), add_stage() and add_sink() bind
+   * tasks that do the pushing and popping.
+   *
+   * @note This operation is not thread-safe during graph construction
+   */
+  template <typename T>
+  auto connect(node_id from, node_id to, uint32_t capacity = 1) -> flow_port<T>
+  {
+    OULY_ASSERT(!started_.load(std::memory_order_acquire));
+    connect(from, to);
+    auto channel = std::make_unique<flow_channel<T>>(capacity);
+    auto port    = flow_port<T>(channel.get());
+    channels_.emplace_back(std::move(channel));
+    return port;
+  }
+
+  /**
+   * @brief Add a task that pushes the result of `func(context)` to `out` on every run
+   */
+  template <typename Out, typename Func>
+  auto add_source(node_id id, flow_port<Out> out, Func&& func) -> task_id
+  {
+    return add(id,
+               [out, func = std::forward<Func>(func)](context_type const& ctx) mutable
+               {
+                 out.push(func(ctx));
+               });
+  }
+
+  /**
+   * @brief Add a task that pops a value from `in` and pushes `func(context, value)` to `out`
+   */
+  template <typename In, typename Out, typename Func>
+  auto add_stage(node_id id, flow_port<In> in, flow_port<Out> out, Func&& func) -> task_id
+  {
+    return add(id,
+               [in, out, func = std::forward<Func>(func)](context_type const& ctx) mutable
+               {
+                 out.push(func(ctx, in.pop()));
+               });
+  }
+
+  /**
+   * @brief Add a task that pops a value from `in` and passes it to `func(context, value)`
+   */
+  template <typename In, typename Func>
+  auto add_sink(node_id id, flow_port<In> in, Func&& func) -> task_id
+  {
+    return add(id,
+               [in, func = std::forward<Func>(func)](context_type const& ctx) mutable
+               {
+                 func(ctx, in.pop());
+               });
+  }
+
+  /**
+   * @brief Freeze the graph into an execution plan
+   *
+   * The plan holds the nodes in topological order, the successor lists packed into one array,
+   * the initial dependency and completion counters of all nodes in one array, and one prebound
+   * scheduler delegate per task, laid out so that the tasks of every node, and of all root nodes
+   * sharing a workgroup, are contiguous. start() then resets the counters with a single copy,
+   * submits the roots of each workgroup as one batch (through submit_batch() where the scheduler
+   * has it) and allocates nothing.
+   *
+   * start() compiles on its own when the graph changed since the last compile; calling it
+   * explicitly moves that cost out of the first run.
+   *
+   * @note This operation is not thread-safe and must not overlap a run of the graph
+   */
+  void compile()
+  {
+    OULY_ASSERT(!started_.load(std::memory_order_acquire));
+
+    auto const count = static_cast<uint32_t>(nodes_.size());
+    plan_.nodes_.assign(count, {});
+    plan_.order_.clear();
+    plan_.order_.reserve(count);
+    plan_.root_count_ = 0;
+    plan_.root_batches_.clear();
+    plan_.empty_roots_.clear();
+
+    // Roots first, grouped by workgroup so that their tasks form one batch per group
+    for (uint32_t node = 0; node < count; ++node)
+    {
+      if (dependency_counts_[node] == 0)
+      {
+        plan_.order_.push_back(node);
+      }
+    }
+    std::ranges::stable_sort(plan_.order_,
+                             [this](uint32_t a, uint32_t b)
+                             {
+                               return nodes_[a].get_workgroup().get_index() < nodes_[b].get_workgroup().get_index();
+                             });
+    auto const root_count = static_cast<uint32_t>(plan_.order_.size());
+    plan_.root_count_     = root_count;
+
+    // Kahn's algorithm over the remaining nodes; the live counters double as the in-degree scratch
+    plan_.successor_offsets_.assign(count + 1, 0);
+    plan_.successors_.clear();
+    counters_.assign(dependency_counts_.begin(), dependency_counts_.end());
+    for (uint32_t i = 0; i < plan_.order_.size(); ++i)
+    {
+      for (uint32_t successor : nodes_[plan_.order_[i]].get_successors())
+      {
+        if (--counters_[successor] == 0)
+        {
+          plan_.order_.push_back(successor);
+        }
+      }
+    }
+    OULY_ASSERT(plan_.order_.size() == count && "flow_graph contains a dependency cycle");
+
+    for (uint32_t node = 0; node < count; ++node)
+    {
+      auto successors = nodes_[node].get_successors();
+      plan_.successors_.insert(plan_.successors_.end(), successors.begin(), successors.end());
+      plan_.successor_offsets_[node + 1] = static_cast<uint32_t>(plan_.successors_.size());
+    }
+
+    plan_.dispatch_.clear();
+    for (uint32_t node : plan_.order_)
+    {
+      auto& info        = plan_.nodes_[node];
+      info.first_task_  = static_cast<uint32_t>(plan_.dispatch_.size());
+      auto const& tasks = nodes_[node].get_tasks();
+      for (uint32_t task = 0; task < tasks.size(); ++task)
+      {
+        if (tasks[task])
+        {
+          plan_.dispatch_.emplace_back(delegate_type::bind(
+           [graph = this, node, task](context_type const& ctx)
+           {
+             graph->run_task(node, task, ctx);
+           }));
+        }
+      }
+      info.task_count_ = static_cast<uint32_t>(plan_.dispatch_.size()) - info.first_task_;
+    }
+
+    for (uint32_t i = 0; i < root_count; ++i)
+    {
+      auto const  node = plan_.order_[i];
+      auto const& info = plan_.nodes_[node];
+      if (nodes_[node].is_main_thread_only())
+      {
+        continue;
+      }
+      if (info.task_count_ == 0)
+      {
+        plan_.empty_roots_.push_back(node);
+        continue;
+      }
+      auto const group = nodes_[node].get_workgroup();
+      if (!plan_.root_batches_.empty() && plan_.root_batches_.back().group_ == group &&
+          plan_.root_batches_.back().end_ == info.first_task_)
+      {
+        plan_.root_batches_.back().end_ += info.task_count_;
+      }
+      else
+      {
+        plan_.root_batches_.push_back(
+         {.group_ = group, .begin_ = info.first_task_, .end_ = info.first_task_ + info.task_count_});
+      }
+    }
+
+    // Pending dependencies of every node, followed by the completed task count of every node
+    plan_.initial_counters_.assign(dependency_counts_.begin(), dependency_counts_.end());
+    plan_.initial_counters_.resize(2 * static_cast<std::size_t>(count), 0);
+    counters_.resize(plan_.initial_counters_.size());
+    plan_.total_tasks_ = static_cast<uint32_t>(plan_.dispatch_.size());
+    compiled_          = true;
+
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+    {
+      run_starts_.resize(count, 0);
+      run_times_.resize(count, 0);
+      update_priorities();
     }
   }
 
+  /**
+   * @brief Seed the cost estimate of a node, e.g. with a value saved from an earlier session
+   *
+   * Measured durations are blended into the estimate from the next run on; the ranks use the new
+   * value from the next compile() or start().
+   */
+  void set_cost_estimate(node_id id, std::chrono::nanoseconds cost)
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    OULY_ASSERT(id.value() < nodes_.size() && !started_.load(std::memory_order_acquire));
+    priorities_[id.value()].cost_ = static_cast<uint64_t>(std::max<int64_t>(cost.count(), 1));
+  }
+
+  /**
+   * @brief Cost estimate of a node as of the last compile() or start(), zero before any measurement
+   */
+  [[nodiscard]] auto get_cost_estimate(node_id id) const -> std::chrono::nanoseconds
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    return std::chrono::nanoseconds(static_cast<int64_t>(priorities_[id.value()].cost_));
+  }
+
+  /**
+   * @brief Estimated time from the start of a node to the end of the longest chain it heads, as of
+   * the last compile() or start()
+   */
+  [[nodiscard]] auto get_upward_rank(node_id id) const -> std::chrono::nanoseconds
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    return std::chrono::nanoseconds(static_cast<int64_t>(priorities_[id.value()].rank_));
+  }
+
+  /**
+   * @brief Whether a node was on (or within 1/8 of) the critical path at the last compile() or start()
+   */
+  [[nodiscard]] auto is_on_critical_path(node_id id) const -> bool
+    requires(ouly::detail::flow_graph_critical_path_v<config>)
+  {
+    return priorities_[id.value()].critical_;
+  }
+
   /**
    * @brief Start execution of the flow graph
    *
@@ -294,49 +573,82 @@ public:
    * @note This method calculates total task count dynamically to handle late additions
    */
   void start(context_type const& ctx)
+  {
+    start(ctx, cancellation_token{});
+  }
+
+  /**
+   * @brief Start execution of the flow graph, skipping every task that has not started once `token`
+   * is cancelled
+   *
+   * Skipped tasks still count as completed, so the run drains quickly and wait() returns as usual.
+   * Values left on typed edges by a cancelled run are dropped by the next start().
+   */
+  void start(context_type const& ctx, cancellation_token token)
   {
     OULY_ASSERT(!started_.load(std::memory_order_acquire));
     [[maybe_unused]] bool drain_acquire = done_.try_acquire();
 
-    // mark the thread that initiated start; inline nodes will run here
-    main_worker_id_              = ctx.get_worker();
-    total_inline_nodes_executed_ = 0;
+    if (skipped_tasks_.exchange(false, std::memory_order_relaxed))
+    {
+      for (auto& channel : channels_)
+      {
+        channel->clear();
+      }
+    }
+    cancellation_ = token;
 
-    for (uint32_t node = 0; node < nodes_.size(); ++node)
+    if (!compiled_)
+    {
+      compile();
+    }
+    else if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
     {
-      nodes_[node].reset_dependencies(dependency_counts_[node]);
-      nodes_[node].reset_run_count();
-      nodes_[node].set_already_executed(false);
+      update_priorities();
     }
 
-    uint32_t total_tasks = 0;
-    for (uint32_t i = 0; i < nodes_.size(); ++i)
+    // mark the thread that initiated start; inline nodes will run here
+    main_worker_id_              = ctx.get_worker();
+    total_inline_nodes_executed_ = 0;
+    for (auto node_index : inline_nodes_)
     {
-      total_tasks += nodes_[i].get_valid_task_count();
+      nodes_[node_index].set_already_executed(false);
     }
-    total_tasks_ = total_tasks;
+
+    std::ranges::copy(plan_.initial_counters_, counters_.begin());
+    total_tasks_ = plan_.total_tasks_;
 
     if (total_tasks_ == 0)
     {
       return;
     }
 
-    // Initialize dependency counts and find ready nodes
     remaining_tasks_.store(total_tasks_, std::memory_order_relaxed);
     started_.store(true, std::memory_order_release);
 
-    // Submit all ready nodes (nodes with 0 dependencies)
-    for (uint32_t i = 0; i < nodes_.size(); ++i)
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
     {
-      if (dependency_counts_[i] == 0)
+      // Ready nodes one by one, highest rank last, each into its own lane
+      for (auto node_index : ranked_roots_)
       {
-        // For main-thread nodes, enqueue for inline execution; otherwise submit to scheduler
-        if (!nodes_[i].is_main_thread_only())
+        if (!nodes_[node_index].is_main_thread_only())
         {
-          execute_node(i, ctx);
+          execute_node(node_index, ctx);
         }
       }
     }
+    else
+    {
+      // Submit the tasks of all ready nodes, one batch per workgroup; main-thread nodes run inline
+      for (auto const& batch : plan_.root_batches_)
+      {
+        submit_tasks(batch.group_, batch.begin_, batch.end_, false, ctx);
+      }
+      for (auto node_index : plan_.empty_roots_)
+      {
+        notify_successors(node_index, ctx);
+      }
+    }
 
     poll_inline_nodes(ctx);
   }
@@ -351,7 +663,7 @@ public:
     for (auto node_index : inline_nodes_)
     {
       auto& node = nodes_[node_index];
-      if (!node.is_already_executed() && !node.has_pending_dependencies())
+      if (!node.is_already_executed() && pending_dependencies(node_index).load(std::memory_order_acquire) == 0)
       {
         execute_node_inline(node_index, ctx);
       }
@@ -434,28 +746,8 @@ private:
 
     explicit task_node(workgroup_id group) noexcept : workgroup_(group) {}
 
-    /// Custom move constructor to handle atomic members properly
-    task_node(task_node&& other) noexcept
-        : workgroup_(other.workgroup_), tasks_(std::move(other.tasks_)), next_nodes_(std::move(other.next_nodes_)),
-          pending_dependencies_(other.pending_dependencies_.load(std::memory_order_relaxed)),
-          is_main_thread_only_(other.is_main_thread_only_), is_already_executed_(other.is_already_executed_)
-    {}
-
-    /// Custom move assignment operator for atomic member handling
-    auto operator=(task_node&& other) noexcept -> task_node&
-    {
-      if (this != &other)
-      {
-        workgroup_  = other.workgroup_;
-        tasks_      = std::move(other.tasks_);
-        next_nodes_ = std::move(other.next_nodes_);
-        pending_dependencies_.store(other.pending_dependencies_.load(std::memory_order_relaxed),
-                                    std::memory_order_relaxed);
-        is_main_thread_only_ = other.is_main_thread_only_;
-        is_already_executed_ = other.is_already_executed_;
-      }
-      return *this;
-    }
+    task_node(task_node&&) noexcept                    = default;
+    auto operator=(task_node&&) noexcept -> task_node& = default;
 
     // Delete copy operations - nodes should not be copied
     task_node(const task_node&)                    = delete;
@@ -540,33 +832,11 @@ private:
       return {tasks_.data(), tasks_.size()};
     }
 
-    /// Reset dependency count for graph reuse
-    void reset_dependencies(uint32_t count) noexcept
-    {
-      pending_dependencies_.store(count, std::memory_order_relaxed);
-    }
-
-    /// Reset task execution count for graph reuse
-    void reset_run_count() noexcept
-    {
-      run_count_.store(0, std::memory_order_relaxed);
-    }
-
-    /// Atomically decrement dependency count and return new value
-    auto decrement_dependencies() noexcept -> uint32_t
-    {
-      return pending_dependencies_.fetch_sub(1, std::memory_order_acq_rel) - 1;
-    }
-
-    /// Check if this node still has pending dependencies
-    [[nodiscard]] auto has_pending_dependencies() const noexcept -> bool
-    {
-      return pending_dependencies_.load(std::memory_order_acquire) > 0;
-    }
-
-    /// Execute a specific task by index and return completion status
-    auto execute_task(uint32_t node_index, uint32_t task_index, context_type const& ctx) noexcept -> bool
+    /// Execute a specific task by index
+    void execute_task(uint32_t node_index, uint32_t task_index, context_type const& ctx) noexcept
     {
+      ouly::trace_scope trace(ctx.get_scheduler().get_trace_recorder(), ctx.get_worker(), workgroup_,
+                              "flow_graph.node", node_index);
       if constexpr (ouly::detail::flow_graph_node_id_v<config>)
       {
         tasks_[task_index](ctx, node_id{node_index});
@@ -575,9 +845,6 @@ private:
       {
         tasks_[task_index](ctx);
       }
-      // Check if this is the last task in this node to complete
-      auto completed_count = run_count_.fetch_add(1, std::memory_order_acq_rel) + 1;
-      return (completed_count == valid_task_count_);
     }
 
     /// Get the number of valid tasks in this node
@@ -595,65 +862,257 @@ private:
   private:
     workgroup_id                              workgroup_{default_workgroup_id}; ///< Workgroup for task execution
     uint32_t                                  valid_task_count_ = 0;
-    std::vector<task_delegate_type>           tasks_;                   ///< Tasks to execute in this node
-    ouly::small_vector<uint32_t, AvgDepCount> next_nodes_;              ///< Successor node IDs
-    std::atomic<uint32_t>                     pending_dependencies_{0}; ///< Number of unfinished dependencies
-    std::atomic_uint32_t                      run_count_{0};            ///< Completed task count in this node
+    std::vector<task_delegate_type>           tasks_;      ///< Tasks to execute in this node
+    ouly::small_vector<uint32_t, AvgDepCount> next_nodes_; ///< Successor node IDs
     bool                                      is_main_thread_only_{false};
     bool                                      is_already_executed_{false};
   };
 
+  /// Per-node entry of the execution plan
+  struct plan_node
+  {
+    uint32_t first_task_ = 0; ///< First of the node's prebound delegates in execution_plan::dispatch_
+    uint32_t task_count_ = 0; ///< Number of valid tasks of the node
+  };
+
+  /// Contiguous range of root tasks sharing a workgroup, submitted as one batch
+  struct root_batch
+  {
+    workgroup_id group_;
+    uint32_t     begin_ = 0;
+    uint32_t     end_   = 0;
+  };
+
+  /// Cost model of a node, see cfg::flow_graph_critical_path
+  struct node_priority
+  {
+    uint64_t cost_     = 0; ///< Moving average of the measured duration in ns, 0 until measured or seeded
+    uint64_t estimate_ = 0; ///< cost_, or a guess for nodes without one
+    uint64_t rank_     = 0; ///< estimate_ plus the largest rank_ of the successors
+    uint64_t top_      = 0; ///< Longest path from a root to the start of the node
+    bool     critical_ = false;
+  };
+
+  /// Immutable result of compile(), see there
+  struct execution_plan
+  {
+    std::vector<plan_node>     nodes_;             ///< Indexed by node
+    std::vector<uint32_t>      order_;             ///< Nodes in topological order, roots first
+    uint32_t                   root_count_ = 0;    ///< Number of roots leading order_
+    std::vector<uint32_t>      successor_offsets_; ///< Successors of node n are successors_[offsets[n], offsets[n+1])
+    std::vector<uint32_t>      successors_;        ///< Packed successor lists
+    std::vector<uint32_t>      initial_counters_;  ///< Copied into counters_ by start()
+    std::vector<delegate_type> dispatch_;          ///< One prebound scheduler delegate per task
+    std::vector<root_batch>    root_batches_;      ///< Root tasks grouped by workgroup
+    std::vector<uint32_t>      empty_roots_;       ///< Roots without tasks, completed by start()
+    uint32_t                   total_tasks_ = 0;
+  };
+
   // Graph state
   ouly::small_vector<task_node, AvgNodeCount> nodes_;             ///< All nodes in the graph
   ouly::small_vector<uint32_t, AvgNodeCount>  dependency_counts_; ///< Initial dependency count per node
   ouly::small_vector<uint32_t, AvgNodeCount>  inline_nodes_;      ///< Temporary storage for dependency updates
   uint32_t                                    total_tasks_{0};    ///< Total number of tasks across all nodes
 
+  execution_plan        plan_;                           ///< Valid while compiled_ is set
+  std::vector<uint32_t> counters_;                       ///< Live counters, accessed through std::atomic_ref
+  bool                  compiled_{false};                ///< Cleared by every graph modification
   uint32_t              total_inline_nodes_executed_{0}; ///< Total number of inline nodes executed
   std::atomic<uint32_t> remaining_tasks_{0};             ///< Remaining unfinished tasks
   std::atomic_bool      started_{false};                 ///< Whether graph execution has started
   std::binary_semaphore done_{0};                        ///< Signaled when all tasks complete
   worker_id             main_worker_id_;
+  cancellation_token    cancellation_;                   ///< Of the current or last run
+  std::atomic_bool      skipped_tasks_{false};           ///< A cancelled run may have left values on typed edges
+
+  // Critical path state, used with cfg::flow_graph_critical_path only
+  std::vector<node_priority> priorities_;        ///< Indexed by node
+  std::vector<int64_t>       run_starts_;        ///< Start of each node's first task in the current run
+  std::vector<int64_t>       run_times_;         ///< Duration of each node in the current run, 0 if it did not run
+  std::vector<uint32_t>      ranked_roots_;      ///< Roots by ascending rank
+  std::vector<uint32_t>      ranked_successors_; ///< plan_.successors_ with every list by ascending rank
+
+  std::vector<std::unique_ptr<ouly::detail::flow_channel_base>> channels_; ///< Buffers of the typed edges
+
+  [[nodiscard]] auto pending_dependencies(uint32_t node_index) noexcept -> std::atomic_ref<uint32_t>
+  {
+    return std::atomic_ref<uint32_t>(counters_[node_index]);
+  }
+
+  [[nodiscard]] auto completed_tasks(uint32_t node_index) noexcept -> std::atomic_ref<uint32_t>
+  {
+    return std::atomic_ref<uint32_t>(counters_[nodes_.size() + node_index]);
+  }
+
+  /// Fold the last run's measurements into the cost estimates, rank the nodes and order the roots
+  /// and every successor list by ascending rank; the plan itself is left untouched
+  void update_priorities()
+  {
+    auto const count          = static_cast<uint32_t>(nodes_.size());
+    uint64_t   measured_cost  = 0;
+    uint64_t   measured_tasks = 0;
+    for (uint32_t node = 0; node < count; ++node)
+    {
+      auto& priority = priorities_[node];
+      if (run_times_[node] != 0)
+      {
+        priority.cost_ = ouly::detail::blend_cost(priority.cost_, run_times_[node]);
+      }
+      run_starts_[node] = 0;
+      run_times_[node]  = 0;
+      if (priority.cost_ != 0)
+      {
+        measured_cost += priority.cost_;
+        measured_tasks += plan_.nodes_[node].task_count_;
+      }
+    }
+
+    // Nodes that never ran cost what an average measured task costs, per task
+    uint64_t const task_cost = measured_tasks != 0 ? std::max<uint64_t>(measured_cost / measured_tasks, 1) : 1;
+    for (auto node : std::views::reverse(plan_.order_))
+    {
+      auto& priority     = priorities_[node];
+      priority.estimate_ = priority.cost_ != 0 ? priority.cost_ : task_cost * plan_.nodes_[node].task_count_;
+      uint64_t longest   = 0;
+      for (uint32_t i = plan_.successor_offsets_[node]; i < plan_.successor_offsets_[node + 1]; ++i)
+      {
+        longest = std::max(longest, priorities_[plan_.successors_[i]].rank_);
+      }
+      priority.rank_ = priority.estimate_ + longest;
+      priority.top_  = 0;
+    }
+
+    uint64_t critical_path = 0;
+    for (auto node : plan_.order_)
+    {
+      auto const& priority = priorities_[node];
+      critical_path        = std::max(critical_path, priority.top_ + priority.rank_);
+      for (uint32_t i = plan_.successor_offsets_[node]; i < plan_.successor_offsets_[node + 1]; ++i)
+      {
+        auto& top = priorities_[plan_.successors_[i]].top_;
+        top       = std::max(top, priority.top_ + priority.estimate_);
+      }
+    }
+
+    auto const by_rank = [this](uint32_t a, uint32_t b)
+    {
+      return priorities_[a].rank_ < priorities_[b].rank_;
+    };
+    ranked_successors_.assign(plan_.successors_.begin(), plan_.successors_.end());
+    for (uint32_t node = 0; node < count; ++node)
+    {
+      auto& priority     = priorities_[node];
+      priority.critical_ =
+       critical_path != 0 && ouly::detail::is_near_critical(priority.top_ + priority.rank_, critical_path);
+      std::sort(ranked_successors_.begin() + plan_.successor_offsets_[node],
+                ranked_successors_.begin() + plan_.successor_offsets_[node + 1], by_rank);
+    }
+    ranked_roots_.assign(plan_.order_.begin(), plan_.order_.begin() + plan_.root_count_);
+    std::ranges::stable_sort(ranked_roots_, by_rank);
+  }
+
+  void mark_started(uint32_t node_index) noexcept
+  {
+    auto started = std::atomic_ref<int64_t>(run_starts_[node_index]);
+    if (int64_t expected = 0; started.load(std::memory_order_relaxed) == expected)
+    {
+      started.compare_exchange_strong(expected, ouly::detail::flow_graph_clock(), std::memory_order_relaxed);
+    }
+  }
+
+  /// Submit the prebound delegates [begin, end) to `group`, into the critical lane where supported
+  void submit_tasks(workgroup_id group, uint32_t begin, uint32_t end, bool critical, context_type const& ctx)
+  {
+    auto  tasks     = std::span<delegate_type const>(plan_.dispatch_).subspan(begin, end - begin);
+    auto& scheduler = ctx.get_scheduler();
+    if constexpr (requires { typename SchedulerType::lane_type; })
+    {
+      using lane_type = typename SchedulerType::lane_type;
+      scheduler.submit_batch(ctx, group, tasks, critical ? lane_type::critical : lane_type::normal);
+    }
+    else if constexpr (requires { scheduler.submit_batch(ctx, group, tasks); })
+    {
+      scheduler.submit_batch(ctx, group, tasks);
+    }
+    else
+    {
+      for (uint32_t i = begin; i < end; ++i)
+      {
+        scheduler.submit(ctx, group,
+                         [graph_ptr = this, i](context_type const& task_ctx)
+                         {
+                           graph_ptr->plan_.dispatch_[i](task_ctx);
+                         });
+      }
+    }
+  }
+
+  /// Body of every scheduled task: run it, then complete its node and the graph as needed
+  void run_task(uint32_t node_index, uint32_t task_index, context_type const& ctx)
+  {
+    if (!skip_cancelled())
+    {
+      if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+      {
+        mark_started(node_index);
+      }
+      nodes_[node_index].execute_task(node_index, task_index, ctx);
+    }
+    complete_task(node_index, ctx);
+  }
+
+  /// Whether the run was cancelled, in which case the calling task is skipped
+  auto skip_cancelled() noexcept -> bool
+  {
+    if (!cancellation_.is_cancelled())
+    {
+      return false;
+    }
+    skipped_tasks_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  void complete_task(uint32_t node_index, context_type const& ctx)
+  {
+    if (completed_tasks(node_index).fetch_add(1, std::memory_order_acq_rel) + 1 ==
+        plan_.nodes_[node_index].task_count_)
+    {
+      // Last task in this node, notify successors
+      if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+      {
+        // A node whose tasks were all cancelled did not run
+        auto const started = std::atomic_ref<int64_t>(run_starts_[node_index]).load(std::memory_order_relaxed);
+        if (started != 0)
+        {
+          run_times_[node_index] = std::max<int64_t>(ouly::detail::flow_graph_clock() - started, 1);
+        }
+      }
+      notify_successors(node_index, ctx);
+    }
+    // Each task decrements the global task count
+    if (remaining_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      signal_done();
+    }
+  }
 
   /// Execute all tasks in a specific node
   void execute_node(uint32_t node_index, context_type const& ctx)
   {
-    auto& node      = nodes_[node_index];
-    auto  tasks     = node.get_tasks();
-    auto  workgroup = node.get_workgroup();
-
-    if (node.has_no_tasks())
+    auto const& info = plan_.nodes_[node_index];
+    if (info.task_count_ == 0)
     {
       // Node has no tasks, just notify successors
       notify_successors(node_index, ctx);
       return;
     }
-
-    // Submit all tasks for this node
-    for (uint32_t i = 0; i < tasks.size(); ++i)
+    bool critical = false;
+    if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
     {
-      if (!tasks[i])
-      {
-        continue; // Skip empty tasks
-      }
-      // Create a simple lambda that captures minimal data
-      auto* graph_ptr = this;
-      ctx.get_scheduler().submit(ctx, workgroup,
-                                 [graph_ptr, node_index, i](context_type const& task_ctx) mutable
-                                 {
-                                   // Execute the actual task
-                                   if (graph_ptr->nodes_[node_index].execute_task(node_index, i, task_ctx))
-                                   {
-                                     // Last task in this node, notify successors
-                                     graph_ptr->notify_successors(node_index, task_ctx);
-                                   }
-                                   // Each task decrements the global task count
-                                   if (graph_ptr->remaining_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1)
-                                   {
-                                     graph_ptr->signal_done();
-                                   }
-                                 });
+      critical = priorities_[node_index].critical_;
     }
+    submit_tasks(nodes_[node_index].get_workgroup(), info.first_task_, info.first_task_ + info.task_count_, critical,
+                 ctx);
   }
 
   // Execute a node's tasks inline on the main/start thread
@@ -665,7 +1124,7 @@ private:
     total_inline_nodes_executed_++;
     node.set_already_executed();
 
-    if (node.has_no_tasks())
+    if (plan_.nodes_[node_index].task_count_ == 0)
     {
       notify_successors(node_index, ctx);
       // no remaining_tasks_ change for empty nodes
@@ -679,15 +1138,15 @@ private:
         continue;
       }
       // Execute sequentially
-      bool is_last = node.execute_task(node_index, i, ctx);
-      if (remaining_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1)
-      {
-        signal_done();
-      }
-      if (is_last)
+      if (!skip_cancelled())
       {
-        notify_successors(node_index, ctx);
+        if constexpr (ouly::detail::flow_graph_critical_path_v<config>)
+        {
+          mark_started(node_index);
+        }
+        node.execute_task(node_index, i, ctx);
       }
+      complete_task(node_index, ctx);
     }
   }
 
@@ -709,28 +1168,17 @@ private:
   /// Notify successor nodes when a node completes
   void notify_successors(uint32_t node_index, context_type const& ctx)
   {
-    if (node_index >= nodes_.size())
+    auto const  first      = plan_.successor_offsets_[node_index];
+    auto const  last       = plan_.successor_offsets_[node_index + 1];
+    auto const& successors = ouly::detail::flow_graph_critical_path_v<config> ? ranked_successors_ : plan_.successors_;
+    for (uint32_t i = first; i < last; ++i)
     {
-      return;
-    }
-
-    auto& node       = nodes_[node_index];
-    auto  successors = node.get_successors();
-
-    // Notify all successor nodes
-    for (uint32_t successor_id : successors)
-    {
-      if (successor_id < nodes_.size())
+      auto const successor_id = successors[i];
+      // All dependencies satisfied; main-thread nodes are picked up by poll_inline_nodes()
+      if (pending_dependencies(successor_id).fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+          !nodes_[successor_id].is_main_thread_only())
       {
-        auto& successor = nodes_[successor_id];
-        if (successor.decrement_dependencies() == 0)
-        {
-          // All dependencies satisfied
-          if (!successor.is_main_thread_only())
-          {
-            execute_node(successor_id, ctx);
-          }
-        }
+        execute_node(successor_id, ctx);
       }
     }
   }
@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
 namespace ouly::cfg
 {
 
@@ -17,6 +21,21 @@ struct flow_graph_node_id
   static constexpr bool flow_graph_node_id_v = true;
 };
 
+/**
+ * @brief Dispatch flow-graph nodes on the critical path first.
+ *
+ * When this option is present the graph measures how long every node takes (from the start of its
+ * first task to the end of its last task) and keeps an exponentially weighted moving average of it
+ * per node. From those estimates it derives each node's upward rank, the estimated time from the
+ * node's start to the end of the longest chain it heads. Nodes readied together are dispatched in
+ * descending rank order, and with a scheduler that has priority lanes (v3) the nodes on the
+ * critical path go to the critical lane. Without the option no timing is taken.
+ */
+struct flow_graph_critical_path
+{
+  static constexpr bool flow_graph_critical_path_v = true;
+};
+
 } // namespace ouly::cfg
 
 namespace ouly::detail
@@ -35,6 +54,49 @@ inline constexpr bool flow_graph_node_id_v = []
   }
 }();
 
+template <typename Config>
+inline constexpr bool flow_graph_critical_path_v = []
+{
+  if constexpr (requires { Config::flow_graph_critical_path_v; })
+  {
+    return Config::flow_graph_critical_path_v;
+  }
+  else
+  {
+    return false;
+  }
+}();
+
+/// A new measurement moves a cost estimate by 1/flow_graph_cost_smoothing of the difference
+constexpr int64_t flow_graph_cost_smoothing = 4;
+/// A node is critical when its longest path is within 1/flow_graph_critical_slack of the longest one
+constexpr uint64_t flow_graph_critical_slack = 8;
+
+[[nodiscard]] inline auto flow_graph_clock() noexcept -> int64_t
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+   .count();
+}
+
+/// Fold one measured duration into a cost estimate; 0 means not measured yet
+[[nodiscard]] inline auto blend_cost(uint64_t estimate, int64_t sample) noexcept -> uint64_t
+{
+  auto const value = static_cast<uint64_t>(std::max<int64_t>(sample, 1));
+  if (estimate == 0)
+  {
+    return value;
+  }
+  auto const current = static_cast<int64_t>(estimate);
+  return static_cast<uint64_t>(
+   std::max<int64_t>(current + ((static_cast<int64_t>(value) - current) / flow_graph_cost_smoothing), 1));
+}
+
+/// Whether a path of length `path` is close enough to the longest path `longest` to be critical
+[[nodiscard]] constexpr auto is_near_critical(uint64_t path, uint64_t longest) noexcept -> bool
+{
+  return path * flow_graph_critical_slack >= longest * (flow_graph_critical_slack - 1);
+}
+
 template <bool WithNodeId, typename Delegate, typename Context, typename NodeId>
 struct flow_graph_delegate
 {
@@ -1,6 +1,7 @@
 #pragma once
 // SPDX-License-Identifier: MIT
 
+#include "ouly/scheduler/affinity_partitioner.hpp"
 #include "ouly/scheduler/auto_parallel_for.hpp"
 #include "ouly/scheduler/default_parallel_for.hpp"
 
@@ -17,4 +18,14 @@ void parallel_for(L lambda, FwIt&& range, WC const& this_context, Traits /*unuse
 
   default_parallel_for(lambda, std::forward<FwIt>(range), this_context, Traits{});
 }
+
+/**
+ * @brief parallel_for that replays the chunk-to-worker assignment `partitioner` recorded on its
+ * previous call, see basic_affinity_partitioner.
+ */
+template <typename L, typename FwIt, TaskContext WC, typename Traits>
+void parallel_for(L lambda, FwIt&& range, WC const& this_context, basic_affinity_partitioner<Traits>& partitioner)
+{
+  partitioner.execute(lambda, std::forward<FwIt>(range), this_context);
+}
 } // namespace ouly
\ No newline at end of file
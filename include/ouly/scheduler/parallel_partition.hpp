@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/chunked_range.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ouly
+{
+
+namespace detail
+{
+
+struct index_run
+{
+  uint32_t begin_ = 0;
+  uint32_t end_   = 0;
+  uint32_t rank_  = 0; // Number of elements in the runs before this one
+};
+
+/**
+ * @brief Position of the `rank`-th element across `runs`, and a cursor to step through the
+ * following ones.
+ */
+class run_cursor
+{
+public:
+  run_cursor(std::vector<index_run> const& runs, uint32_t rank) noexcept
+      : run_(std::upper_bound(runs.begin(), runs.end(), rank,
+                              [](uint32_t r, index_run const& run)
+                              {
+                                return r < run.rank_;
+                              }) -
+             1)
+  {
+    position_ = run_->begin_ + (rank - run_->rank_);
+  }
+
+  [[nodiscard]] auto position() const noexcept -> uint32_t
+  {
+    return position_;
+  }
+
+  void next() noexcept
+  {
+    if (++position_ == run_->end_)
+    {
+      ++run_;
+      position_ = run_->begin_;
+    }
+  }
+
+private:
+  std::vector<index_run>::const_iterator run_;
+  uint32_t                               position_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Reorder [first, last) so that the elements satisfying `pred` come first, in parallel.
+ *
+ * Every chunk is partitioned in place in parallel. Afterwards the only misplaced elements are the
+ * chunk-local `false` runs left of the partition point and the `true` runs right of it; both hold
+ * the same number of elements, and they are swapped pairwise in parallel. Needs no scratch buffer.
+ * Relative order is not preserved.
+ *
+ * @return Iterator to the first element of the second group
+ */
+template <std::random_access_iterator It, typename Pred, TaskContext WC, typename Traits = auto_partitioner_traits>
+auto parallel_partition(It first, It last, Pred pred, WC const& this_context, Traits /*traits*/ = {}) -> It
+{
+  using traits     = detail::min_chunk_traits<Traits>;
+  auto const count = static_cast<uint32_t>(last - first);
+  auto const plan  = detail::make_chunk_plan<traits>(count);
+  if (plan.chunk_count_ <= 1)
+  {
+    return std::partition(first, last, pred);
+  }
+
+  std::vector<detail::cache_optimized_data<uint32_t>> selected(plan.chunk_count_);
+  detail::for_each_chunk<traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     auto const chunk_first = detail::advance_by(first, begin);
+     ouly::detail::vector_access(selected, chunk).get() =
+      static_cast<uint32_t>(std::partition(chunk_first, detail::advance_by(first, end), pred) - chunk_first);
+   },
+   this_context);
+
+  uint32_t split = 0;
+  for (auto const& s : selected)
+  {
+    split += s.get();
+  }
+
+  std::vector<detail::index_run> misplaced_false;
+  std::vector<detail::index_run> misplaced_true;
+  uint32_t                       misplaced = 0;
+  uint32_t                       rank_true = 0;
+  for (uint32_t chunk = 0; chunk < plan.chunk_count_; ++chunk)
+  {
+    auto const begin      = plan.begin(chunk);
+    auto const end        = plan.end(chunk);
+    auto const false_from = begin + ouly::detail::vector_access(selected, chunk).get();
+    if (false_from < std::min(end, split))
+    {
+      misplaced_false.push_back({.begin_ = false_from, .end_ = std::min(end, split), .rank_ = misplaced});
+      misplaced += std::min(end, split) - false_from;
+    }
+    if (std::max(begin, split) < false_from)
+    {
+      misplaced_true.push_back({.begin_ = std::max(begin, split), .end_ = false_from, .rank_ = rank_true});
+      rank_true += false_from - std::max(begin, split);
+    }
+  }
+
+  detail::for_each_chunk<traits>(
+   detail::make_chunk_plan<traits>(misplaced),
+   [&](uint32_t /*chunk*/, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     detail::run_cursor left(misplaced_false, begin);
+     detail::run_cursor right(misplaced_true, begin);
+     for (uint32_t i = begin; i < end; ++i)
+     {
+       std::iter_swap(detail::advance_by(first, left.position()), detail::advance_by(first, right.position()));
+       if (i + 1 < end)
+       {
+         left.next();
+         right.next();
+       }
+     }
+   },
+   this_context);
+
+  return detail::advance_by(first, split);
+}
+
+/**
+ * @brief Reorder [first, last) so that the elements satisfying `pred` come first, preserving the
+ * relative order within both groups, in parallel.
+ *
+ * `pred` is evaluated once per element while counting each chunk's selection; the chunk counts are
+ * prefix-summed in order and every chunk then scatters its elements into a scratch buffer, which is
+ * moved back in parallel. The value type must be default constructible and movable.
+ *
+ * @return Iterator to the first element of the second group
+ */
+template <std::random_access_iterator It, typename Pred, TaskContext WC, typename Traits = auto_partitioner_traits>
+auto parallel_stable_partition(It first, It last, Pred pred, WC const& this_context, Traits /*traits*/ = {}) -> It
+{
+  using traits     = detail::min_chunk_traits<Traits>;
+  using value_type = std::iter_value_t<It>;
+  auto const count = static_cast<uint32_t>(last - first);
+  auto const plan  = detail::make_chunk_plan<traits>(count);
+  if (plan.chunk_count_ <= 1)
+  {
+    return std::stable_partition(first, last, pred);
+  }
+
+  std::vector<uint8_t>                                flags(count);
+  std::vector<detail::cache_optimized_data<uint32_t>> selected(plan.chunk_count_);
+  detail::for_each_chunk<traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     uint32_t chosen = 0;
+     for (uint32_t i = begin; i < end; ++i)
+     {
+       bool const flag                       = std::invoke(pred, *detail::advance_by(first, i));
+       ouly::detail::vector_access(flags, i) = flag ? 1 : 0;
+       chosen += flag ? 1 : 0;
+     }
+     ouly::detail::vector_access(selected, chunk).get() = chosen;
+   },
+   this_context);
+
+  // Exclusive prefix of the selections; false elements of a chunk follow all selected elements
+  uint32_t split = 0;
+  for (auto& s : selected)
+  {
+    split += std::exchange(s.get(), split);
+  }
+
+  std::vector<value_type> buffer(count);
+  detail::for_each_chunk<traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     uint32_t chosen   = ouly::detail::vector_access(selected, chunk).get();
+     uint32_t rejected = split + (begin - chosen);
+     for (uint32_t i = begin; i < end; ++i)
+     {
+       auto& target = ouly::detail::vector_access(flags, i) != 0 ? chosen : rejected;
+       ouly::detail::vector_access(buffer, target++) = std::move(*detail::advance_by(first, i));
+     }
+   },
+   this_context);
+
+  detail::move_chunks<traits>(plan, buffer.begin(), first, this_context);
+  return detail::advance_by(first, split);
+}
+
+} // namespace ouly
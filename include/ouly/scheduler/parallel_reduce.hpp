@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/chunked_range.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ouly
+{
+
+namespace detail
+{
+
+/**
+ * @brief Fold [first, last) into `acc`.
+ *
+ * `map` is either a range mapper `map(first, last, ctx) -> T` producing the partial of the whole
+ * subrange, or an element mapper `map(element, ctx)` / `map(element)` whose results are combined
+ * left to right.
+ */
+template <typename T, typename It, typename Map, typename Combine, TaskContext WC>
+void fold_range(T& acc, It first, It last, Map& map, Combine& combine, WC const& ctx)
+{
+  if constexpr (std::invocable<Map&, It, It, WC const&>)
+  {
+    acc = std::invoke(combine, std::move(acc), std::invoke(map, first, last, ctx));
+  }
+  else
+  {
+    for (; first != last; ++first)
+    {
+      if constexpr (std::invocable<Map&, decltype(element_at(first)), WC const&>)
+      {
+        acc = std::invoke(combine, std::move(acc), std::invoke(map, element_at(first), ctx));
+      }
+      else
+      {
+        acc = std::invoke(combine, std::move(acc), std::invoke(map, element_at(first)));
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Map every element of `range` and reduce the results with `combine`, in parallel.
+ *
+ * The range is cut into chunks by a plan that depends only on its size and `Traits`, and the chunks
+ * are spread over the workers with the same range_pool splitting auto_parallel_for uses. Each chunk
+ * folds into its own cache-line padded partial, starting from `identity`; the partials are then
+ * combined in chunk order on the calling thread. The association of `combine` is therefore the
+ * same on every run, whatever the worker count or the stealing, which makes floating point
+ * reductions reproducible. `combine` needs to be associative only, not commutative.
+ *
+ * Integral ranges (e.g. `ouly::subrange<uint32_t>`) pass the index as the element.
+ *
+ * @param range    Random access range (or integral subrange) to reduce
+ * @param identity Identity element of `combine`, the result for an empty range
+ * @param map      `map(element, ctx)`, `map(element)`, or `map(first, last, ctx)` for a subrange
+ * @param combine  `combine(T, T) -> T`
+ */
+template <typename Range, typename T, typename Map, typename Combine, TaskContext WC,
+          typename Traits = auto_partitioner_traits>
+[[nodiscard]] auto parallel_reduce(Range&& range, T identity, Map map, Combine combine, WC const& this_context,
+                                   Traits /*traits*/ = {}) -> T
+{
+  auto const first = std::begin(range);
+  auto const plan  = detail::make_chunk_plan<Traits>(ouly::detail::it_size_type<Range>::size(range));
+  if (plan.chunk_count_ == 0)
+  {
+    return identity;
+  }
+
+  std::vector<detail::cache_optimized_data<T>> partials(plan.chunk_count_, detail::cache_optimized_data<T>(identity));
+  detail::for_each_chunk<Traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& ctx)
+   {
+     detail::fold_range(ouly::detail::vector_access(partials, chunk).get(), detail::advance_by(first, begin),
+                        detail::advance_by(first, end), map, combine, ctx);
+   },
+   this_context);
+
+  T result = std::move(identity);
+  for (auto& partial : partials)
+  {
+    result = std::invoke(combine, std::move(result), std::move(partial.get()));
+  }
+  return result;
+}
+
+} // namespace ouly
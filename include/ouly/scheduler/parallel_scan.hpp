@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/chunked_range.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ouly
+{
+
+enum class scan_kind : uint8_t
+{
+  /** @brief out[i] = in[0] + ... + in[i] */
+  inclusive,
+  /** @brief out[0] = identity, out[i] = in[0] + ... + in[i - 1] */
+  exclusive
+};
+
+/**
+ * @brief Prefix-combine `range` into `out`, in parallel.
+ *
+ * Runs in three steps over the same fixed chunk plan parallel_reduce uses: every chunk reduces
+ * into its own cache-line padded partial, the partials are prefix-combined in chunk order on the
+ * calling thread, and every chunk then rescans its elements starting from its prefix and writes the
+ * output. Each output is therefore the same association of `combine` on every run, independent of
+ * the worker count, which keeps floating point scans reproducible. `combine` needs to be
+ * associative only.
+ *
+ * `out` may alias the beginning of `range` for an in-place scan.
+ *
+ * @param range    Random access range (or integral subrange) to scan
+ * @param out      Random access iterator to the first output element
+ * @param identity Identity element of `combine`
+ * @param combine  `combine(T, element) -> T`, also used as `combine(T, T) -> T` on chunk partials
+ * @param kind     Inclusive or exclusive scan
+ */
+template <typename Range, typename OutIt, typename T, typename Combine, TaskContext WC,
+          typename Traits = auto_partitioner_traits>
+void parallel_scan(Range&& range, OutIt out, T identity, Combine combine, WC const& this_context,
+                   scan_kind kind = scan_kind::inclusive, Traits /*traits*/ = {})
+{
+  auto const first = std::begin(range);
+  auto const plan  = detail::make_chunk_plan<Traits>(ouly::detail::it_size_type<Range>::size(range));
+  if (plan.chunk_count_ == 0)
+  {
+    return;
+  }
+
+  std::vector<detail::cache_optimized_data<T>> partials(plan.chunk_count_, detail::cache_optimized_data<T>(identity));
+
+  // The last chunk's total never feeds another chunk
+  if (plan.chunk_count_ > 1)
+  {
+    auto const reduced_plan = detail::chunk_plan{.count_       = plan.begin(plan.chunk_count_ - 1),
+                                                 .chunk_size_  = plan.chunk_size_,
+                                                 .chunk_count_ = plan.chunk_count_ - 1};
+    detail::for_each_chunk<Traits>(
+     reduced_plan,
+     [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+     {
+       auto& acc = ouly::detail::vector_access(partials, chunk).get();
+       for (auto it = detail::advance_by(first, begin), last = detail::advance_by(first, end); it != last; ++it)
+       {
+         acc = std::invoke(combine, std::move(acc), detail::element_at(it));
+       }
+     },
+     this_context);
+  }
+
+  // Turn the chunk totals into the exclusive prefix each chunk starts from
+  T carry = std::move(identity);
+  for (auto& partial : partials)
+  {
+    T next        = std::invoke(combine, carry, std::move(partial.get()));
+    partial.get() = std::move(carry);
+    carry         = std::move(next);
+  }
+
+  detail::for_each_chunk<Traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     T    acc = ouly::detail::vector_access(partials, chunk).get();
+     auto dst = detail::advance_by(out, begin);
+     for (auto it = detail::advance_by(first, begin), last = detail::advance_by(first, end); it != last; ++it, ++dst)
+     {
+       if (kind == scan_kind::inclusive)
+       {
+         acc  = std::invoke(combine, std::move(acc), detail::element_at(it));
+         *dst = acc;
+       }
+       else
+       {
+         // Read the element before writing so in-place scans see the input
+         T next = std::invoke(combine, acc, detail::element_at(it));
+         *dst   = std::move(acc);
+         acc    = std::move(next);
+       }
+     }
+   },
+   this_context);
+}
+
+} // namespace ouly
@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/chunked_range.hpp"
+#include "ouly/utility/user_config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly
+{
+
+/**
+ * @brief Keys parallel_sort orders with a radix sort: integers (bar bool), float and double.
+ */
+template <typename K>
+concept RadixSortKey = (std::integral<K> && !std::same_as<K, bool>) ||
+                       (std::floating_point<K> && (sizeof(K) == sizeof(uint32_t) || sizeof(K) == sizeof(uint64_t)));
+
+namespace detail
+{
+
+template <typename K>
+using radix_bits_t = std::conditional_t<std::floating_point<K>,
+                                        std::conditional_t<sizeof(K) == sizeof(uint32_t), uint32_t, uint64_t>,
+                                        std::make_unsigned_t<std::conditional_t<std::floating_point<K>, int, K>>>;
+
+/**
+ * @brief Map a key to an unsigned integer with the same order. Negative floats compare below
+ * positive ones, -0.0 below +0.0, and NaNs sort to the ends according to their sign.
+ */
+template <RadixSortKey K>
+[[nodiscard]] constexpr auto to_radix_bits(K key) noexcept -> radix_bits_t<K>
+{
+  using bits_type              = radix_bits_t<K>;
+  constexpr bits_type sign_bit = bits_type{1} << ((sizeof(bits_type) * 8U) - 1U);
+  if constexpr (std::floating_point<K>)
+  {
+    auto const bits = std::bit_cast<bits_type>(key);
+    return (bits & sign_bit) != 0 ? static_cast<bits_type>(~bits) : static_cast<bits_type>(bits | sign_bit);
+  }
+  else if constexpr (std::is_signed_v<K>)
+  {
+    return static_cast<bits_type>(static_cast<bits_type>(key) ^ sign_bit);
+  }
+  else
+  {
+    return key;
+  }
+}
+
+constexpr uint32_t radix_digit_bits = 8;
+constexpr uint32_t radix_size       = 1U << radix_digit_bits;
+
+struct alignas(cache_line_size) radix_histogram
+{
+  std::array<uint32_t, radix_size> counts_;
+};
+
+/**
+ * @brief One stable counting pass over the digit `digit(value)` extracts, scattering `src` into `dst`.
+ * @return false if every element has the same digit, in which case nothing was moved.
+ */
+template <typename Traits, typename SrcIt, typename DstIt, typename Digit, TaskContext WC>
+auto radix_pass(chunk_plan const& plan, SrcIt src, DstIt dst, std::vector<radix_histogram>& histograms,
+                Digit const& digit, WC const& this_context) -> bool
+{
+  for_each_chunk<Traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     auto& counts = ouly::detail::vector_access(histograms, chunk).counts_;
+     counts.fill(0);
+     for (auto it = advance_by(src, begin), last = advance_by(src, end); it != last; ++it)
+     {
+       ++ouly::detail::vector_access(counts, digit(*it));
+     }
+   },
+   this_context);
+
+  // Digit-major, chunk-minor offsets keep equal digits in input order
+  uint32_t offset = 0;
+  for (uint32_t d = 0; d < radix_size; ++d)
+  {
+    uint32_t const first_offset = offset;
+    for (auto& histogram : histograms)
+    {
+      auto& count = ouly::detail::vector_access(histogram.counts_, d);
+      offset += std::exchange(count, offset);
+    }
+    if (offset - first_offset == plan.count_)
+    {
+      return false;
+    }
+  }
+
+  for_each_chunk<Traits>(
+   plan,
+   [&](uint32_t chunk, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     auto& offsets = ouly::detail::vector_access(histograms, chunk).counts_;
+     for (auto it = advance_by(src, begin), last = advance_by(src, end); it != last; ++it)
+     {
+       *advance_by(dst, ouly::detail::vector_access(offsets, digit(*it))++) = std::move(*it);
+     }
+   },
+   this_context);
+  return true;
+}
+
+template <typename Traits, typename It, typename Key, TaskContext WC>
+void radix_sort(It first, uint32_t count, Key& key, WC const& this_context)
+{
+  using value_type = std::iter_value_t<It>;
+  using key_type   = std::remove_cvref_t<std::invoke_result_t<Key&, value_type const&>>;
+  static_assert(RadixSortKey<key_type>, "The sort key must be an integer, float or double");
+
+  auto const plan = make_chunk_plan<Traits>(count);
+  if (plan.chunk_count_ <= 1)
+  {
+    std::stable_sort(first, advance_by(first, count),
+                     [&key](value_type const& a, value_type const& b)
+                     {
+                       return to_radix_bits(std::invoke(key, a)) < to_radix_bits(std::invoke(key, b));
+                     });
+    return;
+  }
+
+  std::vector<value_type>      buffer(count);
+  std::vector<radix_histogram> histograms(plan.chunk_count_);
+  bool                         in_buffer = false;
+  for (uint32_t shift = 0; shift < sizeof(key_type) * 8U; shift += radix_digit_bits)
+  {
+    auto const digit = [&key, shift](value_type const& value)
+    {
+      return static_cast<uint32_t>((to_radix_bits(std::invoke(key, value)) >> shift) & (radix_size - 1));
+    };
+    bool const moved = in_buffer ? radix_pass<Traits>(plan, buffer.begin(), first, histograms, digit, this_context)
+                                 : radix_pass<Traits>(plan, first, buffer.begin(), histograms, digit, this_context);
+    in_buffer        = in_buffer != moved;
+  }
+  if (in_buffer)
+  {
+    move_chunks<Traits>(plan, buffer.begin(), first, this_context);
+  }
+}
+
+struct merge_piece
+{
+  uint32_t a_begin_ = 0;
+  uint32_t a_end_   = 0;
+  uint32_t b_begin_ = 0;
+  uint32_t b_end_   = 0;
+  uint32_t out_     = 0;
+};
+
+/**
+ * @brief Merge every pair of adjacent `width` long sorted runs of `src` into `dst`. Each pair is cut
+ * into pieces of about `piece_size` output elements by splitting the left run evenly and locating
+ * the splitters in the right run, so the last levels still spread over all workers.
+ */
+template <typename Traits, typename SrcIt, typename DstIt, typename Compare, TaskContext WC>
+void merge_level(uint32_t count, uint32_t width, uint32_t piece_size, SrcIt src, DstIt dst, Compare& comp,
+                 std::vector<merge_piece>& pieces, WC const& this_context)
+{
+  pieces.clear();
+  for (uint32_t lo = 0; lo < count; lo += 2 * width)
+  {
+    uint32_t const mid    = std::min(count, lo + width);
+    uint32_t const hi     = std::min(count, mid + width);
+    uint32_t const splits = std::max(1U, (hi - lo) / piece_size);
+    uint32_t       a_prev = lo;
+    uint32_t       b_prev = mid;
+    for (uint32_t p = 1; p <= splits; ++p)
+    {
+      uint32_t a_next = mid;
+      uint32_t b_next = hi;
+      if (p < splits)
+      {
+        a_next = lo + static_cast<uint32_t>(uint64_t{mid - lo} * p / splits);
+        b_next = static_cast<uint32_t>(
+         std::lower_bound(advance_by(src, mid), advance_by(src, hi), *advance_by(src, a_next), comp) - src);
+      }
+      pieces.push_back({.a_begin_ = a_prev,
+                        .a_end_   = a_next,
+                        .b_begin_ = b_prev,
+                        .b_end_   = b_next,
+                        .out_     = a_prev + (b_prev - mid)});
+      a_prev = a_next;
+      b_prev = b_next;
+    }
+  }
+
+  auto const piece_count = static_cast<uint32_t>(pieces.size());
+  for_each_chunk<Traits>(
+   chunk_plan{.count_ = piece_count, .chunk_size_ = 1, .chunk_count_ = piece_count},
+   [&](uint32_t chunk, uint32_t /*begin*/, uint32_t /*end*/, WC const& /*ctx*/)
+   {
+     auto const& piece = ouly::detail::vector_access(pieces, chunk);
+     std::merge(std::make_move_iterator(advance_by(src, piece.a_begin_)),
+                std::make_move_iterator(advance_by(src, piece.a_end_)),
+                std::make_move_iterator(advance_by(src, piece.b_begin_)),
+                std::make_move_iterator(advance_by(src, piece.b_end_)), advance_by(dst, piece.out_), comp);
+   },
+   this_context);
+}
+
+template <typename Traits, typename It, typename Compare, TaskContext WC>
+void merge_sort(It first, uint32_t count, Compare& comp, WC const& this_context)
+{
+  using value_type = std::iter_value_t<It>;
+
+  auto const plan = make_chunk_plan<Traits>(count);
+  for_each_chunk<Traits>(
+   plan,
+   [&](uint32_t /*chunk*/, uint32_t begin, uint32_t end, WC const& /*ctx*/)
+   {
+     std::sort(advance_by(first, begin), advance_by(first, end), comp);
+   },
+   this_context);
+  if (plan.chunk_count_ <= 1)
+  {
+    return;
+  }
+
+  std::vector<value_type>  buffer(count);
+  std::vector<merge_piece> pieces;
+  pieces.reserve(plan.chunk_count_ * 2);
+  bool in_buffer = false;
+  for (uint32_t width = plan.chunk_size_; width < count; width *= 2)
+  {
+    if (in_buffer)
+    {
+      merge_level<Traits>(count, width, plan.chunk_size_, buffer.begin(), first, comp, pieces, this_context);
+    }
+    else
+    {
+      merge_level<Traits>(count, width, plan.chunk_size_, first, buffer.begin(), comp, pieces, this_context);
+    }
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer)
+  {
+    move_chunks<Traits>(plan, buffer.begin(), first, this_context);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Sort [first, last) by `comp` in parallel.
+ *
+ * Chunks are sorted with std::sort in parallel, then merged pairwise level by level into a scratch
+ * buffer; every merge is cut into chunk sized pieces so that the final levels stay parallel. Not
+ * stable. The value type must be default constructible and movable.
+ */
+template <std::random_access_iterator It, typename Compare, TaskContext WC,
+          typename Traits = auto_partitioner_traits>
+void parallel_sort(It first, It last, Compare comp, WC const& this_context, Traits /*traits*/ = {})
+{
+  detail::merge_sort<detail::min_chunk_traits<Traits>>(first, static_cast<uint32_t>(last - first), comp,
+                                                       this_context);
+}
+
+/**
+ * @brief Sort [first, last) ascending in parallel.
+ *
+ * Integer and floating point values are sorted with a parallel LSD radix sort, one byte per pass,
+ * skipping passes where every key shares the digit. Other types are merge sorted with std::less.
+ */
+template <std::random_access_iterator It, TaskContext WC, typename Traits = auto_partitioner_traits>
+void parallel_sort(It first, It last, WC const& this_context, Traits /*traits*/ = {})
+{
+  using value_type = std::iter_value_t<It>;
+  auto const count = static_cast<uint32_t>(last - first);
+  if constexpr (RadixSortKey<value_type>)
+  {
+    std::identity key;
+    detail::radix_sort<detail::min_chunk_traits<Traits>>(first, count, key, this_context);
+  }
+  else
+  {
+    std::less<> comp;
+    detail::merge_sort<detail::min_chunk_traits<Traits>>(first, count, comp, this_context);
+  }
+}
+
+/**
+ * @brief Stable parallel LSD radix sort of [first, last) by `key(value)`, an integer, float or
+ * double, e.g. a draw call's packed sort key.
+ */
+template <std::random_access_iterator It, typename Key, TaskContext WC, typename Traits = auto_partitioner_traits>
+void parallel_radix_sort(It first, It last, Key key, WC const& this_context, Traits /*traits*/ = {})
+{
+  detail::radix_sort<detail::min_chunk_traits<Traits>>(first, static_cast<uint32_t>(last - first), key,
+                                                       this_context);
+}
+
+} // namespace ouly
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
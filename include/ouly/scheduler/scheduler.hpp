@@ -21,6 +21,8 @@ using task = basic_task<T, task_context>;
 
 using task_scope = basic_task_scope<task_context>;
 
+using task_graph = basic_task_graph<task_context>;
+
 /**
  * @brief Asynchronously submits a task to the scheduler
  *
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/utility/user_config.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ouly
+{
+
+/**
+ * @brief Scheduler telemetry is compiled in only when OULY_SCHEDULER_STATS is defined (CMake option
+ * OULY_SCHEDULER_STATS). Otherwise every counter compiles away and snapshots report zeros.
+ */
+#ifdef OULY_SCHEDULER_STATS
+static constexpr bool scheduler_stats_enabled = true;
+#else
+static constexpr bool scheduler_stats_enabled = false;
+#endif
+
+/**
+ * @brief Counters of one worker, accumulated since begin_execution().
+ */
+struct worker_stats
+{
+  uint64_t tasks_executed_ = 0; // Work items run to completion
+  uint64_t local_pops_     = 0; // Items taken from the worker's own queue
+  uint64_t mailbox_pops_   = 0; // Items taken from a group mailbox (v2, v3) or its overflow (v3)
+  uint64_t steals_         = 0; // Items taken from another worker's queue
+  uint64_t failed_steals_  = 0; // Steal probes that came back empty
+  uint64_t parks_          = 0; // Times the worker blocked waiting for work
+  uint64_t unparks_        = 0; // Times the worker resumed after blocking
+  uint64_t parked_ns_      = 0; // Total time spent blocked, in nanoseconds
+
+  auto operator+=(worker_stats const& other) noexcept -> worker_stats&
+  {
+    tasks_executed_ += other.tasks_executed_;
+    local_pops_ += other.local_pops_;
+    mailbox_pops_ += other.mailbox_pops_;
+    steals_ += other.steals_;
+    failed_steals_ += other.failed_steals_;
+    parks_ += other.parks_;
+    unparks_ += other.unparks_;
+    parked_ns_ += other.parked_ns_;
+    return *this;
+  }
+};
+
+/**
+ * @brief Counters of one workgroup.
+ */
+struct workgroup_stats
+{
+  // Largest number of items seen queued in the group at once. v1 counts items until they finish
+  // executing, v2 and v3 until they are dequeued.
+  uint64_t queued_high_water_ = 0;
+};
+
+/**
+ * @brief Point-in-time copy of every scheduler counter, see scheduler::snapshot_stats().
+ *
+ * Counters are read individually with relaxed loads while workers keep running, so a snapshot is
+ * not a consistent cut: totals taken in the same snapshot may disagree by the few items in flight.
+ * Differences between two snapshots give per-frame rates.
+ */
+struct scheduler_stats
+{
+  std::vector<worker_stats>    workers_;    // Indexed by worker_id
+  std::vector<workgroup_stats> workgroups_; // Indexed by workgroup_id
+  worker_stats                 total_;      // Sum over workers_
+};
+
+} // namespace ouly
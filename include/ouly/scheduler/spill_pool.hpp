@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/utility/config.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ouly
+{
+
+/**
+ * @brief Process-wide counters of the spill pools, see spill_pool::get_stats().
+ */
+struct spill_pool_stats
+{
+  uint64_t slabs_        = 0; // Slabs carved so far; flat once submission reaches steady state
+  uint64_t large_blocks_ = 0; // Requests above the largest size class, served by operator new
+  uint64_t remote_frees_ = 0; // Blocks returned by another thread, counted once their owner reclaims them
+};
+
+/**
+ * @brief Per-thread, size-classed slab pool backing spilled task captures.
+ *
+ * Every thread (worker or not) owns a pool, created on its first allocation. Blocks come in power
+ * of two size classes from `min_block_size` to `max_block_size` and are carved out of `slab_size`
+ * slabs that stay with the pool for its lifetime, so once the working set is reached allocation is
+ * a pop off a thread-local free list.
+ *
+ * A block may be released on any thread. The owning thread pushes it back onto its own free list;
+ * any other thread pushes it onto the owner's lock-free remote-free list for that size class, which
+ * the owner reclaims in one exchange the next time its local list runs dry.
+ *
+ * A pool outlives its thread while blocks are still out, and is deleted by whichever thread
+ * returns the last one.
+ */
+class spill_pool
+{
+public:
+  static constexpr std::size_t min_block_size = 64;
+  static constexpr std::size_t max_block_size = 4096;
+  static constexpr std::size_t slab_size      = 64 * 1024;
+  static constexpr std::size_t alignment      = alignof(std::max_align_t);
+
+  /**
+   * @brief Allocate `size` bytes, aligned to `alignment`, from the calling thread's pool.
+   */
+  [[nodiscard]] OULY_API static auto allocate(std::size_t size) -> void*;
+
+  /**
+   * @brief Release a block returned by allocate(). May be called from any thread.
+   */
+  OULY_API static void deallocate(void* block) noexcept;
+
+  [[nodiscard]] OULY_API static auto get_stats() noexcept -> spill_pool_stats;
+};
+
+/**
+ * @brief One-shot handle to a callable spilled into the spill_pool.
+ *
+ * The handle is a single pointer, so it is trivially copyable and binds into any basic_delegate,
+ * whatever the callable captures. Invoking it runs the callable, destroys it and returns its block
+ * to the pool; it must therefore be invoked exactly once. A handle that is never invoked leaks its
+ * callable.
+ */
+template <typename F>
+class spilled_task
+{
+public:
+  explicit spilled_task(F* function) noexcept : function_(function) {}
+
+  template <typename... Args>
+    requires std::invocable<F&, Args...>
+  auto operator()(Args&&... args) const -> decltype(auto)
+  {
+    struct release_guard
+    {
+      F* function_ = nullptr;
+
+      explicit release_guard(F* function) noexcept : function_(function) {}
+      release_guard(release_guard const&)                    = delete;
+      release_guard(release_guard&&)                         = delete;
+      auto operator=(release_guard const&) -> release_guard& = delete;
+      auto operator=(release_guard&&) -> release_guard&      = delete;
+      ~release_guard() noexcept
+      {
+        std::destroy_at(function_);
+        spill_pool::deallocate(function_);
+      }
+    };
+
+    release_guard guard(function_);
+    return std::invoke(*function_, std::forward<Args>(args)...);
+  }
+
+private:
+  F* function_ = nullptr;
+};
+
+/**
+ * @brief Move `function` into the calling thread's spill pool and return a trivially copyable
+ * handle to it.
+ *
+ * Use it to submit tasks whose captures are too large or not trivially copyable for the inline
+ * delegate storage, e.g. a std::vector or a std::shared_ptr:
+ * ```cpp
+ * scheduler.submit(ctx, group, ouly::spill([data = std::move(data)](ouly::task_context const&) { ... }));
+ * ```
+ * Captures that already fit need not be spilled.
+ */
+template <typename F>
+auto spill(F&& function) -> spilled_task<std::decay_t<F>>
+{
+  using function_type = std::decay_t<F>;
+  static_assert(alignof(function_type) <= spill_pool::alignment, "Over-aligned captures cannot be spilled");
+
+  void* block = spill_pool::allocate(sizeof(function_type));
+  try
+  {
+    return spilled_task<function_type>(::new (block) function_type(std::forward<F>(function)));
+  }
+  catch (...)
+  {
+    spill_pool::deallocate(block);
+    throw;
+  }
+}
+
+} // namespace ouly
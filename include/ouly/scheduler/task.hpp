@@ -2,11 +2,13 @@
 #pragma once
 
 #include "ouly/scheduler/awaiters.hpp"
+#include "ouly/scheduler/cancellation.hpp"
 #include "ouly/scheduler/config.hpp"
 #include "ouly/scheduler/detail/allocation.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/user_config.hpp"
 
+#include <array>
 #include <atomic>
 #include <concepts>
 #include <cstddef>
@@ -17,10 +19,13 @@
 #include <mutex>
 #include <optional>
 #include <ranges>
+#include <stdexcept>
 #include <thread>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace ouly
 {
@@ -31,12 +36,18 @@ class basic_task;
 template <TaskContext WC>
 class basic_task_scope;
 
+template <TaskContext WC>
+class basic_task_graph;
+
 namespace detail
 {
 
 template <TaskContext WC>
 class task_state_base;
 
+template <TaskContext WC>
+struct task_capture;
+
 template <typename T, TaskContext WC>
 class basic_task_awaiter;
 
@@ -49,7 +60,11 @@ struct continuation_base
   auto operator=(continuation_base const&) -> continuation_base&    = delete;
   continuation_base(continuation_base&&)                            = delete;
   auto         operator=(continuation_base&&) -> continuation_base& = delete;
-  virtual void schedule(WC const& ctx) noexcept                     = 0;
+  /**
+   * @brief Queue the continuation, or run it right here when `completing` is set and the inline
+   * continuation limit allows it. `completing` is only set by the thread that finished the task.
+   */
+  virtual void schedule(WC const& ctx, bool completing) noexcept = 0;
 
   continuation_base* next_ = nullptr;
 };
@@ -58,20 +73,35 @@ template <TaskContext WC>
 struct task_execution_slot
 {
   inline static thread_local task_state_base<WC>* current = nullptr;
+  inline static thread_local uint32_t             depth   = 0;
 };
 
+/**
+ * @brief Marks a task body as executing on this thread and counts how deeply task bodies nest on
+ * its stack, which bounds the recursion of inline continuations.
+ */
 template <TaskContext WC>
 class task_execution_guard
 {
 public:
+  /**
+   * @brief Depth-only guard for continuation nodes that run no user task of their own.
+   */
+  task_execution_guard() noexcept : previous_(task_execution_slot<WC>::current)
+  {
+    ++task_execution_slot<WC>::depth;
+  }
+
   explicit task_execution_guard(task_state_base<WC>* state) noexcept
       : previous_(std::exchange(task_execution_slot<WC>::current, state))
   {
     state->executing_parent_ = previous_;
+    ++task_execution_slot<WC>::depth;
   }
 
   ~task_execution_guard() noexcept
   {
+    --task_execution_slot<WC>::depth;
     task_execution_slot<WC>::current = previous_;
   }
 
@@ -84,13 +114,25 @@ private:
   task_state_base<WC>* previous_ = nullptr;
 };
 
+/**
+ * @brief Whether a continuation bound to `group`, released by a task that just finished on `ctx`,
+ * may run on this thread instead of taking a round trip through the scheduler queues.
+ */
+template <TaskContext WC>
+[[nodiscard]] auto can_continue_inline(WC const& ctx, workgroup_id group) noexcept -> bool
+{
+  return task_execution_slot<WC>::depth < ctx.get_scheduler().get_inline_continuation_depth() &&
+         group == ctx.get_workgroup();
+}
+
 template <TaskContext WC>
 class task_state_base
 {
 public:
   using destroy_fn = void (*)(task_state_base*) noexcept;
 
-  task_state_base(scheduler_allocator allocator, destroy_fn destroy) noexcept : allocator_(allocator), destroy_(destroy)
+  task_state_base(scheduler_allocator allocator, destroy_fn destroy, cancellation_token token) noexcept
+      : allocator_(allocator), destroy_(destroy), token_(token)
   {}
 
   task_state_base(task_state_base const&)                    = delete;
@@ -156,7 +198,7 @@ public:
       }
     }
     continuation->next_ = nullptr;
-    continuation->schedule(ctx);
+    continuation->schedule(ctx, false);
   }
 
   [[nodiscard]] auto get_exception() const noexcept -> std::exception_ptr
@@ -175,6 +217,30 @@ public:
     return allocator_;
   }
 
+  [[nodiscard]] auto get_cancellation_token() const noexcept -> cancellation_token
+  {
+    return token_;
+  }
+
+  /// Whether the task should be skipped instead of run; checked once, right before its body starts
+  [[nodiscard]] auto is_cancelled() const noexcept -> bool
+  {
+    return token_.is_cancelled();
+  }
+
+  /**
+   * @brief Return a finished state to pending so a recorded task graph can complete it again.
+   *
+   * Only called by basic_task_graph::replay(), which owns the state and guarantees that nothing
+   * is running against it.
+   */
+  void rearm() noexcept
+  {
+    OULY_ASSERT(is_complete() && "A task can only be replayed after its previous run has finished");
+    exception_ = {};
+    continuations_.store(nullptr, std::memory_order_relaxed);
+  }
+
 protected:
   ~task_state_base() noexcept
   {
@@ -195,7 +261,7 @@ protected:
     {
       auto* next           = continuations->next_;
       continuations->next_ = nullptr;
-      continuations->schedule(ctx);
+      continuations->schedule(ctx, true);
       continuations = next;
     }
   }
@@ -203,7 +269,7 @@ protected:
 private:
   struct completion_tag final : continuation_base<WC>
   {
-    void schedule(WC const& /*ctx*/) noexcept final {}
+    void schedule(WC const& /*ctx*/, bool /*completing*/) noexcept final {}
   };
 
   /**
@@ -240,6 +306,7 @@ private:
   std::atomic<continuation_base<WC>*> continuations_{nullptr};
   scheduler_allocator                 allocator_;
   destroy_fn                          destroy_ = nullptr;
+  cancellation_token                  token_;
   std::exception_ptr                  exception_;
   task_state_base*                    executing_parent_ = nullptr;
 };
@@ -248,7 +315,9 @@ template <typename T, TaskContext WC>
 class task_state final : public task_state_base<WC>
 {
 public:
-  explicit task_state(scheduler_allocator allocator) noexcept : task_state_base<WC>(allocator, &destroy_state) {}
+  explicit task_state(scheduler_allocator allocator, cancellation_token token = {}) noexcept
+      : task_state_base<WC>(allocator, &destroy_state, token)
+  {}
 
   template <typename V>
   void set_value(WC const& ctx, V&& value) noexcept(std::is_nothrow_constructible_v<T, V&&>)
@@ -281,7 +350,9 @@ template <TaskContext WC>
 class task_state<void, WC> final : public task_state_base<WC>
 {
 public:
-  explicit task_state(scheduler_allocator allocator) noexcept : task_state_base<WC>(allocator, &destroy_state) {}
+  explicit task_state(scheduler_allocator allocator, cancellation_token token = {}) noexcept
+      : task_state_base<WC>(allocator, &destroy_state, token)
+  {}
 
   void set_value(WC const& ctx) noexcept
   {
@@ -366,7 +437,11 @@ public:
     task_execution_guard guard(state_);
     try
     {
-      if constexpr (std::is_void_v<R>)
+      if (state_->is_cancelled())
+      {
+        state_->set_exception(ctx, cancelled_exception());
+      }
+      else if constexpr (std::is_void_v<R>)
       {
         invoke_task(function_, ctx);
         state_->set_value(ctx);
@@ -401,8 +476,13 @@ public:
     result_->add_ref();
   }
 
-  void schedule(WC const& ctx) noexcept final
+  void schedule(WC const& ctx, bool completing) noexcept final
   {
+    if (completing && can_continue_inline(ctx, group_))
+    {
+      run(ctx);
+      return;
+    }
     ctx.get_scheduler().submit(ctx, group_,
                                [self = this](WC const& run_ctx) noexcept -> void
                                {
@@ -420,6 +500,10 @@ private:
       {
         result_->set_exception(ctx, std::move(exception));
       }
+      else if (result_->is_cancelled())
+      {
+        result_->set_exception(ctx, cancelled_exception());
+      }
       else if constexpr (std::is_void_v<R>)
       {
         invoke_continuation(function_, *predecessor_, ctx);
@@ -511,8 +595,13 @@ public:
     predecessor_->add_ref();
   }
 
-  void schedule(WC const& ctx) noexcept final
+  void schedule(WC const& ctx, bool completing) noexcept final
   {
+    if (completing && can_continue_inline(ctx, group_))
+    {
+      run(ctx);
+      return;
+    }
     ctx.get_scheduler().submit(ctx, group_,
                                [self = this](WC const& run_ctx) noexcept -> void
                                {
@@ -523,7 +612,8 @@ public:
 private:
   void run(WC const& ctx) noexcept
   {
-    auto exception = predecessor_->get_exception();
+    task_execution_guard<WC> guard;
+    auto                     exception = predecessor_->get_exception();
     predecessor_->release();
     control_->arrive(ctx, std::move(exception));
     scheduler_allocator::destroy(this);
@@ -545,8 +635,13 @@ public:
     predecessor_->add_ref();
   }
 
-  void schedule(WC const& ctx) noexcept final
+  void schedule(WC const& ctx, bool completing) noexcept final
   {
+    if (completing && can_continue_inline(ctx, group_))
+    {
+      run(ctx);
+      return;
+    }
     ctx.get_scheduler().submit(ctx, group_,
                                [self = this](WC const& run_ctx) noexcept -> void
                                {
@@ -557,7 +652,8 @@ public:
 private:
   void run(WC const& ctx) noexcept
   {
-    auto coroutine = coroutine_;
+    task_execution_guard<WC> guard;
+    auto                     coroutine = coroutine_;
     predecessor_->release();
     scheduler_allocator::destroy(this);
     resume_coroutine(coroutine, ctx);
@@ -574,6 +670,16 @@ struct scope_execution_slot
   inline static thread_local basic_task_scope<WC>* current = nullptr;
 };
 
+/**
+ * @brief The graph this thread is recording into, set between basic_task_scope::begin_capture()
+ * and end_capture(). then() and when_all() consult it to record continuations of captured tasks.
+ */
+template <TaskContext WC>
+struct task_capture_slot
+{
+  inline static thread_local basic_task_graph<WC>* current = nullptr;
+};
+
 template <TaskContext WC>
 class scope_node_base
 {
@@ -647,7 +753,12 @@ private:
     std::exception_ptr exception;
     try
     {
-      if constexpr (std::is_void_v<R>)
+      // A skipped task is not a failure of the scope, join() does not report it
+      if (self->state_->is_cancelled())
+      {
+        self->state_->set_exception(ctx, cancelled_exception());
+      }
+      else if constexpr (std::is_void_v<R>)
       {
         invoke_task(self->function_, ctx);
         self->state_->set_value(ctx);
@@ -678,6 +789,255 @@ private:
   F                  function_;
 };
 
+/**
+ * @brief One recorded task of a basic_task_graph.
+ *
+ * Owns a reference to the task state it completes, so the handles returned while capturing keep
+ * observing the latest replay. Dependencies are counted once when recorded; a replay only reloads
+ * the pending count, so running a node never allocates or touches a reference count.
+ */
+template <TaskContext WC>
+class graph_node_base
+{
+public:
+  /// Runs the task and completes its state; returns the exception thrown by the task itself
+  using execute_fn = auto (*)(graph_node_base*, WC const&) noexcept -> std::exception_ptr;
+  using destroy_fn = void (*)(graph_node_base*) noexcept;
+
+  graph_node_base(basic_task_graph<WC>* graph, task_state_base<WC>* state, workgroup_id group, execute_fn execute,
+                  destroy_fn destroy) noexcept
+      : graph_(graph), state_(state), group_(group), execute_(execute), destroy_(destroy)
+  {
+    state_->add_ref();
+  }
+
+  graph_node_base(graph_node_base const&)                    = delete;
+  auto operator=(graph_node_base const&) -> graph_node_base& = delete;
+  graph_node_base(graph_node_base&&)                         = delete;
+  auto operator=(graph_node_base&&) -> graph_node_base&      = delete;
+
+  void precede(graph_node_base* successor)
+  {
+    successors_.push_back(successor);
+    ++successor->dependencies_;
+  }
+
+  void rearm() noexcept
+  {
+    state_->rearm();
+    pending_.store(dependencies_, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto is_root() const noexcept -> bool
+  {
+    return dependencies_ == 0;
+  }
+
+  [[nodiscard]] auto state() const noexcept -> task_state_base<WC>*
+  {
+    return state_;
+  }
+
+  void schedule(WC const& ctx, bool completing) noexcept
+  {
+    if (completing && can_continue_inline(ctx, group_))
+    {
+      run(ctx);
+      return;
+    }
+    ctx.get_scheduler().submit(ctx, group_,
+                               [self = this](WC const& run_ctx) noexcept -> void
+                               {
+                                 self->run(run_ctx);
+                               });
+  }
+
+  void destroy() noexcept
+  {
+    state_->release();
+    destroy_(this);
+  }
+
+protected:
+  ~graph_node_base() noexcept = default;
+
+private:
+  void run(WC const& ctx) noexcept
+  {
+    std::exception_ptr exception;
+    {
+      // Successors are released inside the guard so inline chains count toward the depth limit
+      task_execution_guard guard(state_);
+      exception = execute_(this, ctx);
+      for (auto* successor : successors_)
+      {
+        if (successor->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          successor->schedule(ctx, true);
+        }
+      }
+    }
+    graph_->finish_node(std::move(exception));
+  }
+
+  basic_task_graph<WC>*         graph_ = nullptr;
+  task_state_base<WC>*          state_ = nullptr;
+  std::vector<graph_node_base*> successors_;
+  std::atomic<uint32_t>         pending_{0};
+  uint32_t                      dependencies_ = 0;
+  workgroup_id                  group_;
+  execute_fn                    execute_ = nullptr;
+  destroy_fn                    destroy_ = nullptr;
+};
+
+/**
+ * @brief Recorded basic_task_scope::run() task; a root of the graph.
+ */
+template <typename F, typename R, TaskContext WC>
+class graph_task_node final : public graph_node_base<WC>
+{
+public:
+  graph_task_node(basic_task_graph<WC>* graph, task_state<R, WC>* state, workgroup_id group, F function)
+      : graph_node_base<WC>(graph, state, group, &execute_node, &destroy_node), function_(std::move(function))
+  {}
+
+private:
+  static auto execute_node(graph_node_base<WC>* base, WC const& ctx) noexcept -> std::exception_ptr
+  {
+    auto* self  = static_cast<graph_task_node*>(base);
+    auto* state = static_cast<task_state<R, WC>*>(self->state());
+    try
+    {
+      if (state->is_cancelled())
+      {
+        state->set_exception(ctx, cancelled_exception());
+      }
+      else if constexpr (std::is_void_v<R>)
+      {
+        invoke_task(self->function_, ctx);
+        state->set_value(ctx);
+      }
+      else
+      {
+        state->set_value(ctx, invoke_task(self->function_, ctx));
+      }
+    }
+    catch (...)
+    {
+      auto exception = std::current_exception();
+      state->set_exception(ctx, exception);
+      return exception;
+    }
+    return {};
+  }
+
+  static void destroy_node(graph_node_base<WC>* base) noexcept
+  {
+    scheduler_allocator::destroy(static_cast<graph_task_node*>(base));
+  }
+
+  F function_;
+};
+
+/**
+ * @brief Recorded then() continuation; receives the value of its single predecessor.
+ */
+template <typename F, typename T, typename R, TaskContext WC>
+class graph_continuation_node final : public graph_node_base<WC>
+{
+public:
+  graph_continuation_node(basic_task_graph<WC>* graph, task_state<T, WC>* predecessor, task_state<R, WC>* result,
+                          workgroup_id group, F function)
+      : graph_node_base<WC>(graph, result, group, &execute_node, &destroy_node), predecessor_(predecessor),
+        function_(std::move(function))
+  {}
+
+private:
+  static auto execute_node(graph_node_base<WC>* base, WC const& ctx) noexcept -> std::exception_ptr
+  {
+    auto* self   = static_cast<graph_continuation_node*>(base);
+    auto* result = static_cast<task_state<R, WC>*>(self->state());
+    try
+    {
+      if (auto exception = self->predecessor_->get_exception())
+      {
+        result->set_exception(ctx, std::move(exception));
+      }
+      else if (result->is_cancelled())
+      {
+        result->set_exception(ctx, cancelled_exception());
+      }
+      else if constexpr (std::is_void_v<R>)
+      {
+        invoke_continuation(self->function_, *self->predecessor_, ctx);
+        result->set_value(ctx);
+      }
+      else
+      {
+        result->set_value(ctx, invoke_continuation(self->function_, *self->predecessor_, ctx));
+      }
+    }
+    catch (...)
+    {
+      auto exception = std::current_exception();
+      result->set_exception(ctx, exception);
+      return exception;
+    }
+    return {};
+  }
+
+  static void destroy_node(graph_node_base<WC>* base) noexcept
+  {
+    scheduler_allocator::destroy(static_cast<graph_continuation_node*>(base));
+  }
+
+  // Kept alive by the predecessor's own node in the graph
+  task_state<T, WC>* predecessor_ = nullptr;
+  F                  function_;
+};
+
+/**
+ * @brief Recorded when_all(); completes with the first exception among its predecessors.
+ */
+template <TaskContext WC>
+class graph_join_node final : public graph_node_base<WC>
+{
+public:
+  graph_join_node(basic_task_graph<WC>* graph, task_state<void, WC>* result, workgroup_id group)
+      : graph_node_base<WC>(graph, result, group, &execute_node, &destroy_node)
+  {}
+
+  void add_predecessor(graph_node_base<WC>* predecessor)
+  {
+    predecessors_.push_back(predecessor->state());
+    predecessor->precede(this);
+  }
+
+private:
+  static auto execute_node(graph_node_base<WC>* base, WC const& ctx) noexcept -> std::exception_ptr
+  {
+    auto* self   = static_cast<graph_join_node*>(base);
+    auto* result = static_cast<task_state<void, WC>*>(self->state());
+    for (auto* predecessor : self->predecessors_)
+    {
+      if (auto exception = predecessor->get_exception())
+      {
+        result->set_exception(ctx, std::move(exception));
+        return {};
+      }
+    }
+    result->set_value(ctx);
+    return {};
+  }
+
+  static void destroy_node(graph_node_base<WC>* base) noexcept
+  {
+    scheduler_allocator::destroy(static_cast<graph_join_node*>(base));
+  }
+
+  std::vector<task_state_base<WC>*> predecessors_;
+};
+
 } // namespace detail
 
 template <typename T, TaskContext WC>
@@ -792,9 +1152,15 @@ public:
     using result_type   = detail::continuation_result_t<function_type, T, WC>;
     using node_type     = detail::continuation_node<function_type, T, result_type, WC>;
 
-    auto* result = allocator.make<detail::task_state<result_type, WC>>(allocator);
+    // The continuation is skipped along with the task it follows
+    auto* result = allocator.make<detail::task_state<result_type, WC>>(allocator, state_->get_cancellation_token());
     try
     {
+      if (auto* graph = detail::task_capture_slot<WC>::current)
+      {
+        detail::task_capture<WC>::template record_continuation<function_type>(*graph, state_, result, group,
+                                                                                 function);
+      }
       auto* node = allocator.make<node_type>(state_, result, group, std::forward<F>(function));
       state_->add_continuation(node, ctx);
     }
@@ -833,7 +1199,7 @@ private:
   friend struct detail::task_access;
 
   template <TaskContext Context, typename F>
-  friend auto submit_task(Context const&, workgroup_id, scheduler_allocator, F&&)
+  friend auto submit_task(Context const&, workgroup_id, scheduler_allocator, cancellation_token, F&&)
    -> basic_task<detail::task_result_t<std::decay_t<F>, Context>, Context>;
 
   template <TaskContext Context, typename... Tasks>
@@ -905,15 +1271,21 @@ auto basic_task<T, WC>::operator co_await() const noexcept -> detail::basic_task
   return detail::basic_task_awaiter<T, WC>(*this);
 }
 
+/**
+ * @brief Submit `function` to `group`, skipping it if `token` is cancelled before it starts.
+ *
+ * A skipped task completes with ouly::task_cancelled. Continuations attached with then() share the
+ * token, so a whole chain is skipped once it is cancelled.
+ */
 template <TaskContext WC, typename F>
-auto submit_task(WC const& ctx, workgroup_id group, scheduler_allocator allocator, F&& function)
- -> basic_task<detail::task_result_t<std::decay_t<F>, WC>, WC>
+auto submit_task(WC const& ctx, workgroup_id group, scheduler_allocator allocator, cancellation_token token,
+                 F&& function) -> basic_task<detail::task_result_t<std::decay_t<F>, WC>, WC>
 {
   using function_type = std::decay_t<F>;
   using result_type   = detail::task_result_t<function_type, WC>;
   using node_type     = detail::producer_node<function_type, result_type, WC>;
 
-  auto* state = allocator.template make<detail::task_state<result_type, WC>>(allocator);
+  auto* state = allocator.template make<detail::task_state<result_type, WC>>(allocator, token);
   try
   {
     auto* node = allocator.template make<node_type>(state, std::forward<F>(function));
@@ -931,6 +1303,27 @@ auto submit_task(WC const& ctx, workgroup_id group, scheduler_allocator allocato
   return basic_task<result_type, WC>(state);
 }
 
+template <TaskContext WC, typename F>
+auto submit_task(WC const& ctx, workgroup_id group, scheduler_allocator allocator, F&& function)
+ -> basic_task<detail::task_result_t<std::decay_t<F>, WC>, WC>
+{
+  return submit_task(ctx, group, allocator, cancellation_token{}, std::forward<F>(function));
+}
+
+template <TaskContext WC, typename F>
+auto submit_task(WC const& ctx, workgroup_id group, cancellation_token token, F&& function)
+ -> basic_task<detail::task_result_t<std::decay_t<F>, WC>, WC>
+{
+  return submit_task(ctx, group, scheduler_allocator{}, token, std::forward<F>(function));
+}
+
+template <TaskContext WC, typename F>
+auto submit_task(WC const& ctx, cancellation_token token, F&& function)
+ -> basic_task<detail::task_result_t<std::decay_t<F>, WC>, WC>
+{
+  return submit_task(ctx, ctx.get_workgroup(), scheduler_allocator{}, token, std::forward<F>(function));
+}
+
 template <TaskContext WC, typename F>
 auto submit_task(WC const& ctx, scheduler_allocator allocator, F&& function)
  -> basic_task<detail::task_result_t<std::decay_t<F>, WC>, WC>
@@ -969,6 +1362,12 @@ auto when_all(WC const& ctx, workgroup_id group, scheduler_allocator allocator,
     detail::when_all_control<WC>* control = nullptr;
     try
     {
+      if (auto* graph = detail::task_capture_slot<WC>::current)
+      {
+        detail::task_capture<WC>::record_join(
+         *graph, result, group,
+         std::array<detail::task_state_base<WC>*, count>{detail::task_access::state(tasks)...});
+      }
       control = allocator.make<detail::when_all_control<WC>>(result, count);
     }
     catch (...)
@@ -1032,6 +1431,15 @@ auto when_all(WC const& ctx, workgroup_id group, scheduler_allocator allocator,
   detail::when_all_control<WC>* control = nullptr;
   try
   {
+    if (auto* graph = detail::task_capture_slot<WC>::current)
+    {
+      detail::task_capture<WC>::record_join(*graph, result, group,
+                                            tasks | std::views::transform(
+                                                     [](task_type const& task) -> detail::task_state_base<WC>*
+                                                     {
+                                                       return detail::task_access::state(task);
+                                                     }));
+    }
     control = allocator.make<detail::when_all_control<WC>>(result, count);
   }
   catch (...)
@@ -1073,12 +1481,310 @@ auto when_all(WC const& ctx, Range const& tasks) -> basic_task<void, WC>
   return when_all(ctx, ctx.get_workgroup(), scheduler_allocator{}, tasks);
 }
 
+/**
+ * @brief Task structure recorded from one execution of a basic_task_scope, replayable without
+ * submitting it again.
+ *
+ * Between basic_task_scope::begin_capture() and end_capture(), every run() on the scope is
+ * recorded as a root of the graph, and every then() or when_all() set up on the capturing thread
+ * whose inputs were recorded becomes a dependent node. The captured execution itself runs as usual.
+ * replay() then runs the same structure again: it reuses the recorded nodes and task states, so a
+ * replay performs no allocation and no reference counting, only one dependency count per node.
+ *
+ * Recorded tasks are copies of the submitted callables. New inputs reach them through whatever they
+ * captured, e.g. a pointer to the frame being recorded, and results are published through the task
+ * handles returned while capturing, which observe the latest replay.
+ *
+ * ## Constraints
+ * - Recorded callables must be copy constructible. While capturing, run() and then() throw
+ *   std::invalid_argument for a callable that is not, instead of leaving a hole in the graph.
+ * - when_all() over recorded tasks must only join recorded tasks. While capturing, a when_all()
+ *   that mixes them with tasks from outside the capture throws std::invalid_argument.
+ * - Recorded tasks must not submit work into the capturing scope themselves; nested work is not
+ *   part of the graph.
+ * - The captured execution, and each replay, must have completed before the next replay.
+ *
+ * @code
+ * ouly::task_graph graph;
+ * ouly::task_scope scope;
+ * scope.begin_capture(graph);
+ * auto commands = scope.run(ctx, [&frame] { return record_commands(frame); });
+ * auto sorted   = commands.then(ctx, [](command_list const& list) { return sort(list); });
+ * scope.end_capture();
+ * scope.join(ctx);
+ * sorted.get(ctx);
+ *
+ * // every following frame
+ * graph.replay(ctx);
+ * graph.wait(ctx);
+ * submit(sorted.get(ctx));
+ * @endcode
+ */
+template <TaskContext WC>
+class basic_task_graph
+{
+public:
+  explicit basic_task_graph(scheduler_allocator allocator = {}) noexcept : allocator_(allocator) {}
+
+  basic_task_graph(basic_task_graph const&)                        = delete;
+  auto operator=(basic_task_graph const&) -> basic_task_graph&     = delete;
+  basic_task_graph(basic_task_graph&&) noexcept                    = delete;
+  auto operator=(basic_task_graph&&) noexcept -> basic_task_graph& = delete;
+
+  ~basic_task_graph() noexcept
+  {
+    clear();
+  }
+
+  /**
+   * @brief Run every recorded task again, in dependency order.
+   */
+  void replay(WC const& ctx) noexcept
+  {
+    OULY_ASSERT(detail::task_capture_slot<WC>::current != this && "Cannot replay a task_graph while capturing it");
+    OULY_ASSERT(is_complete() && "A task_graph cannot be replayed before its previous replay has finished");
+    if (nodes_.empty())
+    {
+      return;
+    }
+
+    exception_ = {};
+    exception_claimed_.store(false, std::memory_order_relaxed);
+    remaining_.store(static_cast<uint32_t>(nodes_.size()), std::memory_order_relaxed);
+    done_.store(false, std::memory_order_relaxed);
+    // Rearm everything before the first root runs, a fast root may otherwise reach a stale node
+    for (auto* node : nodes_)
+    {
+      node->rearm();
+    }
+    for (auto* node : nodes_)
+    {
+      if (node->is_root())
+      {
+        node->schedule(ctx, false);
+      }
+    }
+  }
+
+  /**
+   * @brief Wait for the current replay, running other work on this thread meanwhile; rethrows the
+   * first exception thrown by a recorded task.
+   */
+  void wait(WC const& ctx)
+  {
+    while (!done_.load(std::memory_order_acquire))
+    {
+      ctx.get_scheduler().busy_work(ctx);
+      std::this_thread::yield();
+    }
+    rethrow_exception();
+  }
+
+  void wait()
+  {
+    while (!done_.load(std::memory_order_acquire))
+    {
+      done_.wait(false, std::memory_order_relaxed);
+    }
+    rethrow_exception();
+  }
+
+  [[nodiscard]] auto is_complete() const noexcept -> bool
+  {
+    return done_.load(std::memory_order_acquire);
+  }
+
+  /// Number of recorded tasks, continuations and joins
+  [[nodiscard]] auto size() const noexcept -> uint32_t
+  {
+    return static_cast<uint32_t>(nodes_.size());
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return nodes_.empty();
+  }
+
+  /**
+   * @brief Drop the recorded structure so the graph can capture again.
+   */
+  void clear() noexcept
+  {
+    OULY_ASSERT(detail::task_capture_slot<WC>::current != this && "Cannot clear a task_graph while capturing it");
+    OULY_ASSERT(is_complete() && "A task_graph cannot be cleared while a replay is running");
+    if (!is_complete())
+    {
+      std::terminate();
+    }
+    for (auto* node : nodes_)
+    {
+      node->destroy();
+    }
+    nodes_.clear();
+    recorded_.clear();
+  }
+
+private:
+  void finish_node(std::exception_ptr exception) noexcept
+  {
+    if (exception && !exception_claimed_.exchange(true, std::memory_order_relaxed))
+    {
+      exception_ = std::move(exception);
+    }
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      // Same handshake as task_scope::complete_one(): the waiter re-acquires `mutex_` before it
+      // returns, so the graph cannot be destroyed between the store and the notify.
+      std::scoped_lock lock(mutex_);
+      done_.store(true, std::memory_order_release);
+      done_.notify_all();
+    }
+  }
+
+  void rethrow_exception() const
+  {
+    std::exception_ptr exception;
+    {
+      std::scoped_lock lock(mutex_);
+      exception = exception_;
+    }
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  [[nodiscard]] auto find(detail::task_state_base<WC>* state) const noexcept -> detail::graph_node_base<WC>*
+  {
+    auto it = recorded_.find(state);
+    return it != recorded_.end() ? it->second : nullptr;
+  }
+
+  void adopt(detail::graph_node_base<WC>* node)
+  {
+    try
+    {
+      nodes_.push_back(node);
+      recorded_.emplace(node->state(), node);
+    }
+    catch (...)
+    {
+      if (!nodes_.empty() && nodes_.back() == node)
+      {
+        nodes_.pop_back();
+      }
+      node->destroy();
+      throw;
+    }
+  }
+
+  friend class detail::graph_node_base<WC>;
+  friend struct detail::task_capture<WC>;
+
+  scheduler_allocator                                                              allocator_;
+  std::vector<detail::graph_node_base<WC>*>                                        nodes_;
+  std::unordered_map<detail::task_state_base<WC>*, detail::graph_node_base<WC>*> recorded_;
+  std::atomic<uint32_t>                                                            remaining_{0};
+  std::atomic_bool                                                                 done_{true};
+  std::atomic_bool                                                                 exception_claimed_{false};
+  mutable std::mutex                                                               mutex_;
+  std::exception_ptr                                                               exception_;
+};
+
+namespace detail
+{
+
+/**
+ * @brief Records tasks, continuations and joins into the graph being captured.
+ */
+template <TaskContext WC>
+struct task_capture
+{
+  template <typename F, typename R>
+  static void record_task(basic_task_graph<WC>& graph, task_state<R, WC>* state, workgroup_id group,
+                          F const& function)
+  {
+    if constexpr (std::copy_constructible<F>)
+    {
+      graph.adopt(graph.allocator_.template make<graph_task_node<F, R, WC>>(&graph, state, group, function));
+    }
+    else
+    {
+      throw std::invalid_argument("Tasks recorded into a task_graph must be copy constructible");
+    }
+  }
+
+  template <typename F, typename T, typename R>
+  static void record_continuation(basic_task_graph<WC>& graph, task_state<T, WC>* predecessor,
+                                  task_state<R, WC>* result, workgroup_id group, F const& function)
+  {
+    auto* source = graph.find(predecessor);
+    if (source == nullptr)
+    {
+      return;
+    }
+    if constexpr (std::copy_constructible<F>)
+    {
+      auto* node = graph.allocator_.template make<graph_continuation_node<F, T, R, WC>>(&graph, predecessor, result,
+                                                                                          group, function);
+      graph.adopt(node);
+      source->precede(node);
+    }
+    else
+    {
+      throw std::invalid_argument("Continuations recorded into a task_graph must be copy constructible");
+    }
+  }
+
+  template <typename Range>
+  static void record_join(basic_task_graph<WC>& graph, task_state<void, WC>* result, workgroup_id group,
+                          Range&& predecessors)
+  {
+    uint32_t recorded = 0;
+    uint32_t count    = 0;
+    for (auto* state : predecessors)
+    {
+      recorded += graph.find(state) != nullptr ? 1U : 0U;
+      ++count;
+    }
+    if (recorded == 0)
+    {
+      return;
+    }
+    if (recorded != count)
+    {
+      // A replay could not wait on the unrecorded tasks, the join would silently lose them
+      throw std::invalid_argument("when_all() while capturing into a task_graph mixes recorded and unrecorded tasks");
+    }
+
+    auto* node = graph.allocator_.template make<graph_join_node<WC>>(&graph, result, group);
+    graph.adopt(node);
+    for (auto* state : predecessors)
+    {
+      if (auto* source = graph.find(state))
+      {
+        node->add_predecessor(source);
+      }
+    }
+  }
+};
+
+} // namespace detail
+
 template <TaskContext WC>
 class basic_task_scope
 {
 public:
   explicit basic_task_scope(scheduler_allocator allocator = {}) noexcept : allocator_(allocator) {}
 
+  /**
+   * @brief A scope whose tasks are skipped, completing with ouly::task_cancelled, once `token` is
+   * cancelled. Skipped tasks are not failures: join() still returns normally for them.
+   */
+  explicit basic_task_scope(cancellation_token token, scheduler_allocator allocator = {}) noexcept
+      : allocator_(allocator), token_(token)
+  {}
+
   basic_task_scope(basic_task_scope const&)                        = delete;
   auto operator=(basic_task_scope const&) -> basic_task_scope&     = delete;
   basic_task_scope(basic_task_scope&&) noexcept                    = delete;
@@ -1088,6 +1794,7 @@ public:
   {
     auto const outstanding = outstanding_.load(std::memory_order_acquire);
     OULY_ASSERT(outstanding == 0 && "task_scope must be joined before destruction");
+    OULY_ASSERT(capture_ == nullptr && "task_scope destroyed while capturing into a task_graph");
     if (outstanding != 0)
     {
       std::terminate();
@@ -1120,11 +1827,16 @@ public:
       {
         std::terminate();
       }
+      OULY_ASSERT((capture_ == nullptr || !is_descendant) && "Captured tasks cannot submit into their own scope");
 
       auto const allocator = allocator_;
-      state                = allocator.template make<detail::task_state<result_type, WC>>(allocator);
+      state                = allocator.template make<detail::task_state<result_type, WC>>(allocator, token_);
       try
       {
+        if (capture_ != nullptr && detail::task_capture_slot<WC>::current == capture_)
+        {
+          detail::task_capture<WC>::template record_task<function_type>(*capture_, state, group, function);
+        }
         node = allocator.template make<node_type>(state, this, &complete_one, group, std::forward<F>(function));
       }
       catch (...)
@@ -1213,6 +1925,37 @@ public:
     return outstanding_.load(std::memory_order_acquire) == 0;
   }
 
+  [[nodiscard]] auto get_cancellation_token() const noexcept -> cancellation_token
+  {
+    return token_;
+  }
+
+  /**
+   * @brief Record the tasks run on this scope from now on, and the then()/when_all() continuations
+   * set up on this thread on top of them, into `graph` for later basic_task_graph::replay().
+   *
+   * `graph` must be empty. Work still executes normally while it is being captured. Capture ends
+   * with end_capture(), which must be called on the same thread.
+   */
+  void begin_capture(basic_task_graph<WC>& graph) noexcept
+  {
+    OULY_ASSERT(capture_ == nullptr && detail::task_capture_slot<WC>::current == nullptr &&
+                "Only one task_graph can be captured at a time on a thread");
+    OULY_ASSERT(graph.empty() && "Clear a task_graph before capturing into it again");
+    std::scoped_lock lock(mutex_);
+    capture_                               = &graph;
+    detail::task_capture_slot<WC>::current = &graph;
+  }
+
+  void end_capture() noexcept
+  {
+    OULY_ASSERT(capture_ != nullptr && detail::task_capture_slot<WC>::current == capture_ &&
+                "end_capture() must follow begin_capture() on the same thread");
+    std::scoped_lock lock(mutex_);
+    capture_                               = nullptr;
+    detail::task_capture_slot<WC>::current = nullptr;
+  }
+
   void reset() noexcept
   {
     reset(allocator_);
@@ -1222,6 +1965,7 @@ public:
   {
     auto const outstanding = outstanding_.load(std::memory_order_acquire);
     OULY_ASSERT(outstanding == 0 && "task_scope cannot be reset while work is outstanding");
+    OULY_ASSERT(capture_ == nullptr && "task_scope cannot be reset while capturing into a task_graph");
     if (outstanding != 0)
     {
       std::terminate();
@@ -1293,11 +2037,13 @@ private:
   }
 
   scheduler_allocator          allocator_;
+  cancellation_token           token_;
   std::atomic<uint32_t>        outstanding_{0};
   mutable std::mutex           mutex_;
   detail::scope_node_base<WC>* nodes_ = nullptr;
   std::exception_ptr           exception_;
-  bool                         closed_ = false;
+  basic_task_graph<WC>*        capture_ = nullptr;
+  bool                         closed_  = false;
 };
 
 } // namespace ouly
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/utility/config.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace ouly
+{
+
+/**
+ * @brief Position of one logical CPU in the cache and memory hierarchy.
+ */
+struct cpu_info
+{
+  uint32_t cpu_       = 0; // OS logical CPU index, as used for affinity masks
+  uint32_t core_      = 0; // Physical core key, shared by SMT siblings
+  uint32_t llc_       = 0; // Last-level cache domain key, shared by CPUs behind the same LLC
+  uint32_t numa_node_ = 0; // NUMA node id
+
+  auto operator<=>(cpu_info const&) const noexcept = default;
+};
+
+/**
+ * @brief How far apart two CPUs are, nearest first.
+ */
+enum class cpu_distance : uint8_t
+{
+  same_core,
+  same_llc,
+  same_node,
+  remote
+};
+
+/**
+ * @brief Description of the CPUs a scheduler may place workers on.
+ *
+ * CPUs are kept in placement order: grouped by NUMA node, then by LLC domain. Inside an LLC the
+ * first hardware thread of every core comes before any SMT sibling. Assigning worker `w` to
+ * `cpus()[w]` therefore keeps contiguous worker ranges (and with them workgroups) inside one LLC
+ * for as long as possible, while neighbouring workers still get a core of their own.
+ *
+ * detect() reads `/sys/devices/system/cpu` on Linux and keeps the CPUs in the process affinity
+ * mask. When sysfs is not readable it reports the CPUs of the affinity mask sharing one LLC and
+ * node, and on other platforms `std::thread::hardware_concurrency()` such CPUs.
+ */
+class topology
+{
+public:
+  topology() noexcept = default;
+  OULY_API explicit topology(std::vector<cpu_info> cpus);
+
+  /**
+   * @brief Describe the CPUs of the running machine.
+   */
+  OULY_API static auto detect() -> topology;
+
+  /**
+   * @brief Pin the calling thread to one logical CPU.
+   * @return false if the platform does not support pinning or the call failed.
+   */
+  OULY_API static auto pin_current_thread(uint32_t cpu) noexcept -> bool;
+
+  [[nodiscard]] static auto distance(cpu_info const& lhs, cpu_info const& rhs) noexcept -> cpu_distance
+  {
+    if (lhs.core_ == rhs.core_ && lhs.llc_ == rhs.llc_ && lhs.numa_node_ == rhs.numa_node_)
+    {
+      return cpu_distance::same_core;
+    }
+    if (lhs.llc_ == rhs.llc_ && lhs.numa_node_ == rhs.numa_node_)
+    {
+      return cpu_distance::same_llc;
+    }
+    return lhs.numa_node_ == rhs.numa_node_ ? cpu_distance::same_node : cpu_distance::remote;
+  }
+
+  [[nodiscard]] auto cpus() const noexcept -> std::span<cpu_info const>
+  {
+    return cpus_;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> uint32_t
+  {
+    return static_cast<uint32_t>(cpus_.size());
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool
+  {
+    return cpus_.empty();
+  }
+
+  /**
+   * @brief CPU assigned to a worker index; wraps around when there are more workers than CPUs.
+   */
+  [[nodiscard]] auto cpu_for_worker(uint32_t worker_index) const noexcept -> cpu_info const&
+  {
+    OULY_ASSERT(!cpus_.empty());
+    return ouly::detail::vector_access(cpus_, worker_index % size());
+  }
+
+private:
+  std::vector<cpu_info> cpus_;
+};
+
+} // namespace ouly
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/worker_structs.hpp"
+#include "ouly/utility/config.hpp"
+#include "ouly/utility/user_config.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly
+{
+
+/**
+ * @brief One recorded span: a task, a flow graph node task or a graph node fire.
+ */
+struct trace_event
+{
+  static constexpr uint32_t no_arg = std::numeric_limits<uint32_t>::max();
+
+  char const* name_     = nullptr; // Must have static storage duration
+  uint64_t    begin_ns_ = 0;       // Relative to the recorder's epoch
+  uint64_t    end_ns_   = 0;
+  uint32_t    worker_   = 0;
+  uint32_t    group_    = no_arg; // Workgroup index, or no_arg
+  uint32_t    arg_      = no_arg; // Node index for graph events, or no_arg
+};
+
+/**
+ * @brief Task timeline recorder producing Chrome JSON traces (chrome://tracing, ui.perfetto.dev).
+ *
+ * Attach a recorder to a scheduler with `set_trace_recorder()` before `begin_execution()`. The
+ * scheduler then records one span per executed task, and flow_graph / dynamic_flow_graph record
+ * their node tasks and node fires, each keyed by worker_id and workgroup_id.
+ *
+ * Every worker owns a fixed single-producer ring, so recording is a clock read plus a few plain
+ * stores with no shared cache line traffic. A full ring drops new events (see dropped()) rather
+ * than blocking the worker. drain() moves ring contents into the recorder and may run concurrently
+ * with recording, so long captures can be drained periodically; flush() drains and writes the
+ * trace file. A scheduler flushes its recorder at end_execution().
+ *
+ * Only spans that end are recorded; each span becomes a single Chrome "complete" (`X`) event
+ * carrying both its begin and end time.
+ */
+class trace_recorder
+{
+  using clock = std::chrono::steady_clock;
+
+public:
+  static constexpr uint32_t default_events_per_worker = 1U << 14U;
+
+  /**
+   * @param events_per_worker Ring capacity per worker, rounded up to a power of two.
+   * @param output_path       File written by flush(); leave empty to only write on demand.
+   */
+  OULY_API explicit trace_recorder(uint32_t events_per_worker = default_events_per_worker,
+                                   std::string output_path = {});
+
+  trace_recorder(trace_recorder const&)                    = delete;
+  trace_recorder(trace_recorder&&)                         = delete;
+  auto operator=(trace_recorder const&) -> trace_recorder& = delete;
+  auto operator=(trace_recorder&&) -> trace_recorder&      = delete;
+  OULY_API ~trace_recorder() noexcept;
+
+  /**
+   * @brief Size the per-worker rings. Called by the scheduler from begin_execution(); must not
+   * run while workers are recording. Events already drained are kept.
+   */
+  OULY_API void prepare(uint32_t worker_count);
+
+  /**
+   * @brief Nanoseconds since the recorder was created.
+   */
+  [[nodiscard]] auto now() const noexcept -> uint64_t
+  {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch_).count());
+  }
+
+  /**
+   * @brief Record a finished span. Only the thread running as `worker` may call this.
+   */
+  void record(worker_id worker, workgroup_id group, char const* name, uint64_t begin_ns, uint64_t end_ns,
+              uint32_t arg = trace_event::no_arg) noexcept
+  {
+    if (worker.get_index() >= worker_count_)
+    {
+      return;
+    }
+    auto& ring = ouly::detail::vector_access(rings_, worker.get_index());
+    auto  head = ring.head_.load(std::memory_order_relaxed);
+    if (head - ring.tail_.load(std::memory_order_acquire) > mask_)
+    {
+      ring.dropped_.store(ring.dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return;
+    }
+    ouly::detail::vector_access(ring.events_, head & mask_) =
+     trace_event{.name_     = name,
+                 .begin_ns_ = begin_ns,
+                 .end_ns_   = end_ns,
+                 .worker_   = worker.get_index(),
+                 .group_    = group ? group.get_index() : trace_event::no_arg,
+                 .arg_      = arg};
+    ring.head_.store(head + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Move every recorded event out of the worker rings. Safe to call from any thread while
+   * workers keep recording.
+   */
+  OULY_API void drain();
+
+  /**
+   * @brief Drain, then write every event collected so far as a Chrome JSON trace.
+   */
+  OULY_API void write_chrome_json(std::ostream& out);
+
+  /**
+   * @brief Drain and write the trace to the output path given at construction.
+   * @return false if no output path is set or the file could not be written.
+   */
+  OULY_API auto flush() -> bool;
+
+  /**
+   * @brief Drop all drained events and reset the drop counters.
+   */
+  OULY_API void clear();
+
+  /**
+   * @brief Drain and return a copy of the events collected so far, in drain order.
+   */
+  [[nodiscard]] OULY_API auto events() -> std::vector<trace_event>;
+
+  /**
+   * @brief Events lost because a worker's ring was full.
+   */
+  [[nodiscard]] OULY_API auto dropped() const noexcept -> uint64_t;
+
+  [[nodiscard]] auto get_output_path() const noexcept -> std::string const&
+  {
+    return output_path_;
+  }
+
+private:
+  struct worker_ring
+  {
+    alignas(ouly::detail::cache_line_size) std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t>                                       dropped_{0};
+    alignas(ouly::detail::cache_line_size) std::atomic<uint64_t> tail_{0};
+    std::unique_ptr<trace_event[]>                              events_;
+  };
+
+  void drain_locked();
+
+  std::unique_ptr<worker_ring[]> rings_;
+  uint32_t                       worker_count_ = 0;
+  uint64_t                       mask_         = 0;
+  uint64_t                       capacity_     = 0;
+  clock::time_point              epoch_        = clock::now();
+
+  std::mutex               drain_mutex_;
+  std::vector<trace_event> collected_;
+  std::string              output_path_;
+};
+
+/**
+ * @brief Records the enclosing scope as one span. Reads no clock when `recorder` is null.
+ */
+class trace_scope
+{
+public:
+  trace_scope(trace_recorder* recorder, worker_id worker, workgroup_id group, char const* name,
+              uint32_t arg = trace_event::no_arg) noexcept
+      : recorder_(recorder), name_(name), worker_(worker), group_(group), arg_(arg)
+  {
+    if (recorder_ != nullptr)
+    {
+      begin_ns_ = recorder_->now();
+    }
+  }
+
+  ~trace_scope() noexcept
+  {
+    if (recorder_ != nullptr)
+    {
+      recorder_->record(worker_, group_, name_, begin_ns_, recorder_->now(), arg_);
+    }
+  }
+
+  trace_scope(trace_scope const&)                    = delete;
+  trace_scope(trace_scope&&)                         = delete;
+  auto operator=(trace_scope const&) -> trace_scope& = delete;
+  auto operator=(trace_scope&&) -> trace_scope&      = delete;
+
+private:
+  trace_recorder* recorder_ = nullptr;
+  char const*     name_     = nullptr;
+  uint64_t        begin_ns_ = 0;
+  worker_id       worker_;
+  workgroup_id    group_;
+  uint32_t        arg_ = trace_event::no_arg;
+};
+
+} // namespace ouly
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 #include "ouly/scheduler/detail/v1/worker.hpp"
+#include "ouly/scheduler/scheduler_stats.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
 #include "ouly/scheduler/v1/task_context.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/common.hpp"
@@ -88,7 +90,8 @@ public:
       : worker_count_(other.worker_count_), stop_(other.stop_.load()), workers_(std::move(other.workers_)),
         group_ranges_(std::move(other.group_ranges_)), wake_data_(std::move(other.wake_data_)),
         workgroups_(std::move(other.workgroups_)), threads_(std::move(other.threads_)),
-        entry_fn_(std::move(other.entry_fn_))
+        entry_fn_(std::move(other.entry_fn_)), tracer_(other.tracer_),
+        inline_continuation_depth_(other.inline_continuation_depth_.load(std::memory_order_relaxed))
   {
     other.worker_count_ = 0;
   }
@@ -97,6 +100,8 @@ public:
   {
     if (this != &other)
     {
+      inline_continuation_depth_.store(other.inline_continuation_depth_.load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
       workgroups_         = std::move(other.workgroups_);
       workers_            = std::move(other.workers_);
       worker_count_       = other.worker_count_;
@@ -104,6 +109,7 @@ public:
       entry_fn_           = std::move(other.entry_fn_);
       group_ranges_       = std::move(other.group_ranges_);
       wake_data_          = std::move(other.wake_data_);
+      tracer_             = other.tracer_;
       other.worker_count_ = 0;
     }
     return *this;
@@ -285,6 +291,35 @@ public:
    */
   OULY_API void take_ownership() noexcept;
 
+  /**
+   * @brief Record a timeline of executed tasks (and flow graph nodes) into `recorder`, or stop
+   * recording with nullptr. Set before begin_execution(); the recorder must outlive execution and
+   * is flushed by end_execution().
+   */
+  void set_trace_recorder(trace_recorder* recorder) noexcept
+  {
+    tracer_ = recorder;
+  }
+
+  [[nodiscard]] auto get_trace_recorder() const noexcept -> trace_recorder*
+  {
+    return tracer_;
+  }
+
+  /**
+   * @brief Opt in to running task continuations on the completing worker, see
+   * ouly::v3::scheduler::set_inline_continuation_depth(). 0 (the default) queues every continuation.
+   */
+  void set_inline_continuation_depth(uint32_t max_depth) noexcept
+  {
+    inline_continuation_depth_.store(max_depth, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_inline_continuation_depth() const noexcept -> uint32_t
+  {
+    return inline_continuation_depth_.load(std::memory_order_relaxed);
+  }
+
   /**
    * @brief Try to execute queued work on the calling worker.
    * @return true if at least one work item was executed
@@ -297,6 +332,12 @@ public:
 
   OULY_API void wait_for_tasks();
 
+  /**
+   * @brief Copy the per-worker and per-workgroup telemetry counters. Lock-free and safe to call while
+   * tasks run; all counters read zero unless OULY_SCHEDULER_STATS is defined.
+   */
+  [[nodiscard]] OULY_API auto snapshot_stats() const -> scheduler_stats;
+
 private:
   /**
    * @brief Submit a work for execution
@@ -350,6 +391,8 @@ private:
 
   // Scheduler state and configuration (cold data)
   scheduler_worker_entry entry_fn_;
+  trace_recorder*        tracer_ = nullptr;
+  std::atomic_uint32_t   inline_continuation_depth_{0};
 };
 
 } // namespace ouly::v1
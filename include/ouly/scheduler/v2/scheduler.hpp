@@ -7,6 +7,8 @@
 #include "ouly/scheduler/detail/mpmc_ring.hpp"
 #include "ouly/scheduler/detail/v2/worker.hpp"
 #include "ouly/scheduler/detail/v2/workgroup.hpp"
+#include "ouly/scheduler/scheduler_stats.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/config.hpp"
 #include "ouly/utility/type_traits.hpp"
@@ -69,8 +71,9 @@ public:
   scheduler(scheduler&& other) noexcept
       : stop_(other.stop_.load()), initializer_(std::move(other.initializer_)), workers_(std::move(other.workers_)),
         workgroups_(std::move(other.workgroups_)), threads_(std::move(other.threads_)),
-        entry_fn_(std::move(other.entry_fn_)), worker_count_(other.worker_count_),
-        workgroup_count_(other.workgroup_count_)
+        entry_fn_(std::move(other.entry_fn_)), tracer_(other.tracer_),
+        inline_continuation_depth_(other.inline_continuation_depth_.load(std::memory_order_relaxed)),
+        worker_count_(other.worker_count_), workgroup_count_(other.workgroup_count_)
   {
     other.worker_count_ = 0;
   }
@@ -79,12 +82,15 @@ public:
   {
     if (this != &other)
     {
+      inline_continuation_depth_.store(other.inline_continuation_depth_.load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
       stop_            = other.stop_.load();
       initializer_     = std::move(other.initializer_);
       workers_         = std::move(other.workers_);
       workgroups_      = std::move(other.workgroups_);
       threads_         = std::move(other.threads_);
       entry_fn_        = std::move(other.entry_fn_);
+      tracer_          = other.tracer_;
       worker_count_    = other.worker_count_;
       workgroup_count_ = other.workgroup_count_;
     }
@@ -251,6 +257,35 @@ public:
    */
   OULY_API void take_ownership() noexcept;
 
+  /**
+   * @brief Record a timeline of executed tasks (and flow graph nodes) into `recorder`, or stop
+   * recording with nullptr. Set before begin_execution(); the recorder must outlive execution and
+   * is flushed by end_execution().
+   */
+  void set_trace_recorder(trace_recorder* recorder) noexcept
+  {
+    tracer_ = recorder;
+  }
+
+  [[nodiscard]] auto get_trace_recorder() const noexcept -> trace_recorder*
+  {
+    return tracer_;
+  }
+
+  /**
+   * @brief Opt in to running task continuations on the completing worker, see
+   * ouly::v3::scheduler::set_inline_continuation_depth(). 0 (the default) queues every continuation.
+   */
+  void set_inline_continuation_depth(uint32_t max_depth) noexcept
+  {
+    inline_continuation_depth_.store(max_depth, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_inline_continuation_depth() const noexcept -> uint32_t
+  {
+    return inline_continuation_depth_.load(std::memory_order_relaxed);
+  }
+
   /**
    * @brief Worker busy work loop - called when worker has no immediate work
    * @return true if at least one work item was executed
@@ -264,6 +299,12 @@ public:
 
   OULY_API void wait_for_tasks();
 
+  /**
+   * @brief Copy the per-worker and per-workgroup telemetry counters. Lock-free and safe to call while
+   * tasks run; all counters read zero unless OULY_SCHEDULER_STATS is defined.
+   */
+  [[nodiscard]] OULY_API auto snapshot_stats() const -> scheduler_stats;
+
 private:
   /**
    * @brief Submit a work for execution - new implementation using mailbox system
@@ -322,6 +363,8 @@ private:
 
   // Scheduler state and configuration (cold data)
   scheduler_worker_entry entry_fn_;
+  trace_recorder*        tracer_ = nullptr;
+  std::atomic_uint32_t   inline_continuation_depth_{0};
 
   uint32_t worker_count_    = 0;
   uint32_t workgroup_count_ = 0;
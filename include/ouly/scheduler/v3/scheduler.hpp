@@ -2,24 +2,97 @@
 #pragma once
 #include "ouly/scheduler/co_task.hpp"
 #include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include "ouly/scheduler/detail/v3/parking_lot.hpp"
 #include "ouly/scheduler/detail/v3/worker.hpp"
 #include "ouly/scheduler/detail/v3/workgroup.hpp"
+#include "ouly/scheduler/scheduler_stats.hpp"
+#include "ouly/scheduler/topology.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
 #include "ouly/scheduler/v3/task_context.hpp"
 #include "ouly/scheduler/worker_structs.hpp"
 #include "ouly/utility/config.hpp"
 #include "ouly/utility/type_traits.hpp"
 #include <array>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <coroutine>
 #include <cstdint>
-#include <mutex>
+#include <ranges>
+#include <span>
 #include <thread>
 #include <vector>
 
 namespace ouly::v3
 {
 
+/**
+ * @brief How an idle worker picks sibling deques to steal from within a workgroup.
+ */
+enum class steal_policy : uint8_t
+{
+  // Probe every sibling once, from a random start or in topology victim order when set.
+  sweep,
+  // Probe uniformly random siblings, one xorshift draw per probe. Spreads concurrent thieves
+  // under deep recursive splits; ignores the topology victim order.
+  randomized,
+  // Retry the sibling of the last successful steal in the group first, then sweep.
+  last_victim_first
+};
+
+/**
+ * @brief Priority lane inside a workgroup. A worker always serves the most urgent non-empty lane of
+ * a group first (see scheduler::set_lane_aging_period() for how starved lanes still progress).
+ */
+enum class task_lane : uint8_t
+{
+  // Latency-critical jobs (input, audio mixing) that must jump ahead of bulk work
+  critical,
+  // Lane of every submit() that does not name one
+  normal,
+  // Bulk work that only runs when nothing more urgent is queued in the group
+  background
+};
+
+static_assert(static_cast<uint32_t>(task_lane::background) + 1 == detail::v3::lane_count);
+static_assert(static_cast<uint32_t>(task_lane::normal) == detail::v3::default_lane);
+
+/**
+ * @brief Absolute completion deadline of a task, see scheduler::set_deadline_thresholds().
+ */
+using task_deadline = std::chrono::steady_clock::time_point;
+
+/**
+ * @brief How an idle worker decides between spinning and parking.
+ */
+enum class idle_policy : uint8_t
+{
+  // Poll a fixed number of times (set_idle_spin_count()) before parking.
+  fixed,
+  // Spin for a window derived from each worker's recent idle gaps: short gaps inside a burst are
+  // bridged by spinning, long gaps between frames park at once. See set_max_idle_spin().
+  adaptive
+};
+
+/**
+ * @brief Idle period counters summed over all workers. Collected under every idle_policy.
+ */
+struct idle_stats
+{
+  uint64_t spin_hits_    = 0; // Idle periods ended by work found while spinning
+  uint64_t spin_misses_  = 0; // Idle periods that spun without finding work, then parked
+  uint64_t direct_parks_ = 0; // Idle periods that parked without spinning
+  uint64_t spin_ns_      = 0; // Total time spent spinning, in nanoseconds
+};
+
+/**
+ * @brief Steal counters summed over all workers.
+ */
+struct steal_stats
+{
+  uint64_t attempts_  = 0;
+  uint64_t successes_ = 0;
+};
+
 /**
  * @brief A work-stealing task scheduler designed for game engines.
  *
@@ -34,15 +107,24 @@ namespace ouly::v3
  *   covers it, decided at begin_execution(). No slot claiming, no migration, no locks on
  *   the hot path.
  * - Per (workgroup, member) Chase-Lev deque for local push/pop, per-workgroup MPMC
- *   mailbox for cross-group and external submissions.
+ *   mailbox for cross-group and external submissions. A full mailbox spills into an
+ *   unbounded segmented overflow queue, so submit never blocks or spins.
  * - Accurate queue accounting: a workgroup advertises only items actually sitting in its
  *   queues. Idle workers therefore park even while long tasks execute elsewhere.
- * - Idle workers block on a condition variable coordinated by the work-queue mutex.
- *   Submitters notify through the same mutex, preventing lost wakeups without spinning.
+ * - Idle workers park on their own futex word (std::atomic::wait) and advertise themselves in an
+ *   idle bitmask. Submitters wake a sleeping member of the destination group directly, with no
+ *   global lock, and the Dekker-style handshake in parking_lot prevents lost wakeups.
+ *   Under idle_policy::adaptive each worker first spins for a window learned from its recent
+ *   idle gaps, so bursts inside a frame avoid the park/unpark round trip.
  * - Wake chaining: a worker that dequeues an item and observes more queued work wakes one
  *   more sleeper, so bursts (parallel_for) fan out without broadcast storms.
- * - wait_for_tasks() helps execute work, then blocks on the same condition variable
- *   until all submitted tasks (queued and in-flight) complete.
+ * - Priority lanes: every group queue exists once per task_lane, so latency-critical jobs
+ *   overtake bulk work submitted to the same group; tasks can also be routed by deadline.
+ * - wait_for_tasks() helps execute work, then parks the same way until all submitted tasks
+ *   (queued and in-flight) complete; the last completion wakes only such waiters.
+ * - Optional topology placement (set_topology()): workers are pinned to CPUs grouped by LLC
+ *   and NUMA node, and steal from siblings behind the same LLC before crossing to another
+ *   cache domain or socket.
  *
  * The public API mirrors v1/v2: submit() overloads, task_context, workgroup creation,
  * busy_work(), wait_for_tasks(), begin/end_execution().
@@ -54,24 +136,45 @@ namespace ouly::v3
 class scheduler
 {
 public:
-  static constexpr uint32_t work_scale = 4;
+  static constexpr uint32_t work_scale           = 4;
+  static constexpr uint32_t batch_chunk_size     = 64; // Items bound per batch by the range submit_batch()
+  static constexpr uint32_t default_aging_period = 16;
+
+  static constexpr std::chrono::nanoseconds default_critical_slack   = std::chrono::milliseconds(1);
+  static constexpr std::chrono::nanoseconds default_background_slack = std::chrono::milliseconds(33);
+  static constexpr std::chrono::nanoseconds default_max_idle_spin    = std::chrono::microseconds(50);
 
   using delegate_type = ouly::v3::task_delegate;
   using context_type  = ouly::v3::task_context;
+  using lane_type     = ouly::v3::task_lane;
 
   OULY_API scheduler() noexcept                  = default;
   scheduler(scheduler const&)                    = delete;
   auto operator=(scheduler const&) -> scheduler& = delete;
   OULY_API ~scheduler() noexcept;
 
+  /**
+   * @brief Construct with a steal policy other than the default steal_policy::sweep.
+   */
+  explicit scheduler(steal_policy policy) noexcept : steal_policy_(policy) {}
+
   /**
    * @brief Move is only valid before begin_execution() (no worker threads running).
    */
   scheduler(scheduler&& other) noexcept
-      : workers_(std::move(other.workers_)), workgroups_(std::move(other.workgroups_)),
+      : idle_spin_count_(other.idle_spin_count_.load(std::memory_order_relaxed)),
+        idle_policy_(other.idle_policy_.load(std::memory_order_relaxed)),
+        max_idle_spin_ns_(other.max_idle_spin_ns_.load(std::memory_order_relaxed)),
+        aging_period_(other.aging_period_.load(std::memory_order_relaxed)),
+        critical_slack_(other.critical_slack_.load(std::memory_order_relaxed)),
+        background_slack_(other.background_slack_.load(std::memory_order_relaxed)),
+        workers_(std::move(other.workers_)), workgroups_(std::move(other.workgroups_)),
         threads_(std::move(other.threads_)), workgroup_descs_(other.workgroup_descs_),
-        entry_fn_(std::move(other.entry_fn_)), worker_count_(other.worker_count_),
-        workgroup_count_(other.workgroup_count_), stop_(other.stop_.load(std::memory_order_relaxed))
+        topology_(std::move(other.topology_)), entry_fn_(std::move(other.entry_fn_)), tracer_(other.tracer_),
+        inline_continuation_depth_(other.inline_continuation_depth_.load(std::memory_order_relaxed)),
+        worker_count_(other.worker_count_), workgroup_count_(other.workgroup_count_),
+        pin_workers_(other.pin_workers_), steal_policy_(other.steal_policy_),
+        stop_(other.stop_.load(std::memory_order_relaxed))
   {
     OULY_ASSERT(other.threads_.empty());
     other.worker_count_    = 0;
@@ -84,13 +187,25 @@ public:
     {
       OULY_ASSERT(other.threads_.empty());
       stop_.store(other.stop_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      idle_spin_count_.store(other.idle_spin_count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      idle_policy_.store(other.idle_policy_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      max_idle_spin_ns_.store(other.max_idle_spin_ns_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      aging_period_.store(other.aging_period_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      critical_slack_.store(other.critical_slack_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      background_slack_.store(other.background_slack_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      inline_continuation_depth_.store(other.inline_continuation_depth_.load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
       workers_               = std::move(other.workers_);
       workgroups_            = std::move(other.workgroups_);
       threads_               = std::move(other.threads_);
       workgroup_descs_       = other.workgroup_descs_;
+      topology_              = std::move(other.topology_);
       entry_fn_              = std::move(other.entry_fn_);
+      tracer_                = other.tracer_;
       worker_count_          = other.worker_count_;
       workgroup_count_       = other.workgroup_count_;
+      pin_workers_           = other.pin_workers_;
+      steal_policy_          = other.steal_policy_;
       other.worker_count_    = 0;
       other.workgroup_count_ = 0;
     }
@@ -139,6 +254,27 @@ public:
     submit(current, current.get_workgroup(), std::forward<Lambda>(data));
   }
 
+  /**
+   * @brief Submits a callable work item into a priority lane of `group`.
+   */
+  template <typename Lambda>
+    requires(std::invocable<Lambda, task_context const&> && !std::is_same_v<std::decay_t<Lambda>, delegate_type>)
+  void submit(task_context const& src, workgroup_id group, task_lane lane, Lambda&& data) noexcept
+  {
+    submit_internal(src, group, delegate_type::bind(std::forward<Lambda>(data)), lane);
+  }
+
+  /**
+   * @brief Submits a callable work item that should finish by `deadline`. The lane is picked from
+   * the remaining slack when the task is submitted, see set_deadline_thresholds().
+   */
+  template <typename Lambda>
+    requires(std::invocable<Lambda, task_context const&> && !std::is_same_v<std::decay_t<Lambda>, delegate_type>)
+  void submit(task_context const& src, workgroup_id group, task_deadline deadline, Lambda&& data) noexcept
+  {
+    submit_internal(src, group, delegate_type::bind(std::forward<Lambda>(data)), lane_for(deadline));
+  }
+
   /**
    * @brief Submits a function pointer with packaged arguments.
    */
@@ -155,6 +291,53 @@ public:
     submit_internal(src, src.get_workgroup(), delegate_type::bind(ptr, std::forward<PackArgs>(args)...));
   }
 
+  /**
+   * @brief Submit many work items to one workgroup at once.
+   *
+   * Equivalent to calling submit() for every item, but the bookkeeping is paid once per batch:
+   * one reservation of the pending count, one bulk push (the caller's own deque when it is a
+   * member of `group`, otherwise the mailbox and its overflow), one update of the group's queued
+   * count and one scan for sleeping members, waking at most min(tasks.size(), sleeping members).
+   * Prefer it for frame-wide fan-outs of many small jobs.
+   */
+  OULY_API void submit_batch(task_context const& current, workgroup_id group, std::span<delegate_type const> tasks,
+                             task_lane lane = task_lane::normal);
+
+  /**
+   * @brief Submit every element of a range (a container, a view or a generator) to one workgroup.
+   * Elements are delegates or callables taking `task_context const&`; they are bound into chunks of
+   * batch_chunk_size items, each submitted as one batch.
+   */
+  template <std::ranges::input_range Range>
+    requires((std::invocable<std::ranges::range_reference_t<Range>, task_context const&> ||
+              std::convertible_to<std::ranges::range_reference_t<Range>, delegate_type>) &&
+             !std::convertible_to<Range, std::span<delegate_type const>>)
+  void submit_batch(task_context const& current, workgroup_id group, Range&& tasks, task_lane lane = task_lane::normal)
+  {
+    std::array<delegate_type, batch_chunk_size> chunk;
+    std::size_t                                 count = 0;
+    for (auto&& task : tasks)
+    {
+      if constexpr (std::convertible_to<decltype(task), delegate_type>)
+      {
+        ouly::detail::vector_access(chunk, count++) = task;
+      }
+      else
+      {
+        ouly::detail::vector_access(chunk, count++) = delegate_type::bind(std::forward<decltype(task)>(task));
+      }
+      if (count == batch_chunk_size)
+      {
+        submit_batch(current, group, std::span<delegate_type const>(chunk.data(), count), lane);
+        count = 0;
+      }
+    }
+    if (count > 0)
+    {
+      submit_batch(current, group, std::span<delegate_type const>(chunk.data(), count), lane);
+    }
+  }
+
   /**
    * @brief Begin scheduler execution, group creation is frozen after this call.
    * @param entry An entry function executed on all worker threads upon entry.
@@ -167,6 +350,57 @@ public:
    */
   OULY_API void end_execution();
 
+  /**
+   * @brief Place workers on a CPU topology. Must be called before begin_execution().
+   *
+   * Worker `w` is assigned `topo.cpu_for_worker(w)`; because the topology keeps CPUs grouped by
+   * NUMA node and LLC, contiguous workgroup ranges stay cache-local. Each worker then steals from
+   * members of its groups nearest first (same core, same LLC, same node, remote).
+   *
+   * @param topo CPU description, typically topology::detect().
+   * @param pin_workers Pin worker threads to their CPUs. Worker 0 is the thread that calls
+   * begin_execution() and is never pinned by the scheduler.
+   */
+  void set_topology(topology topo, bool pin_workers = true)
+  {
+    OULY_ASSERT(threads_.empty());
+    topology_    = std::move(topo);
+    pin_workers_ = pin_workers;
+  }
+
+  [[nodiscard]] auto get_topology() const noexcept -> topology const&
+  {
+    return topology_;
+  }
+
+  [[nodiscard]] auto get_steal_policy() const noexcept -> steal_policy
+  {
+    return steal_policy_;
+  }
+
+  /**
+   * @brief Sum of every worker's steal attempt/success counters. Relaxed reads; cheap enough to
+   * sample once per frame.
+   */
+  [[nodiscard]] OULY_API auto get_steal_stats() const noexcept -> steal_stats;
+
+  /**
+   * @brief Copy the per-worker and per-workgroup telemetry counters. Lock-free and safe to call while
+   * tasks run. Apart from the steal counts, all counters read zero unless OULY_SCHEDULER_STATS is
+   * defined.
+   */
+  [[nodiscard]] OULY_API auto snapshot_stats() const -> scheduler_stats;
+
+  /**
+   * @brief Inspect a worker's placement (CPU, victim order) and counters. Valid after
+   * begin_execution().
+   */
+  [[nodiscard]] auto get_worker(worker_id wid) const noexcept -> detail::v3::worker const&
+  {
+    OULY_ASSERT(workers_ && wid.get_index() < worker_count_);
+    return ouly::detail::vector_access(workers_, wid.get_index());
+  }
+
   /**
    * @brief Get worker count in the scheduler
    */
@@ -211,6 +445,44 @@ public:
    */
   OULY_API void take_ownership() noexcept;
 
+  /**
+   * @brief Record a timeline of executed tasks (and flow graph nodes) into `recorder`, or stop
+   * recording with nullptr. Set before begin_execution(); the recorder must outlive execution and
+   * is flushed by end_execution().
+   */
+  void set_trace_recorder(trace_recorder* recorder) noexcept
+  {
+    tracer_ = recorder;
+  }
+
+  [[nodiscard]] auto get_trace_recorder() const noexcept -> trace_recorder*
+  {
+    return tracer_;
+  }
+
+  /**
+   * @brief Opt in to running continuations on the worker that completes their last dependency.
+   *
+   * With a non-zero `max_depth`, a `then()` or `when_all()` continuation bound to the completing
+   * worker's workgroup runs as a direct call instead of a queue push and pop, as long as fewer than
+   * `max_depth` task bodies are already nested on that worker's stack; deeper chains fall back to the
+   * queue. Coroutines awaiting a co_task in their own workgroup are resumed by symmetric transfer.
+   * Continuations attached to an already finished task are always queued, so then() never runs user
+   * code on the calling thread. 0 (the default) disables both.
+   *
+   * Only affects tasks completing on this scheduler. Inline continuations trade parallelism for
+   * latency: a continuation runs on the completing worker even if others are idle.
+   */
+  void set_inline_continuation_depth(uint32_t max_depth) noexcept
+  {
+    inline_continuation_depth_.store(max_depth, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_inline_continuation_depth() const noexcept -> uint32_t
+  {
+    return inline_continuation_depth_.load(std::memory_order_relaxed);
+  }
+
   /**
    * @brief Try to execute a small amount of queued work on the calling worker.
    */
@@ -227,13 +499,47 @@ public:
   OULY_API void wait_for_tasks();
 
   /**
-   * @brief Number of poll attempts an idle worker makes before parking on the condition variable.
+   * @brief Select how idle workers choose between spinning and parking. Defaults to
+   * idle_policy::fixed with a spin count of 0, i.e. park immediately.
+   */
+  void set_idle_policy(idle_policy policy) noexcept
+  {
+    idle_policy_.store(policy, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_idle_policy() const noexcept -> idle_policy
+  {
+    return idle_policy_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Longest spin window of idle_policy::adaptive. A worker whose predicted idle gap exceeds
+   * it parks at once; set it near the cost of a park/unpark round trip on the target machine.
+   */
+  void set_max_idle_spin(std::chrono::nanoseconds limit) noexcept
+  {
+    max_idle_spin_ns_.store(limit.count(), std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_max_idle_spin() const noexcept -> std::chrono::nanoseconds
+  {
+    return std::chrono::nanoseconds(max_idle_spin_ns_.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief Sum of every worker's idle period counters. Per-worker values, including the predicted
+   * idle gap, are available through get_worker(wid).get_idle_controller().
+   */
+  [[nodiscard]] OULY_API auto get_idle_stats() const noexcept -> idle_stats;
+
+  /**
+   * @brief Number of poll attempts an idle worker makes before parking under idle_policy::fixed.
    *
    * Defaults to 0: workers park immediately, which is the right trade for latency-insensitive or
-   * power-sensitive workloads. Parking costs a mutex acquisition plus a condvar round trip, and
-   * every submit broadcasts, so bursty producers of short tasks can spend more time parking and
-   * waking than executing. Giving idle workers a small spin window (tens to a few hundred) lets
-   * them pick up the next burst without that round trip, at the cost of burning CPU while idle.
+   * power-sensitive workloads. Parking costs a futex wait and a wake syscall on the submitter, so
+   * bursty producers of short tasks can spend more time parking and waking than executing. Giving
+   * idle workers a small spin window (tens to a few hundred) lets them pick up the next burst
+   * without that round trip, at the cost of burning CPU while idle.
    */
   void set_idle_spin_count(uint32_t spins) noexcept
   {
@@ -245,16 +551,66 @@ public:
     return idle_spin_count_.load(std::memory_order_relaxed);
   }
 
+  /**
+   * @brief Route deadline submissions: a task whose remaining slack is at most `critical` goes to
+   * task_lane::critical, one with at least `background` slack to task_lane::background, anything
+   * in between to task_lane::normal. Defaults: 1 ms and 33 ms (two 60 Hz frames).
+   */
+  void set_deadline_thresholds(std::chrono::nanoseconds critical, std::chrono::nanoseconds background) noexcept
+  {
+    critical_slack_.store(critical.count(), std::memory_order_relaxed);
+    background_slack_.store(background.count(), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Lane aging: every `period`-th dequeue of a worker serves a less urgent lane first, so a
+   * steady stream of critical work cannot starve normal and background work forever. Each lower
+   * lane gets at least one in `period * (lane count - 1)` of a worker's dequeues while it is
+   * non-empty. 0 disables aging (strict priority). Defaults to default_aging_period.
+   */
+  void set_lane_aging_period(uint32_t period) noexcept
+  {
+    aging_period_.store(period, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto get_lane_aging_period() const noexcept -> uint32_t
+  {
+    return aging_period_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Lane a task with `deadline` would be submitted to right now.
+   */
+  [[nodiscard]] auto lane_for(task_deadline deadline) const noexcept -> task_lane
+  {
+    auto slack = (deadline - std::chrono::steady_clock::now()).count();
+    if (slack <= critical_slack_.load(std::memory_order_relaxed))
+    {
+      return task_lane::critical;
+    }
+    return slack >= background_slack_.load(std::memory_order_relaxed) ? task_lane::background : task_lane::normal;
+  }
+
 private:
   friend class task_context;
 
-  OULY_API void submit_internal(task_context const& current, workgroup_id dst, detail::v3::work_item const& work);
+  using clock = std::chrono::steady_clock;
+
+  OULY_API void submit_internal(task_context const& current, workgroup_id dst, detail::v3::work_item const& work,
+                                task_lane lane = task_lane::normal);
 
   void run_worker(worker_id wid);
+  auto spin_for_work(detail::v3::worker& wkr, clock::time_point idle_begin, clock::time_point& found) noexcept
+   -> bool;
 
   auto try_execute_one(worker_id wid) noexcept -> bool;
+  auto try_take(detail::v3::worker& wkr, uint32_t group_index, uint32_t lane, detail::v3::work_item& out) noexcept
+   -> bool;
+  auto try_steal(detail::v3::worker& wkr, uint32_t group_index, uint32_t own, uint32_t lane,
+                 detail::v3::work_item& out) noexcept -> bool;
   void execute_work(detail::v3::worker& wkr, uint32_t group_index, detail::v3::work_item& work) noexcept;
-  void notify_workers(uint32_t count) noexcept;
+  void wake_group(uint32_t group_index, uint32_t count) noexcept;
+  void assign_topology();
   void finish_task() noexcept;
 
   [[nodiscard]] auto has_queued_work(detail::v3::worker const& wkr) const noexcept -> bool;
@@ -262,24 +618,37 @@ private:
   // Tasks submitted but not yet finished executing (queued + in-flight).
   ouly::detail::cache_aligned_atomic<uint32_t> pending_{uint32_t{0}};
 
-  // Coordinates worker parking with submit/finish notifications. Queue operations remain
-  // lock-free; this mutex only serializes condition-variable wait/notify handoff.
-  std::mutex              work_queue_mutex_;
-  std::condition_variable work_available_;
+  // Per-worker futex parking with targeted wakeups; no lock on the submit path.
+  detail::v3::parking_lot parking_;
 
   // Poll attempts before an idle worker parks. See set_idle_spin_count().
   std::atomic<uint32_t> idle_spin_count_{0};
 
+  // Spin-then-park controller, see set_idle_policy() and set_max_idle_spin().
+  std::atomic<idle_policy> idle_policy_{idle_policy::fixed};
+  std::atomic<int64_t>     max_idle_spin_ns_{default_max_idle_spin.count()};
+
+  // Lane selection, see set_lane_aging_period() and set_deadline_thresholds().
+  std::atomic<uint32_t> aging_period_{default_aging_period};
+  std::atomic<int64_t>  critical_slack_{default_critical_slack.count()};
+  std::atomic<int64_t>  background_slack_{default_background_slack.count()};
+
   std::unique_ptr<detail::v3::worker[]>    workers_;
   std::unique_ptr<detail::v3::workgroup[]> workgroups_;
   std::vector<std::thread>                 threads_;
 
   std::array<detail::v3::workgroup_desc, detail::v3::max_workgroup> workgroup_descs_{};
 
+  topology topology_;
+
   scheduler_worker_entry entry_fn_;
+  trace_recorder*        tracer_ = nullptr;
+  std::atomic<uint32_t>  inline_continuation_depth_{0};
 
-  uint32_t worker_count_    = 0;
-  uint32_t workgroup_count_ = 0;
+  uint32_t     worker_count_    = 0;
+  uint32_t     workgroup_count_ = 0;
+  bool         pin_workers_     = false;
+  steal_policy steal_policy_    = steal_policy::sweep;
 
   std::atomic_bool stop_{false};
 };
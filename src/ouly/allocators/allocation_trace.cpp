@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/allocators/allocation_trace.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace ouly
+{
+namespace
+{
+constexpr std::array<char, 4> trace_magic   = {'O', 'T', 'R', 'C'};
+constexpr std::uint64_t       trace_version = 1;
+
+/* Tag byte of an event: the operation in the top bit, log2 of the alignment below it */
+constexpr std::uint8_t op_bit         = 0x80U;
+constexpr std::uint8_t alignment_mask = 0x7FU;
+
+void write_varint(std::ostream& stream, std::uint64_t value)
+{
+  std::array<char, 10> bytes = {};
+  std::size_t          count = 0;
+  do
+  {
+    auto byte = static_cast<std::uint8_t>(value & 0x7FU);
+    value >>= 7U;
+    if (value != 0)
+    {
+      byte |= 0x80U;
+    }
+    bytes[count++] = static_cast<char>(byte);
+  }
+  while (value != 0);
+  stream.write(bytes.data(), static_cast<std::streamsize>(count));
+}
+
+auto read_byte(std::istream& stream) -> std::uint8_t
+{
+  auto const value = stream.get();
+  if (value == std::istream::traits_type::eof())
+  {
+    throw std::out_of_range("Not enough data in the trace");
+  }
+  return static_cast<std::uint8_t>(value);
+}
+
+auto read_varint(std::istream& stream) -> std::uint64_t
+{
+  std::uint64_t value = 0;
+  for (std::uint32_t shift = 0; shift < 64; shift += 7)
+  {
+    auto const byte = read_byte(stream);
+    value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+    if ((byte & 0x80U) == 0)
+    {
+      return value;
+    }
+  }
+  throw std::invalid_argument("Malformed varint in the trace");
+}
+} // namespace
+
+void write_trace(std::ostream& stream, allocation_trace const& trace)
+{
+  stream.write(trace_magic.data(), trace_magic.size());
+  write_varint(stream, trace_version);
+  write_varint(stream, trace.id_count_);
+  write_varint(stream, trace.events_.size());
+
+  std::uint64_t last = 0;
+  for (auto const& event : trace.events_)
+  {
+    OULY_ASSERT(event.timestamp_ >= last && event.alignment_log2_ <= alignment_mask);
+    auto const tag = static_cast<std::uint8_t>((event.op_ == allocation_trace_op::deallocate ? op_bit : 0U) |
+                                               (event.alignment_log2_ & alignment_mask));
+    stream.put(static_cast<char>(tag));
+    write_varint(stream, event.timestamp_ - last);
+    write_varint(stream, event.size_);
+    write_varint(stream, event.id_);
+    last = event.timestamp_;
+  }
+}
+
+auto read_trace(std::istream& stream) -> allocation_trace
+{
+  std::array<char, 4> magic = {};
+  stream.read(magic.data(), magic.size());
+  if (stream.gcount() != static_cast<std::streamsize>(magic.size()) || magic != trace_magic)
+  {
+    throw std::invalid_argument("Not an allocation trace");
+  }
+  if (read_varint(stream) != trace_version)
+  {
+    throw std::invalid_argument("Unsupported allocation trace version");
+  }
+
+  allocation_trace trace;
+  trace.id_count_   = static_cast<std::uint32_t>(read_varint(stream));
+  auto const events = read_varint(stream);
+  // The count comes from the file, do not trust it for more than a modest reservation
+  trace.events_.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(events, std::uint64_t{1} << 20U)));
+
+  std::uint64_t last = 0;
+  for (std::uint64_t i = 0; i < events; ++i)
+  {
+    auto const tag        = read_byte(stream);
+    auto       event      = allocation_trace_event{};
+    event.op_             = (tag & op_bit) != 0 ? allocation_trace_op::deallocate : allocation_trace_op::allocate;
+    event.alignment_log2_ = static_cast<std::uint8_t>(tag & alignment_mask);
+    event.timestamp_      = last + read_varint(stream);
+    event.size_           = read_varint(stream);
+    event.id_             = static_cast<std::uint32_t>(read_varint(stream));
+    if (event.id_ >= trace.id_count_ || event.alignment_log2_ >= 64)
+    {
+      throw std::invalid_argument("Corrupt allocation trace event");
+    }
+    last = event.timestamp_;
+    trace.events_.push_back(event);
+  }
+  return trace;
+}
+} // namespace ouly
@@ -2,6 +2,8 @@
 
 #include "ouly/allocators/detail/platform_memory.hpp"
 #include <algorithm>
+#include <array>
+#include <cstdint>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -113,12 +115,57 @@ inline static auto advice_to_posix(cfg::advice advice_type) noexcept -> int
     return MADV_WILLNEED;
   case cfg::advice::dont_need:
     return MADV_DONTNEED;
+  case cfg::advice::huge_page:
+#ifdef MADV_HUGEPAGE
+    return MADV_HUGEPAGE;
+#else
+    return MADV_NORMAL;
+#endif
   default:
     return MADV_NORMAL;
   }
 }
+
+/**
+ * Map `size` bytes at an `align` boundary by over-mapping and trimming both ends; the trimmed
+ * pieces are unmapped again, so the region is released with a plain munmap of `size` bytes
+ */
+inline static auto map_aligned(std::size_t size, std::size_t align, int posix_prot) noexcept -> void*
+{
+  std::size_t const span = size + align;
+  void*             raw  = mmap(nullptr, span, posix_prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  auto const base    = reinterpret_cast<std::uintptr_t>(raw); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto const aligned = (base + align - 1) & ~(align - 1);
+  auto const head    = aligned - base;
+  auto const tail    = span - head - size;
+  if (head != 0)
+  {
+    munmap(raw, head);
+  }
+  if (tail != 0)
+  {
+    munmap(reinterpret_cast<void*>(aligned + size), tail); // NOLINT(performance-no-int-to-ptr)
+  }
+  return reinterpret_cast<void*>(aligned); // NOLINT(performance-no-int-to-ptr)
+}
+
+/** Mark a region for transparent huge pages; failing only means it stays on regular pages */
+inline static void advise_huge_pages([[maybe_unused]] void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+#ifdef MADV_HUGEPAGE
+  madvise(ptr, size, MADV_HUGEPAGE);
 #endif
-auto get_memory_info() noexcept -> memory_info
+}
+#endif
+
+constexpr std::size_t default_huge_page_size = std::size_t{2} * 1024 * 1024;
+
+inline static auto query_memory_info() noexcept -> memory_info
 {
   memory_info info{};
 
@@ -127,11 +174,41 @@ auto get_memory_info() noexcept -> memory_info
   GetSystemInfo(&sys_info);
   info.page_size_              = sys_info.dwPageSize;
   info.allocation_granularity_ = sys_info.dwAllocationGranularity;
+  info.huge_page_size_         = GetLargePageMinimum();
 #else
   info.page_size_              = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
   info.allocation_granularity_ = info.page_size_; // On Unix, allocation granularity == page size
+#ifdef __linux__
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  int fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", O_RDONLY);
+  if (fd != -1)
+  {
+    constexpr std::size_t        max_digits = 32;
+    std::array<char, max_digits> text{};
+    auto const                   length = read(fd, text.data(), text.size() - 1);
+    close(fd);
+    auto const  digits = length > 0 ? static_cast<std::size_t>(length) : std::size_t{0};
+    std::size_t value  = 0;
+    for (std::size_t i = 0; i < digits && text[i] >= '0' && text[i] <= '9'; ++i)
+    {
+      value = (value * 10) + static_cast<std::size_t>(text[i] - '0'); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    }
+    info.huge_page_size_ = value;
+  }
+#endif
 #endif
 
+  if (info.huge_page_size_ < info.page_size_ || (info.huge_page_size_ & (info.huge_page_size_ - 1)) != 0)
+  {
+    info.huge_page_size_ = std::max(default_huge_page_size, info.page_size_);
+  }
+  return info;
+}
+
+auto get_memory_info() noexcept -> memory_info
+{
+  // Allocators query this on construction; the huge page size takes a file read on Linux
+  static memory_info const info = query_memory_info();
   return info;
 }
 
@@ -154,6 +231,53 @@ auto virtual_alloc(std::size_t size, cfg::protection prot, void* preferred_addre
 #endif
 }
 
+auto virtual_alloc_huge(std::size_t size, cfg::huge_page_policy policy, cfg::protection prot) noexcept -> void*
+{
+  if (policy == cfg::huge_page_policy::none)
+  {
+    return virtual_alloc(size, prot);
+  }
+
+#ifdef _WIN32
+  // Windows has no transparent huge pages; large pages need the lock memory privilege and a size
+  // that is a multiple of the large page minimum
+  DWORD protect = protection_to_win32(prot);
+  if (policy == cfg::huge_page_policy::dedicated)
+  {
+    auto const large = GetLargePageMinimum();
+    if (large != 0 && size % large == 0)
+    {
+      void* result = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, protect);
+      if (result != nullptr)
+      {
+        return result;
+      }
+    }
+  }
+  return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, protect);
+#else
+  int        posix_prot = protection_to_posix(prot);
+  auto const huge       = get_memory_info().huge_page_size_;
+#ifdef MAP_HUGETLB
+  if (policy == cfg::huge_page_policy::dedicated && size % huge == 0)
+  {
+    // Fails when the huge page pool is empty, which is the default on most systems
+    void* result = mmap(nullptr, size, posix_prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (result != MAP_FAILED)
+    {
+      return result;
+    }
+  }
+#endif
+  void* result = map_aligned(size, huge, posix_prot);
+  if (result != nullptr)
+  {
+    advise_huge_pages(result, size);
+  }
+  return result;
+#endif
+}
+
 auto virtual_free(void* ptr, std::size_t size) noexcept -> bool
 {
   if (ptr == nullptr)
@@ -169,6 +293,61 @@ auto virtual_free(void* ptr, std::size_t size) noexcept -> bool
 #endif
 }
 
+auto virtual_reserve(std::size_t size, [[maybe_unused]] cfg::huge_page_policy policy) noexcept -> void*
+{
+#ifdef _WIN32
+  return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+  if (policy != cfg::huge_page_policy::none)
+  {
+    // Reserved huge pages cannot be committed piecemeal, so both policies use transparent ones; the
+    // advice sticks to the range and applies to the pages mprotect() later commits
+    void* result = map_aligned(size, get_memory_info().huge_page_size_, PROT_NONE);
+    if (result != nullptr)
+    {
+      advise_huge_pages(result, size);
+    }
+    return result;
+  }
+
+  // An inaccessible private mapping is not charged against the commit limit; mprotect() charges the
+  // pages it makes writable, so commit fails cleanly instead of faulting later
+  void* result = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return (result == MAP_FAILED) ? nullptr : result;
+#endif
+}
+
+auto virtual_commit(void* ptr, std::size_t size, cfg::protection prot) noexcept -> bool
+{
+  if (ptr == nullptr)
+  {
+    return false;
+  }
+
+#ifdef _WIN32
+  return VirtualAlloc(ptr, size, MEM_COMMIT, protection_to_win32(prot)) != nullptr;
+#else
+  return mprotect(ptr, size, protection_to_posix(prot)) == 0;
+#endif
+}
+
+auto virtual_decommit(void* ptr, std::size_t size) noexcept -> bool
+{
+  if (ptr == nullptr)
+  {
+    return false;
+  }
+
+#ifdef _WIN32
+  return VirtualFree(ptr, size, MEM_DECOMMIT) != FALSE;
+#else
+  // Mapping fresh inaccessible pages over the range drops its memory in one call and leaves it
+  // reserved; a later commit sees zeroed pages again
+  void* result = mmap(ptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  return result != MAP_FAILED;
+#endif
+}
+
 auto virtual_protect(void* ptr, std::size_t size, cfg::protection new_prot) noexcept -> bool
 {
   if (ptr == nullptr)
@@ -0,0 +1,467 @@
+
+#include "ouly/allocators/ts_pool_allocator.hpp"
+#include "ouly/utility/common.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace ouly
+{
+struct ts_pool_allocator::free_block
+{
+  free_block* next_          = nullptr; ///< Next block of the same magazine or batch
+  free_block* next_magazine_ = nullptr; ///< Next magazine in a depot, only set on the first block
+};
+
+struct ts_pool_allocator::slab_t
+{
+  /** Cache that carves the slab, remote frees go back to it. Changes when its range is adopted. */
+  std::atomic<thread_cache*> owner_      = nullptr;
+  uint32_t                   size_class_ = 0;       ///< Size class of every block in the slab
+  slab_t*                    next_page_  = nullptr; ///< Next page, only set on the first slab of a page
+};
+
+struct ts_pool_allocator::thread_cache
+{
+  /** Per-class state of a thread cache, only ever touched by the owning thread */
+  struct cache_bin
+  {
+    free_block*   head_         = nullptr; ///< Magazine of free blocks
+    uint32_t      count_        = 0;       ///< Blocks in the magazine
+    uint32_t      remote_count_ = 0;       ///< Blocks in the pending remote batch
+    std::byte*    cursor_       = nullptr; ///< Next uncarved block of the current slab
+    std::byte*    end_          = nullptr; ///< End of the last whole block of the slab
+    thread_cache* remote_owner_ = nullptr; ///< Owner of the pending remote batch
+    free_block*   remote_head_  = nullptr;
+    free_block*   remote_tail_  = nullptr;
+  };
+
+  std::shared_ptr<std::atomic_bool>       alive_; ///< Cleared when the owning thread exits
+  thread_cache*                           next_ = nullptr;
+  std::array<cache_bin, size_class_count> bins_ = {};
+
+  /** Blocks other threads freed back home, one lock-free list per size class */
+  alignas(ouly_cache_line_size) std::array<std::atomic<free_block*>, size_class_count> remote_ = {};
+};
+
+namespace
+{
+struct tls_slot
+{
+  uint64_t                         id_    = 0;       ///< Allocator the cache belongs to
+  ts_pool_allocator::thread_cache* cache_ = nullptr; ///< Calling thread's cache in that allocator
+};
+
+/* A thread usually talks to one or two pools; remembering a few keeps the lookup a short scan */
+constexpr uint32_t tls_slot_count = 4;
+
+/* Marks the caches of a thread as orphaned once it exits; shared so it outlives allocators and thread alike */
+struct thread_life
+{
+  std::shared_ptr<std::atomic_bool> alive_ = std::make_shared<std::atomic_bool>(true);
+
+  thread_life() = default;
+  thread_life(thread_life const&)                    = delete;
+  thread_life(thread_life&&)                         = delete;
+  auto operator=(thread_life const&) -> thread_life& = delete;
+  auto operator=(thread_life&&) -> thread_life&      = delete;
+  ~thread_life() noexcept
+  {
+    alive_->store(false, std::memory_order_release);
+  }
+};
+
+// NOLINTBEGIN
+thread_local std::array<tls_slot, tls_slot_count> local_caches = {};
+thread_local uint32_t                             local_victim = 0;
+thread_local thread_life                          local_life;
+// NOLINTEND
+
+auto is_orphaned(ts_pool_allocator::thread_cache const& cache) noexcept -> bool
+{
+  return !cache.alive_->load(std::memory_order_acquire);
+}
+
+auto slab_of(void* ptr) noexcept -> ts_pool_allocator::slab_t*
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+  return reinterpret_cast<ts_pool_allocator::slab_t*>(reinterpret_cast<std::uintptr_t>(ptr) &
+                                                      ~(ts_pool_allocator::slab_size - 1));
+}
+} // namespace
+
+auto ts_pool_allocator::next_id() noexcept -> uint64_t
+{
+  static std::atomic<uint64_t> next{1}; // 0 marks an empty thread-local slot
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto ts_pool_allocator::allocate_block(std::size_t size, std::size_t align) -> void*
+{
+  auto const size_class = size_class_of(size, align);
+  if (size_class == size_class_count) [[unlikely]]
+  {
+    return ::operator new(size, std::align_val_t{std::max(align, alignment)});
+  }
+
+  auto* cache = local_cache();
+  auto& bin   = cache->bins_[size_class];
+  if (auto* block = bin.head_; block != nullptr) [[likely]]
+  {
+    bin.head_ = block->next_;
+    --bin.count_;
+    return block; // **zero synchronisation**
+  }
+  return refill(*cache, size_class);
+}
+
+void ts_pool_allocator::deallocate_block(void* ptr, std::size_t size, std::size_t align)
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+
+  auto const size_class = size_class_of(size, align);
+  if (size_class == size_class_count) [[unlikely]]
+  {
+    ::operator delete(ptr, std::align_val_t{std::max(align, alignment)});
+    return;
+  }
+
+  auto* cache = local_cache();
+  auto* slab  = slab_of(ptr);
+  OULY_ASSERT(slab->size_class_ == size_class && "ts_pool_allocator: size does not match the allocation");
+
+  auto& bin   = cache->bins_[size_class];
+  auto* block = ::new (ptr) free_block{};
+  auto* owner = slab->owner_.load(std::memory_order_relaxed);
+  if (owner == cache) [[likely]]
+  {
+    block->next_ = bin.head_;
+    bin.head_    = block;
+    if (++bin.count_ < 2 * magazine_size_) [[likely]]
+    {
+      return;
+    }
+
+    // Keep one magazine for the next allocations and hand the other one to the depot
+    auto* last = bin.head_;
+    for (uint32_t i = 1; i < magazine_size_; ++i)
+    {
+      last = last->next_;
+    }
+    auto* magazine = bin.head_;
+    bin.head_      = last->next_;
+    last->next_    = nullptr;
+    bin.count_ -= magazine_size_;
+    push_magazine(size_class, magazine);
+    return;
+  }
+
+  // Remote free: batch blocks going to the same owner so they travel home with one CAS
+  if (bin.remote_owner_ != owner)
+  {
+    flush_remote(*cache, size_class);
+    bin.remote_owner_ = owner;
+    bin.remote_tail_  = block;
+  }
+  block->next_     = bin.remote_head_;
+  bin.remote_head_ = block;
+  if (++bin.remote_count_ >= magazine_size_)
+  {
+    flush_remote(*cache, size_class);
+  }
+}
+
+auto ts_pool_allocator::local_cache() -> thread_cache*
+{
+  for (auto const& slot : local_caches)
+  {
+    if (slot.id_ == id_)
+    {
+      return slot.cache_;
+    }
+  }
+  return attach_thread();
+}
+
+auto ts_pool_allocator::attach_thread() -> thread_cache*
+{
+  auto const&   alive  = local_life.alive_;
+  thread_cache* cache  = nullptr;
+  thread_cache* orphan = nullptr;
+  {
+    std::scoped_lock lock{mutex_};
+    // A thread that was evicted from the thread-local slots picks up its existing cache; a new
+    // thread takes over the cache of one that exited, along with the blocks and slabs it holds
+    for (auto* it = caches_; it != nullptr; it = it->next_)
+    {
+      if (it->alive_ == alive)
+      {
+        cache = it;
+        break;
+      }
+      if (orphan == nullptr && is_orphaned(*it))
+      {
+        orphan = it;
+      }
+    }
+    if (cache == nullptr && orphan != nullptr)
+    {
+      cache         = orphan;
+      cache->alive_ = alive;
+    }
+    if (cache == nullptr)
+    {
+      cache         = new thread_cache; // NOLINT(cppcoreguidelines-owning-memory)
+      cache->alive_ = alive;
+      cache->next_  = caches_;
+      caches_       = cache;
+    }
+  }
+
+  local_caches[local_victim++ % tls_slot_count] = tls_slot{.id_ = id_, .cache_ = cache};
+  return cache;
+}
+
+auto ts_pool_allocator::refill(thread_cache& cache, uint32_t size_class) -> void*
+{
+  auto& bin = cache.bins_[size_class];
+
+  // 1) Blocks other threads sent home
+  auto* block = cache.remote_[size_class].exchange(nullptr, std::memory_order_acquire);
+
+  // 2) Otherwise a full magazine from the depot
+  if (block == nullptr)
+  {
+    auto&            depot = depots_[size_class];
+    std::scoped_lock lock{depot.mutex_};
+    block = depot.magazines_;
+    if (block != nullptr)
+    {
+      depot.magazines_ = block->next_magazine_;
+    }
+  }
+
+  // 3) Otherwise, rather than cutting a new slab, whatever the caches of exited threads hold
+  if (block == nullptr && bin.cursor_ == bin.end_)
+  {
+    block = adopt_orphaned(cache, size_class);
+  }
+
+  if (block != nullptr)
+  {
+    uint32_t count = 0;
+    for (auto* it = block->next_; it != nullptr; it = it->next_)
+    {
+      ++count;
+    }
+    bin.head_  = block->next_;
+    bin.count_ = count;
+    return block;
+  }
+
+  // 4) Otherwise carve a magazine worth of fresh blocks, cutting a new slab if this one is used up
+  if (bin.cursor_ == bin.end_)
+  {
+    carve_slab(cache, size_class);
+  }
+
+  auto const block_size = size_class_size(size_class);
+  void*      result     = bin.cursor_;
+  bin.cursor_ += block_size;
+  while (bin.count_ + 1 < magazine_size_ && bin.cursor_ != bin.end_)
+  {
+    bin.head_ = ::new (bin.cursor_) free_block{.next_ = bin.head_};
+    ++bin.count_;
+    bin.cursor_ += block_size;
+  }
+  return result;
+}
+
+auto ts_pool_allocator::adopt_orphaned(thread_cache& cache, uint32_t size_class) -> free_block*
+{
+  auto&            bin = cache.bins_[size_class];
+  std::scoped_lock lock{mutex_};
+  for (auto* orphan = caches_; orphan != nullptr; orphan = orphan->next_)
+  {
+    if (orphan == &cache || !is_orphaned(*orphan))
+    {
+      continue;
+    }
+    // No thread touches an orphaned cache's bins; holding mutex_ keeps other adopters out
+    flush_remote(*orphan, size_class);
+    auto& from  = orphan->bins_[size_class];
+    auto* block = orphan->remote_[size_class].exchange(nullptr, std::memory_order_acquire);
+    if (block == nullptr)
+    {
+      block       = from.head_;
+      from.head_  = nullptr;
+      from.count_ = 0;
+    }
+    if (block != nullptr)
+    {
+      return block;
+    }
+    if (from.cursor_ != from.end_)
+    {
+      // The uncarved rest of the slab; refill() carves it as if it were its own. Frees of its
+      // blocks then stay local instead of taking the remote path to the exited thread's cache.
+      bin.cursor_ = std::exchange(from.cursor_, nullptr);
+      bin.end_    = std::exchange(from.end_, nullptr);
+      slab_of(bin.cursor_)->owner_.store(&cache, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+void ts_pool_allocator::carve_slab(thread_cache& cache, uint32_t size_class)
+{
+  static_assert(sizeof(slab_t) <= max_slab_alignment);
+  static_assert(default_page_size % slab_size == 0);
+
+  std::byte* memory = nullptr;
+  {
+    std::scoped_lock lock{mutex_};
+    slab_t*          slab = nullptr;
+    if (page_cursor_ == page_end_)
+    {
+      // The first slab of a page links the pages for release()
+      memory       = static_cast<std::byte*>(::operator new(default_page_size, std::align_val_t{slab_size}));
+      page_cursor_ = memory + slab_size;
+      page_end_    = memory + default_page_size;
+      slab         = ::new (memory) slab_t{.next_page_ = pages_};
+      pages_       = slab;
+    }
+    else
+    {
+      memory = page_cursor_;
+      page_cursor_ += slab_size;
+      slab = ::new (memory) slab_t{};
+    }
+    slab->owner_.store(&cache, std::memory_order_relaxed);
+    slab->size_class_ = size_class;
+  }
+  slab_count_.fetch_add(1, std::memory_order_relaxed);
+
+  auto const block_size  = size_class_size(size_class);
+  auto const block_count = (slab_size - max_slab_alignment) / block_size;
+  auto&      bin         = cache.bins_[size_class];
+  bin.cursor_            = memory + max_slab_alignment;
+  bin.end_               = bin.cursor_ + (block_count * block_size);
+}
+
+void ts_pool_allocator::push_magazine(uint32_t size_class, free_block* magazine) noexcept
+{
+  auto&            depot = depots_[size_class];
+  std::scoped_lock lock{depot.mutex_};
+  magazine->next_magazine_ = depot.magazines_;
+  depot.magazines_         = magazine;
+}
+
+void ts_pool_allocator::flush_remote(thread_cache& cache, uint32_t size_class) noexcept
+{
+  auto& bin = cache.bins_[size_class];
+  if (bin.remote_head_ == nullptr)
+  {
+    return;
+  }
+
+  auto& home = bin.remote_owner_->remote_[size_class];
+  auto* head = home.load(std::memory_order_relaxed);
+  do
+  {
+    bin.remote_tail_->next_ = head;
+  }
+  while (!home.compare_exchange_weak(head, bin.remote_head_, std::memory_order_release, std::memory_order_relaxed));
+
+  bin.remote_owner_ = nullptr;
+  bin.remote_head_  = nullptr;
+  bin.remote_tail_  = nullptr;
+  bin.remote_count_ = 0;
+}
+
+void ts_pool_allocator::flush_cache(thread_cache& cache) noexcept
+{
+  for (uint32_t size_class = 0; size_class < size_class_count; ++size_class)
+  {
+    flush_remote(cache, size_class);
+
+    auto& bin   = cache.bins_[size_class];
+    auto* block = cache.remote_[size_class].exchange(nullptr, std::memory_order_acquire);
+    // Everything left goes to the depot in magazines of at most magazine_size_ blocks
+    while (block != nullptr || bin.head_ != nullptr)
+    {
+      if (block == nullptr)
+      {
+        block     = bin.head_;
+        bin.head_ = nullptr;
+      }
+      auto*    magazine = block;
+      uint32_t count    = 1;
+      while (count < magazine_size_ && block->next_ != nullptr)
+      {
+        block = block->next_;
+        ++count;
+      }
+      auto* rest   = block->next_;
+      block->next_ = nullptr;
+      push_magazine(size_class, magazine);
+      block = rest;
+    }
+    bin.count_ = 0;
+  }
+}
+
+void ts_pool_allocator::flush_thread_cache() noexcept
+{
+  for (auto const& slot : local_caches)
+  {
+    if (slot.id_ == id_)
+    {
+      flush_cache(*slot.cache_);
+      return;
+    }
+  }
+}
+
+void ts_pool_allocator::release() noexcept
+{
+  std::scoped_lock lock{mutex_};
+  // Thread-local slots still name the old id, so no thread finds the caches freed below
+  id_ = next_id();
+
+  auto* cache = caches_;
+  while (cache != nullptr)
+  {
+    auto* next = cache->next_;
+    delete cache; // NOLINT(cppcoreguidelines-owning-memory)
+    cache = next;
+  }
+  caches_ = nullptr;
+
+  auto* page = pages_;
+  while (page != nullptr)
+  {
+    auto* next = page->next_page_;
+    ::operator delete(page, std::align_val_t{slab_size});
+    page = next;
+  }
+  pages_       = nullptr;
+  page_cursor_ = nullptr;
+  page_end_    = nullptr;
+
+  for (auto& depot : depots_)
+  {
+    depot.magazines_ = nullptr;
+  }
+  slab_count_.store(0, std::memory_order_relaxed);
+}
+} // namespace ouly
@@ -1,6 +1,7 @@
 
 #include "ouly/allocators/ts_thread_local_allocator.hpp"
 #include "ouly/allocators/config.hpp"
+#include "ouly/allocators/detail/platform_memory.hpp"
 #include "ouly/utility/common.hpp"
 #include <algorithm>
 #include <atomic>
@@ -228,7 +229,7 @@ void ts_thread_local_allocator::reset() noexcept
   while (page != nullptr)
   {
     arena_t* next = page->next_;
-    ::operator delete(page, std::align_val_t{alignof(std::max_align_t)});
+    destroy_page(page);
     page = next;
   }
   pages_to_free_ = nullptr;
@@ -241,7 +242,7 @@ void ts_thread_local_allocator::release() noexcept
   while (page != nullptr)
   {
     arena_t* next = page->next_;
-    ::operator delete(page, std::align_val_t{alignof(std::max_align_t)});
+    destroy_page(page);
     page = next;
   }
   available_pages_ = nullptr;
@@ -249,7 +250,23 @@ void ts_thread_local_allocator::release() noexcept
 auto ts_thread_local_allocator::create_page(std::size_t payload_size) -> arena_t*
 {
   std::size_t total = sizeof(arena_t) + payload_size;
-  void*       raw   = ::operator new(total, std::align_val_t{alignof(std::max_align_t)});
+  void*       raw   = nullptr;
+  if (huge_pages_ == cfg::huge_page_policy::none)
+  {
+    raw = ::operator new(total, std::align_val_t{alignof(std::max_align_t)});
+  }
+  else
+  {
+    // Whole huge pages are mapped either way, so the payload grows to use all of them
+    auto const huge = ouly::detail::get_memory_info().huge_page_size_;
+    total           = ((total + huge - 1) / huge) * huge;
+    payload_size    = total - sizeof(arena_t);
+    raw             = ouly::detail::virtual_alloc_huge(total, huge_pages_);
+    if (raw == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+  }
 
   auto* page  = static_cast<arena_t*>(raw);
   page->used_ = 0;
@@ -257,6 +274,17 @@ auto ts_thread_local_allocator::create_page(std::size_t payload_size) -> arena_t
   page->next_ = nullptr;
   return page;
 }
+void ts_thread_local_allocator::destroy_page(arena_t* page) const noexcept
+{
+  if (huge_pages_ == cfg::huge_page_policy::none)
+  {
+    ::operator delete(page, std::align_val_t{alignof(std::max_align_t)});
+  }
+  else
+  {
+    ouly::detail::virtual_free(page, sizeof(arena_t) + page->size_);
+  }
+}
 auto ts_thread_local_allocator::pop_free_list(std::size_t min_payload) -> arena_t*
 {
   if (available_pages_ != nullptr && available_pages_->size_ >= min_payload)
@@ -281,9 +309,7 @@ auto ts_thread_local_allocator::allocate_slow_path(std::size_t size, std::size_t
   {
     // If the requested size is larger than the default page size,
     // we allocate a single large page that is not reused.
-    auto* arena =
-     static_cast<arena_t*>(::operator new(sizeof(arena_t) + payload, std::align_val_t{alignof(std::max_align_t)}));
-    arena->size_ = payload;
+    auto* arena = create_page(payload);
 
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
     auto const padding = ouly::detail::align_padding(reinterpret_cast<std::uintptr_t>(&arena->data_[0]), align);
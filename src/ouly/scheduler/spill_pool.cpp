@@ -0,0 +1,260 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/scheduler/spill_pool.hpp"
+#include "ouly/scheduler/detail/cache_optimized_data.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) // structure was padded due to alignment specifier
+#endif
+
+namespace ouly
+{
+
+namespace
+{
+
+constexpr uint32_t min_block_shift = std::countr_zero(spill_pool::min_block_size);
+constexpr uint32_t class_count     = std::countr_zero(spill_pool::max_block_size) - min_block_shift + 1;
+
+class thread_pool;
+
+struct block_header
+{
+  block_header* next_       = nullptr;
+  thread_pool*  owner_      = nullptr; // Null for blocks above the largest size class
+  uint32_t      size_class_ = 0;
+};
+
+constexpr std::size_t header_size =
+ (sizeof(block_header) + spill_pool::alignment - 1) & ~(spill_pool::alignment - 1);
+
+std::atomic<uint64_t> total_slabs{0};
+std::atomic<uint64_t> total_large_blocks{0};
+std::atomic<uint64_t> total_remote_frees{0};
+
+auto header_of(void* block) noexcept -> block_header*
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<block_header*>(static_cast<std::byte*>(block) - header_size);
+}
+
+auto payload_of(block_header* header) noexcept -> void*
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return reinterpret_cast<std::byte*>(header) + header_size;
+}
+
+auto size_class_of(std::size_t size) noexcept -> uint32_t
+{
+  auto const rounded = std::max<std::size_t>(size, spill_pool::min_block_size) - 1;
+  return static_cast<uint32_t>(std::bit_width(rounded >> min_block_shift));
+}
+
+/**
+ * Pool of one thread. Only the owning thread touches the local lists, slabs and allocation count;
+ * other threads only push onto the remote lists and bump remote_state_.
+ *
+ * remote_state_ packs the number of remote frees with an `orphaned` bit set when the owning thread
+ * exits. Both the owner's final fetch_or and every remote fetch_add see the whole word, so exactly
+ * one of them observes "orphaned and nothing outstanding" and deletes the pool; nobody touches the
+ * pool after an RMW that did not.
+ */
+class thread_pool
+{
+  static constexpr uint64_t orphaned_bit = uint64_t{1} << 63U;
+
+public:
+  auto allocate(uint32_t size_class) -> block_header*
+  {
+    auto& list = ouly::detail::vector_access(classes_, size_class);
+    if (list.local_ == nullptr)
+    {
+      list.local_ = list.remote_.exchange(nullptr, std::memory_order_acquire);
+      if (list.local_ == nullptr)
+      {
+        carve_slab(size_class);
+      }
+      else
+      {
+        report_remote_frees();
+      }
+    }
+    auto* block = std::exchange(list.local_, list.local_->next_);
+    ++allocated_;
+    return block;
+  }
+
+  void free_local(block_header* block) noexcept
+  {
+    auto& list   = ouly::detail::vector_access(classes_, block->size_class_);
+    block->next_ = list.local_;
+    list.local_  = block;
+    ++freed_local_;
+  }
+
+  /**
+   * @brief Push a block freed by another thread. Deletes the pool if it was the last block of an
+   * exited thread.
+   */
+  void free_remote(block_header* block) noexcept
+  {
+    auto& list = ouly::detail::vector_access(classes_, block->size_class_);
+    auto* head = list.remote_.load(std::memory_order_relaxed);
+    do
+    {
+      block->next_ = head;
+    }
+    while (!list.remote_.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+
+    auto const state = remote_state_.get().fetch_add(1, std::memory_order_acq_rel) + 1;
+    if ((state & orphaned_bit) != 0 && is_drained(state))
+    {
+      delete this; // NOLINT(cppcoreguidelines-owning-memory)
+    }
+  }
+
+  /**
+   * @brief Called once by the owning thread on exit.
+   */
+  void retire() noexcept
+  {
+    report_remote_frees();
+    auto const state = remote_state_.get().fetch_or(orphaned_bit, std::memory_order_acq_rel);
+    if (is_drained(state))
+    {
+      delete this; // NOLINT(cppcoreguidelines-owning-memory)
+    }
+  }
+
+private:
+  struct free_lists
+  {
+    block_header*                                                     local_ = nullptr;
+    alignas(ouly::detail::cache_line_size) std::atomic<block_header*> remote_{nullptr};
+  };
+
+  [[nodiscard]] auto is_drained(uint64_t state) const noexcept -> bool
+  {
+    return freed_local_ + (state & ~orphaned_bit) == allocated_;
+  }
+
+  void carve_slab(uint32_t size_class)
+  {
+    auto const stride = header_size + (spill_pool::min_block_size << size_class);
+    auto const count  = spill_pool::slab_size / stride;
+    auto&      slab   = slabs_.emplace_back(std::make_unique<std::byte[]>(spill_pool::slab_size));
+    auto&      list   = ouly::detail::vector_access(classes_, size_class);
+    for (std::size_t i = count; i-- > 0;)
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto* block = ::new (slab.get() + (i * stride))
+       block_header{.next_ = list.local_, .owner_ = this, .size_class_ = size_class};
+      list.local_ = block;
+    }
+    total_slabs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void report_remote_frees() noexcept
+  {
+    auto const freed = remote_state_.get().load(std::memory_order_relaxed) & ~orphaned_bit;
+    total_remote_frees.fetch_add(freed - reported_remote_, std::memory_order_relaxed);
+    reported_remote_ = freed;
+  }
+
+  std::array<free_lists, class_count>          classes_;
+  std::vector<std::unique_ptr<std::byte[]>>    slabs_;
+  uint64_t                                     allocated_       = 0;
+  uint64_t                                     freed_local_     = 0;
+  uint64_t                                     reported_remote_ = 0;
+  ouly::detail::cache_aligned_atomic<uint64_t> remote_state_{0U};
+};
+
+thread_local thread_pool* current_pool = nullptr;
+
+struct pool_owner
+{
+  pool_owner() noexcept                            = default;
+  pool_owner(pool_owner const&)                    = delete;
+  pool_owner(pool_owner&&)                         = delete;
+  auto operator=(pool_owner const&) -> pool_owner& = delete;
+  auto operator=(pool_owner&&) -> pool_owner&      = delete;
+  ~pool_owner() noexcept
+  {
+    if (auto* pool = std::exchange(current_pool, nullptr))
+    {
+      pool->retire();
+    }
+  }
+};
+
+thread_local pool_owner current_owner;
+
+auto local_pool() -> thread_pool&
+{
+  if (current_pool == nullptr)
+  {
+    // Touching the owner constructs it, so its destructor retires the pool at thread exit
+    [[maybe_unused]] auto const* owner = &current_owner;
+    current_pool                       = new thread_pool(); // NOLINT(cppcoreguidelines-owning-memory)
+  }
+  return *current_pool;
+}
+
+} // namespace
+
+auto spill_pool::allocate(std::size_t size) -> void*
+{
+  if (size > max_block_size)
+  {
+    auto* block = ::new (::operator new(header_size + size)) block_header{.size_class_ = class_count};
+    total_large_blocks.fetch_add(1, std::memory_order_relaxed);
+    return payload_of(block);
+  }
+  return payload_of(local_pool().allocate(size_class_of(size)));
+}
+
+void spill_pool::deallocate(void* block) noexcept
+{
+  if (block == nullptr)
+  {
+    return;
+  }
+  auto* header = header_of(block);
+  auto* owner  = header->owner_;
+  if (owner == nullptr)
+  {
+    ::operator delete(header);
+  }
+  else if (owner == current_pool)
+  {
+    owner->free_local(header);
+  }
+  else
+  {
+    owner->free_remote(header);
+  }
+}
+
+auto spill_pool::get_stats() noexcept -> spill_pool_stats
+{
+  return {.slabs_        = total_slabs.load(std::memory_order_relaxed),
+          .large_blocks_ = total_large_blocks.load(std::memory_order_relaxed),
+          .remote_frees_ = total_remote_frees.load(std::memory_order_relaxed)};
+}
+
+} // namespace ouly
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/scheduler/topology.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ouly
+{
+
+namespace
+{
+
+constexpr uint32_t package_shift = 16;
+
+#ifdef __linux__
+constexpr uint32_t max_cache_index = 16;
+constexpr uint32_t decimal_base    = 10;
+
+auto read_line(std::string const& path, std::string& out) -> bool
+{
+  std::ifstream file(path);
+  return file.is_open() && static_cast<bool>(std::getline(file, out));
+}
+
+auto read_uint(std::string const& path, uint32_t& out) -> bool
+{
+  std::string line;
+  if (!read_line(path, line))
+  {
+    return false;
+  }
+  try
+  {
+    out = static_cast<uint32_t>(std::stoul(line));
+  }
+  catch (...)
+  {
+    return false;
+  }
+  return true;
+}
+
+// Parses sysfs cpu lists such as "0-3,8,10-11".
+auto parse_cpu_list(std::string const& list) -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> result;
+  uint32_t              first    = 0;
+  uint32_t              value    = 0;
+  bool                  in_range = false;
+  bool                  has_ch   = false;
+
+  auto flush = [&]()
+  {
+    if (!has_ch)
+    {
+      return;
+    }
+    for (uint32_t cpu = in_range ? first : value; cpu <= value; ++cpu)
+    {
+      result.push_back(cpu);
+    }
+    value    = 0;
+    in_range = false;
+    has_ch   = false;
+  };
+
+  for (char ch : list)
+  {
+    if (ch >= '0' && ch <= '9')
+    {
+      value  = (value * decimal_base) + static_cast<uint32_t>(ch - '0');
+      has_ch = true;
+    }
+    else if (ch == '-')
+    {
+      first    = value;
+      value    = 0;
+      in_range = true;
+    }
+    else if (ch == ',')
+    {
+      flush();
+    }
+  }
+  flush();
+  return result;
+}
+
+// CPUs in the process affinity mask, in id order; empty when the mask cannot be read.
+auto affinity_cpus() -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> ids;
+  cpu_set_t             allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+  {
+    for (uint32_t id = 0; id < CPU_SETSIZE; ++id)
+    {
+      if (CPU_ISSET(id, &allowed))
+      {
+        ids.push_back(id);
+      }
+    }
+  }
+  return ids;
+}
+
+auto detect_sysfs(std::vector<cpu_info>& cpus) -> bool
+{
+  std::string const root = "/sys/devices/system/cpu/";
+
+  std::string online;
+  if (!read_line(root + "online", online))
+  {
+    return false;
+  }
+
+  // Only CPUs the process may run on are usable; cgroups and taskset narrow the online set.
+  auto ids = parse_cpu_list(online);
+  if (auto const allowed = affinity_cpus(); !allowed.empty())
+  {
+    std::erase_if(ids,
+                  [&allowed](uint32_t id)
+                  {
+                    return !std::ranges::binary_search(allowed, id);
+                  });
+  }
+  if (ids.empty())
+  {
+    return false;
+  }
+
+  for (auto id : ids)
+  {
+    std::string const base = root + "cpu" + std::to_string(id) + "/";
+    cpu_info          info;
+    info.cpu_ = id;
+
+    uint32_t core_id = id;
+    uint32_t package = 0;
+    read_uint(base + "topology/core_id", core_id);
+    read_uint(base + "topology/physical_package_id", package);
+    info.core_ = (package << package_shift) | core_id;
+
+    // The LLC is the highest-level data/unified cache; its key is the lowest CPU sharing it.
+    uint32_t best_level = 0;
+    info.llc_           = id;
+    for (uint32_t index = 0; index < max_cache_index; ++index)
+    {
+      std::string const cache = base + "cache/index" + std::to_string(index) + "/";
+      uint32_t          level = 0;
+      if (!read_uint(cache + "level", level))
+      {
+        break;
+      }
+      std::string type;
+      if (read_line(cache + "type", type) && type == "Instruction")
+      {
+        continue;
+      }
+      std::string shared;
+      if (level > best_level && read_line(cache + "shared_cpu_list", shared))
+      {
+        auto sharing = parse_cpu_list(shared);
+        if (!sharing.empty())
+        {
+          best_level = level;
+          info.llc_  = *std::ranges::min_element(sharing);
+        }
+      }
+    }
+    cpus.push_back(info);
+  }
+
+  // NUMA nodes list their CPUs; machines without NUMA support have no node directory.
+  std::string nodes;
+  if (read_line("/sys/devices/system/node/online", nodes))
+  {
+    for (auto node : parse_cpu_list(nodes))
+    {
+      std::string cpulist;
+      if (!read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", cpulist))
+      {
+        continue;
+      }
+      for (auto id : parse_cpu_list(cpulist))
+      {
+        auto it = std::ranges::find(cpus, id, &cpu_info::cpu_);
+        if (it != cpus.end())
+        {
+          it->numa_node_ = node;
+        }
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+} // namespace
+
+topology::topology(std::vector<cpu_info> cpus) : cpus_(std::move(cpus))
+{
+  std::ranges::sort(cpus_,
+                    [](cpu_info const& lhs, cpu_info const& rhs) -> bool
+                    {
+                      return std::tie(lhs.numa_node_, lhs.llc_, lhs.core_, lhs.cpu_) <
+                             std::tie(rhs.numa_node_, rhs.llc_, rhs.core_, rhs.cpu_);
+                    });
+
+  // Within an LLC, hand out the first hardware thread of every core before any SMT sibling, so
+  // consecutive workers land on different cores.
+  std::vector<std::pair<uint32_t, cpu_info>> ranked;
+  ranked.reserve(cpus_.size());
+  uint32_t smt_index = 0;
+  for (size_t i = 0; i < cpus_.size(); ++i)
+  {
+    smt_index = (i > 0 && distance(cpus_[i - 1], cpus_[i]) == cpu_distance::same_core) ? smt_index + 1 : 0;
+    ranked.emplace_back(smt_index, cpus_[i]);
+  }
+  std::ranges::stable_sort(ranked,
+                           [](auto const& lhs, auto const& rhs) -> bool
+                           {
+                             return std::tie(lhs.second.numa_node_, lhs.second.llc_, lhs.first) <
+                                    std::tie(rhs.second.numa_node_, rhs.second.llc_, rhs.first);
+                           });
+  std::ranges::transform(ranked, cpus_.begin(), &std::pair<uint32_t, cpu_info>::second);
+}
+
+auto topology::detect() -> topology
+{
+  std::vector<cpu_info> cpus;
+  std::vector<uint32_t> ids;
+#ifdef __linux__
+  if (!detect_sysfs(cpus))
+  {
+    cpus.clear();
+    ids = affinity_cpus();
+  }
+#endif
+  if (cpus.empty())
+  {
+    if (ids.empty())
+    {
+      ids.resize(std::max(std::thread::hardware_concurrency(), 1U));
+      std::iota(ids.begin(), ids.end(), 0U);
+    }
+    cpus.reserve(ids.size());
+    for (auto cpu : ids)
+    {
+      cpus.push_back(cpu_info{.cpu_ = cpu, .core_ = cpu, .llc_ = 0, .numa_node_ = 0});
+    }
+  }
+  return topology(std::move(cpus));
+}
+
+auto topology::pin_current_thread([[maybe_unused]] uint32_t cpu) noexcept -> bool
+{
+#ifdef _WIN32
+  constexpr uint32_t mask_bits = std::numeric_limits<DWORD_PTR>::digits;
+  if (cpu >= mask_bits)
+  {
+    return false;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif defined(__linux__)
+  if (cpu >= CPU_SETSIZE)
+  {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+} // namespace ouly
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: MIT
+
+#include "ouly/scheduler/trace_recorder.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ouly
+{
+
+namespace
+{
+
+constexpr uint64_t ns_per_us   = 1000;
+constexpr int      us_decimals = 3;
+
+// Chrome traces take microseconds; keep nanosecond precision as three decimals.
+void write_us(std::ostream& out, uint64_t ns)
+{
+  auto fill = out.fill('0');
+  out << ns / ns_per_us << '.' << std::setw(us_decimals) << ns % ns_per_us;
+  out.fill(fill);
+}
+
+void write_name(std::ostream& out, char const* name)
+{
+  out << '"';
+  for (char const* c = name != nullptr ? name : "unnamed"; *c != '\0'; ++c)
+  {
+    if (*c == '"' || *c == '\\')
+    {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+
+} // namespace
+
+trace_recorder::trace_recorder(uint32_t events_per_worker, std::string output_path)
+    : capacity_(std::bit_ceil(std::max<uint64_t>(events_per_worker, 1))), output_path_(std::move(output_path))
+{
+  mask_ = capacity_ - 1;
+}
+
+trace_recorder::~trace_recorder() noexcept = default;
+
+void trace_recorder::prepare(uint32_t worker_count)
+{
+  std::scoped_lock lock(drain_mutex_);
+  if (rings_)
+  {
+    drain_locked();
+  }
+  rings_        = std::make_unique<worker_ring[]>(worker_count);
+  worker_count_ = worker_count;
+  for (uint32_t w = 0; w < worker_count; ++w)
+  {
+    ouly::detail::vector_access(rings_, w).events_ = std::make_unique<trace_event[]>(capacity_);
+  }
+}
+
+void trace_recorder::drain()
+{
+  std::scoped_lock lock(drain_mutex_);
+  drain_locked();
+}
+
+void trace_recorder::drain_locked()
+{
+  for (uint32_t w = 0; w < worker_count_; ++w)
+  {
+    auto& ring = ouly::detail::vector_access(rings_, w);
+    auto  head = ring.head_.load(std::memory_order_acquire);
+    auto  tail = ring.tail_.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail)
+    {
+      collected_.push_back(ouly::detail::vector_access(ring.events_, tail & mask_));
+    }
+    // Publishing the new tail hands the slots back to the worker.
+    ring.tail_.store(head, std::memory_order_release);
+  }
+}
+
+void trace_recorder::write_chrome_json(std::ostream& out)
+{
+  std::scoped_lock lock(drain_mutex_);
+  drain_locked();
+
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (uint32_t w = 0; w < worker_count_; ++w)
+  {
+    out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << w
+        << ",\"args\":{\"name\":\"worker " << w << "\"}}";
+    first = false;
+  }
+  for (auto const& ev : collected_)
+  {
+    out << (first ? "" : ",") << "\n{\"name\":";
+    write_name(out, ev.name_);
+    out << ",\"cat\":\"ouly\",\"ph\":\"X\",\"pid\":0,\"tid\":" << ev.worker_ << ",\"ts\":";
+    write_us(out, ev.begin_ns_);
+    out << ",\"dur\":";
+    write_us(out, ev.end_ns_ >= ev.begin_ns_ ? ev.end_ns_ - ev.begin_ns_ : 0);
+    out << ",\"args\":{";
+    bool first_arg = true;
+    if (ev.group_ != trace_event::no_arg)
+    {
+      out << "\"workgroup\":" << ev.group_;
+      first_arg = false;
+    }
+    if (ev.arg_ != trace_event::no_arg)
+    {
+      out << (first_arg ? "" : ",") << "\"node\":" << ev.arg_;
+    }
+    out << "}}";
+    first = false;
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+auto trace_recorder::flush() -> bool
+{
+  if (output_path_.empty())
+  {
+    drain();
+    return false;
+  }
+  std::ofstream file(output_path_, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  write_chrome_json(file);
+  return static_cast<bool>(file);
+}
+
+void trace_recorder::clear()
+{
+  std::scoped_lock lock(drain_mutex_);
+  drain_locked();
+  collected_.clear();
+  for (uint32_t w = 0; w < worker_count_; ++w)
+  {
+    ouly::detail::vector_access(rings_, w).dropped_.store(0, std::memory_order_relaxed);
+  }
+}
+
+auto trace_recorder::events() -> std::vector<trace_event>
+{
+  std::scoped_lock lock(drain_mutex_);
+  drain_locked();
+  return collected_;
+}
+
+auto trace_recorder::dropped() const noexcept -> uint64_t
+{
+  uint64_t total = 0;
+  for (uint32_t w = 0; w < worker_count_; ++w)
+  {
+    total += ouly::detail::vector_access(rings_, w).dropped_.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+} // namespace ouly
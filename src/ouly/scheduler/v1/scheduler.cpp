@@ -60,8 +60,12 @@ inline void scheduler::do_work(workgroup_id id, worker_id thread, ouly::detail::
 {
   auto& worker            = ouly::detail::vector_access(workers_, thread.get_index()).get();
   worker.current_context_ = &ouly::detail::vector_access(worker.contexts_, id.get_index());
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-  work(*worker.current_context_);
+  {
+    ouly::trace_scope trace(tracer_, thread, id, "task");
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    work(*worker.current_context_);
+  }
+  worker.stats_.add(ouly::detail::worker_counter::tasks_executed);
   ouly::detail::vector_access(workgroups_, id.get_index()).sink_one_work();
 }
 
@@ -141,7 +145,10 @@ void scheduler::run_worker(worker_id thread)
       break;
     }
 
-    wake.event_.acquire();
+    {
+      ouly::detail::park_scope park(ouly::detail::vector_access(workers_, thread.get_index()).get().stats_);
+      wake.event_.acquire();
+    }
     wake.status_.store(true, std::memory_order_relaxed);
   }
 
@@ -219,6 +226,7 @@ thread_local uint32_t adaptive_work_stealer::success_streak  = 0;
 auto scheduler::get_work(worker_id thread, ouly::detail::v1::work_item& work) noexcept -> workgroup_id
 {
   auto& range = ouly::detail::vector_access(group_ranges_, thread.get_index());
+  auto& stats = ouly::detail::vector_access(workers_, thread.get_index()).get().stats_;
 
   // Check workgroups in priority order - each worker's queue within each workgroup
   for (uint32_t i = 0; i < range.count_; ++i)
@@ -233,6 +241,7 @@ auto scheduler::get_work(worker_id thread, ouly::detail::v1::work_item& work) no
     if (workgroup.pop_item_from_worker(worker_offset, work)) [[likely]]
     {
       detail::adaptive_work_stealer::record_success();
+      stats.add(ouly::detail::worker_counter::local_pops);
       return workgroup_id{group_idx};
     }
 
@@ -255,8 +264,10 @@ auto scheduler::get_work(worker_id thread, ouly::detail::v1::work_item& work) no
         if (workgroup.pop_item_from_worker(target_worker_offset, work)) [[likely]]
         {
           detail::adaptive_work_stealer::record_success();
+          stats.add(ouly::detail::worker_counter::steals);
           return workgroup_id{group_idx};
         }
+        stats.add(ouly::detail::worker_counter::failed_steals);
       }
     }
 
@@ -278,8 +289,10 @@ auto scheduler::get_work(worker_id thread, ouly::detail::v1::work_item& work) no
       if (workgroup.pop_item_from_worker(target_worker_offset, work)) [[unlikely]]
       {
         detail::adaptive_work_stealer::record_success();
+        stats.add(ouly::detail::worker_counter::steals);
         return workgroup_id{group_idx};
       }
+      stats.add(ouly::detail::worker_counter::failed_steals);
     }
   }
 
@@ -358,6 +371,10 @@ void scheduler::begin_execution(scheduler_worker_entry&& entry, void* user_conte
   workers_      = std::make_unique<aligned_worker[]>(worker_count_);
   group_ranges_ = std::make_unique<ouly::detail::v1::group_range[]>(worker_count_);
   wake_data_    = std::make_unique<aligned_wake_data[]>(worker_count_);
+  if (tracer_ != nullptr)
+  {
+    tracer_->prepare(worker_count_);
+  }
   // per-worker backoff is stored in each worker structure; no global init required
 
   threads_.reserve(worker_count_ - 1);
@@ -455,6 +472,11 @@ void scheduler::end_execution()
     }
   }
   threads_.clear();
+
+  if (tracer_ != nullptr)
+  {
+    tracer_->flush();
+  }
 }
 
 void scheduler::submit_internal([[maybe_unused]] worker_id src, workgroup_id dst,
@@ -563,6 +585,26 @@ auto scheduler::has_work() const -> bool
                              });
 }
 
+auto scheduler::snapshot_stats() const -> scheduler_stats
+{
+  scheduler_stats stats;
+  if (workers_)
+  {
+    stats.workers_.reserve(worker_count_);
+    for (uint32_t w = 0; w < worker_count_; ++w)
+    {
+      stats.workers_.push_back(ouly::detail::vector_access(workers_, w).get().stats_.read());
+      stats.total_ += stats.workers_.back();
+    }
+  }
+  stats.workgroups_.reserve(workgroups_.size());
+  for (auto const& group : workgroups_)
+  {
+    stats.workgroups_.push_back(group.stats_.read());
+  }
+  return stats;
+}
+
 void scheduler::wait_for_tasks()
 {
   while (has_work())
@@ -199,7 +199,10 @@ void scheduler::run_worker(worker_id wid)
         worker.set_workgroup_info(0, workgroup_id{});
       }
 
-      wake_tokens_.acquire();
+      {
+        ouly::detail::park_scope park(worker.stats_);
+        wake_tokens_.acquire();
+      }
 
       if (stop_.load(std::memory_order_relaxed))
       {
@@ -258,6 +261,7 @@ auto scheduler::find_work_for_worker(worker_id wid) noexcept -> bool
 
       if (workgroup.pop_work_from_worker(work, worker.get_group_offset()))
       {
+        worker.stats_.add(ouly::detail::worker_counter::local_pops);
         on_work_taken(workgroup);
         execute_work(wid, work);
         return true;
@@ -266,13 +270,16 @@ auto scheduler::find_work_for_worker(worker_id wid) noexcept -> bool
       // No work in mailbox, try stealing from this workgroup
       if (workgroup.steal_work(work, random_victim))
       {
+        worker.stats_.add(ouly::detail::worker_counter::steals);
         on_work_taken(workgroup);
         execute_work(wid, work);
         return true;
       }
+      worker.stats_.add(ouly::detail::worker_counter::failed_steals);
 
       if (workgroup.receive_from_mailbox(work))
       {
+        worker.stats_.add(ouly::detail::worker_counter::mailbox_pops);
         on_work_taken(workgroup);
         execute_work(wid, work);
         return true;
@@ -304,13 +311,16 @@ auto scheduler::find_work_for_worker(worker_id wid) noexcept -> bool
     detail::v2::work_item work{detail::v2::work_item::noinit};
     if (workgroup.steal_work(work, steal_start_idx))
     {
+      worker.stats_.add(ouly::detail::worker_counter::steals);
       on_work_taken(workgroup);
       execute_work(wid, work);
       return true;
     }
+    worker.stats_.add(ouly::detail::worker_counter::failed_steals);
 
     if (workgroup.receive_from_mailbox(work))
     {
+      worker.stats_.add(ouly::detail::worker_counter::mailbox_pops);
       on_work_taken(workgroup);
       execute_work(wid, work);
       return true;
@@ -344,7 +354,11 @@ void scheduler::execute_work(worker_id wid, detail::v2::work_item& work) noexcep
   auto& worker = ouly::detail::vector_access(workers_, wid.get_index());
   // Create a copy since work_item expects mutable reference
   auto const& current_context = worker.get_context();
-  work(current_context);
+  {
+    ouly::trace_scope trace(tracer_, wid, current_context.get_workgroup(), "task");
+    work(current_context);
+  }
+  worker.stats_.add(ouly::detail::worker_counter::tasks_executed);
 
   pending_.fetch_sub(1, std::memory_order_acq_rel);
 }
@@ -384,6 +398,10 @@ void scheduler::begin_execution(scheduler_worker_entry&& entry, void* user_conte
 
   // Initialize workers and workgroups
   workers_ = std::make_unique<detail::v2::worker[]>(worker_count_);
+  if (tracer_ != nullptr)
+  {
+    tracer_->prepare(worker_count_);
+  }
 
   // Per-worker backoff lives inside each worker
 
@@ -450,6 +468,11 @@ void scheduler::end_execution()
   }
 
   threads_.clear();
+
+  if (tracer_ != nullptr)
+  {
+    tracer_->flush();
+  }
 }
 
 auto scheduler::has_work() const -> bool
@@ -482,6 +505,29 @@ void scheduler::wait_for_tasks()
   }
 }
 
+auto scheduler::snapshot_stats() const -> scheduler_stats
+{
+  scheduler_stats stats;
+  if (workers_)
+  {
+    stats.workers_.reserve(worker_count_);
+    for (uint32_t w = 0; w < worker_count_; ++w)
+    {
+      stats.workers_.push_back(ouly::detail::vector_access(workers_, w).stats_.read());
+      stats.total_ += stats.workers_.back();
+    }
+  }
+  if (workgroups_)
+  {
+    stats.workgroups_.reserve(workgroup_count_);
+    for (uint32_t g = 0; g < workgroup_count_; ++g)
+    {
+      stats.workgroups_.push_back(ouly::detail::vector_access(workgroups_, g).stats_.read());
+    }
+  }
+  return stats;
+}
+
 void scheduler::finish_pending_tasks()
 {
   wait_for_tasks();
@@ -9,10 +9,12 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <latch>
-#include <mutex>
+#include <span>
 #include <thread>
+#include <utility>
 
 namespace ouly::v3
 {
@@ -29,13 +31,28 @@ thread_local ouly::worker_id g_worker_id = {};
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 thread_local uint32_t g_random_seed = 0;
 
-// LCG constants for fast PRNG used to randomize steal victims
-static constexpr uint32_t lcg_multiplier = 1664525U;
-static constexpr uint32_t lcg_increment  = 1013904223U;
+// xorshift32 PRNG used to randomize steal victims. An LCG's low bits cycle with a tiny period,
+// which made `seed % thread_count` revisit the same victims; xorshift mixes all bits.
+static constexpr uint32_t seed_multiplier   = 0x9E3779B9U; // golden ratio, spreads worker seeds
+static constexpr uint32_t xorshift_fallback = 0x6C8E9CF5U; // any non-zero state
+static constexpr uint32_t xorshift_a        = 13U;
+static constexpr uint32_t xorshift_b        = 17U;
+static constexpr uint32_t xorshift_c        = 5U;
+
+static auto elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) noexcept
+ -> int64_t
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
 
 static auto update_seed() -> uint32_t
 {
-  return (g_random_seed = (g_random_seed * lcg_multiplier) + lcg_increment);
+  // The state must never be zero; threads that did not enter run_worker() start there.
+  uint32_t x = g_random_seed != 0 ? g_random_seed : xorshift_fallback;
+  x ^= x << xorshift_a;
+  x ^= x >> xorshift_b;
+  x ^= x << xorshift_c;
+  return (g_random_seed = x);
 }
 
 auto task_context::this_context::get() noexcept -> task_context const&
@@ -57,22 +74,20 @@ scheduler::~scheduler() noexcept
   }
 }
 
-void scheduler::notify_workers([[maybe_unused]] uint32_t count) noexcept
+void scheduler::wake_group(uint32_t group_index, uint32_t count) noexcept
 {
-  // The lock serializes notify with a worker's predicate check + wait transition.
-  // Queue updates happen before this call; holding the mutex here prevents a worker
-  // from checking "no work", missing this notification, and then sleeping forever.
-  {
-    std::scoped_lock lock(work_queue_mutex_);
-  }
-  work_available_.notify_all();
+  // Only members can run the group's items; sleepers of other groups are left alone. The queue
+  // update that precedes this call is a seq_cst RMW, which pairs with the parking worker's fence
+  // (see parking_lot).
+  auto const& group = ouly::detail::vector_access(workgroups_, group_index);
+  parking_.wake_range(group.get_start_thread_idx(), group.get_thread_count(), count);
 }
 
 void scheduler::finish_task() noexcept
 {
-  if (pending_.get().fetch_sub(1, std::memory_order_acq_rel) == 1)
+  if (pending_.get().fetch_sub(1, std::memory_order_seq_cst) == 1)
   {
-    notify_workers(worker_count_);
+    parking_.wake_waiters();
   }
 }
 
@@ -86,7 +101,11 @@ void scheduler::execute_work(worker_type& wkr, uint32_t group_index, work_item_t
   ctx.group_id_ = workgroup_id(group_index);
   ctx.offset_   = group.get_offset(ctx.get_worker().get_index());
 
-  work(ctx);
+  {
+    ouly::trace_scope trace(tracer_, ctx.get_worker(), ctx.group_id_, "task");
+    work(ctx);
+  }
+  wkr.stats_.add(ouly::detail::worker_counter::tasks_executed);
 
   // Restore so a context observed through this_context::get() stays valid after nested
   // helping (cooperative waits) regardless of which group's task we just ran.
@@ -110,14 +129,29 @@ auto scheduler::try_execute_one(worker_id wid) noexcept -> bool
       continue;
     }
 
+    // Most urgent lane first. Every aging_period-th attempt first serves one of the less urgent
+    // lanes, rotating through them, so critical work cannot starve the rest of the group.
+    uint32_t aged   = detail::v3::lane_count;
+    uint32_t period = aging_period_.load(std::memory_order_relaxed);
+    if (period != 0 && (++wkr.lane_ticks_ % period) == 0)
+    {
+      aged = 1 + ((wkr.lane_ticks_ / period) % (detail::v3::lane_count - 1));
+    }
+
     work_item_type work{work_item_type::noinit};
-    if (group.take(work, group.get_offset(wid.get_index()), update_seed()))
+    bool           found = aged != detail::v3::lane_count && try_take(wkr, group_index, aged, work);
+    for (uint32_t lane = 0; !found && lane < detail::v3::lane_count; ++lane)
     {
-      // Wake chaining: if this group still has queued items, recruit one more sleeper so
-      // bursts fan out exponentially without broadcasting on every submit.
+      found = lane != aged && try_take(wkr, group_index, lane, work);
+    }
+
+    if (found)
+    {
+      // Wake chaining: if this group still has queued items, recruit one more sleeping member
+      // so bursts fan out exponentially without broadcasting on every submit.
       if (group.has_queued())
       {
-        notify_workers(1);
+        wake_group(group_index, 1);
       }
       execute_work(wkr, group_index, work);
       return true;
@@ -126,6 +160,153 @@ auto scheduler::try_execute_one(worker_id wid) noexcept -> bool
   return false;
 }
 
+auto scheduler::try_take(worker_type& wkr, uint32_t group_index, uint32_t lane, work_item_type& out) noexcept -> bool
+{
+  auto& group = ouly::detail::vector_access(workgroups_, group_index);
+  if (!group.has_queued(lane))
+  {
+    return false;
+  }
+
+  uint32_t own = group.get_offset(wkr.get_worker_id().get_index());
+  if (group.pop_local(out, own, lane))
+  {
+    wkr.stats_.add(ouly::detail::worker_counter::local_pops);
+    return true;
+  }
+  if (group.pop_mailbox(out, lane))
+  {
+    wkr.stats_.add(ouly::detail::worker_counter::mailbox_pops);
+    return true;
+  }
+  return try_steal(wkr, group_index, own, lane, out);
+}
+
+auto scheduler::try_steal(worker_type& wkr, uint32_t group_index, uint32_t own, uint32_t lane,
+                          work_item_type& out) noexcept -> bool
+{
+  auto&    group = ouly::detail::vector_access(workgroups_, group_index);
+  uint32_t count = group.get_thread_count();
+  if (count < 2)
+  {
+    return false;
+  }
+
+  auto attempt = [&](uint32_t victim) -> bool
+  {
+    wkr.count_steal_attempt();
+    if (!group.steal_from(out, victim, lane))
+    {
+      return false;
+    }
+    wkr.count_steal_success();
+    ouly::detail::vector_access(wkr.last_victim_, group_index) = victim;
+    return true;
+  };
+
+  if (steal_policy_ == steal_policy::randomized)
+  {
+    // A fresh draw per probe: concurrent thieves do not walk the same sequence of deques.
+    for (uint32_t i = 1; i < count; ++i)
+    {
+      uint32_t victim = update_seed() % (count - 1);
+      victim += victim >= own ? 1 : 0;
+      if (attempt(victim))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint32_t tried = own;
+  if (steal_policy_ == steal_policy::last_victim_first)
+  {
+    uint32_t last = ouly::detail::vector_access(wkr.last_victim_, group_index);
+    if (last != own && last < count)
+    {
+      if (attempt(last))
+      {
+        return true;
+      }
+      tried = last;
+    }
+  }
+
+  auto victims = wkr.get_victim_order(workgroup_id(group_index));
+  if (!victims.empty())
+  {
+    for (auto victim : victims)
+    {
+      if (victim != tried && attempt(victim))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint32_t start = update_seed();
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint32_t victim = (start + i) % count;
+    if (victim != own && victim != tried && attempt(victim))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto scheduler::get_idle_stats() const noexcept -> idle_stats
+{
+  idle_stats stats;
+  for (uint32_t w = 0; workers_ && w < worker_count_; ++w)
+  {
+    auto const& idle = ouly::detail::vector_access(workers_, w).get_idle_controller();
+    stats.spin_hits_ += idle.get_spin_hits();
+    stats.spin_misses_ += idle.get_spin_misses();
+    stats.direct_parks_ += idle.get_direct_parks();
+    stats.spin_ns_ += idle.get_spin_ns();
+  }
+  return stats;
+}
+
+auto scheduler::get_steal_stats() const noexcept -> steal_stats
+{
+  steal_stats stats;
+  for (uint32_t w = 0; workers_ && w < worker_count_; ++w)
+  {
+    auto const& wkr = ouly::detail::vector_access(workers_, w);
+    stats.attempts_ += wkr.get_steal_attempts();
+    stats.successes_ += wkr.get_steal_successes();
+  }
+  return stats;
+}
+
+auto scheduler::snapshot_stats() const -> scheduler_stats
+{
+  scheduler_stats stats;
+  if (workers_)
+  {
+    stats.workers_.reserve(worker_count_);
+    for (uint32_t w = 0; w < worker_count_; ++w)
+    {
+      stats.workers_.push_back(ouly::detail::vector_access(workers_, w).get_stats());
+      stats.total_ += stats.workers_.back();
+    }
+  }
+  if (workgroups_)
+  {
+    stats.workgroups_.reserve(workgroup_count_);
+    for (uint32_t g = 0; g < workgroup_count_; ++g)
+    {
+      stats.workgroups_.push_back(ouly::detail::vector_access(workgroups_, g).get_stats());
+    }
+  }
+  return stats;
+}
+
 auto scheduler::has_queued_work(worker_type const& wkr) const noexcept -> bool
 {
   for (uint32_t i = 0; i < wkr.group_count_; ++i)
@@ -138,55 +319,121 @@ auto scheduler::has_queued_work(worker_type const& wkr) const noexcept -> bool
   return false;
 }
 
+auto scheduler::spin_for_work(worker_type& wkr, clock::time_point idle_begin, clock::time_point& found) noexcept
+ -> bool
+{
+  // Clock reads are amortized over a few polls; a poll is far shorter than the windows involved.
+  constexpr uint32_t polls_per_clock_read = 8;
+
+  auto wid = wkr.get_worker_id();
+  found    = idle_begin;
+  if (idle_policy_.load(std::memory_order_relaxed) == idle_policy::fixed)
+  {
+    // The spin is bounded by a count, so the clock is only read once it is over
+    bool executed = false;
+    auto spins    = idle_spin_count_.load(std::memory_order_relaxed);
+    while (!executed && spins-- > 0 && !stop_.load(std::memory_order_relaxed))
+    {
+      ouly::detail::pause_exec();
+      executed = try_execute_one(wid);
+    }
+    found = clock::now();
+    return executed;
+  }
+
+  auto budget = wkr.idle_.spin_budget(max_idle_spin_ns_.load(std::memory_order_relaxed));
+  if (budget == 0)
+  {
+    return false;
+  }
+  for (uint32_t poll = 1; !stop_.load(std::memory_order_relaxed); ++poll)
+  {
+    ouly::detail::pause_exec();
+    if (try_execute_one(wid))
+    {
+      return true;
+    }
+    if (poll % polls_per_clock_read == 0)
+    {
+      found = clock::now();
+      if (elapsed_ns(idle_begin, found) >= budget)
+      {
+        break;
+      }
+    }
+  }
+  return false;
+}
+
 void scheduler::run_worker(worker_id wid)
 {
   auto& wkr   = ouly::detail::vector_access(workers_, wid.get_index());
   g_worker    = &wkr;
   g_worker_id = wid;
-  g_random_seed ^= wid.get_index() * lcg_multiplier;
+  g_random_seed = (wid.get_index() + 1) * seed_multiplier;
+
+  if (pin_workers_ && !topology_.empty())
+  {
+    ouly::topology::pin_current_thread(wkr.get_cpu().cpu_);
+  }
 
   if (entry_fn_)
   {
     entry_fn_(wid);
   }
 
+  // Current idle period, fed to the worker's idle controller once work is found again.
+  bool              idle   = false;
+  bool              parked = false;
+  int64_t           spun   = 0;
+  clock::time_point idle_begin;
+
   while (!stop_.load(std::memory_order_relaxed))
   {
+    auto polled = idle ? clock::now() : clock::time_point{};
     if (try_execute_one(wid))
     {
+      if (idle)
+      {
+        wkr.idle_.record(elapsed_ns(idle_begin, polled), spun, parked);
+        idle = false;
+      }
       continue;
     }
 
-    // Optional pre-park spin. Parking costs a mutex acquisition plus a condvar round trip, and
-    // every submit broadcasts to all workers, so for bursty producers it is often cheaper to poll
-    // briefly than to sleep. Disabled by default; see set_idle_spin_count().
-    auto spins   = idle_spin_count_.load(std::memory_order_relaxed);
-    bool resumed = false;
-    while (spins-- > 0)
+    if (!idle)
     {
-      ouly::detail::pause_exec();
-      if (try_execute_one(wid))
-      {
-        resumed = true;
-        break;
-      }
-      if (stop_.load(std::memory_order_relaxed))
+      idle       = true;
+      parked     = false;
+      spun       = 0;
+      idle_begin = clock::now();
+    }
+
+    // Pre-park spin, once per idle period. Parking costs a futex wait plus the waker's syscall, so
+    // for bursty producers it is often cheaper to poll briefly than to sleep. See set_idle_policy().
+    if (!parked)
+    {
+      bool found = spin_for_work(wkr, idle_begin, polled);
+      spun       = elapsed_ns(idle_begin, polled);
+      if (found)
       {
-        break;
+        wkr.idle_.record(spun, spun, false);
+        idle = false;
+        continue;
       }
     }
-    if (resumed)
+
+    // The condition is re-checked after advertising the park, so spinning above cannot lose a
+    // wakeup.
+    auto token = parking_.prepare(wid.get_index(), false);
+    if (stop_.load(std::memory_order_acquire) || has_queued_work(wkr))
     {
+      parking_.cancel(wid.get_index());
       continue;
     }
-
-    // The predicate is re-checked under the lock, so spinning above cannot lose a wakeup.
-    std::unique_lock<std::mutex> lock(work_queue_mutex_);
-    work_available_.wait(lock,
-                         [this, &wkr]() noexcept -> bool
-                         {
-                           return stop_.load(std::memory_order_acquire) || has_queued_work(wkr);
-                         });
+    ouly::detail::park_scope park(wkr.stats_);
+    parked = true;
+    parking_.park(wid.get_index(), token);
   }
 
   g_worker    = nullptr;
@@ -194,7 +441,7 @@ void scheduler::run_worker(worker_id wid)
 }
 
 void scheduler::submit_internal([[maybe_unused]] task_context const& current, workgroup_id dst,
-                                work_item_type const& work)
+                                work_item_type const& work, task_lane lane)
 {
   OULY_ASSERT(workgroups_ != nullptr);
   OULY_ASSERT(dst && dst.get_index() < workgroup_count_);
@@ -211,27 +458,54 @@ void scheduler::submit_internal([[maybe_unused]] task_context const& current, wo
     self = nullptr; // worker thread of a different scheduler instance
   }
 
-  bool pushed = false;
+  auto lane_index = static_cast<uint32_t>(lane);
+  bool pushed     = false;
   if (self != nullptr && group.contains(self->get_worker_id().get_index()))
   {
-    pushed = group.push_local(group.get_offset(self->get_worker_id().get_index()), work);
+    pushed = group.push_local(group.get_offset(self->get_worker_id().get_index()), work, lane_index);
   }
 
-  while (!pushed && !group.push_mailbox(work))
+  if (!pushed && !group.push_mailbox(work, lane_index))
   {
-    // Mailbox full: wake everyone, then help drain if we are a worker of this scheduler.
-    notify_workers(worker_count_);
-    if (self != nullptr)
-    {
-      busy_work(self->get_worker_id());
-    }
-    else
-    {
-      std::this_thread::yield();
-    }
+    // Mailbox full: spill into the group's overflow queue rather than spinning until members
+    // drain the ring. External submitters (IO, network) therefore never stall on a busy group.
+    group.push_overflow(work, lane_index);
   }
 
-  notify_workers(1);
+  wake_group(dst.get_index(), 1);
+}
+
+void scheduler::submit_batch([[maybe_unused]] task_context const& current, workgroup_id dst,
+                             std::span<work_item_type const> tasks, task_lane lane)
+{
+  OULY_ASSERT(workgroups_ != nullptr);
+  OULY_ASSERT(dst && dst.get_index() < workgroup_count_);
+
+  if (tasks.empty())
+  {
+    return;
+  }
+
+  auto& group = ouly::detail::vector_access(workgroups_, dst.get_index());
+
+  // Reserve the whole batch before any item becomes visible, so an early finisher cannot drive
+  // pending_ to zero while the rest of the batch is still being pushed.
+  pending_.get().fetch_add(static_cast<uint32_t>(tasks.size()), std::memory_order_relaxed);
+
+  worker_type const* self = g_worker;
+  if (self != nullptr && &self->get_context().get_scheduler() != this)
+  {
+    self = nullptr;
+  }
+
+  uint32_t offset = detail::v3::no_member;
+  if (self != nullptr && group.contains(self->get_worker_id().get_index()))
+  {
+    offset = group.get_offset(self->get_worker_id().get_index());
+  }
+  group.push_batch(tasks, offset, static_cast<uint32_t>(lane));
+
+  wake_group(dst.get_index(), static_cast<uint32_t>(std::min<std::size_t>(tasks.size(), group.get_thread_count())));
 }
 
 void scheduler::busy_work(worker_id thread) noexcept
@@ -264,13 +538,15 @@ void scheduler::wait_for_tasks()
       break;
     }
 
-    auto&                        wkr = ouly::detail::vector_access(workers_, main_thread.get_index());
-    std::unique_lock<std::mutex> lock(work_queue_mutex_);
-    work_available_.wait(lock,
-                         [this, &wkr]() noexcept -> bool
-                         {
-                           return pending_.get().load(std::memory_order_acquire) == 0 || has_queued_work(wkr);
-                         });
+    auto& wkr   = ouly::detail::vector_access(workers_, main_thread.get_index());
+    auto  token = parking_.prepare(main_thread.get_index(), true);
+    if (pending_.get().load(std::memory_order_acquire) == 0 || has_queued_work(wkr))
+    {
+      parking_.cancel(main_thread.get_index());
+      continue;
+    }
+    ouly::detail::park_scope park(wkr.stats_);
+    parking_.park(main_thread.get_index(), token);
   }
 }
 
@@ -302,6 +578,11 @@ void scheduler::begin_execution(scheduler_worker_entry&& entry, void* user_conte
   }
 
   workers_ = std::make_unique<worker_type[]>(worker_count_);
+  parking_.reset(worker_count_);
+  if (tracer_ != nullptr)
+  {
+    tracer_->prepare(worker_count_);
+  }
   for (uint32_t w = 0; w < worker_count_; ++w)
   {
     auto& wkr = ouly::detail::vector_access(workers_, w);
@@ -333,6 +614,11 @@ void scheduler::begin_execution(scheduler_worker_entry&& entry, void* user_conte
     }
   }
 
+  if (!topology_.empty())
+  {
+    assign_topology();
+  }
+
   stop_.store(false, std::memory_order_relaxed);
   pending_.get().store(0, std::memory_order_relaxed);
 
@@ -361,12 +647,57 @@ void scheduler::begin_execution(scheduler_worker_entry&& entry, void* user_conte
   entry_fn_ = {};
 }
 
+void scheduler::assign_topology()
+{
+  for (uint32_t w = 0; w < worker_count_; ++w)
+  {
+    ouly::detail::vector_access(workers_, w).cpu_ = topology_.cpu_for_worker(w);
+  }
+
+  for (uint32_t w = 0; w < worker_count_; ++w)
+  {
+    auto& wkr = ouly::detail::vector_access(workers_, w);
+    wkr.victims_.clear();
+    for (uint32_t i = 0; i < wkr.group_count_; ++i)
+    {
+      uint32_t    group_index = ouly::detail::vector_access(wkr.group_order_, i);
+      auto const& group       = ouly::detail::vector_access(workgroups_, group_index);
+      uint32_t    count       = group.get_thread_count();
+      uint32_t    own         = group.get_offset(w);
+      auto const  first       = static_cast<uint32_t>(wkr.victims_.size());
+
+      for (uint32_t offset = 0; offset < count; ++offset)
+      {
+        if (offset != own)
+        {
+          wkr.victims_.push_back(offset);
+        }
+      }
+
+      // Nearest first; within a distance class start after our own offset so members of the
+      // same LLC do not all hammer the same victim.
+      auto distance_key = [&](uint32_t offset) -> std::pair<ouly::cpu_distance, uint32_t>
+      {
+        auto const& cpu = ouly::detail::vector_access(workers_, group.get_start_thread_idx() + offset).cpu_;
+        return {ouly::topology::distance(wkr.cpu_, cpu), (offset + count - own) % count};
+      };
+      std::sort(wkr.victims_.begin() + static_cast<std::ptrdiff_t>(first), wkr.victims_.end(),
+                [&](uint32_t lhs, uint32_t rhs) -> bool
+                {
+                  return distance_key(lhs) < distance_key(rhs);
+                });
+
+      ouly::detail::vector_access(wkr.victim_ranges_, group_index) = {first, count - 1};
+    }
+  }
+}
+
 void scheduler::end_execution()
 {
   wait_for_tasks();
 
-  stop_.store(true, std::memory_order_release);
-  notify_workers(worker_count_);
+  stop_.store(true, std::memory_order_seq_cst);
+  parking_.wake_all();
 
   for (auto& thread : threads_)
   {
@@ -376,6 +707,11 @@ void scheduler::end_execution()
     }
   }
   threads_.clear();
+
+  if (tracer_ != nullptr)
+  {
+    tracer_->flush();
+  }
 }
 
 void scheduler::create_group(workgroup_id group, uint32_t start_thread_idx, uint32_t thread_count, uint32_t priority)
@@ -0,0 +1,266 @@
+#include "ouly/allocators/allocation_trace.hpp"
+#include "catch2/catch_all.hpp"
+#include "ouly/allocators/arena_allocator.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// NOLINTBEGIN
+namespace
+{
+// Replay target whose footprint is the sum of live sizes rounded up to 64 bytes
+struct rounding_target
+{
+  using handle = std::size_t;
+
+  std::size_t footprint_ = 0;
+  std::size_t calls_     = 0;
+
+  auto allocate(std::size_t size, std::size_t /*align*/) -> handle
+  {
+    ++calls_;
+    auto rounded = (size + 63) & ~std::size_t{63};
+    footprint_ += rounded;
+    return rounded;
+  }
+
+  void deallocate(handle h, std::size_t /*size*/, std::size_t /*align*/)
+  {
+    ++calls_;
+    footprint_ -= h;
+  }
+
+  [[nodiscard]] auto footprint() const -> std::size_t
+  {
+    return footprint_;
+  }
+};
+
+struct arena_mem_manager
+{
+  std::vector<std::size_t> sizes_;
+  std::size_t              footprint_ = 0;
+
+  bool drop_arena(std::uint32_t id)
+  {
+    footprint_ -= sizes_[id];
+    sizes_[id] = 0;
+    return true;
+  }
+
+  std::uint32_t add_arena(std::uint32_t /*id*/, std::size_t size)
+  {
+    sizes_.push_back(size);
+    footprint_ += size;
+    return static_cast<std::uint32_t>(sizes_.size() - 1);
+  }
+
+  void remove_arena(std::uint32_t id)
+  {
+    footprint_ -= sizes_[id];
+    sizes_[id] = 0;
+  }
+};
+
+struct tlsf_target
+{
+  using allocator_t = ouly::arena_allocator<ouly::config<ouly::cfg::strategy<ouly::strat::tlsf<>>,
+                                                         ouly::cfg::manager<arena_mem_manager>>>;
+  using handle      = std::uint32_t;
+
+  arena_mem_manager mgr_;
+  allocator_t       allocator_{4096, mgr_};
+
+  auto allocate(std::size_t size, std::size_t align) -> handle
+  {
+    return std::get<1>(allocator_.allocate(static_cast<std::uint32_t>(size), static_cast<std::uint32_t>(align)));
+  }
+
+  void deallocate(handle h, std::size_t /*size*/, std::size_t /*align*/)
+  {
+    allocator_.deallocate(h);
+  }
+
+  [[nodiscard]] auto footprint() const -> std::size_t
+  {
+    return mgr_.footprint_;
+  }
+};
+} // namespace
+
+TEST_CASE("allocation_recorder records every allocation it forwards", "[allocation_trace]")
+{
+  ouly::allocation_recorder<> recorder;
+
+  void* a = recorder.allocate(100);
+  void* b = recorder.allocate(64, ouly::alignment<64>{});
+  REQUIRE(a != nullptr);
+  REQUIRE(b != nullptr);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(b) % 64 == 0);
+  recorder.deallocate(a, 100);
+  void* c = recorder.zero_allocate(32, std::align_val_t{16});
+  recorder.deallocate(b, 64, ouly::alignment<64>{});
+  recorder.deallocate(c, 32, std::align_val_t{16});
+
+  auto const& trace = recorder.trace();
+  REQUIRE(trace.events_.size() == 6);
+  REQUIRE(trace.id_count_ == 2);
+
+  auto const& ev = trace.events_;
+  REQUIRE(ev[0].op_ == ouly::allocation_trace_op::allocate);
+  REQUIRE(ev[0].size_ == 100);
+  REQUIRE(ev[0].alignment() == 1);
+  REQUIRE(ev[1].alignment() == 64);
+  REQUIRE(ev[1].id_ != ev[0].id_);
+  REQUIRE(ev[2].op_ == ouly::allocation_trace_op::deallocate);
+  REQUIRE(ev[2].id_ == ev[0].id_);
+  // The id freed by `a` is reused for `c`
+  REQUIRE(ev[3].id_ == ev[0].id_);
+  REQUIRE(ev[3].alignment() == 16);
+  REQUIRE(ev[4].id_ == ev[1].id_);
+  REQUIRE(ev[5].id_ == ev[3].id_);
+  for (std::size_t i = 1; i < ev.size(); ++i)
+  {
+    REQUIRE(ev[i].timestamp_ >= ev[i - 1].timestamp_);
+  }
+
+  auto taken = recorder.take_trace();
+  REQUIRE(taken.events_.size() == 6);
+  REQUIRE(recorder.trace().events_.empty());
+  REQUIRE(recorder.trace().id_count_ == 2);
+}
+
+TEST_CASE("allocation traces round trip through the binary log", "[allocation_trace]")
+{
+  ouly::allocation_trace trace;
+  trace.id_count_ = 1000;
+  for (std::uint32_t i = 0; i < 1000; ++i)
+  {
+    trace.events_.push_back({.timestamp_      = i * 37ULL,
+                             .size_           = (i * 7919ULL) << (i % 40),
+                             .id_             = i,
+                             .op_             = ouly::allocation_trace_op::allocate,
+                             .alignment_log2_ = static_cast<std::uint8_t>(i % 13)});
+  }
+  for (std::uint32_t i = 0; i < 1000; ++i)
+  {
+    trace.events_.push_back({.timestamp_ = 1'000'000'000'000ULL + i,
+                             .size_      = (i * 7919ULL) << (i % 40),
+                             .id_        = 999 - i,
+                             .op_        = ouly::allocation_trace_op::deallocate});
+  }
+
+  std::stringstream stream;
+  ouly::write_trace(stream, trace);
+  auto const bytes = stream.str().size();
+  // Far below the in-memory size of the events
+  REQUIRE(bytes < trace.events_.size() * 12);
+
+  auto read = ouly::read_trace(stream);
+  REQUIRE(read == trace);
+
+  SECTION("A stream that is not a trace is rejected")
+  {
+    std::stringstream bad("not a trace at all");
+    REQUIRE_THROWS_AS(ouly::read_trace(bad), std::invalid_argument);
+  }
+
+  SECTION("A truncated trace is rejected")
+  {
+    std::stringstream truncated(stream.str().substr(0, bytes / 2));
+    REQUIRE_THROWS_AS(ouly::read_trace(truncated), std::out_of_range);
+  }
+}
+
+TEST_CASE("replay_trace measures footprint and fragmentation", "[allocation_trace]")
+{
+  ouly::allocation_trace trace;
+  trace.id_count_ = 3;
+  auto push       = [&](ouly::allocation_trace_op op, std::uint32_t id, std::uint64_t size)
+  {
+    trace.events_.push_back({.size_ = size, .id_ = id, .op_ = op});
+  };
+  // A deallocation of an allocation made before the recording started is skipped
+  push(ouly::allocation_trace_op::deallocate, 2, 10);
+  push(ouly::allocation_trace_op::allocate, 0, 64);
+  push(ouly::allocation_trace_op::allocate, 1, 1);
+  push(ouly::allocation_trace_op::deallocate, 0, 64);
+  push(ouly::allocation_trace_op::allocate, 2, 32);
+  push(ouly::allocation_trace_op::deallocate, 1, 1);
+  push(ouly::allocation_trace_op::deallocate, 2, 32);
+
+  rounding_target target;
+  auto            stats = ouly::replay_trace(trace, target);
+  REQUIRE(target.calls_ == 6);
+  REQUIRE(target.footprint_ == 0);
+  REQUIRE(stats.allocations_ == 3);
+  REQUIRE(stats.deallocations_ == 3);
+  REQUIRE(stats.peak_live_ == 65);
+  REQUIRE(stats.peak_footprint_ == 128);
+  REQUIRE(stats.fragmentation_ratio() == Catch::Approx(1.0 - (65.0 / 128.0)));
+  REQUIRE(stats.worst_latency_ns_ <= stats.total_ns_);
+}
+
+TEST_CASE("replay_trace drives an arena_allocator from a recorded trace", "[allocation_trace]")
+{
+  ouly::allocation_recorder<> recorder;
+  std::vector<void*>          live;
+  std::vector<std::size_t>    sizes;
+  std::uint32_t               seed = 7;
+  for (int i = 0; i < 2000; ++i)
+  {
+    seed = seed * 1664525U + 1013904223U;
+    if ((seed >> 28) < 10 || live.empty())
+    {
+      auto size = 16 + ((seed >> 8) % 512);
+      live.push_back(recorder.allocate(size, ouly::alignment<16>{}));
+      sizes.push_back(size);
+    }
+    else
+    {
+      auto index = (seed >> 8) % live.size();
+      recorder.deallocate(live[index], sizes[index], ouly::alignment<16>{});
+      live[index]  = live.back();
+      sizes[index] = sizes.back();
+      live.pop_back();
+      sizes.pop_back();
+    }
+  }
+  for (std::size_t i = 0; i < live.size(); ++i)
+  {
+    recorder.deallocate(live[i], sizes[i], ouly::alignment<16>{});
+  }
+
+  std::stringstream stream;
+  ouly::write_trace(stream, recorder.trace());
+  auto trace = ouly::read_trace(stream);
+
+  tlsf_target target;
+  auto        stats = ouly::replay_trace(trace, target);
+  REQUIRE(stats.allocations_ == stats.deallocations_);
+  REQUIRE(stats.allocations_ + stats.deallocations_ == trace.events_.size());
+  REQUIRE(stats.peak_live_ > 0);
+  REQUIRE(stats.peak_footprint_ >= stats.peak_live_);
+  REQUIRE(stats.fragmentation_ratio() >= 0.0);
+  REQUIRE(stats.fragmentation_ratio() < 1.0);
+  REQUIRE(stats.throughput() > 0.0);
+  // Every arena was handed back once the trace freed everything
+  REQUIRE(target.footprint() == 0);
+}
+TEST_CASE("allocation traces and scheduler traces live side by side", "[allocation_trace]")
+{
+  static_assert(!std::is_same_v<ouly::allocation_trace_event, ouly::trace_event>);
+
+  ouly::trace_recorder        timeline(16);
+  ouly::allocation_recorder<> recorder;
+  recorder.deallocate(recorder.allocate(32), 32);
+
+  REQUIRE(recorder.trace().events_.size() == 2);
+  REQUIRE(timeline.events().empty());
+}
+// NOLINTEND
@@ -6,6 +6,7 @@
 #include "ouly/allocators/strat/best_fit_v2.hpp"
 #include "ouly/allocators/strat/greedy_v0.hpp"
 #include "ouly/allocators/strat/greedy_v1.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
 #include <iostream>
 #include <random>
 #include <unordered_set>
@@ -180,6 +181,47 @@ TEST_CASE("arena_allocator without memory manager", "[arena_allocator][default]"
   REQUIRE(xoffset != 0);
 }
 
+TEST_CASE("arena_allocator with the tlsf strategy", "[arena_allocator][tlsf]")
+{
+  using allocator_t = ouly::arena_allocator<ouly::config<ouly::cfg::strategy<ouly::strat::tlsf<>>>>;
+  allocator_t allocator(1024);
+
+  auto [first, first_offset] = allocator.allocate(700);
+  REQUIRE(first_offset == 0);
+  // 321 rounds up past the list holding the 324 byte remainder; the remainder still has to be found
+  auto [second, second_offset] = allocator.allocate(321);
+  REQUIRE(second != allocator.null());
+  REQUIRE(second_offset == 700);
+  auto [third, third_offset] = allocator.allocate(4);
+  REQUIRE(third == allocator.null());
+
+  // Freeing both merges the arena back into one block
+  allocator.deallocate(second);
+  allocator.deallocate(first);
+  auto [whole, whole_offset] = allocator.allocate(1024);
+  REQUIRE(whole != allocator.null());
+  REQUIRE(whole_offset == 0);
+  allocator.deallocate(whole);
+
+  // Small requests of every size class come back from the freed space
+  std::vector<std::uint32_t> blocks;
+  std::uint32_t              used = 0;
+  for (std::uint32_t size = 1; used + size <= 1024; used += size, ++size)
+  {
+    auto [id, offset] = allocator.allocate(size);
+    REQUIRE(id != allocator.null());
+    REQUIRE(offset + size <= 1024);
+    blocks.push_back(id);
+  }
+  for (auto id : blocks)
+  {
+    allocator.deallocate(id);
+  }
+#ifdef OULY_VALIDITY_CHECKS
+  allocator.validate_integrity();
+#endif
+}
+
 TEMPLATE_TEST_CASE("Validate arena_allocator", "[arena_allocator.strat]",
 
                    (ouly::strat::best_fit_v1<ouly::cfg::bsearch_min2>),
@@ -188,7 +230,8 @@ TEMPLATE_TEST_CASE("Validate arena_allocator", "[arena_allocator.strat]",
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min0>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min2>), (ouly::strat::greedy_v1<>),
-                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>)
+                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>),
+                   (ouly::strat::tlsf<>)
 
 )
 {
@@ -204,7 +247,8 @@ TEMPLATE_TEST_CASE("Validate arena_allocator : 1542249547 init bug", "[arena_all
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min0>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>),
                    (ouly::strat::best_fit_v2<ouly::cfg::bsearch_min2>), (ouly::strat::greedy_v1<>),
-                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>)
+                   (ouly::strat::greedy_v0<>), (ouly::strat::best_fit_tree<>), (ouly::strat::best_fit_v0<>),
+                   (ouly::strat::tlsf<>)
 
 )
 {
@@ -1,4 +1,277 @@
 #include "nanobench.h"
+#include "ouly/allocators/allocation_trace.hpp"
 #include "ouly/allocators/arena_allocator.hpp"
+#include "ouly/allocators/best_fit_defrag_allocator.hpp"
+#include "ouly/allocators/coalescing_arena_allocator.hpp"
+#include "ouly/allocators/first_fit_defrag_allocator.hpp"
+#include "ouly/allocators/gpu_allocator.hpp"
+#include "ouly/allocators/strat/best_fit_tree.hpp"
+#include "ouly/allocators/strat/best_fit_v0.hpp"
+#include "ouly/allocators/strat/best_fit_v1.hpp"
+#include "ouly/allocators/strat/best_fit_v2.hpp"
+#include "ouly/allocators/strat/greedy_v0.hpp"
+#include "ouly/allocators/strat/greedy_v1.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
 #include "ouly/reflection/type_name.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
 #include <string_view>
+#include <vector>
+
+// NOLINTBEGIN
+namespace
+{
+constexpr uint32_t trace_arena_size = 4 * 1024 * 1024;
+
+// Arena sizes by handle, so every target can report the backing memory it holds
+struct footprint_tracker
+{
+  std::vector<std::size_t> sizes_;
+  std::size_t              footprint_ = 0;
+
+  void add(std::uint32_t handle, std::size_t size)
+  {
+    if (sizes_.size() <= handle)
+    {
+      sizes_.resize(handle + 1, 0);
+    }
+    sizes_[handle] = size;
+    footprint_ += size;
+  }
+
+  void remove(std::uint32_t handle)
+  {
+    footprint_ -= sizes_[handle];
+    sizes_[handle] = 0;
+  }
+};
+
+struct trace_arena_manager
+{
+  footprint_tracker tracker_;
+  std::uint32_t     next_ = 0;
+
+  bool drop_arena(std::uint32_t handle)
+  {
+    tracker_.remove(handle);
+    return true;
+  }
+
+  std::uint32_t add_arena([[maybe_unused]] std::uint32_t id, std::size_t size)
+  {
+    tracker_.add(next_, size);
+    return next_++;
+  }
+
+  void remove_arena(std::uint32_t handle)
+  {
+    tracker_.remove(handle);
+  }
+};
+
+struct trace_coalescing_manager
+{
+  footprint_tracker tracker_;
+
+  void add(ouly::arena_id arena, ouly::allocation_size_type size)
+  {
+    tracker_.add(arena.get(), size);
+  }
+
+  void remove(ouly::arena_id arena)
+  {
+    tracker_.remove(arena.get());
+  }
+};
+
+template <typename Strategy>
+struct arena_replay_target
+{
+  using allocator_t = ouly::arena_allocator<ouly::config<ouly::cfg::strategy<Strategy>,
+                                                         ouly::cfg::manager<trace_arena_manager>,
+                                                         ouly::cfg::basic_size_type<uint32_t>>>;
+  using handle      = std::uint32_t;
+
+  trace_arena_manager mgr_;
+  allocator_t         allocator_{trace_arena_size, mgr_};
+
+  auto allocate(std::size_t size, std::size_t align) -> handle
+  {
+    auto [arena, id, offset] =
+     allocator_.allocate(static_cast<uint32_t>(std::max<std::size_t>(size, 1)), static_cast<uint32_t>(align));
+    return id;
+  }
+
+  void deallocate(handle id, std::size_t, std::size_t)
+  {
+    allocator_.deallocate(id);
+  }
+
+  auto footprint() const -> std::size_t
+  {
+    return mgr_.tracker_.footprint_;
+  }
+};
+
+template <typename Allocator>
+struct coalescing_replay_target
+{
+  using handle = ouly::allocation_id;
+
+  trace_coalescing_manager mgr_;
+  Allocator                allocator_{trace_arena_size};
+
+  auto allocate(std::size_t size, std::size_t align) -> handle
+  {
+    auto const vsize = static_cast<ouly::allocation_size_type>(std::max<std::size_t>(size, 1));
+    return allocator_.allocate(vsize, mgr_, static_cast<ouly::allocation_size_type>(align)).get_allocation_id();
+  }
+
+  void deallocate(handle id, std::size_t, std::size_t)
+  {
+    allocator_.deallocate(id, mgr_);
+  }
+
+  auto footprint() const -> std::size_t
+  {
+    return mgr_.tracker_.footprint_;
+  }
+};
+
+struct gpu_replay_target
+{
+  using handle = ouly::allocation_id;
+
+  trace_coalescing_manager mgr_;
+  ouly::gpu_allocator      allocator_{trace_arena_size};
+
+  auto allocate(std::size_t size, std::size_t align) -> handle
+  {
+    auto const vsize = static_cast<ouly::allocation_size_type>(std::max<std::size_t>(size, 1));
+    return allocator_
+     .allocate(vsize, mgr_, ouly::gpu_allocation_options{.alignment_ = static_cast<ouly::allocation_size_type>(align)})
+     .get_allocation_id();
+  }
+
+  void deallocate(handle id, std::size_t, std::size_t)
+  {
+    allocator_.deallocate(id, mgr_);
+  }
+
+  auto footprint() const -> std::size_t
+  {
+    return mgr_.tracker_.footprint_;
+  }
+};
+
+template <typename Target>
+void replay(ouly::allocation_trace const& trace, std::string_view name)
+{
+  Target target;
+  auto   stats = ouly::replay_trace(trace, target);
+  std::printf("| %-26.*s | %12.0f | %14.2f | %13.3f | %16.2f |\n", static_cast<int>(name.size()), name.data(),
+              stats.throughput(), static_cast<double>(stats.peak_footprint_) / (1024.0 * 1024.0),
+              stats.fragmentation_ratio(), static_cast<double>(stats.worst_latency_ns_) / 1000.0);
+}
+
+// Frame-shaped load: scratch that lives for up to three frames, and resources of mixed sizes that live
+// for a random number of frames
+auto record_synthetic_trace() -> ouly::allocation_trace
+{
+  struct block
+  {
+    void*       ptr_;
+    std::size_t size_;
+    std::size_t align_;
+    uint32_t    expires_;
+  };
+
+  constexpr uint32_t frames             = 120;
+  constexpr uint32_t scratch_per_frame  = 2000;
+  constexpr uint32_t resource_per_frame = 20;
+
+  ouly::allocation_recorder<> recorder;
+  std::vector<block>          live;
+  uint32_t                    seed = 2147483647;
+  auto                        next = [&seed]()
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  };
+  auto allocate = [&](std::size_t size, std::size_t align, uint32_t expires)
+  {
+    live.push_back({recorder.allocate(size, std::align_val_t{align}), size, align, expires});
+  };
+
+  for (uint32_t frame = 0; frame < frames; ++frame)
+  {
+    for (uint32_t i = 0; i < resource_per_frame; ++i)
+    {
+      allocate(4096 + (next() % (256 * 1024)), 256, frame + 1 + (next() % 30));
+    }
+    for (uint32_t i = 0; i < scratch_per_frame; ++i)
+    {
+      allocate(16 + (next() % 4080), 16, frame + (next() % 3));
+    }
+    std::erase_if(live,
+                  [&](block const& b)
+                  {
+                    if (b.expires_ > frame)
+                    {
+                      return false;
+                    }
+                    recorder.deallocate(b.ptr_, b.size_, std::align_val_t{b.align_});
+                    return true;
+                  });
+  }
+  for (auto const& b : live)
+  {
+    recorder.deallocate(b.ptr_, b.size_, std::align_val_t{b.align_});
+  }
+  return recorder.take_trace();
+}
+} // namespace
+
+// Replays a trace recorded with ouly::allocation_recorder (or a synthetic frame trace when no path
+// is given) against every arena based allocator, so strategies can be picked from captured frames
+void bench_allocation_trace(char const* path)
+{
+  ouly::allocation_trace trace;
+  if (path != nullptr)
+  {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+      std::cerr << "Cannot open trace " << path << "\n";
+      return;
+    }
+    trace = ouly::read_trace(file);
+  }
+  else
+  {
+    trace = record_synthetic_trace();
+  }
+
+  std::cout << "\nReplaying " << trace.events_.size() << " events, arena size " << (trace_arena_size >> 20U)
+            << " MiB\n";
+  std::printf("| %-26s | %12s | %14s | %13s | %16s |\n", "allocator", "ops/s", "peak foot MiB", "fragmentation",
+              "worst latency us");
+  std::printf("|%s|%s|%s|%s|%s|\n", "----------------------------", "--------------", "----------------",
+              "---------------", "------------------");
+  replay<arena_replay_target<ouly::strat::greedy_v0<>>>(trace, "arena greedy-v0");
+  replay<arena_replay_target<ouly::strat::greedy_v1<>>>(trace, "arena greedy-v1");
+  replay<arena_replay_target<ouly::strat::best_fit_tree<>>>(trace, "arena bf-tree");
+  replay<arena_replay_target<ouly::strat::best_fit_v0<>>>(trace, "arena bf-v0");
+  replay<arena_replay_target<ouly::strat::best_fit_v1<ouly::cfg::bsearch_min1>>>(trace, "arena bf-v1-min1");
+  replay<arena_replay_target<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>>>(trace, "arena bf-v2-min1");
+  replay<arena_replay_target<ouly::strat::tlsf<>>>(trace, "arena tlsf");
+  replay<coalescing_replay_target<ouly::coalescing_arena_allocator>>(trace, "coalescing_arena_allocator");
+  replay<coalescing_replay_target<ouly::best_fit_defrag_allocator>>(trace, "best_fit_defrag_allocator");
+  replay<coalescing_replay_target<ouly::first_fit_defrag_allocator>>(trace, "first_fit_defrag_allocator");
+  replay<gpu_replay_target>(trace, "gpu_allocator");
+}
+// NOLINTEND
@@ -6,6 +6,7 @@
 #include "ouly/scheduler/co_task.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
+#include "ouly/scheduler/task.hpp"
 #include "ouly/scheduler/v1/scheduler.hpp"
 #include "ouly/scheduler/v1/task_context.hpp"
 #include "ouly/scheduler/v2/scheduler.hpp"
@@ -55,6 +56,7 @@ constexpr float    VECTOR_INCREMENT    = 0.1F;
 constexpr float    SCALE_FACTOR        = 1.01F;
 constexpr uint32_t NESTED_DEPTH        = 5U;
 constexpr uint32_t BATCH_SIZE          = 100U;
+constexpr uint32_t INLINE_DEPTH        = 16U;
 } // namespace coroutine_benchmark_config
 
 // Benchmark data structures for coroutine tests
@@ -563,6 +565,68 @@ private:
   }
 };
 
+// Per-edge latency of dependent chains, queued vs inline continuations
+class ChainLatencyBenchmarks
+{
+public:
+  // A then() chain where every link only becomes ready once its predecessor finishes
+  static void run_task_chain_latency(ankerl::nanobench::Bench& bench)
+  {
+    ouly::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+
+    for (uint32_t depth : {0U, coroutine_benchmark_config::INLINE_DEPTH})
+    {
+      scheduler.set_inline_continuation_depth(depth);
+      bench.run(std::string("TaskChainLatency_") + (depth == 0 ? "Queued" : "Inline"),
+                []()
+                {
+                  auto const& main_ctx = ouly::task_context::this_context::get();
+                  auto        link     = ouly::submit_task(main_ctx,
+                                                           []() -> uint32_t
+                                                           {
+                                                  return 1U;
+                                                });
+                  for (uint32_t i = 0; i < coroutine_benchmark_config::CHAIN_LENGTH_LONG; ++i)
+                  {
+                    link = link.then(main_ctx,
+                                     [](uint32_t value) -> uint32_t
+                                     {
+                                       CoroutineComputationKernels::minimal_work(value);
+                                       return value;
+                                     });
+                  }
+                  ankerl::nanobench::doNotOptimizeAway(link.get(main_ctx));
+                });
+    }
+
+    scheduler.end_execution();
+  }
+
+  // A recursive co_task chain, resumed through the queue or by symmetric transfer
+  static void run_coroutine_chain_latency(ankerl::nanobench::Bench& bench)
+  {
+    ouly::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+
+    for (uint32_t depth : {0U, coroutine_benchmark_config::INLINE_DEPTH})
+    {
+      scheduler.set_inline_continuation_depth(depth);
+      bench.run(std::string("CoroutineChainLatency_") + (depth == 0 ? "Queued" : "SymmetricTransfer"),
+                []()
+                {
+                  auto const& main_ctx = ouly::task_context::this_context::get();
+                  auto task = simple_coroutines::chain_task(1.0F, coroutine_benchmark_config::CHAIN_LENGTH_LONG, 0U);
+                  ankerl::nanobench::doNotOptimizeAway(task.cooperative_wait(main_ctx));
+                });
+    }
+
+    scheduler.end_execution();
+  }
+};
+
 // TBB comparison for coroutine-style workflows
 class TBBCoroutineStyleBenchmarks
 {
@@ -805,6 +869,22 @@ void run_coroutine_benchmarks(int benchmark_set = -1)
      .relative(true);
   }
 
+  if (benchmark_set < 0 || benchmark_set == 2)
+  {
+    std::cout << "⛓️  Running Chain Latency Benchmarks..." << std::endl;
+
+    ChainLatencyBenchmarks::run_task_chain_latency(bench);
+    ChainLatencyBenchmarks::run_coroutine_chain_latency(bench);
+
+    const char* commit_hash_env  = std::getenv("GITHUB_SHA");
+    const char* build_number_env = std::getenv("GITHUB_RUN_NUMBER");
+
+    std::string commit_hash  = (commit_hash_env != nullptr) ? commit_hash_env : "";
+    std::string build_number = (build_number_env != nullptr) ? build_number_env : "";
+
+    CoroutineBenchmarkReporter::save_results(bench, "chain_latency", commit_hash, build_number);
+  }
+
   std::cout << "✅ All coroutine benchmarks completed!" << std::endl;
 }
 
@@ -7,9 +7,12 @@
 #include "ouly/allocators/strat/best_fit_v2.hpp"
 #include "ouly/allocators/strat/greedy_v0.hpp"
 #include "ouly/allocators/strat/greedy_v1.hpp"
+#include "ouly/allocators/strat/tlsf.hpp"
 #include <string_view>
 
 // NOLINTBEGIN
+void bench_allocation_trace(char const* path);
+
 struct alloc_mem_manager
 {
 
@@ -79,6 +82,43 @@ void bench_arena(uint32_t size, std::string_view name)
                           });
 }
 
+// Random frees and allocations with `live` blocks outstanding, the load of a long lived GPU heap
+template <typename T>
+void bench_arena_live_blocks(uint32_t live, std::string_view name)
+{
+  using allocator_t = ouly::arena_allocator<
+   ouly::config<ouly::cfg::strategy<T>, ouly::cfg::manager<alloc_mem_manager>, ouly::cfg::basic_size_type<uint32_t>>>;
+  constexpr uint32_t nchurn     = 100000;
+  constexpr uint32_t arena_size = 64 * 1024 * 1024;
+
+  ankerl::nanobench::Bench bench;
+  bench.output(&std::cout);
+  bench.minEpochIterations(3);
+  bench.batch(nchurn).run(std::string{name},
+                          [&]
+                          {
+                            rand_device                dev;
+                            alloc_mem_manager          mgr;
+                            allocator_t                allocator(arena_size, mgr);
+                            std::vector<std::uint32_t> allocations;
+                            allocations.reserve(live);
+                            for (std::uint32_t i = 0; i < live; ++i)
+                            {
+                              auto alloc_size      = ((dev.update() % 100) + 4) * T::min_granularity;
+                              auto [arena, id, at] = allocator.allocate(alloc_size);
+                              allocations.push_back(id);
+                            }
+                            for (std::uint32_t i = 0; i < nchurn; ++i)
+                            {
+                              auto& slot = allocations[dev.update() % live];
+                              allocator.deallocate(slot);
+                              auto alloc_size      = ((dev.update() % 100) + 4) * T::min_granularity;
+                              auto [arena, id, at] = allocator.allocate(alloc_size);
+                              slot                 = id;
+                            }
+                          });
+}
+
 int main(int argc, char* argv[])
 {
   constexpr uint32_t size = 256 * 256;
@@ -97,6 +137,18 @@ int main(int argc, char* argv[])
   bench_arena<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min0>>(size, "bf-v2-min0");
   bench_arena<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>>(size, "bf-v2-min1");
   bench_arena<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min2>>(size, "bf-v2-min2");
+  bench_arena<ouly::strat::tlsf<>>(size, "tlsf");
+
+  // The linear scans of the greedy strategies are left out, they do not scale to this many blocks
+  constexpr uint32_t live = 100000;
+  bench_arena_live_blocks<ouly::strat::best_fit_tree<>>(live, "bf-tree 100k live");
+  bench_arena_live_blocks<ouly::strat::best_fit_v0<>>(live, "bf-v0 100k live");
+  bench_arena_live_blocks<ouly::strat::best_fit_v1<ouly::cfg::bsearch_min1>>(live, "bf-v1-min1 100k live");
+  bench_arena_live_blocks<ouly::strat::best_fit_v2<ouly::cfg::bsearch_min1>>(live, "bf-v2-min1 100k live");
+  bench_arena_live_blocks<ouly::strat::tlsf<>>(live, "tlsf 100k live");
+
+  // Pass the path of a trace written by ouly::write_trace to replay a captured workload
+  bench_allocation_trace(argc > 1 ? argv[1] : nullptr);
 
   return 0;
 }
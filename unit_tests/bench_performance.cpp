@@ -2,11 +2,16 @@
 #define ANKERL_NANOBENCH_IMPLEMENT
 #include "nanobench.h"
 #include "ouly/allocators/coalescing_arena_allocator.hpp"
+#include "ouly/allocators/ts_pool_allocator.hpp"
 #include "ouly/allocators/ts_shared_linear_allocator.hpp"
 #include "ouly/allocators/ts_thread_local_allocator.hpp"
+#include "ouly/allocators/virtual_allocator.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
 #include <atomic>
+#include <barrier>
+#include <cstdint>
+#include <cstring>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
@@ -269,6 +274,182 @@ void bench_ts_thread_local_allocator()
             });
 }
 
+// Random alloc/free churn on every thread; with `cross_thread` set, each round every thread also
+// frees the blocks its neighbour allocated, the producer/consumer pattern of worker threads
+template <typename Allocate, typename Deallocate, typename Flush>
+void run_allocator_churn(Allocate&& allocate, Deallocate&& deallocate, Flush&& flush, bool cross_thread)
+{
+  constexpr int         num_threads = 4;
+  constexpr int         rounds      = 16;
+  constexpr int         churn       = 1000;
+  constexpr std::size_t slots       = 256;
+  constexpr std::size_t handoff     = 128;
+
+  std::vector<std::vector<std::pair<void*, std::size_t>>> outbox(num_threads);
+  std::barrier<>                                          sync(num_threads);
+  std::vector<std::thread>                                threads;
+
+  for (int t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back(
+     [&, t]()
+     {
+       std::mt19937                              rng(static_cast<unsigned>(t));
+       std::vector<std::pair<void*, std::size_t>> live(slots, {nullptr, 0});
+       for (int round = 0; round < rounds; ++round)
+       {
+         for (int i = 0; i < churn; ++i)
+         {
+           auto& slot = live[rng() % slots];
+           if (slot.first != nullptr)
+           {
+             deallocate(slot.first, slot.second);
+             slot.first = nullptr;
+           }
+           else
+           {
+             slot.second = 16 + (rng() % 1024);
+             slot.first  = allocate(slot.second);
+             ankerl::nanobench::doNotOptimizeAway(slot.first);
+           }
+         }
+
+         if (cross_thread)
+         {
+           for (std::size_t i = 0; i < handoff; ++i)
+           {
+             std::size_t size = 16 + (rng() % 256);
+             outbox[t].emplace_back(allocate(size), size);
+           }
+           sync.arrive_and_wait();
+           for (auto [ptr, size] : outbox[(t + 1) % num_threads])
+           {
+             deallocate(ptr, size);
+           }
+           sync.arrive_and_wait();
+           outbox[t].clear();
+         }
+       }
+
+       for (auto [ptr, size] : live)
+       {
+         deallocate(ptr, size);
+       }
+       flush();
+     });
+  }
+
+  for (auto& t : threads)
+  {
+    t.join();
+  }
+}
+
+void bench_ts_pool_allocator()
+{
+  std::cout << "Benchmarking ts_pool_allocator against malloc...\n";
+
+  ankerl::nanobench::Bench bench;
+  bench.title("Thread-Safe Pool Allocator").unit("churn").warmup(3).epochIterations(20);
+
+  ouly::ts_pool_allocator pool;
+  auto                    pool_allocate = [&](std::size_t size)
+  {
+    return pool.allocate(size);
+  };
+  auto pool_deallocate = [&](void* ptr, std::size_t size)
+  {
+    pool.deallocate(ptr, size);
+  };
+  auto pool_flush = [&]()
+  {
+    pool.flush_thread_cache();
+  };
+  auto malloc_allocate = [](std::size_t size)
+  {
+    return std::malloc(size); // NOLINT(cppcoreguidelines-no-malloc)
+  };
+  auto malloc_deallocate = [](void* ptr, std::size_t /*size*/)
+  {
+    std::free(ptr); // NOLINT(cppcoreguidelines-no-malloc)
+  };
+  auto no_flush = []() {};
+
+  bench.run("ts_pool multi-thread churn",
+            [&]
+            {
+              run_allocator_churn(pool_allocate, pool_deallocate, pool_flush, false);
+            });
+
+  bench.run("malloc multi-thread churn",
+            [&]
+            {
+              run_allocator_churn(malloc_allocate, malloc_deallocate, no_flush, false);
+            });
+
+  bench.run("ts_pool cross-thread free churn",
+            [&]
+            {
+              run_allocator_churn(pool_allocate, pool_deallocate, pool_flush, true);
+            });
+
+  bench.run("malloc cross-thread free churn",
+            [&]
+            {
+              run_allocator_churn(malloc_allocate, malloc_deallocate, no_flush, true);
+            });
+}
+
+void bench_huge_page_arena()
+{
+  std::cout << "Benchmarking random access over a 1 GiB arena with and without huge pages...\n";
+
+  constexpr std::size_t arena_bytes = std::size_t{1} << 30U;
+  constexpr std::size_t word_mask   = (arena_bytes / sizeof(std::uint64_t)) - 1;
+  constexpr std::size_t accesses    = std::size_t{1} << 20U;
+
+  ankerl::nanobench::Bench bench;
+  bench.title("Huge Page Arena Random Access").unit("access").batch(accesses).warmup(1).epochIterations(5);
+
+  auto run = [&](char const* name, auto& allocator)
+  {
+    auto* data = static_cast<std::uint64_t*>(allocator.allocate(arena_bytes));
+    if (data == nullptr)
+    {
+      std::cout << "  skipping " << name << ": could not map the arena\n";
+      return;
+    }
+    // Fault every page in up front so the runs measure TLB reach, not page faults
+    std::memset(data, 1, arena_bytes);
+
+    std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+    bench.run(name,
+              [&]
+              {
+                std::uint64_t sum = 0;
+                for (std::size_t i = 0; i < accesses; ++i)
+                {
+                  state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+                  sum += data[(state >> 16U) & word_mask];
+                }
+                ankerl::nanobench::doNotOptimizeAway(sum);
+              });
+
+    allocator.deallocate(data, arena_bytes);
+  };
+
+  using transparent_config = ouly::config<ouly::cfg::huge_pages<ouly::cfg::huge_page_policy::transparent>>;
+  using dedicated_config   = ouly::config<ouly::cfg::huge_pages<ouly::cfg::huge_page_policy::dedicated>>;
+
+  ouly::virtual_allocator<>                   regular;
+  ouly::virtual_allocator<transparent_config> transparent;
+  ouly::virtual_allocator<dedicated_config>   dedicated;
+
+  run("1 GiB arena, regular pages", regular);
+  run("1 GiB arena, transparent huge pages", transparent);
+  run("1 GiB arena, dedicated huge pages", dedicated);
+}
+
 void bench_coalescing_arena_allocator()
 {
   std::cout << "Benchmarking coalescing_arena_allocator...\n";
@@ -381,6 +562,8 @@ int main(int argc, char* argv[])
   {
     bench_ts_shared_linear_allocator();
     bench_ts_thread_local_allocator();
+    bench_ts_pool_allocator();
+    bench_huge_page_arena();
     bench_coalescing_arena_allocator();
 
     std::cout << "\nBenchmarks completed successfully!\n";
@@ -439,6 +622,17 @@ int main(int argc, char* argv[])
       allocator.reset();
     }
 
+    {
+      ouly::ts_pool_allocator allocator;
+      json_bench.run("ts_pool_single_thread",
+                     [&]
+                     {
+                       void* ptr = allocator.allocate(64);
+                       ankerl::nanobench::doNotOptimizeAway(ptr);
+                       allocator.deallocate(ptr, 64);
+                     });
+    }
+
     {
       simple_memory_manager            manager;
       ouly::coalescing_arena_allocator allocator;
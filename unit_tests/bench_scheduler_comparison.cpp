@@ -3,8 +3,12 @@
 #define GLM_ENABLE_EXPERIMENTAL
 
 #include "nanobench.h"
+#include "ouly/scheduler/flow_graph.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
+#include "ouly/scheduler/parallel_partition.hpp"
+#include "ouly/scheduler/parallel_sort.hpp"
 #include "ouly/scheduler/scheduler.hpp"
+#include "ouly/scheduler/spill_pool.hpp"
 
 #include <algorithm>
 #include <atomic>
@@ -14,12 +18,17 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <random>
+#include <ranges>
 #include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
+#if __has_include(<execution>)
+#include <execution>
+#endif
 
 // Include GLM for mathematical operations
 #include <glm/glm.hpp>
@@ -348,6 +357,430 @@ private:
   }
 };
 
+// External-thread submission benchmarks (v3 only: threads that are not scheduler workers submit
+// into a group through its mailbox and, once that ring is full, its overflow queue)
+class ExternalSubmitBenchmarks
+{
+public:
+  // Eight non-worker threads (IO/network style) flood one workgroup far past the mailbox capacity
+  static void run_external_flood(ankerl::nanobench::Bench& bench)
+  {
+    constexpr uint32_t PRODUCER_COUNT     = 8U;
+    constexpr uint32_t TASKS_PER_PRODUCER = 20000U;
+
+    ouly::v3::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+    const auto& main_ctx = ouly::v3::task_context::this_context::get();
+
+    bench.run("ExternalFlood_8Producers_V3",
+              [&scheduler, &main_ctx]()
+              {
+                std::atomic<uint32_t>    counter{0};
+                std::vector<std::thread> producers;
+                producers.reserve(PRODUCER_COUNT);
+                for (uint32_t p = 0; p < PRODUCER_COUNT; ++p)
+                {
+                  producers.emplace_back(
+                   [&scheduler, &main_ctx, &counter]()
+                   {
+                     for (uint32_t i = 0; i < TASKS_PER_PRODUCER; ++i)
+                     {
+                       scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                                        [&counter](const ouly::v3::task_context&)
+                                        {
+                                          counter.fetch_add(1, std::memory_order_relaxed);
+                                        });
+                     }
+                   });
+                }
+                for (auto& producer : producers)
+                {
+                  producer.join();
+                }
+                scheduler.wait_for_tasks();
+
+                ankerl::nanobench::doNotOptimizeAway(counter.load());
+              });
+
+    scheduler.end_execution();
+  }
+};
+
+// Batch submission benchmarks (v3 only): a frame-style fan-out of many tiny jobs submitted one by
+// one versus through submit_batch(), which pays the pending/queued accounting and wakeup once
+class BatchSubmitBenchmarks
+{
+public:
+  static void run_batch_vs_loop(ankerl::nanobench::Bench& bench)
+  {
+    constexpr uint32_t TASK_COUNT = 10000U;
+
+    ouly::v3::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+    const auto& main_ctx = ouly::v3::task_context::this_context::get();
+
+    std::atomic<uint32_t> counter{0};
+    auto                  job = [&counter](const ouly::v3::task_context&)
+    {
+      counter.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    bench.run("SubmitLoop_10k_V3",
+              [&]()
+              {
+                for (uint32_t i = 0; i < TASK_COUNT; ++i)
+                {
+                  scheduler.submit(main_ctx, ouly::workgroup_id(0), job);
+                }
+                scheduler.wait_for_tasks();
+                ankerl::nanobench::doNotOptimizeAway(counter.load());
+              });
+
+    std::vector<ouly::v3::task_delegate> batch(TASK_COUNT, ouly::v3::task_delegate::bind(job));
+    bench.run("SubmitBatch_10k_V3",
+              [&]()
+              {
+                scheduler.submit_batch(main_ctx, ouly::workgroup_id(0), batch);
+                scheduler.wait_for_tasks();
+                ankerl::nanobench::doNotOptimizeAway(counter.load());
+              });
+
+    bench.run("SubmitBatchRange_10k_V3",
+              [&]()
+              {
+                scheduler.submit_batch(main_ctx, ouly::workgroup_id(0),
+                                       std::views::iota(0U, TASK_COUNT) |
+                                        std::views::transform(
+                                         [&job](uint32_t)
+                                         {
+                                           return job;
+                                         }));
+                scheduler.wait_for_tasks();
+                ankerl::nanobench::doNotOptimizeAway(counter.load());
+              });
+
+    scheduler.end_execution();
+  }
+};
+
+class SpilledSubmitBenchmarks
+{
+public:
+  // Tasks capturing a vector and a shared_ptr, boxed on the heap by hand vs spilled into the pool
+  static void run_spill_vs_heap(ankerl::nanobench::Bench& bench)
+  {
+    constexpr uint32_t TASK_COUNT   = 10000U;
+    constexpr uint32_t CAPTURE_SIZE = 8U;
+
+    ouly::v3::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+    const auto& main_ctx = ouly::v3::task_context::this_context::get();
+
+    std::atomic<uint64_t> total{0};
+    auto                  scale = std::make_shared<uint64_t>(3);
+    auto                  job   = [&total](std::vector<uint32_t> const& values, uint64_t factor)
+    {
+      total.fetch_add(std::accumulate(values.begin(), values.end(), uint64_t{0}) * factor, std::memory_order_relaxed);
+    };
+
+    bench.run("FatTaskHeapBoxed_10k_V3",
+              [&]()
+              {
+                for (uint32_t i = 0; i < TASK_COUNT; ++i)
+                {
+                  struct boxed
+                  {
+                    std::vector<uint32_t>     values;
+                    std::shared_ptr<uint64_t> factor;
+                  };
+                  auto* box = new boxed{std::vector<uint32_t>(CAPTURE_SIZE, i), scale};
+                  scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                                   [box, &job](const ouly::v3::task_context&)
+                                   {
+                                     job(box->values, *box->factor);
+                                     delete box;
+                                   });
+                }
+                scheduler.wait_for_tasks();
+                ankerl::nanobench::doNotOptimizeAway(total.load());
+              });
+
+    bench.run("FatTaskSpilled_10k_V3",
+              [&]()
+              {
+                for (uint32_t i = 0; i < TASK_COUNT; ++i)
+                {
+                  scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                                   ouly::spill(
+                                    [values = std::vector<uint32_t>(CAPTURE_SIZE, i), factor = scale,
+                                     &job](const ouly::v3::task_context&)
+                                    {
+                                      job(values, *factor);
+                                    }));
+                }
+                scheduler.wait_for_tasks();
+                ankerl::nanobench::doNotOptimizeAway(total.load());
+              });
+
+    scheduler.end_execution();
+  }
+};
+
+class ParallelSortBenchmarks
+{
+public:
+  // Sorting and partitioning a frame's worth of keys, against std::sort and std::execution::par
+  static void run_sort_comparison(ankerl::nanobench::Bench& bench)
+  {
+    constexpr uint32_t KEY_COUNT = 1U << 20U;
+
+    ouly::v3::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+    const auto& main_ctx = ouly::v3::task_context::this_context::get();
+
+    std::mt19937_64       rng(benchmark_config::HASH_ADDITIVE);
+    std::vector<uint64_t> source(KEY_COUNT);
+    for (auto& key : source)
+    {
+      key = rng();
+    }
+    std::vector<float> float_source(KEY_COUNT);
+    std::ranges::transform(source, float_source.begin(),
+                           [](uint64_t key)
+                           {
+                             return static_cast<float>(key >> benchmark_config::SHIFT_AMOUNT);
+                           });
+
+    std::vector<uint64_t> keys;
+    std::vector<float>    float_keys;
+
+    bench.run("Sort_1M_u64_StdSort",
+              [&]()
+              {
+                keys = source;
+                std::sort(keys.begin(), keys.end());
+                ankerl::nanobench::doNotOptimizeAway(keys.front());
+              });
+
+#if defined(__cpp_lib_parallel_algorithm)
+    bench.run("Sort_1M_u64_StdExecutionPar",
+              [&]()
+              {
+                keys = source;
+                std::sort(std::execution::par, keys.begin(), keys.end());
+                ankerl::nanobench::doNotOptimizeAway(keys.front());
+              });
+#endif
+
+    bench.run("Sort_1M_u64_OulyRadix_V3",
+              [&]()
+              {
+                keys = source;
+                ouly::parallel_sort(keys.begin(), keys.end(), main_ctx);
+                ankerl::nanobench::doNotOptimizeAway(keys.front());
+              });
+
+    bench.run("Sort_1M_u64_OulyMerge_V3",
+              [&]()
+              {
+                keys = source;
+                ouly::parallel_sort(keys.begin(), keys.end(), std::less<>{}, main_ctx);
+                ankerl::nanobench::doNotOptimizeAway(keys.front());
+              });
+
+    bench.run("Sort_1M_f32_StdSort",
+              [&]()
+              {
+                float_keys = float_source;
+                std::sort(float_keys.begin(), float_keys.end());
+                ankerl::nanobench::doNotOptimizeAway(float_keys.front());
+              });
+
+    bench.run("Sort_1M_f32_OulyRadix_V3",
+              [&]()
+              {
+                float_keys = float_source;
+                ouly::parallel_sort(float_keys.begin(), float_keys.end(), main_ctx);
+                ankerl::nanobench::doNotOptimizeAway(float_keys.front());
+              });
+
+    auto const is_odd = [](uint64_t key)
+    {
+      return (key & 1U) != 0;
+    };
+
+    bench.run("Partition_1M_StdStablePartition",
+              [&]()
+              {
+                keys = source;
+                ankerl::nanobench::doNotOptimizeAway(std::stable_partition(keys.begin(), keys.end(), is_odd));
+              });
+
+    bench.run("Partition_1M_OulyStablePartition_V3",
+              [&]()
+              {
+                keys = source;
+                ankerl::nanobench::doNotOptimizeAway(
+                 ouly::parallel_stable_partition(keys.begin(), keys.end(), is_odd, main_ctx));
+              });
+
+    bench.run("Partition_1M_StdPartition",
+              [&]()
+              {
+                keys = source;
+                ankerl::nanobench::doNotOptimizeAway(std::partition(keys.begin(), keys.end(), is_odd));
+              });
+
+    bench.run("Partition_1M_OulyPartition_V3",
+              [&]()
+              {
+                keys = source;
+                ankerl::nanobench::doNotOptimizeAway(
+                 ouly::parallel_partition(keys.begin(), keys.end(), is_odd, main_ctx));
+              });
+
+    scheduler.end_execution();
+  }
+};
+
+class AffinityBenchmarks
+{
+public:
+  // Repeated sweeps over the same particle array, as a simulation does every frame
+  static void run_affinity_vs_auto(ankerl::nanobench::Bench& bench)
+  {
+    constexpr uint32_t PARTICLE_COUNT = 1U << 19U;
+    constexpr uint32_t FRAME_COUNT    = 16U;
+
+    ouly::v3::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+    const auto& main_ctx = ouly::v3::task_context::this_context::get();
+
+    std::vector<float> positions(PARTICLE_COUNT * 4U, 1.0F);
+    std::vector<float> velocities(PARTICLE_COUNT * 4U, benchmark_config::VECTOR_INCREMENT);
+
+    auto const integrate = [&](uint32_t begin, uint32_t end, const ouly::v3::task_context&)
+    {
+      for (uint32_t i = begin * 4U; i < end * 4U; ++i)
+      {
+        velocities[i] *= benchmark_config::SCALAR_INCREMENT + 1.0F;
+        positions[i] += velocities[i];
+      }
+    };
+
+    bench.run("ParticleFrames_AutoPartitioner_V3",
+              [&]()
+              {
+                for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+                {
+                  ouly::auto_parallel_for(integrate, ouly::subrange<uint32_t>(0, PARTICLE_COUNT), main_ctx);
+                }
+                ankerl::nanobench::doNotOptimizeAway(positions.front());
+              });
+
+    ouly::affinity_partitioner partitioner;
+    bench.run("ParticleFrames_AffinityPartitioner_V3",
+              [&]()
+              {
+                for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+                {
+                  ouly::parallel_for(integrate, ouly::subrange<uint32_t>(0, PARTICLE_COUNT), main_ctx, partitioner);
+                }
+                ankerl::nanobench::doNotOptimizeAway(positions.front());
+              });
+
+    std::cout << "Affinity hits in the last frame: " << partitioner.get_affinity_hits() << " of "
+              << partitioner.get_chunk_count() << " chunks" << std::endl;
+
+    scheduler.end_execution();
+  }
+};
+
+// Critical path scheduling: a deep chain whose every link also releases a layer of independent
+// nodes of the same cost. The makespan is bound by the chain; with ready-order dispatch the layers
+// can hold a chain link back, with cfg::flow_graph_critical_path the links go to the critical lane.
+class CriticalPathBenchmarks
+{
+public:
+  static constexpr uint32_t DEPTH = 16U;
+  static constexpr uint32_t WIDTH = 8U;
+
+  static void spin_for(std::chrono::nanoseconds duration)
+  {
+    auto const until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until)
+    {
+    }
+  }
+
+  template <typename Graph>
+  static void build_wide_deep_dag(Graph& graph, std::chrono::nanoseconds cost)
+  {
+    auto const work = [cost](const ouly::v3::task_context&)
+    {
+      spin_for(cost);
+    };
+    auto link = graph.create_node();
+    graph.add(link, work);
+    auto sink = graph.create_node();
+    for (uint32_t level = 1; level < DEPTH; ++level)
+    {
+      auto next = graph.create_node();
+      graph.add(next, work);
+      graph.connect(link, next);
+      for (uint32_t i = 0; i < WIDTH; ++i)
+      {
+        auto side = graph.create_node();
+        graph.add(side, work);
+        graph.connect(link, side);
+        graph.connect(side, sink);
+      }
+      link = next;
+    }
+    graph.connect(link, sink);
+    graph.compile();
+  }
+
+  static void run_wide_deep_dag(ankerl::nanobench::Bench& bench)
+  {
+    using plain_graph = ouly::flow_graph<ouly::v3::scheduler>;
+    using critical_graph =
+     ouly::flow_graph<ouly::v3::scheduler, 4, 4, ouly::config<ouly::cfg::flow_graph_critical_path>>;
+    constexpr auto NODE_COST = std::chrono::microseconds(20);
+
+    ouly::v3::scheduler scheduler;
+    scheduler.create_group(ouly::workgroup_id(0), 0, std::thread::hardware_concurrency());
+    scheduler.begin_execution();
+    const auto& main_ctx = ouly::v3::task_context::this_context::get();
+
+    plain_graph    plain;
+    critical_graph critical;
+    build_wide_deep_dag(plain, NODE_COST);
+    build_wide_deep_dag(critical, NODE_COST);
+
+    bench.run("WideDeepDag_ReadyOrder_V3",
+              [&]()
+              {
+                plain.start(main_ctx);
+                plain.cooperative_wait(main_ctx);
+              });
+
+    bench.run("WideDeepDag_CriticalPath_V3",
+              [&]()
+              {
+                critical.start(main_ctx);
+                critical.cooperative_wait(main_ctx);
+              });
+
+    scheduler.end_execution();
+  }
+};
+
 // TBB benchmark implementations for comparison
 class TBBBenchmarks
 {
@@ -623,6 +1056,42 @@ void run_comprehensive_scheduler_benchmarks(int run_only = -1)
     ComprehensiveSchedulerBenchmark<ouly::v2::scheduler, ouly::v2::task_context>::run_nested_parallel(bench, "V2");
   }
 
+  if (run_only < 0 || run_only == 6)
+  {
+    std::cout << "📥 Running External Submission Flood..." << std::endl;
+    ExternalSubmitBenchmarks::run_external_flood(bench);
+  }
+
+  if (run_only < 0 || run_only == 7)
+  {
+    std::cout << "📦 Running Batch Submission Benchmarks..." << std::endl;
+    BatchSubmitBenchmarks::run_batch_vs_loop(bench);
+  }
+
+  if (run_only < 0 || run_only == 8)
+  {
+    std::cout << "🧳 Running Spilled Task Submission Benchmarks..." << std::endl;
+    SpilledSubmitBenchmarks::run_spill_vs_heap(bench);
+  }
+
+  if (run_only < 0 || run_only == 9)
+  {
+    std::cout << "🗂️ Running Parallel Sort And Partition Benchmarks..." << std::endl;
+    ParallelSortBenchmarks::run_sort_comparison(bench);
+  }
+
+  if (run_only < 0 || run_only == 10)
+  {
+    std::cout << "🧭 Running Affinity Partitioner Benchmarks..." << std::endl;
+    AffinityBenchmarks::run_affinity_vs_auto(bench);
+  }
+
+  if (run_only < 0 || run_only == 11)
+  {
+    std::cout << "🛤️ Running Critical Path Flow Graph Benchmarks..." << std::endl;
+    CriticalPathBenchmarks::run_wide_deep_dag(bench);
+  }
+
   std::cout << " Saving benchmark results...\n";
 
   // Get environment variables for CI integration
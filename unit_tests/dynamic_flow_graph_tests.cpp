@@ -12,6 +12,8 @@
 #include <catch2/reporters/catch_reporter_registrars.hpp>
 #include <chrono>
 #include <iostream>
+#include <latch>
+#include <string>
 #include <thread>
 #include <vector>
 // NOLINTBEGIN
@@ -264,6 +266,57 @@ TEST_CASE("dynamic_flow_graph self-loop runs a fixed number of iterations", "[dy
   scheduler.end_execution();
 }
 
+TEST_CASE("dynamic_flow_graph cancellation stops the loop and skips scheduled tasks",
+          "[dynamic_flow_graph][loop][cancellation]")
+{
+  using SchedulerType = ouly::v2::scheduler;
+  dynamic_flow_graph<SchedulerType> graph;
+
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 1);
+  scheduler.begin_execution();
+
+  constexpr int             iterations = 10;
+  ouly::cancellation_source source;
+  std::atomic<int>          ticks{0};
+  std::atomic<int>          fanned{0};
+
+  auto tick = graph.create_node();
+  auto fan  = graph.create_node();
+  graph.connect(tick, tick);
+  graph.connect(tick, fan);
+  graph.add(tick,
+            [&](auto const&)
+            {
+              ticks.fetch_add(1);
+            });
+  // A single worker runs the fan-out tasks one by one; the one reaching `iterations` cancels the
+  // source and every task still queued behind it is skipped
+  for (int i = 0; i < 8; ++i)
+  {
+    graph.add(fan,
+              [&](auto const&)
+              {
+                if (fanned.fetch_add(1) + 1 == iterations)
+                {
+                  source.request_cancel();
+                }
+              });
+  }
+  graph.set_cancellation_token(source.get_token());
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  graph.signal(tick, ctx);
+  graph.cooperative_wait(ctx);
+
+  REQUIRE(fanned.load() == iterations);
+  REQUIRE(ticks.load() >= 2);
+  REQUIRE(graph.is_idle());
+  REQUIRE_FALSE(graph.stop_requested());
+
+  scheduler.end_execution();
+}
+
 TEST_CASE("dynamic_flow_graph multi-node cycle loops correctly", "[dynamic_flow_graph][loop]")
 {
   using SchedulerType = ouly::v2::scheduler;
@@ -605,6 +658,288 @@ TEST_CASE("dynamic_flow_graph stress linear chain", "[dynamic_flow_graph][schedu
   scheduler.end_execution();
 }
 
+TEST_CASE("dynamic_flow_graph ranks nodes incrementally and runs the critical chain first",
+          "[dynamic_flow_graph][scheduler][critical_path]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  using Graph         = dynamic_flow_graph<SchedulerType, default_chunk_size, default_edge_chunk_size,
+                                           ouly::config<ouly::cfg::flow_graph_critical_path>>;
+  using namespace std::chrono_literals;
+
+  Graph graph;
+
+  // A single worker with strict lane priority makes the dispatch order observable
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 1);
+  scheduler.set_lane_aging_period(0);
+  scheduler.begin_execution();
+
+  constexpr int     frames = 3;
+  std::string       order;
+  std::atomic<int>  presented{0};
+  auto const        make_node = [&](char name, std::chrono::nanoseconds cost)
+  {
+    auto node = graph.create_node();
+    graph.add(node,
+              [&order, name](auto const&)
+              {
+                order.push_back(name);
+              });
+    graph.set_cost_estimate(node, cost);
+    return node;
+  };
+
+  // Frame loop: update fans out to a short node d and a long chain a -> b, both join in present
+  auto update  = make_node('u', 10us);
+  auto d       = make_node('d', 20us);
+  auto a       = make_node('a', 100us);
+  auto b       = make_node('b', 100us);
+  auto present = make_node('p', 10us);
+  graph.add(present,
+            [&](auto const&)
+            {
+              if (presented.fetch_add(1) + 1 == frames)
+              {
+                graph.request_stop();
+              }
+            });
+
+  REQUIRE(graph.get_upward_rank(a) == 100us);
+  graph.connect(b, present);
+  REQUIRE(graph.get_upward_rank(b) == 110us);
+  graph.connect(a, b);
+  REQUIRE(graph.get_upward_rank(a) == 210us);
+  graph.connect(d, present);
+  graph.connect(update, d);
+  graph.connect(update, a);
+  REQUIRE(graph.get_upward_rank(d) == 30us);
+  REQUIRE(graph.get_upward_rank(update) == 220us);
+
+  // Closing the loop adds a back edge, which leaves the ranks finite and unchanged
+  graph.connect(present, update);
+  REQUIRE(graph.get_upward_rank(present) == 10us);
+  REQUIRE(graph.get_upward_rank(update) == 220us);
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  graph.signal(update, ctx);
+  graph.cooperative_wait(ctx);
+
+  REQUIRE(presented.load() == frames);
+  REQUIRE(order == "uabdpuabdpuabdp");
+  REQUIRE(graph.get_cost_estimate(a) < 100us);
+  REQUIRE(graph.get_cost_estimate(a) > 0ns);
+  REQUIRE(graph.get_upward_rank(update) < 220us);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("dynamic_flow_graph fires the highest ranked ready successor last",
+          "[dynamic_flow_graph][scheduler][critical_path]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  using Graph         = dynamic_flow_graph<SchedulerType, default_chunk_size, default_edge_chunk_size,
+                                           ouly::config<ouly::cfg::flow_graph_critical_path>>;
+  using namespace std::chrono_literals;
+
+  Graph graph;
+
+  // A single worker pops its own queue last in, first out, so the last successor fired runs first
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 1);
+  scheduler.set_lane_aging_period(0);
+  scheduler.begin_execution();
+
+  std::string order;
+  auto const  make_node = [&](char name, std::chrono::nanoseconds cost)
+  {
+    auto node = graph.create_node();
+    graph.add(node,
+              [&order, name](auto const&)
+              {
+                order.push_back(name);
+              });
+    graph.set_cost_estimate(node, cost);
+    return node;
+  };
+
+  // x carries the critical chain into the critical lane; p, q and s share the normal lane
+  auto root = make_node('r', 10us);
+  auto x    = make_node('x', 1000us);
+  auto p    = make_node('p', 10us);
+  auto q    = make_node('q', 30us);
+  auto s    = make_node('s', 20us);
+  graph.connect(root, p);
+  graph.connect(root, q);
+  graph.connect(root, x);
+  graph.connect(root, s);
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  graph.signal(root, ctx);
+  graph.cooperative_wait(ctx);
+  REQUIRE(order == "rxqsp");
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("dynamic_flow_graph typed edges pipeline values with backpressure",
+          "[dynamic_flow_graph][scheduler][typed_edges]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  using Graph         = dynamic_flow_graph<SchedulerType>;
+
+  Graph         graph;
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 4);
+  scheduler.begin_execution();
+
+  constexpr int      values   = 64;
+  constexpr uint32_t capacity = 2;
+
+  // decode -> transform -> upload, with upload slow enough for the channels to fill up
+  auto decode    = graph.create_node();
+  auto transform = graph.create_node();
+  auto upload    = graph.create_node();
+  auto frames    = graph.connect<std::string>(decode, transform, capacity);
+  auto meshes    = graph.connect<std::vector<int>>(transform, upload, capacity);
+
+  std::atomic<int> decoded{0};
+  std::atomic<int> transformed{0};
+  std::atomic<int> uploaded{0};
+  std::atomic<int> max_ahead{0};
+  std::atomic<int> total{0};
+  graph.add_source(decode, frames,
+                   [&](auto const&)
+                   {
+                     int  id    = decoded.fetch_add(1) + 1;
+                     int  ahead = id - transformed.load();
+                     int  seen  = max_ahead.load();
+                     while (ahead > seen && !max_ahead.compare_exchange_weak(seen, ahead))
+                     {
+                     }
+                     return std::to_string(id);
+                   });
+  graph.add_stage(transform, frames, meshes,
+                  [&](auto const&, std::string text)
+                  {
+                    std::vector<int> mesh(1, std::stoi(text));
+                    transformed.fetch_add(1);
+                    return mesh;
+                  });
+  graph.add_sink(upload, meshes,
+                 [&](auto const&, std::vector<int> mesh)
+                 {
+                   std::this_thread::sleep_for(std::chrono::microseconds(100));
+                   total.fetch_add(mesh[0]);
+                   uploaded.fetch_add(1);
+                 });
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  for (int i = 0; i < values; ++i)
+  {
+    graph.signal(decode, ctx);
+  }
+  graph.cooperative_wait(ctx);
+
+  REQUIRE(decoded.load() == values);
+  REQUIRE(uploaded.load() == values);
+  REQUIRE(total.load() == values * (values + 1) / 2);
+  // A decode firing never runs more than `capacity` values ahead of the completed transforms
+  REQUIRE(max_ahead.load() <= static_cast<int>(capacity));
+  REQUIRE(frames.size() == 0);
+  REQUIRE(meshes.size() == 0);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("dynamic_flow_graph pipelined loop overlaps iterations up to the limit",
+          "[dynamic_flow_graph][scheduler][pipelined_loop]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  using Graph         = dynamic_flow_graph<SchedulerType>;
+
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 4);
+  scheduler.begin_execution();
+
+  for (uint32_t limit : {1U, 2U, 3U})
+  {
+    Graph graph;
+
+    // update -> render -> present, present closes the loop; render and present never overlap
+    // themselves, present is slow so later iterations pile up behind it. The first present also
+    // waits for `limit` updates, so the loop is known to reach its limit once.
+    constexpr int         frames = 12;
+    std::atomic<int>      presented{0};
+    std::atomic<int>      max_inflight{0};
+    std::latch            first_updates{limit};
+    std::vector<uint64_t> update_iterations;
+    std::vector<uint64_t> present_iterations;
+
+    auto update  = graph.create_node();
+    auto render  = graph.create_node();
+    auto present = graph.create_node();
+    graph.connect(update, render);
+    graph.connect(render, present);
+    graph.connect_next_iteration(render, render);
+    graph.connect_next_iteration(present, present);
+    graph.set_pipelined_loop(update, present, limit);
+
+    graph.add(update,
+              [&](auto const&)
+              {
+                auto iteration = Graph::current_iteration();
+                update_iterations.push_back(iteration);
+                int inflight = static_cast<int>(iteration) + 1 - presented.load();
+                int seen     = max_inflight.load();
+                while (inflight > seen && !max_inflight.compare_exchange_weak(seen, inflight))
+                {
+                }
+                if (iteration < limit)
+                {
+                  first_updates.count_down();
+                }
+              });
+    graph.add(present,
+              [&](auto const&)
+              {
+                present_iterations.push_back(Graph::current_iteration());
+                if (Graph::current_iteration() == 0)
+                {
+                  first_updates.wait();
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                if (presented.fetch_add(1) + 1 == frames)
+                {
+                  graph.request_stop();
+                }
+              });
+
+    auto ctx = SchedulerType::context_type::this_context::get();
+    graph.signal(update, ctx);
+    graph.cooperative_wait(ctx);
+
+    REQUIRE(presented.load() == frames);
+    REQUIRE(graph.completed_iterations(update) == frames);
+    REQUIRE(max_inflight.load() <= static_cast<int>(limit));
+    // The gate held iteration 0 in flight until `limit` updates had fired
+    REQUIRE(max_inflight.load() == static_cast<int>(limit));
+    // update runs at most `limit` iterations ahead, each firing with the next iteration index
+    REQUIRE(update_iterations.size() >= frames);
+    REQUIRE(update_iterations.size() < frames + limit);
+    for (size_t i = 0; i < update_iterations.size(); ++i)
+    {
+      REQUIRE(update_iterations[i] == i);
+    }
+    REQUIRE(present_iterations.size() == frames);
+    for (size_t i = 0; i < present_iterations.size(); ++i)
+    {
+      REQUIRE(present_iterations[i] == i);
+    }
+  }
+
+  scheduler.end_execution();
+}
+
 TEST_CASE("dynamic_flow_graph works with v1 scheduler", "[dynamic_flow_graph][scheduler]")
 {
   using SchedulerType = ouly::v1::scheduler;
@@ -11,8 +11,11 @@
 #include <catch2/reporters/catch_reporter_registrars.hpp>
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
+#include <string>
 #include <thread>
+#include <vector>
 // NOLINTBEGIN
 using namespace ouly;
 
@@ -1305,3 +1308,438 @@ TEST_CASE("flow_graph complex removal with diamond pattern", "[flow_graph][task_
   scheduler.end_execution();
 }
 // NOLINTEND
+
+TEST_CASE("flow_graph compiled plan is reused and rebuilt after changes", "[flow_graph][scheduler][compile]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  flow_graph<SchedulerType> graph;
+
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 4);
+  scheduler.begin_execution();
+
+  std::atomic<int> sequence{0};
+  std::atomic<int> roots_done{0};
+  int              join_seen = -1;
+
+  // Four roots fanning into one join node; the roots are submitted as a single batch
+  auto join = graph.create_node();
+  for (int i = 0; i < 4; ++i)
+  {
+    auto root = graph.create_node();
+    graph.connect(root, join);
+    for (int t = 0; t < 3; ++t)
+    {
+      graph.add(root,
+                [&](auto const&)
+                {
+                  sequence.fetch_add(1);
+                  roots_done.fetch_add(1);
+                });
+    }
+  }
+  graph.add(join,
+            [&](auto const&)
+            {
+              join_seen = roots_done.load();
+              sequence.fetch_add(1);
+            });
+
+  graph.compile();
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  for (int run = 1; run <= 10; ++run)
+  {
+    graph.start(ctx);
+    graph.cooperative_wait(ctx);
+    REQUIRE(sequence.load() == run * 13);
+    REQUIRE(join_seen == run * 12);
+  }
+
+  // Modifying the graph invalidates the plan; start() recompiles it
+  int  tail_seen = -1;
+  auto tail      = graph.create_node();
+  graph.connect(join, tail);
+  graph.add(tail,
+            [&](auto const&)
+            {
+              tail_seen = sequence.load();
+            });
+
+  graph.start(ctx);
+  graph.cooperative_wait(ctx);
+  REQUIRE(sequence.load() == 11 * 13);
+  REQUIRE(tail_seen == 11 * 13);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("flow_graph dispatches the critical path first", "[flow_graph][scheduler][critical_path]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  using Graph         = flow_graph<SchedulerType, 4, 4, ouly::config<ouly::cfg::flow_graph_critical_path>>;
+  using namespace std::chrono_literals;
+
+  Graph graph;
+
+  // A single worker with strict lane priority makes the dispatch order observable
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 1);
+  scheduler.set_lane_aging_period(0);
+  scheduler.begin_execution();
+
+  std::vector<char> order;
+  auto const        make_node = [&](char name)
+  {
+    auto node = graph.create_node();
+    graph.add(node,
+              [&order, name](auto const&)
+              {
+                order.push_back(name);
+              });
+    return node;
+  };
+
+  // root -> a -> b -> c is the long chain, root -> d and root -> e are short side branches
+  auto root = make_node('r');
+  auto d    = make_node('d');
+  auto e    = make_node('e');
+  auto a    = make_node('a');
+  auto b    = make_node('b');
+  auto c    = make_node('c');
+  graph.connect(root, d);
+  graph.connect(root, e);
+  graph.connect(root, a);
+  graph.connect(a, b);
+  graph.connect(b, c);
+
+  graph.set_cost_estimate(root, 10us);
+  graph.set_cost_estimate(d, 20us);
+  graph.set_cost_estimate(e, 20us);
+  graph.set_cost_estimate(a, 100us);
+  graph.set_cost_estimate(b, 100us);
+  graph.set_cost_estimate(c, 100us);
+  graph.compile();
+
+  REQUIRE(graph.get_upward_rank(c) == 100us);
+  REQUIRE(graph.get_upward_rank(a) == 300us);
+  REQUIRE(graph.get_upward_rank(root) == 310us);
+  REQUIRE(graph.is_on_critical_path(root));
+  REQUIRE(graph.is_on_critical_path(a));
+  REQUIRE(graph.is_on_critical_path(c));
+  REQUIRE_FALSE(graph.is_on_critical_path(d));
+  REQUIRE_FALSE(graph.is_on_critical_path(e));
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  graph.start(ctx);
+  graph.cooperative_wait(ctx);
+  REQUIRE(order.size() == 6);
+  REQUIRE(std::string(order.begin(), order.begin() + 4) == "rabc");
+
+  // The measured durations are folded into the seeded estimates on the next start
+  graph.start(ctx);
+  graph.cooperative_wait(ctx);
+  REQUIRE(order.size() == 12);
+  REQUIRE(graph.get_cost_estimate(a) < 100us);
+  REQUIRE(graph.get_cost_estimate(a) > 0ns);
+  REQUIRE(graph.get_upward_rank(root) >= graph.get_upward_rank(a));
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("flow_graph submits the highest ranked ready node last", "[flow_graph][scheduler][critical_path]")
+{
+  using SchedulerType = ouly::v3::scheduler;
+  using Graph         = flow_graph<SchedulerType, 4, 4, ouly::config<ouly::cfg::flow_graph_critical_path>>;
+  using namespace std::chrono_literals;
+
+  Graph graph;
+
+  // A single worker pops its own queue last in, first out, so the last node submitted runs first
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 1);
+  scheduler.set_lane_aging_period(0);
+  scheduler.begin_execution();
+
+  std::string order;
+  auto const  make_node = [&](char name, std::chrono::nanoseconds cost)
+  {
+    auto node = graph.create_node();
+    graph.add(node,
+              [&order, name](auto const&)
+              {
+                order.push_back(name);
+              });
+    graph.set_cost_estimate(node, cost);
+    return node;
+  };
+
+  // x heads the critical path and takes the critical lane; p, q and s share the normal lane
+  auto root = make_node('r', 10us);
+  auto x    = make_node('x', 1000us);
+  auto p    = make_node('p', 10us);
+  auto q    = make_node('q', 30us);
+  auto s    = make_node('s', 20us);
+  graph.connect(root, p);
+  graph.connect(root, q);
+  graph.connect(root, x);
+  graph.connect(root, s);
+  graph.compile();
+  REQUIRE_FALSE(graph.is_on_critical_path(q));
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  for (int run = 0; run < 2; ++run)
+  {
+    order.clear();
+    graph.start(ctx);
+    graph.cooperative_wait(ctx);
+    REQUIRE(order == "rxqsp");
+    // Seed again so the re-rank done by the next start() keeps the same order
+    graph.set_cost_estimate(root, 10us);
+    graph.set_cost_estimate(x, 1000us);
+    graph.set_cost_estimate(p, 10us);
+    graph.set_cost_estimate(q, 30us);
+    graph.set_cost_estimate(s, 20us);
+  }
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("flow_graph critical path works without priority lanes", "[flow_graph][scheduler][critical_path]")
+{
+  using SchedulerType = ouly::v2::scheduler;
+  using Graph         = flow_graph<SchedulerType, 4, 4, ouly::config<ouly::cfg::flow_graph_critical_path>>;
+
+  Graph         graph;
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 4);
+  scheduler.begin_execution();
+
+  // Wide and deep: 8 chains of growing length joined at the end, plus an unmeasured late node
+  std::atomic<int> executed{0};
+  auto             join = graph.create_node();
+  for (int chain = 0; chain < 8; ++chain)
+  {
+    auto prev = graph.create_node();
+    graph.add(prev,
+              [&](auto const&)
+              {
+                executed.fetch_add(1);
+              });
+    for (int link = 0; link < chain; ++link)
+    {
+      auto next = graph.create_node();
+      graph.add(next,
+                [&](auto const&)
+                {
+                  executed.fetch_add(1);
+                });
+      graph.connect(prev, next);
+      prev = next;
+    }
+    graph.connect(prev, join);
+  }
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  for (int run = 1; run <= 5; ++run)
+  {
+    graph.start(ctx);
+    graph.cooperative_wait(ctx);
+    REQUIRE(executed.load() == run * 36);
+  }
+  REQUIRE(graph.get_cost_estimate(join) == std::chrono::nanoseconds(0));
+
+  auto late = graph.create_node();
+  graph.connect(join, late);
+  graph.add(late,
+            [&](auto const&)
+            {
+              executed.fetch_add(1);
+            });
+  graph.start(ctx);
+  graph.cooperative_wait(ctx);
+  REQUIRE(executed.load() == 5 * 36 + 37);
+  REQUIRE(graph.get_upward_rank(late) > std::chrono::nanoseconds(0));
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("flow_graph typed edges carry values between nodes", "[flow_graph][scheduler][typed_edges]")
+{
+  using SchedulerType = ouly::v2::scheduler;
+  using Graph         = flow_graph<SchedulerType>;
+
+  Graph         graph;
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 4);
+  scheduler.begin_execution();
+
+  // decode -> transform -> upload, plus a second producer joining into upload
+  auto decode    = graph.create_node();
+  auto transform = graph.create_node();
+  auto scale     = graph.create_node();
+  auto upload    = graph.create_node();
+  auto frames    = graph.connect<std::string>(decode, transform);
+  auto meshes    = graph.connect<std::unique_ptr<std::vector<int>>>(transform, upload);
+  auto factors   = graph.connect<int>(scale, upload);
+
+  int                  frame = 0;
+  std::vector<int64_t> uploaded;
+  graph.add_source(decode, frames,
+                   [&frame](auto const&)
+                   {
+                     return std::string(static_cast<size_t>(++frame), 'x');
+                   });
+  graph.add_stage(transform, frames, meshes,
+                  [](auto const&, std::string text)
+                  {
+                    return std::make_unique<std::vector<int>>(text.size(), 1);
+                  });
+  graph.add_source(scale, factors,
+                   [](auto const&)
+                   {
+                     return 10;
+                   });
+  graph.add(upload,
+            [&uploaded, meshes, factors](auto const&)
+            {
+              auto mesh   = meshes.pop();
+              auto factor = factors.pop();
+              uploaded.push_back(static_cast<int64_t>(mesh->size()) * factor);
+            });
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  for (int run = 0; run < 3; ++run)
+  {
+    graph.start(ctx);
+    graph.cooperative_wait(ctx);
+  }
+
+  REQUIRE(uploaded == std::vector<int64_t>{10, 20, 30});
+  REQUIRE(frames.size() == 0);
+  REQUIRE(meshes.size() == 0);
+  REQUIRE(factors.size() == 0);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("flow_graph skips the rest of a cancelled run", "[flow_graph][scheduler][cancellation]")
+{
+  using SchedulerType = ouly::v2::scheduler;
+  using Graph         = flow_graph<SchedulerType>;
+
+  Graph         graph;
+  SchedulerType scheduler;
+  scheduler.create_group(default_workgroup_id, 0, 4);
+  scheduler.begin_execution();
+
+  ouly::cancellation_source source;
+  bool                      cancel = true;
+  std::atomic<int>          consumed{0};
+  std::atomic<int>          finished{0};
+
+  auto produce = graph.create_node();
+  auto consume = graph.create_node();
+  auto finish  = graph.create_node();
+  auto values  = graph.connect<int>(produce, consume);
+  graph.connect(consume, finish);
+  graph.add_source(produce, values,
+                   [&](auto const&)
+                   {
+                     if (cancel)
+                     {
+                       source.request_cancel();
+                     }
+                     return 1;
+                   });
+  graph.add_sink(consume, values,
+                 [&](auto const&, int value)
+                 {
+                   consumed.fetch_add(value);
+                 });
+  graph.add(finish,
+            [&](auto const&)
+            {
+              finished.fetch_add(1);
+            });
+
+  auto ctx = SchedulerType::context_type::this_context::get();
+  graph.start(ctx, source.get_token());
+  graph.cooperative_wait(ctx);
+  REQUIRE(consumed.load() == 0);
+  REQUIRE(finished.load() == 0);
+  REQUIRE(values.size() == 1);
+
+  // The value stranded by the cancelled run is dropped, the edge has room again
+  cancel = false;
+  source.reset();
+  graph.start(ctx, source.get_token());
+  graph.cooperative_wait(ctx);
+  REQUIRE(consumed.load() == 1);
+  REQUIRE(finished.load() == 1);
+  REQUIRE(values.size() == 0);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("flow_channel is a bounded ring of non-trivial values", "[flow_graph][typed_edges]")
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    ouly::flow_channel<std::shared_ptr<int>> channel(3);
+    ouly::flow_port<std::shared_ptr<int>>    port(&channel);
+    REQUIRE(port.capacity() == 3);
+    REQUIRE_FALSE(port.try_pop().has_value());
+
+    for (int round = 0; round < 4; ++round)
+    {
+      REQUIRE(port.try_push(counter));
+      REQUIRE(port.try_push(counter));
+      REQUIRE(port.try_push(counter));
+      REQUIRE_FALSE(port.try_push(counter));
+      REQUIRE(port.size() == 3);
+      REQUIRE(counter.use_count() == 4);
+      REQUIRE(port.pop() == counter);
+      REQUIRE(port.pop() == counter);
+      REQUIRE(counter.use_count() == 2);
+      port.push(counter);
+      REQUIRE(port.pop() == counter);
+      REQUIRE(port.pop() == counter);
+      REQUIRE(port.size() == 0);
+    }
+
+    // Values left in the channel are destroyed with it
+    port.push(counter);
+    port.push(counter);
+    REQUIRE(counter.use_count() == 3);
+  }
+  REQUIRE(counter.use_count() == 1);
+
+  ouly::flow_channel<int> single(1);
+  for (int round = 0; round < 3; ++round)
+  {
+    REQUIRE(single.try_emplace(round));
+    REQUIRE_FALSE(single.try_emplace(round + 1));
+    REQUIRE(single.try_pop() == round);
+    REQUIRE_FALSE(single.try_pop().has_value());
+  }
+}
+
+TEST_CASE("flow_channel with a capacity of one holds a single value", "[flow_graph][typed_edges]")
+{
+  ouly::flow_channel<int> channel(1);
+  ouly::flow_port<int>    port(&channel);
+  REQUIRE(port.capacity() == 1);
+
+  for (int round = 0; round < 4; ++round)
+  {
+    REQUIRE(port.try_push(round));
+    // A second value must be refused, not overwrite the unread one
+    REQUIRE_FALSE(port.try_push(round + 100));
+    REQUIRE(port.size() == 1);
+    auto value = port.try_pop();
+    REQUIRE(value.has_value());
+    REQUIRE(*value == round);
+    REQUIRE_FALSE(port.try_pop().has_value());
+  }
+}
@@ -1,7 +1,10 @@
 #include "catch2/catch_all.hpp"
+#include "ouly/allocators/linear_arena_allocator.hpp"
 #include "ouly/allocators/mmap_file.hpp"
 #include "ouly/allocators/virtual_allocator.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <system_error>
@@ -80,6 +83,101 @@ TEST_CASE("Validate virtual_allocator", "[virtual_allocator]")
   }
 }
 
+TEST_CASE("virtual_allocator reserves then commits address space", "[virtual_allocator]")
+{
+  using allocator_t = ouly::virtual_allocator<>;
+  allocator_t allocator;
+
+  auto const       page     = allocator.page_size();
+  constexpr size_t reserved = size_t{1} << 30U; // 1 GiB of address space, no memory
+
+  auto* base = static_cast<char*>(allocator.reserve(reserved));
+  REQUIRE(base != nullptr);
+
+  // Commit the first two pages and a page deep inside the reservation
+  REQUIRE(allocator.commit(base, 2 * page));
+  REQUIRE(allocator.commit(base + (reserved / 2) + 1, 1));
+  REQUIRE(base[0] == 0);
+  REQUIRE(base[(reserved / 2) + 1] == 0);
+  base[0]                  = 'a';
+  base[(2 * page) - 1]     = 'b';
+  base[(reserved / 2) + 1] = 'c';
+
+  // Decommit only touches whole pages inside the range: the first page survives
+  REQUIRE(allocator.decommit(base + 1, (2 * page) - 1));
+  REQUIRE(base[0] == 'a');
+
+  // A decommitted page reads as zero once committed again
+  REQUIRE(allocator.commit(base + page, page));
+  REQUIRE(base[(2 * page) - 1] == 0);
+  REQUIRE(base[(reserved / 2) + 1] == 'c');
+
+  allocator.deallocate(base, reserved);
+}
+
+TEST_CASE("virtual_allocator backs allocations with huge pages", "[virtual_allocator]")
+{
+  using transparent_config = ouly::config<ouly::cfg::huge_pages<ouly::cfg::huge_page_policy::transparent>>;
+  using dedicated_config   = ouly::config<ouly::cfg::huge_pages<ouly::cfg::huge_page_policy::dedicated>>;
+
+  ouly::virtual_allocator<transparent_config> allocator;
+  auto const                                  huge = allocator.huge_page_size();
+  REQUIRE(huge >= allocator.page_size());
+  REQUIRE(allocator.backing_page_size() == huge);
+  REQUIRE(ouly::virtual_allocator<>{}.backing_page_size() == allocator.page_size());
+
+  SECTION("transparent allocations are rounded up to whole huge pages")
+  {
+    auto* ptr = static_cast<char*>(allocator.allocate(huge + 1));
+    REQUIRE(ptr != nullptr);
+#ifndef _WIN32
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % huge == 0);
+#endif
+    std::memset(ptr, 'h', 2 * huge);
+    REQUIRE(ptr[(2 * huge) - 1] == 'h');
+    allocator.deallocate(ptr, huge + 1);
+  }
+
+  SECTION("reservations can be committed onto huge pages")
+  {
+    auto* base = static_cast<char*>(allocator.reserve(4 * huge));
+    REQUIRE(base != nullptr);
+#ifndef _WIN32
+    REQUIRE(reinterpret_cast<std::uintptr_t>(base) % huge == 0);
+#endif
+    REQUIRE(allocator.commit(base, huge));
+    std::memset(base, 'r', huge);
+    REQUIRE(base[huge - 1] == 'r');
+    allocator.deallocate(base, 4 * huge);
+  }
+
+  SECTION("dedicated huge pages fall back when the system has none")
+  {
+    ouly::virtual_allocator<dedicated_config> dedicated;
+    auto*                                     ptr = static_cast<char*>(dedicated.allocate(huge));
+    REQUIRE(ptr != nullptr);
+    std::memset(ptr, 'd', huge);
+    REQUIRE(ptr[huge - 1] == 'd');
+    dedicated.deallocate(ptr, huge);
+  }
+
+  SECTION("linear arenas are sized in whole pages of a page_allocator")
+  {
+    using arena_config = ouly::config<ouly::cfg::underlying_allocator<ouly::page_allocator<transparent_config>>>;
+    REQUIRE(ouly::page_allocator<transparent_config>::page_size() == huge);
+
+    // A 1000 byte arena is rounded up to a huge page, which then fits every block below
+    ouly::linear_arena_allocator<arena_config> arena(1000);
+    for (int i = 0; i < 16; ++i)
+    {
+      auto* block = static_cast<char*>(arena.allocate(512));
+      REQUIRE(block != nullptr);
+      std::memset(block, i, 512);
+    }
+    REQUIRE(arena.get_arena_count() == 1);
+  }
+}
+
 TEST_CASE("Validate mmap_sink (read-write file mapping)", "[mmap_sink]")
 {
   const std::filesystem::path filename  = "test_mmap_sink.dat";
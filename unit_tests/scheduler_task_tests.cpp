@@ -9,9 +9,11 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <memory>
 #include <new>
 #include <semaphore>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 // NOLINTBEGIN
@@ -44,6 +46,11 @@ public:
     return allocations_.load(std::memory_order_relaxed) == deallocations_.load(std::memory_order_relaxed);
   }
 
+  [[nodiscard]] auto allocations() const noexcept -> uint32_t
+  {
+    return allocations_.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<uint32_t> allocations_{0};
   std::atomic<uint32_t> deallocations_{0};
@@ -76,6 +83,18 @@ auto coroutine_task_value(ouly::task<int> input) -> ouly::co_task<int>
   co_return co_await input;
 }
 
+auto coroutine_cancel_then_await(ouly::cancellation_source& source, std::atomic<int>& inner_runs)
+ -> ouly::co_task<int>
+{
+  source.request_cancel();
+  auto inner = [](std::atomic<int>& runs) -> ouly::co_task<int>
+  {
+    runs.fetch_add(1, std::memory_order_relaxed);
+    co_return 1;
+  }(inner_runs);
+  co_return co_await inner;
+}
+
 auto coroutine_failure([[maybe_unused]] ouly::scheduler_allocator allocator) -> ouly::co_task<int>
 {
   throw std::runtime_error("expected");
@@ -307,6 +326,274 @@ TEST_CASE("task state and continuations use a custom allocator", "[scheduler][ta
   scheduler.end_execution();
 }
 
+TEST_CASE("task_graph replays a captured scope without allocating", "[scheduler][task][scope][graph]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  counting_allocator allocator;
+  {
+    int                   input = 1;
+    std::atomic<uint32_t> side_effects{0};
+    ouly::task_graph      graph(ouly::scheduler_allocator{allocator});
+    ouly::task_scope      scope(ouly::scheduler_allocator{allocator});
+
+    scope.begin_capture(graph);
+    auto doubled = scope.run(ctx,
+                             [&input]() -> int
+                             {
+                               return input * 2;
+                             });
+    auto next    = scope.run(ctx,
+                             [&input]() -> int
+                             {
+                               return input + 1;
+                             });
+    scope.run(ctx,
+              [&side_effects]()
+              {
+                side_effects.fetch_add(1, std::memory_order_relaxed);
+              });
+    auto shifted = doubled.then(ctx,
+                                [](int value) -> int
+                                {
+                                  return value + 100;
+                                });
+    auto both    = ouly::when_all(ctx, shifted, next);
+    auto total   = both.then(ctx,
+                             [shifted, next]() -> int
+                             {
+                               return shifted.get() + next.get();
+                             });
+    scope.end_capture();
+    scope.join(ctx);
+
+    // An unrecorded task stays out of the graph
+    ouly::submit_task(ctx, ouly::scheduler_allocator{allocator}, []() {}).get(ctx);
+
+    REQUIRE(total.get(ctx) == 104);
+    REQUIRE(graph.size() == 6);
+    REQUIRE(graph.is_complete());
+
+    auto const captured_allocations = allocator.allocations();
+    for (int frame = 2; frame < 10; ++frame)
+    {
+      input = frame;
+      graph.replay(ctx);
+      graph.wait(ctx);
+      REQUIRE(doubled.get() == frame * 2);
+      REQUIRE(total.get(ctx) == frame * 2 + 100 + frame + 1);
+    }
+    REQUIRE(side_effects.load(std::memory_order_relaxed) == 9);
+    REQUIRE(allocator.allocations() == captured_allocations);
+
+    // A failing task surfaces from wait() and through its dependents
+    input = -1;
+    graph.clear();
+    scope.reset();
+    scope.begin_capture(graph);
+    auto checked = scope.run(ctx,
+                             [&input]() -> int
+                             {
+                               if (input < 0)
+                               {
+                                 throw std::runtime_error("expected");
+                               }
+                               return input;
+                             });
+    auto after   = checked.then(ctx,
+                                [](int value) -> int
+                                {
+                                  return value + 1;
+                                });
+    scope.end_capture();
+    REQUIRE_THROWS_AS(scope.join(ctx), std::runtime_error);
+    REQUIRE_THROWS_AS(after.get(ctx), std::runtime_error);
+
+    input = 41;
+    graph.replay(ctx);
+    graph.wait();
+    REQUIRE(after.get(ctx) == 42);
+
+    input = -1;
+    graph.replay(ctx);
+    REQUIRE_THROWS_AS(graph.wait(ctx), std::runtime_error);
+    REQUIRE_THROWS_AS(after.get(ctx), std::runtime_error);
+  }
+
+  scheduler.wait_for_tasks();
+  REQUIRE(allocator.balanced());
+  scheduler.end_execution();
+}
+
+TEST_CASE("cancelled tasks are skipped before they start", "[scheduler][task][cancellation]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  std::atomic<int>          runs{0};
+  ouly::cancellation_source source;
+  auto                      token = source.get_token();
+  REQUIRE(token.can_be_cancelled());
+  REQUIRE_FALSE(ouly::cancellation_token{}.can_be_cancelled());
+
+  // Only this thread works the group, so nothing starts before the source is cancelled
+  auto ok      = ouly::submit_task(ctx,
+                                   [&runs]() -> int
+                                   {
+                                     runs.fetch_add(1, std::memory_order_relaxed);
+                                     return 1;
+                                   });
+  auto doomed  = ouly::submit_task(ctx, token,
+                                   [&runs]() -> int
+                                   {
+                                     runs.fetch_add(1, std::memory_order_relaxed);
+                                     return 2;
+                                   });
+  auto chained = doomed.then(ctx,
+                             [&runs](int value) -> int
+                             {
+                               runs.fetch_add(1, std::memory_order_relaxed);
+                               return value;
+                             });
+  auto all     = ouly::when_all(ctx, ok, doomed);
+
+  ouly::task_scope scope(token);
+  auto             child = scope.run(ctx,
+                                     [&runs]()
+                                     {
+                                       runs.fetch_add(1, std::memory_order_relaxed);
+                                     });
+
+  REQUIRE(source.request_cancel());
+  REQUIRE_FALSE(source.request_cancel());
+  REQUIRE(token.is_cancelled());
+  REQUIRE_THROWS_AS(token.throw_if_cancelled(), ouly::task_cancelled);
+
+  scope.join(ctx);
+  REQUIRE(ok.get(ctx) == 1);
+  REQUIRE_THROWS_AS(doomed.get(ctx), ouly::task_cancelled);
+  REQUIRE_THROWS_AS(chained.get(ctx), ouly::task_cancelled);
+  REQUIRE_THROWS_AS(all.get(ctx), ouly::task_cancelled);
+  REQUIRE_THROWS_AS(child.get(ctx), ouly::task_cancelled);
+  REQUIRE(runs.load(std::memory_order_relaxed) == 1);
+
+  // A co_task skips its body, and co_tasks it awaits inherit its token
+  {
+    auto coroutine = coroutine_leaf({}, 7);
+    coroutine.set_cancellation_token(token);
+    scheduler.submit(ctx, coroutine);
+    REQUIRE_THROWS_AS(coroutine.cooperative_wait(ctx), ouly::task_cancelled);
+  }
+
+  source.reset();
+  std::atomic<int> inner_runs{0};
+  {
+    auto outer = coroutine_cancel_then_await(source, inner_runs);
+    outer.set_cancellation_token(token);
+    scheduler.submit(ctx, outer);
+    REQUIRE_THROWS_AS(outer.cooperative_wait(ctx), ouly::task_cancelled);
+  }
+  REQUIRE(inner_runs.load(std::memory_order_relaxed) == 0);
+
+  source.reset();
+  REQUIRE(ouly::submit_task(ctx, token,
+                            []() -> int
+                            {
+                              return 3;
+                            })
+           .get(ctx) == 3);
+
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+}
+
+TEST_CASE("task_graph rejects callables it cannot copy", "[scheduler][task][scope][graph]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  {
+    ouly::task_graph graph;
+    ouly::task_scope scope;
+    scope.begin_capture(graph);
+    auto value = scope.run(ctx,
+                           []() -> int
+                           {
+                             return 1;
+                           });
+    REQUIRE_THROWS_AS(scope.run(ctx,
+                                [owned = std::make_unique<int>(2)]() -> int
+                                {
+                                  return *owned;
+                                }),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(value.then(ctx,
+                                 [owned = std::make_unique<int>(3)](int input) -> int
+                                 {
+                                   return input + *owned;
+                                 }),
+                      std::invalid_argument);
+    scope.end_capture();
+    scope.join(ctx);
+    REQUIRE(graph.size() == 1);
+
+    // Outside a capture the same callables run as usual
+    scope.reset();
+    auto moved = scope.run(ctx,
+                           [owned = std::make_unique<int>(4)]() -> int
+                           {
+                             return *owned;
+                           });
+    scope.join(ctx);
+    REQUIRE(moved.get(ctx) == 4);
+  }
+
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+}
+
+TEST_CASE("task_graph rejects joins over tasks it did not record", "[scheduler][task][scope][graph]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+
+  {
+    auto outside = ouly::submit_task(ctx,
+                                     []() -> int
+                                     {
+                                       return 1;
+                                     });
+
+    ouly::task_graph graph;
+    ouly::task_scope scope;
+    scope.begin_capture(graph);
+    auto inside = scope.run(ctx,
+                            []() -> int
+                            {
+                              return 2;
+                            });
+    REQUIRE_THROWS_AS(ouly::when_all(ctx, inside, outside), std::invalid_argument);
+    std::vector<ouly::task<int>> mixed{inside, outside};
+    REQUIRE_THROWS_AS(ouly::when_all(ctx, mixed), std::invalid_argument);
+    scope.end_capture();
+    scope.join(ctx);
+    REQUIRE(graph.size() == 1);
+    REQUIRE(outside.get(ctx) == 1);
+  }
+
+  scheduler.wait_for_tasks();
+  scheduler.end_execution();
+}
+
 TEST_CASE("detached coroutine chains use custom allocation", "[scheduler][coroutine][allocator][detached]")
 {
   ouly::scheduler scheduler;
@@ -396,6 +683,83 @@ TEST_CASE("coroutines await scheduler tasks", "[scheduler][coroutine][task]")
   scheduler.end_execution();
 }
 
+TEST_CASE("inline continuations run on the completing worker up to the depth limit", "[scheduler][task][inline]")
+{
+  constexpr uint32_t max_depth    = 4;
+  constexpr uint32_t chain_length = 16;
+
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+  auto const& ctx = ouly::task_context::this_context::get();
+  scheduler.set_inline_continuation_depth(max_depth);
+  REQUIRE(scheduler.get_inline_continuation_depth() == max_depth);
+
+  // The limit belongs to one scheduler, others keep queueing their continuations.
+  ouly::scheduler other;
+  REQUIRE(other.get_inline_continuation_depth() == 0);
+  other.set_inline_continuation_depth(1);
+  ouly::scheduler moved(std::move(other));
+  REQUIRE(moved.get_inline_continuation_depth() == 1);
+  REQUIRE(scheduler.get_inline_continuation_depth() == max_depth);
+
+  // The producer only finishes once the whole chain is attached, so every link is released by a
+  // completing task rather than attached to a finished one.
+  std::atomic_bool   release{false};
+  std::thread::id    producer_thread;
+  std::atomic<int>   same_thread{0};
+  ouly::task<int>    link = ouly::submit_task(ctx,
+                                              [&]() -> int
+                                              {
+                                                producer_thread = std::this_thread::get_id();
+                                                while (!release.load(std::memory_order_acquire))
+                                                {
+                                                  std::this_thread::yield();
+                                                }
+                                                return 0;
+                                              });
+  std::vector<ouly::task<int>> chain;
+  for (uint32_t i = 0; i < chain_length; ++i)
+  {
+    link = link.then(ctx,
+                     [&](int value) -> int
+                     {
+                       if (std::this_thread::get_id() == producer_thread)
+                       {
+                         same_thread.fetch_add(1, std::memory_order_relaxed);
+                       }
+                       return value + 1;
+                     });
+    chain.push_back(link);
+  }
+  auto joined = ouly::when_all(ctx, chain);
+  release.store(true, std::memory_order_release);
+
+  REQUIRE(link.get(ctx) == static_cast<int>(chain_length));
+  joined.get(ctx);
+  // The producer body is depth 1, so links at depth 2 .. max_depth are guaranteed to run inline.
+  REQUIRE(same_thread.load(std::memory_order_relaxed) >= static_cast<int>(max_depth) - 1);
+
+  std::atomic<int>      result{0};
+  std::binary_semaphore done{0};
+  counting_allocator    allocator;
+  scheduler.submit(ctx, coroutine_chain(ouly::scheduler_allocator(allocator), result, done));
+  ctx.cooperative_wait(done);
+  scheduler.wait_for_tasks();
+  REQUIRE(result.load(std::memory_order_acquire) == 42);
+  REQUIRE(allocator.balanced());
+
+  {
+    auto borrowed = coroutine_chain(ouly::scheduler_allocator(allocator), result, done);
+    scheduler.submit(ctx, borrowed);
+    borrowed.cooperative_wait(ctx);
+  }
+  scheduler.wait_for_tasks();
+  REQUIRE(allocator.balanced());
+
+  scheduler.end_execution();
+}
+
 namespace
 {
 /** @brief Records what allocate() was asked for, and can be told an alignment */
@@ -4,10 +4,13 @@
 #include "ouly/scheduler/auto_parallel_for.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
+#include "ouly/scheduler/spill_pool.hpp"
 #include "ouly/utility/subrange.hpp"
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <ranges>
 #include <thread>
@@ -82,6 +85,65 @@ TEMPLATE_TEST_CASE("Basic Task Submission", "[scheduler][template]",
   REQUIRE(counter.task_count.load() == 1000);
 }
 
+// Test submission of tasks whose captures do not fit the delegate
+TEMPLATE_TEST_CASE("Spilled Task Submission", "[scheduler][spill][template]",
+                   (SchedulerTestRunner<ouly::v1::scheduler, ouly::v1::task_context>),
+                   (SchedulerTestRunner<ouly::v2::scheduler, ouly::v2::task_context>),
+                   (SchedulerTestRunner<ouly::v3::scheduler, ouly::v3::task_context>))
+{
+  using TestRunner      = TestType;
+  using TaskContextType = typename TestRunner::task_context_type;
+
+  auto scheduler = TestRunner::setup_scheduler(4);
+  scheduler.begin_execution();
+  auto const& main_ctx = TestRunner::get_main_context();
+
+  constexpr uint32_t    rounds     = 4;
+  constexpr uint32_t    task_count = 500;
+  auto                  shared     = std::make_shared<uint32_t>(3);
+  std::atomic<uint64_t> total{0};
+  uint64_t              slabs_after_warmup = 0;
+  for (uint32_t round = 0; round < rounds; ++round)
+  {
+    for (uint32_t i = 0; i < task_count; ++i)
+    {
+      std::vector<uint32_t> values(16, i);
+      scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                       ouly::spill(
+                        [values = std::move(values), shared, &total](TaskContextType const&)
+                        {
+                          total.fetch_add(std::accumulate(values.begin(), values.end(), uint64_t{0}) * *shared,
+                                          std::memory_order_relaxed);
+                        }));
+    }
+    scheduler.wait_for_tasks();
+    if (round == 0)
+    {
+      slabs_after_warmup = ouly::spill_pool::get_stats().slabs_;
+    }
+  }
+
+  // Every capture was destroyed on execution, and later rounds reused the warm-up slabs
+  REQUIRE(shared.use_count() == 1);
+  REQUIRE(total.load() == uint64_t{rounds} * 16 * 3 * (uint64_t{task_count} * (task_count - 1) / 2));
+  REQUIRE(ouly::spill_pool::get_stats().slabs_ == slabs_after_warmup);
+
+  // Oversized captures fall back to the heap but are still released
+  std::array<uint64_t, 1024> large{};
+  large.fill(1);
+  auto const large_before = ouly::spill_pool::get_stats().large_blocks_;
+  scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                   ouly::spill(
+                    [large, shared, &total](TaskContextType const&)
+                    {
+                      total.fetch_add(std::accumulate(large.begin(), large.end(), uint64_t{0}),
+                                      std::memory_order_relaxed);
+                    }));
+  scheduler.end_execution();
+  REQUIRE(ouly::spill_pool::get_stats().large_blocks_ == large_before + 1);
+  REQUIRE(shared.use_count() == 1);
+}
+
 struct small_loop_task_traits
 {
   /**
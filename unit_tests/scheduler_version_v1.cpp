@@ -68,6 +68,37 @@ TEST_CASE("v1: parallel_for via ouly::scheduler alias", "[scheduler][version][v1
   }
 }
 
+TEST_CASE("v1: telemetry snapshot", "[scheduler][version][v1][stats]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(0), [](ouly::task_context const&) {});
+  }
+  scheduler.wait_for_tasks();
+
+  auto stats = scheduler.snapshot_stats();
+  REQUIRE(stats.workers_.size() == scheduler.get_worker_count());
+  REQUIRE(stats.workgroups_.size() == 1);
+  if constexpr (ouly::scheduler_stats_enabled)
+  {
+    REQUIRE(stats.total_.tasks_executed_ == 1000);
+    REQUIRE(stats.total_.local_pops_ + stats.total_.mailbox_pops_ + stats.total_.steals_ == 1000);
+    REQUIRE(stats.total_.parks_ >= stats.total_.unparks_);
+    REQUIRE(stats.workgroups_[0].queued_high_water_ >= 1);
+  }
+  else
+  {
+    REQUIRE(stats.total_.tasks_executed_ == 0);
+  }
+
+  scheduler.end_execution();
+}
+
 TEST_CASE("v1: task continuations and scopes", "[scheduler][version][v1][task]")
 {
   ouly::scheduler scheduler;
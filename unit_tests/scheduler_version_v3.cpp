@@ -5,12 +5,21 @@
 #define OULY_SCHEDULER_VERSION v3
 
 #include "catch2/catch_all.hpp"
+#include "ouly/scheduler/detail/segmented_queue.hpp"
+#include "ouly/scheduler/flow_graph.hpp"
 #include "ouly/scheduler/parallel_for.hpp"
 #include "ouly/scheduler/scheduler.hpp"
+#include "ouly/scheduler/trace_recorder.hpp"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 // NOLINTBEGIN
@@ -138,4 +147,577 @@ TEST_CASE("v3: task continuations and scopes", "[scheduler][version][v3][task]")
   REQUIRE(count.load(std::memory_order_relaxed) == 1);
   scheduler.end_execution();
 }
+
+// External threads flooding a group whose members are all busy must not stall: once the
+// mailbox ring is full, submissions spill into the group's overflow queue. Producers are
+// joined before the members are released, so a spinning submit path would deadlock here.
+TEST_CASE("v3: external submitters overflow a saturated mailbox", "[scheduler][version][v3]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  std::atomic<bool> release{false};
+  std::atomic<bool> blocked{false};
+  scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                   [&release, &blocked](ouly::task_context const&)
+                   {
+                     blocked.store(true, std::memory_order_release);
+                     while (!release.load(std::memory_order_acquire))
+                     {
+                       std::this_thread::yield();
+                     }
+                   });
+  // Worker 1 must hold the blocker; the main thread only drains after the producers finish.
+  while (!blocked.load(std::memory_order_acquire))
+  {
+    std::this_thread::yield();
+  }
+
+  constexpr uint32_t       producer_count = 8;
+  constexpr uint32_t       per_producer   = 2000;
+  std::atomic<uint32_t>    count{0};
+  std::vector<std::thread> producers;
+  producers.reserve(producer_count);
+  for (uint32_t p = 0; p < producer_count; ++p)
+  {
+    producers.emplace_back(
+     [&]()
+     {
+       for (uint32_t i = 0; i < per_producer; ++i)
+       {
+         scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                          [&count](ouly::task_context const&)
+                          {
+                            count.fetch_add(1, std::memory_order_relaxed);
+                          });
+       }
+     });
+  }
+  for (auto& producer : producers)
+  {
+    producer.join();
+  }
+
+  release.store(true, std::memory_order_release);
+  scheduler.wait_for_tasks();
+  REQUIRE(count.load() == producer_count * per_producer);
+
+  // Second burst reuses recycled overflow segments.
+  count.store(0);
+  producers.clear();
+  for (uint32_t p = 0; p < producer_count; ++p)
+  {
+    producers.emplace_back(
+     [&]()
+     {
+       for (uint32_t i = 0; i < per_producer; ++i)
+       {
+         scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                          [&count](ouly::task_context const&)
+                          {
+                            count.fetch_add(1, std::memory_order_relaxed);
+                          });
+       }
+     });
+  }
+  for (auto& producer : producers)
+  {
+    producer.join();
+  }
+
+  scheduler.end_execution();
+  REQUIRE(count.load() == producer_count * per_producer);
+}
+
+// Threads that keep pushing and popping are almost never all outside the queue at once, so
+// recycling must not wait for the whole queue to go quiet.
+TEST_CASE("v3: overflow queue recycles segments under sustained traffic", "[scheduler][version][v3]")
+{
+  constexpr std::size_t segment_capacity = 16;
+  constexpr uint32_t    thread_count     = 4;
+  constexpr uint32_t    per_thread       = 50000;
+
+  ouly::detail::segmented_queue<uint32_t, segment_capacity> queue;
+  std::atomic<uint64_t>                                     sum{0};
+  std::vector<std::thread>                                  threads;
+  threads.reserve(thread_count);
+  for (uint32_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back(
+     [&]()
+     {
+       for (uint32_t i = 0; i < per_thread; ++i)
+       {
+         queue.push(i);
+         uint32_t value = 0;
+         while (!queue.pop(value))
+         {
+           std::this_thread::yield();
+         }
+         sum.fetch_add(value, std::memory_order_relaxed);
+       }
+     });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  REQUIRE(queue.empty());
+  REQUIRE(sum.load() == uint64_t{thread_count} * per_thread * (per_thread - 1) / 2);
+  // A stalled thread holds at most one segment, whatever the traffic that passed through
+  REQUIRE(queue.segment_count() < 8 * thread_count);
+}
+
+TEST_CASE("v3: topology detection", "[scheduler][version][v3][topology]")
+{
+  auto topo = ouly::topology::detect();
+  REQUIRE(!topo.empty());
+
+  // Placement order groups CPUs by NUMA node, then LLC.
+  auto cpus = topo.cpus();
+  for (size_t i = 1; i < cpus.size(); ++i)
+  {
+    REQUIRE(std::tie(cpus[i - 1].numa_node_, cpus[i - 1].llc_) <= std::tie(cpus[i].numa_node_, cpus[i].llc_));
+  }
+}
+
+TEST_CASE("v3: topology spreads workers over cores before SMT siblings", "[scheduler][version][v3][topology]")
+{
+  // One node with two LLC domains, each holding two cores with two hardware threads.
+  std::vector<ouly::cpu_info> cpus;
+  for (uint32_t i = 0; i < 8; ++i)
+  {
+    cpus.push_back(ouly::cpu_info{.cpu_ = i, .core_ = i / 2, .llc_ = (i / 4) * 4, .numa_node_ = 0});
+  }
+
+  ouly::topology        topo(cpus);
+  std::vector<uint32_t> order;
+  for (auto const& cpu : topo.cpus())
+  {
+    order.push_back(cpu.cpu_);
+  }
+  REQUIRE(order == std::vector<uint32_t>{0, 2, 1, 3, 4, 6, 5, 7});
+}
+
+TEST_CASE("v3: topology-aware victim order", "[scheduler][version][v3][topology]")
+{
+  // Two NUMA nodes, each with two 2-CPU LLC domains.
+  std::vector<ouly::cpu_info> cpus;
+  for (uint32_t i = 0; i < 8; ++i)
+  {
+    cpus.push_back(ouly::cpu_info{.cpu_ = i, .core_ = i, .llc_ = (i / 2) * 2, .numa_node_ = i / 4});
+  }
+
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 8);
+  scheduler.create_group(ouly::workgroup_id(1), 4, 4);
+  scheduler.set_topology(ouly::topology(cpus), false);
+  scheduler.begin_execution();
+
+  auto const& w0 = scheduler.get_worker(ouly::worker_id(0));
+  REQUIRE(w0.get_cpu().cpu_ == 0);
+  auto order0 = w0.get_victim_order(ouly::workgroup_id(0));
+  REQUIRE(std::vector<uint32_t>(order0.begin(), order0.end()) == std::vector<uint32_t>{1, 2, 3, 4, 5, 6, 7});
+  REQUIRE(w0.get_victim_order(ouly::workgroup_id(1)).empty());
+
+  auto const& w5     = scheduler.get_worker(ouly::worker_id(5));
+  auto        order5 = w5.get_victim_order(ouly::workgroup_id(0));
+  REQUIRE(std::vector<uint32_t>(order5.begin(), order5.end()) == std::vector<uint32_t>{4, 6, 7, 0, 1, 2, 3});
+  // Group 1 covers workers 4..7, so offsets are relative to worker 4.
+  auto group1 = w5.get_victim_order(ouly::workgroup_id(1));
+  REQUIRE(std::vector<uint32_t>(group1.begin(), group1.end()) == std::vector<uint32_t>{0, 2, 3});
+
+  std::vector<uint32_t> data(4096, 1);
+  auto const&           main_ctx = ouly::task_context::this_context::get();
+  ouly::parallel_for(
+   [](uint32_t& element, ouly::task_context const&)
+   {
+     element *= 3;
+   },
+   data, main_ctx);
+  scheduler.end_execution();
+  REQUIRE(std::accumulate(data.begin(), data.end(), 0U) == 3 * 4096);
+}
+TEST_CASE("v3: steal policies", "[scheduler][version][v3][steal]")
+{
+  auto policy = GENERATE(ouly::v3::steal_policy::sweep, ouly::v3::steal_policy::randomized,
+                         ouly::v3::steal_policy::last_victim_first);
+
+  ouly::scheduler scheduler(policy);
+  REQUIRE(scheduler.get_steal_policy() == policy);
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+
+  // Tasks pushed from the main thread land in its own deque. The main thread does not help, so
+  // every one of them has to be stolen by another member.
+  constexpr uint32_t    task_count = 100;
+  std::atomic<uint32_t> count{0};
+  for (uint32_t i = 0; i < task_count; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                     [&count](ouly::task_context const&)
+                     {
+                       count.fetch_add(1, std::memory_order_relaxed);
+                     });
+  }
+  auto const start = std::chrono::steady_clock::now();
+  while (count.load(std::memory_order_acquire) != task_count)
+  {
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+    std::this_thread::yield();
+  }
+
+  auto stats = scheduler.get_steal_stats();
+  REQUIRE(stats.successes_ == task_count);
+  REQUIRE(stats.attempts_ >= stats.successes_);
+
+  // Deep recursive splits still complete under every policy.
+  std::vector<uint32_t> data(20000, 1);
+  ouly::parallel_for(
+   [](uint32_t& element, ouly::task_context const&)
+   {
+     element += 1;
+   },
+   data, main_ctx);
+  scheduler.end_execution();
+  REQUIRE(std::accumulate(data.begin(), data.end(), 0U) == 2 * 20000);
+}
+
+TEST_CASE("v3: telemetry snapshot", "[scheduler][version][v3][stats]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 2);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(i % 2), [](ouly::task_context const&) {});
+  }
+  scheduler.wait_for_tasks();
+
+  auto stats = scheduler.snapshot_stats();
+  REQUIRE(stats.workers_.size() == scheduler.get_worker_count());
+  REQUIRE(stats.workgroups_.size() == 2);
+
+  // Steal counts are collected regardless of OULY_SCHEDULER_STATS.
+  auto steals = scheduler.get_steal_stats();
+  REQUIRE(stats.total_.steals_ == steals.successes_);
+  REQUIRE(stats.total_.failed_steals_ == steals.attempts_ - steals.successes_);
+  if constexpr (ouly::scheduler_stats_enabled)
+  {
+    REQUIRE(stats.total_.tasks_executed_ == 1000);
+    REQUIRE(stats.total_.local_pops_ + stats.total_.mailbox_pops_ + stats.total_.steals_ == 1000);
+    REQUIRE(stats.total_.parks_ >= stats.total_.unparks_);
+    REQUIRE(stats.workgroups_[0].queued_high_water_ >= 1);
+    REQUIRE(stats.workgroups_[1].queued_high_water_ >= 1);
+  }
+  else
+  {
+    REQUIRE(stats.total_.tasks_executed_ == 0);
+    REQUIRE(stats.workgroups_[0].queued_high_water_ == 0);
+  }
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("v3: trace recorder", "[scheduler][version][v3][trace]")
+{
+  ouly::trace_recorder recorder;
+  ouly::scheduler      scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 2);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 2);
+  scheduler.set_trace_recorder(&recorder);
+  REQUIRE(scheduler.get_trace_recorder() == &recorder);
+  scheduler.begin_execution();
+
+  auto const& main_ctx = ouly::task_context::this_context::get();
+  for (uint32_t i = 0; i < 100; ++i)
+  {
+    scheduler.submit(main_ctx, ouly::workgroup_id(i % 2), [](ouly::task_context const&) {});
+  }
+  scheduler.wait_for_tasks();
+
+  ouly::flow_graph<ouly::scheduler> graph;
+  auto                              first  = graph.create_node(ouly::workgroup_id(1));
+  auto                              second = graph.create_node();
+  graph.connect(first, second);
+  graph.add(first, [](ouly::task_context const&) {});
+  graph.add(second, [](ouly::task_context const&) {});
+  graph.start(main_ctx);
+  graph.cooperative_wait(main_ctx);
+  scheduler.end_execution();
+
+  auto events = recorder.events();
+  REQUIRE(recorder.dropped() == 0);
+  auto named = [&](std::string const& name)
+  {
+    return std::ranges::count_if(events, [&](ouly::trace_event const& ev) { return name == ev.name_; });
+  };
+  REQUIRE(named("task") >= 100);
+  REQUIRE(named("flow_graph.node") == 2);
+  for (auto const& ev : events)
+  {
+    REQUIRE(ev.worker_ < scheduler.get_worker_count());
+    REQUIRE(ev.end_ns_ >= ev.begin_ns_);
+    if (std::string("flow_graph.node") == ev.name_)
+    {
+      REQUIRE(ev.group_ == (ev.arg_ == first.value() ? 1U : 0U));
+    }
+  }
+
+  std::ostringstream json;
+  recorder.write_chrome_json(json);
+  REQUIRE(json.str().find("\"traceEvents\"") != std::string::npos);
+  REQUIRE(json.str().find("\"name\":\"flow_graph.node\"") != std::string::npos);
+}
+
+TEST_CASE("v3: batch submission", "[scheduler][version][v3][batch]")
+{
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.create_group(ouly::workgroup_id(1), 2, 2);
+  scheduler.begin_execution();
+
+  auto const&           main_ctx = ouly::task_context::this_context::get();
+  std::atomic<uint32_t> count{0};
+  auto                  job = [&count](ouly::task_context const&)
+  {
+    count.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  // Larger than a member deque plus the mailbox, so the batch spills through every queue.
+  std::vector<ouly::task_delegate> batch(5000, ouly::task_delegate::bind(job));
+  scheduler.submit_batch(main_ctx, ouly::workgroup_id(0), batch);
+  scheduler.submit_batch(main_ctx, ouly::workgroup_id(1), batch);
+  scheduler.submit_batch(main_ctx, ouly::workgroup_id(1), std::span<ouly::task_delegate const>{});
+  scheduler.wait_for_tasks();
+  REQUIRE(count.load() == 10000);
+
+  // Range overload, from inside a worker task targeting another group.
+  count.store(0);
+  scheduler.submit(main_ctx, ouly::workgroup_id(1),
+                   [&](ouly::task_context const& ctx)
+                   {
+                     scheduler.submit_batch(ctx, ouly::workgroup_id(0),
+                                            std::views::iota(0U, 1000U) | std::views::transform(
+                                                                            [&job](uint32_t)
+                                                                            {
+                                                                              return job;
+                                                                            }));
+                   });
+  scheduler.wait_for_tasks();
+  REQUIRE(count.load() == 1000);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("v3: priority lanes", "[scheduler][version][v3][lanes]")
+{
+  // A single-member group run by the main thread makes the execution order deterministic.
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 1);
+  scheduler.begin_execution();
+
+  auto const&           main_ctx = ouly::task_context::this_context::get();
+  std::vector<uint32_t> order;
+  auto                  submit_all = [&]()
+  {
+    order.clear();
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+      scheduler.submit(main_ctx, ouly::workgroup_id(0), ouly::v3::task_lane::background,
+                       [&order](ouly::task_context const&)
+                       {
+                         order.push_back(2);
+                       });
+      scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                       [&order](ouly::task_context const&)
+                       {
+                         order.push_back(1);
+                       });
+      scheduler.submit(main_ctx, ouly::workgroup_id(0), ouly::v3::task_lane::critical,
+                       [&order](ouly::task_context const&)
+                       {
+                         order.push_back(0);
+                       });
+    }
+    scheduler.wait_for_tasks();
+    REQUIRE(order.size() == 192);
+  };
+
+  scheduler.set_lane_aging_period(0);
+  submit_all();
+  REQUIRE(std::ranges::is_sorted(order));
+
+  // With aging, both lower lanes make progress before the critical lane drains.
+  scheduler.set_lane_aging_period(4);
+  submit_all();
+  auto first_normal     = std::ranges::find(order, 1U) - order.begin();
+  auto first_background = std::ranges::find(order, 2U) - order.begin();
+  auto last_critical    = order.rend() - std::ranges::find(order.rbegin(), order.rend(), 0U) - 1;
+  REQUIRE(first_normal < last_critical);
+  REQUIRE(first_background < last_critical);
+
+  auto now = std::chrono::steady_clock::now();
+  REQUIRE(scheduler.lane_for(now) == ouly::v3::task_lane::critical);
+  REQUIRE(scheduler.lane_for(now + std::chrono::milliseconds(10)) == ouly::v3::task_lane::normal);
+  REQUIRE(scheduler.lane_for(now + std::chrono::seconds(1)) == ouly::v3::task_lane::background);
+
+  std::atomic<uint32_t> done{0};
+  scheduler.submit(main_ctx, ouly::workgroup_id(0), now + std::chrono::milliseconds(5),
+                   [&done](ouly::task_context const&)
+                   {
+                     done.fetch_add(1);
+                   });
+  scheduler.wait_for_tasks();
+  REQUIRE(done.load() == 1);
+
+  scheduler.end_execution();
+}
+
+TEST_CASE("v3: moving a scheduler keeps its lane settings", "[scheduler][version][v3][lanes]")
+{
+  ouly::scheduler source;
+  source.set_lane_aging_period(7);
+  source.set_deadline_thresholds(std::chrono::milliseconds(5), std::chrono::milliseconds(100));
+
+  auto check = [](ouly::scheduler const& scheduler)
+  {
+    auto now = std::chrono::steady_clock::now();
+    REQUIRE(scheduler.get_lane_aging_period() == 7);
+    REQUIRE(scheduler.lane_for(now + std::chrono::milliseconds(3)) == ouly::v3::task_lane::critical);
+    REQUIRE(scheduler.lane_for(now + std::chrono::milliseconds(50)) == ouly::v3::task_lane::normal);
+    REQUIRE(scheduler.lane_for(now + std::chrono::seconds(1)) == ouly::v3::task_lane::background);
+  };
+
+  ouly::scheduler moved(std::move(source));
+  check(moved);
+
+  ouly::scheduler assigned;
+  assigned = std::move(moved);
+  check(assigned);
+}
+
+TEST_CASE("v3: adaptive idle controller", "[scheduler][version][v3][idle]")
+{
+  constexpr int64_t max_spin = 50'000;
+
+  ouly::detail::v3::idle_controller idle;
+  REQUIRE(idle.spin_budget(max_spin) > 0);
+
+  // Frame-boundary gaps far above the limit: park at once.
+  for (int i = 0; i < 64; ++i)
+  {
+    idle.record(8'000'000, 0, true);
+  }
+  REQUIRE(idle.spin_budget(max_spin) == 0);
+  REQUIRE(idle.get_direct_parks() == 64);
+
+  // Short gaps inside a burst: spin again, bounded by the limit.
+  for (int i = 0; i < 256; ++i)
+  {
+    idle.record(2'000, 2'000, false);
+  }
+  REQUIRE(idle.spin_budget(max_spin) > 0);
+  REQUIRE(idle.spin_budget(max_spin) <= max_spin);
+  REQUIRE(idle.get_spin_hits() == 256);
+  REQUIRE(idle.get_spin_ns() == 256 * 2'000);
+
+  ouly::scheduler scheduler;
+  scheduler.create_group(ouly::workgroup_id(0), 0, 4);
+  scheduler.set_idle_policy(ouly::v3::idle_policy::adaptive);
+  scheduler.set_max_idle_spin(std::chrono::microseconds(20));
+  REQUIRE(scheduler.get_idle_policy() == ouly::v3::idle_policy::adaptive);
+  REQUIRE(scheduler.get_max_idle_spin() == std::chrono::microseconds(20));
+  scheduler.begin_execution();
+
+  auto const&           main_ctx = ouly::task_context::this_context::get();
+  std::atomic<uint32_t> count{0};
+  for (uint32_t frame = 0; frame < 20; ++frame)
+  {
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+      scheduler.submit(main_ctx, ouly::workgroup_id(0),
+                       [&count](ouly::task_context const&)
+                       {
+                         count.fetch_add(1, std::memory_order_relaxed);
+                       });
+    }
+    scheduler.wait_for_tasks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  REQUIRE(count.load() == 4000);
+
+  auto stats = scheduler.get_idle_stats();
+  REQUIRE(stats.spin_hits_ + stats.spin_misses_ + stats.direct_parks_ > 0);
+  scheduler.end_execution();
+}
+
+TEST_CASE("v3: moving a scheduler keeps its idle settings", "[scheduler][version][v3][idle]")
+{
+  ouly::scheduler source;
+  source.set_idle_policy(ouly::v3::idle_policy::adaptive);
+  source.set_max_idle_spin(std::chrono::microseconds(75));
+  source.set_idle_spin_count(32);
+
+  auto check = [](ouly::scheduler const& scheduler)
+  {
+    REQUIRE(scheduler.get_idle_policy() == ouly::v3::idle_policy::adaptive);
+    REQUIRE(scheduler.get_max_idle_spin() == std::chrono::microseconds(75));
+    REQUIRE(scheduler.get_idle_spin_count() == 32);
+  };
+
+  ouly::scheduler moved(std::move(source));
+  check(moved);
+
+  ouly::scheduler assigned;
+  assigned = std::move(moved);
+  check(assigned);
+}
+
+TEST_CASE("v3: parking lot wakes targeted sleepers", "[scheduler][version][v3][parking]")
+{
+  ouly::detail::v3::parking_lot lot;
+  lot.reset(70); // Spans two mask words
+
+  std::array<std::atomic<bool>, 2> woken{};
+  std::array<uint32_t, 2>          sleepers{1, 66};
+  std::vector<std::thread>         threads;
+  for (uint32_t i = 0; i < 2; ++i)
+  {
+    threads.emplace_back(
+     [&, i]()
+     {
+       auto token = lot.prepare(sleepers[i], i == 0);
+       lot.park(sleepers[i], token);
+       woken[i].store(true);
+     });
+  }
+  while (lot.get_idle_count() != 2)
+  {
+    std::this_thread::yield();
+  }
+
+  // No sleeper in range: nothing happens.
+  REQUIRE(lot.wake_range(2, 60, 4) == 0);
+  // Only the member of [64, 70) is woken.
+  REQUIRE(lot.wake_range(64, 6, 4) == 1);
+  threads[1].join();
+  REQUIRE(woken[1].load());
+  REQUIRE_FALSE(woken[0].load());
+
+  // Waiters are woken by wake_waiters() alone.
+  lot.wake_waiters();
+  threads[0].join();
+  REQUIRE(woken[0].load());
+  REQUIRE(lot.get_idle_count() == 0);
+}
 // NOLINTEND
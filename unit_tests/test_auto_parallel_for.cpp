@@ -1,8 +1,17 @@
 #include "catch2/catch_all.hpp"
+#include "ouly/scheduler/affinity_partitioner.hpp"
 #include "ouly/scheduler/auto_parallel_for.hpp"
+#include "ouly/scheduler/parallel_for.hpp"
+#include "ouly/scheduler/parallel_partition.hpp"
+#include "ouly/scheduler/parallel_reduce.hpp"
+#include "ouly/scheduler/parallel_scan.hpp"
+#include "ouly/scheduler/parallel_sort.hpp"
 #include "ouly/scheduler/scheduler.hpp"
 #include <atomic>
+#include <cstring>
 #include <numeric>
+#include <random>
+#include <string>
 #include <vector>
 
 // Template wrapper for testing both scheduler versions
@@ -105,3 +114,335 @@ TEMPLATE_TEST_CASE("Auto Parallel For Basic Functionality", "[auto_parallel_for]
     scheduler.end_execution();
   }
 }
+
+TEMPLATE_TEST_CASE("Parallel Reduce And Scan", "[parallel_reduce][parallel_scan][template]",
+                   (SchedulerTestRunner<ouly::v1::scheduler, ouly::v1::task_context>),
+                   (SchedulerTestRunner<ouly::v2::scheduler, ouly::v2::task_context>))
+{
+  using TestRunner = TestType;
+
+  auto scheduler = TestRunner::setup_scheduler(4);
+
+  scheduler.begin_execution();
+  auto const& main_ctx = TestRunner::get_main_context();
+  auto const  plus     = [](auto a, auto b)
+  {
+    return a + b;
+  };
+
+  SECTION("Reduce with element, context and range mappers")
+  {
+    constexpr uint32_t data_size = 100000;
+    std::vector<int>   data(data_size);
+    std::iota(data.begin(), data.end(), 0);
+    auto const expected = static_cast<int64_t>(data_size - 1) * data_size / 2;
+
+    auto by_element = ouly::parallel_reduce(
+     data, int64_t{0},
+     [](int value)
+     {
+       return static_cast<int64_t>(value);
+     },
+     plus, main_ctx);
+    REQUIRE(by_element == expected);
+
+    auto by_index = ouly::parallel_reduce(
+     ouly::subrange<uint32_t>(0, data_size), int64_t{0},
+     [](uint32_t index, auto const& /*ctx*/)
+     {
+       return static_cast<int64_t>(index);
+     },
+     plus, main_ctx);
+    REQUIRE(by_index == expected);
+
+    auto by_range = ouly::parallel_reduce(
+     data, int64_t{0},
+     [](auto begin, auto end, auto const& /*ctx*/)
+     {
+       return std::accumulate(begin, end, int64_t{0});
+     },
+     plus, main_ctx);
+    REQUIRE(by_range == expected);
+
+    // Non-commutative combine: chunk partials must be combined in order
+    auto joined = ouly::parallel_reduce(
+     ouly::subrange<uint32_t>(0, 1000), std::vector<uint32_t>{},
+     [](uint32_t index)
+     {
+       return std::vector<uint32_t>{index};
+     },
+     [](std::vector<uint32_t> a, std::vector<uint32_t> const& b)
+     {
+       a.insert(a.end(), b.begin(), b.end());
+       return a;
+     },
+     main_ctx);
+    std::vector<uint32_t> ordered(1000);
+    std::iota(ordered.begin(), ordered.end(), 0U);
+    REQUIRE(joined == ordered);
+
+    REQUIRE(ouly::parallel_reduce(std::vector<int>{}, 7, std::identity{}, plus, main_ctx) == 7);
+
+    scheduler.end_execution();
+  }
+
+  SECTION("Floating point reduction is reproducible")
+  {
+    std::vector<float> data(50000);
+    for (uint32_t i = 0; i < data.size(); ++i)
+    {
+      data[i] = 1.0F / static_cast<float>(1 + (i * 7919U) % 1013U);
+    }
+
+    auto const first = ouly::parallel_reduce(data, 0.0F, std::identity{}, plus, main_ctx);
+    for (int run = 0; run < 20; ++run)
+    {
+      auto const again = ouly::parallel_reduce(data, 0.0F, std::identity{}, plus, main_ctx);
+      REQUIRE(std::memcmp(&first, &again, sizeof(float)) == 0);
+    }
+
+    scheduler.end_execution();
+  }
+
+  SECTION("Inclusive and exclusive scans match the sequential scan")
+  {
+    std::vector<int64_t> data(30011);
+    for (uint32_t i = 0; i < data.size(); ++i)
+    {
+      data[i] = static_cast<int64_t>((i * 31U) % 97U) - 40;
+    }
+
+    std::vector<int64_t> expected(data.size());
+    std::vector<int64_t> output(data.size());
+
+    std::inclusive_scan(data.begin(), data.end(), expected.begin());
+    ouly::parallel_scan(data, output.begin(), int64_t{0}, plus, main_ctx);
+    REQUIRE(output == expected);
+
+    std::exclusive_scan(data.begin(), data.end(), expected.begin(), int64_t{0});
+    ouly::parallel_scan(data, output.begin(), int64_t{0}, plus, main_ctx, ouly::scan_kind::exclusive);
+    REQUIRE(output == expected);
+
+    // In place
+    ouly::parallel_scan(data, data.begin(), int64_t{0}, plus, main_ctx, ouly::scan_kind::exclusive);
+    REQUIRE(data == expected);
+
+    std::vector<int> small{1, 2, 3, 4};
+    ouly::parallel_scan(small, small.begin(), 0, plus, main_ctx);
+    REQUIRE(small == std::vector<int>{1, 3, 6, 10});
+
+    scheduler.end_execution();
+  }
+}
+
+TEMPLATE_TEST_CASE("Parallel Sort And Partition", "[parallel_sort][parallel_partition][template]",
+                   (SchedulerTestRunner<ouly::v1::scheduler, ouly::v1::task_context>),
+                   (SchedulerTestRunner<ouly::v2::scheduler, ouly::v2::task_context>),
+                   (SchedulerTestRunner<ouly::v3::scheduler, ouly::v3::task_context>))
+{
+  using TestRunner = TestType;
+
+  auto scheduler = TestRunner::setup_scheduler(4);
+
+  scheduler.begin_execution();
+  auto const& main_ctx = TestRunner::get_main_context();
+
+  std::mt19937 rng(42);
+
+  SECTION("Radix sort of integers and floats")
+  {
+    std::vector<int32_t> ints(100003);
+    for (auto& v : ints)
+    {
+      v = static_cast<int32_t>(rng());
+    }
+    auto expected_ints = ints;
+    std::sort(expected_ints.begin(), expected_ints.end());
+    ouly::parallel_sort(ints.begin(), ints.end(), main_ctx);
+    REQUIRE(ints == expected_ints);
+
+    // Only the low byte varies, so most passes are skipped
+    std::vector<uint64_t> narrow(50000);
+    for (auto& v : narrow)
+    {
+      v = rng() & 0xFFU;
+    }
+    auto expected_narrow = narrow;
+    std::sort(expected_narrow.begin(), expected_narrow.end());
+    ouly::parallel_sort(narrow.begin(), narrow.end(), main_ctx);
+    REQUIRE(narrow == expected_narrow);
+
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    std::vector<double>                    doubles(70001);
+    for (auto& v : doubles)
+    {
+      v = dist(rng);
+    }
+    auto expected_doubles = doubles;
+    std::sort(expected_doubles.begin(), expected_doubles.end());
+    ouly::parallel_sort(doubles.begin(), doubles.end(), main_ctx);
+    REQUIRE(doubles == expected_doubles);
+
+    scheduler.end_execution();
+  }
+
+  SECTION("Radix sort by key is stable")
+  {
+    struct draw_call
+    {
+      uint16_t key_   = 0;
+      uint32_t order_ = 0;
+    };
+    std::vector<draw_call> calls(60000);
+    for (uint32_t i = 0; i < calls.size(); ++i)
+    {
+      calls[i] = {.key_ = static_cast<uint16_t>(rng() % 500U), .order_ = i};
+    }
+    ouly::parallel_radix_sort(
+     calls.begin(), calls.end(),
+     [](draw_call const& call)
+     {
+       return call.key_;
+     },
+     main_ctx);
+    REQUIRE(std::is_sorted(calls.begin(), calls.end(),
+                           [](draw_call const& a, draw_call const& b)
+                           {
+                             return a.key_ < b.key_ || (a.key_ == b.key_ && a.order_ < b.order_);
+                           }));
+
+    scheduler.end_execution();
+  }
+
+  SECTION("Comparison sort")
+  {
+    std::vector<std::string> words(40000);
+    for (auto& w : words)
+    {
+      w = std::to_string(rng() % 100000U);
+    }
+    auto expected = words;
+    std::sort(expected.begin(), expected.end(), std::greater<>{});
+    ouly::parallel_sort(words.begin(), words.end(), std::greater<>{}, main_ctx);
+    REQUIRE(words == expected);
+
+    // Non-radix types default to std::less
+    ouly::parallel_sort(words.begin(), words.end(), main_ctx);
+    REQUIRE(std::is_sorted(words.begin(), words.end()));
+
+    std::vector<int> few{3, 1, 2};
+    ouly::parallel_sort(few.begin(), few.end(), main_ctx);
+    REQUIRE(few == std::vector<int>{1, 2, 3});
+
+    scheduler.end_execution();
+  }
+
+  SECTION("Partition and stable partition")
+  {
+    std::vector<uint32_t> data(90001);
+    for (auto& v : data)
+    {
+      v = rng() % 1000U;
+    }
+    auto const is_small = [](uint32_t v)
+    {
+      return v < 300U;
+    };
+    auto const small_count = static_cast<std::ptrdiff_t>(std::count_if(data.begin(), data.end(), is_small));
+
+    auto unstable = data;
+    auto split    = ouly::parallel_partition(unstable.begin(), unstable.end(), is_small, main_ctx);
+    REQUIRE(split - unstable.begin() == small_count);
+    REQUIRE(std::is_partitioned(unstable.begin(), unstable.end(), is_small));
+    auto sorted_unstable = unstable;
+    auto sorted_data     = data;
+    std::sort(sorted_unstable.begin(), sorted_unstable.end());
+    std::sort(sorted_data.begin(), sorted_data.end());
+    REQUIRE(sorted_unstable == sorted_data);
+
+    auto stable   = data;
+    auto expected = data;
+    std::stable_partition(expected.begin(), expected.end(), is_small);
+    auto stable_split = ouly::parallel_stable_partition(stable.begin(), stable.end(), is_small, main_ctx);
+    REQUIRE(stable_split - stable.begin() == small_count);
+    REQUIRE(stable == expected);
+
+    scheduler.end_execution();
+  }
+}
+
+TEMPLATE_TEST_CASE("Affinity Partitioner", "[affinity_partitioner][template]",
+                   (SchedulerTestRunner<ouly::v1::scheduler, ouly::v1::task_context>),
+                   (SchedulerTestRunner<ouly::v2::scheduler, ouly::v2::task_context>),
+                   (SchedulerTestRunner<ouly::v3::scheduler, ouly::v3::task_context>))
+{
+  using TestRunner = TestType;
+
+  auto scheduler = TestRunner::setup_scheduler(4);
+
+  scheduler.begin_execution();
+  auto const& main_ctx = TestRunner::get_main_context();
+
+  SECTION("Every element is visited once per frame and the assignment is kept")
+  {
+    std::vector<uint32_t>      visits(20000, 0);
+    ouly::affinity_partitioner partitioner;
+
+    for (uint32_t frame = 1; frame <= 8; ++frame)
+    {
+      ouly::parallel_for(
+       [](uint32_t& value, auto const& /*ctx*/)
+       {
+         ++value;
+       },
+       visits, main_ctx, partitioner);
+
+      REQUIRE(std::ranges::all_of(visits,
+                                  [frame](uint32_t v)
+                                  {
+                                    return v == frame;
+                                  }));
+      REQUIRE(partitioner.get_chunk_count() == 4 * ouly::affinity_partitioner::chunks_per_worker);
+      // Nothing is recorded before the first frame. Afterwards every member, the caller included,
+      // drains its own chunks before stealing, so at least one chunk stays where it ran last time.
+      if (frame == 1)
+      {
+        REQUIRE(partitioner.get_affinity_hits() == 0);
+      }
+      else
+      {
+        REQUIRE(partitioner.get_affinity_hits() > 0);
+      }
+    }
+
+    // A range of another size starts over
+    std::atomic<uint64_t> sum{0};
+    ouly::parallel_for(
+     [&sum](uint32_t begin, uint32_t end, auto const& /*ctx*/)
+     {
+       for (auto i = begin; i < end; ++i)
+       {
+         sum.fetch_add(i, std::memory_order_relaxed);
+       }
+     },
+     ouly::subrange<uint32_t>(0, 1000), main_ctx, partitioner);
+    REQUIRE(sum.load() == 999U * 1000U / 2U);
+    REQUIRE(partitioner.get_affinity_hits() == 0);
+
+    // Small ranges run sequentially and keep the recorded assignment
+    std::vector<uint32_t> small(10, 0);
+    ouly::parallel_for(
+     [](uint32_t& value, auto const& /*ctx*/)
+     {
+       value = 1;
+     },
+     small, main_ctx, partitioner);
+    REQUIRE(std::ranges::all_of(small,
+                                [](uint32_t v)
+                                {
+                                  return v == 1;
+                                }));
+
+    scheduler.end_execution();
+  }
+}
@@ -1,10 +1,19 @@
 #include "catch2/catch_all.hpp"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <ouly/allocators/default_allocator.hpp>
+#include <ouly/allocators/ts_pool_allocator.hpp>
 #include <ouly/allocators/ts_shared_linear_allocator.hpp>
 #include <ouly/allocators/ts_thread_local_allocator.hpp>
+#include <numeric>
+#include <random>
+#include <set>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 // NOLINTBEGIN
@@ -529,4 +538,326 @@ TEST_CASE("Thread-safe allocators hand recycled pages back empty", "[allocator]"
     allocator.release();
   }
 }
+
+TEST_CASE("Thread-safe local allocator backs pages with huge pages", "[allocator]")
+{
+  constexpr std::size_t page_size  = 64 * 1024;
+  constexpr std::size_t block_size = 1024;
+  constexpr std::size_t blocks     = 256; // four times the requested page size
+
+  for (auto policy : {ouly::cfg::huge_page_policy::transparent, ouly::cfg::huge_page_policy::dedicated})
+  {
+    ouly::ts_thread_local_allocator allocator(page_size, policy);
+
+    // Pages are rounded up to whole huge pages, so all blocks land back to back in the first one
+    auto* first = static_cast<std::byte*>(allocator.allocate(block_size));
+    REQUIRE(first != nullptr);
+    for (std::size_t i = 1; i < blocks; ++i)
+    {
+      auto* block = static_cast<std::byte*>(allocator.allocate(block_size));
+      REQUIRE(block == first + (i * block_size));
+      std::memset(block, static_cast<int>(i), block_size);
+    }
+
+    // Oversized requests get a dedicated page of their own
+    constexpr std::size_t large = 4 * 1024 * 1024;
+    auto*                 big   = static_cast<std::byte*>(allocator.allocate(large));
+    REQUIRE(big != nullptr);
+    std::memset(big, 1, large);
+
+    allocator.reset();
+    REQUIRE(allocator.allocate(block_size) == first);
+    allocator.release();
+  }
+}
+
+TEST_CASE("Thread-safe pool allocator size classes", "[allocator][ts_pool_allocator]")
+{
+  using pool = ouly::ts_pool_allocator;
+
+  // Every class is a multiple of the minimum alignment and classes strictly grow
+  for (uint32_t c = 1; c < pool::size_class_count; ++c)
+  {
+    REQUIRE(pool::size_class_size(c) % pool::alignment == 0);
+    REQUIRE(pool::size_class_size(c) > pool::size_class_size(c - 1));
+  }
+
+  // A request maps to the smallest class that holds it
+  for (std::size_t size = 1; size <= pool::max_small_size; ++size)
+  {
+    auto const c = pool::size_class_of(size, 0);
+    REQUIRE(pool::size_class_size(c) >= size);
+    if (c > 0)
+    {
+      REQUIRE(pool::size_class_size(c - 1) < size);
+    }
+  }
+
+  REQUIRE(pool::size_class_size(pool::size_class_of(80, 64)) % 64 == 0);
+  REQUIRE(pool::size_class_of(pool::max_small_size + 1, 0) == pool::size_class_count);
+  REQUIRE(pool::size_class_of(64, 128) == pool::size_class_count);
+
+  pool allocator;
+  for (std::size_t align : {std::size_t{1}, std::size_t{16}, std::size_t{32}, std::size_t{64}, std::size_t{4096}})
+  {
+    for (std::size_t size : {std::size_t{1}, std::size_t{24}, std::size_t{100}, std::size_t{3000},
+                             std::size_t{pool::max_small_size + 100}})
+    {
+      void* ptr = allocator.allocate(size, std::align_val_t{align});
+      REQUIRE(ptr != nullptr);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % std::max(align, pool::alignment) == 0);
+      std::memset(ptr, 0xAB, size);
+      allocator.deallocate(ptr, size, std::align_val_t{align});
+    }
+  }
+}
+
+TEST_CASE("Thread-safe pool allocator reuses freed blocks", "[allocator][ts_pool_allocator]")
+{
+  ouly::ts_pool_allocator allocator(8);
+  constexpr int           count = 200;
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < count; ++i)
+  {
+    blocks.push_back(allocator.allocate(48));
+  }
+  REQUIRE(std::set<void*>(blocks.begin(), blocks.end()).size() == count);
+  auto const slabs = allocator.slab_count();
+
+  // Blocks freed in any order come back, through the thread cache and the depot, without new slabs
+  std::shuffle(blocks.begin(), blocks.end(), std::mt19937{7});
+  for (void* ptr : blocks)
+  {
+    allocator.deallocate(ptr, 48);
+  }
+
+  // The cache may still hold up to a magazine of blocks it carved but never handed out
+  std::set<void*> const freed(blocks.begin(), blocks.end());
+  std::set<void*>       again;
+  for (int i = 0; i < count + 8; ++i)
+  {
+    again.insert(allocator.allocate(40));
+  }
+  REQUIRE(std::includes(again.begin(), again.end(), freed.begin(), freed.end()));
+  REQUIRE(allocator.slab_count() == slabs);
+
+  for (void* ptr : again)
+  {
+    allocator.deallocate(ptr, 40);
+  }
+}
+
+TEST_CASE("Thread-safe pool allocator sends remote frees home", "[allocator][ts_pool_allocator]")
+{
+  ouly::ts_pool_allocator allocator(16);
+  constexpr int           count = 100;
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < count; ++i)
+  {
+    blocks.push_back(allocator.allocate(256));
+  }
+  std::set<void*> const owned(blocks.begin(), blocks.end());
+  auto const            slabs = allocator.slab_count();
+
+  // Another thread frees every block; the batches it could not fill yet go home on flush
+  std::thread consumer(
+   [&]
+   {
+     for (void* ptr : blocks)
+     {
+       allocator.deallocate(ptr, 256);
+     }
+     allocator.flush_thread_cache();
+   });
+  consumer.join();
+
+  std::set<void*> again;
+  for (int i = 0; i < count + 16; ++i)
+  {
+    again.insert(allocator.allocate(256));
+  }
+  REQUIRE(std::includes(again.begin(), again.end(), owned.begin(), owned.end()));
+  REQUIRE(allocator.slab_count() == slabs);
+
+  for (void* ptr : again)
+  {
+    allocator.deallocate(ptr, 256);
+  }
+}
+
+TEST_CASE("Thread-safe pool allocator adopts the cache of an exited thread", "[allocator][ts_pool_allocator]")
+{
+  ouly::ts_pool_allocator allocator;
+  constexpr int           count = 4000;
+
+  // The producer exits without flushing, the blocks it carved come back to its orphaned cache
+  std::vector<void*> blocks;
+  std::thread        producer(
+   [&]
+   {
+     for (int i = 0; i < count; ++i)
+     {
+       blocks.push_back(allocator.allocate(256));
+     }
+   });
+  producer.join();
+  auto const slabs = allocator.slab_count();
+
+  for (void* ptr : blocks)
+  {
+    allocator.deallocate(ptr, 256);
+  }
+  blocks.clear();
+  for (int i = 0; i < count; ++i)
+  {
+    blocks.push_back(allocator.allocate(256));
+  }
+  REQUIRE(allocator.slab_count() == slabs);
+  for (void* ptr : blocks)
+  {
+    allocator.deallocate(ptr, 256);
+  }
+
+  // Short-lived threads take over the caches of the ones before them
+  auto const before = allocator.slab_count();
+  for (int round = 0; round < 16; ++round)
+  {
+    std::thread worker(
+     [&]
+     {
+       std::vector<void*> local;
+       for (int i = 0; i < 8; ++i)
+       {
+         local.push_back(allocator.allocate(48));
+       }
+       for (void* ptr : local)
+       {
+         allocator.deallocate(ptr, 48);
+       }
+     });
+    worker.join();
+  }
+  REQUIRE(allocator.slab_count() == before + 1);
+}
+
+TEST_CASE("Thread-safe pool allocator multi-threaded churn", "[allocator][ts_pool_allocator]")
+{
+  ouly::ts_pool_allocator allocator;
+  constexpr int           num_threads = 8;
+  constexpr int           iterations  = 20000;
+
+  struct handoff
+  {
+    std::mutex                                                mutex;
+    std::vector<std::tuple<std::uint8_t*, std::size_t, int>> blocks;
+  } shared;
+
+  std::atomic<int> corrupted{0};
+  auto             check_and_free = [&](std::uint8_t* ptr, std::size_t size, int tag)
+  {
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      if (ptr[i] != static_cast<std::uint8_t>(tag))
+      {
+        corrupted.fetch_add(1, std::memory_order_relaxed);
+        break;
+      }
+    }
+    allocator.deallocate(ptr, size);
+  };
+
+  auto worker = [&](int thread_index)
+  {
+    std::mt19937                                             rng(static_cast<unsigned>(thread_index));
+    std::vector<std::tuple<std::uint8_t*, std::size_t, int>> live;
+    for (int i = 0; i < iterations; ++i)
+    {
+      auto const choice = rng() % 8;
+      if (choice < 4 || live.empty())
+      {
+        std::size_t size = 1 + (rng() % 1024);
+        int         tag  = static_cast<int>(rng() % 255);
+        auto*       ptr  = static_cast<std::uint8_t*>(allocator.allocate(size));
+        std::memset(ptr, tag, size);
+        live.emplace_back(ptr, size, tag);
+      }
+      else if (choice < 6)
+      {
+        auto index = rng() % live.size();
+        std::swap(live[index], live.back());
+        auto [ptr, size, tag] = live.back();
+        live.pop_back();
+        check_and_free(ptr, size, tag);
+      }
+      else if (choice == 6)
+      {
+        // Hand a block to whichever thread picks it up next
+        std::scoped_lock lock{shared.mutex};
+        shared.blocks.push_back(live.back());
+        live.pop_back();
+      }
+      else
+      {
+        std::tuple<std::uint8_t*, std::size_t, int> block{};
+        {
+          std::scoped_lock lock{shared.mutex};
+          if (shared.blocks.empty())
+          {
+            continue;
+          }
+          block = shared.blocks.back();
+          shared.blocks.pop_back();
+        }
+        check_and_free(std::get<0>(block), std::get<1>(block), std::get<2>(block));
+      }
+    }
+
+    for (auto [ptr, size, tag] : live)
+    {
+      check_and_free(ptr, size, tag);
+    }
+    allocator.flush_thread_cache();
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (auto [ptr, size, tag] : shared.blocks)
+  {
+    check_and_free(ptr, size, tag);
+  }
+  REQUIRE(corrupted.load() == 0);
+}
+
+TEST_CASE("Thread-safe pool allocator backs standard containers", "[allocator][ts_pool_allocator]")
+{
+  ouly::ts_pool_allocator allocator;
+
+  {
+    std::vector<int, ouly::allocator_ref<int, ouly::ts_pool_allocator>> values{
+     ouly::allocator_ref<int, ouly::ts_pool_allocator>(allocator)};
+    for (int i = 0; i < 5000; ++i)
+    {
+      values.push_back(i);
+    }
+    REQUIRE(std::accumulate(values.begin(), values.end(), 0LL) == 4999LL * 5000 / 2);
+  }
+
+  ouly::memory_resource_ref<ouly::ts_pool_allocator> resource(&allocator);
+  std::pmr::vector<std::pmr::string>                  strings(&resource);
+  for (int i = 0; i < 100; ++i)
+  {
+    strings.emplace_back(100 + i, 'x');
+  }
+  REQUIRE(strings.back().size() == 199);
+}
 // NOLINTEND
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "ouly/containers/virtual_vector.hpp"
+#include "catch2/catch_all.hpp"
+#include <memory>
+#include <new>
+#include <string>
+
+// NOLINTBEGIN
+TEST_CASE("virtual_vector grows in place without moving elements", "[virtual_vector]")
+{
+  ouly::virtual_vector<int> values;
+  REQUIRE(values.empty());
+  REQUIRE(values.data() == nullptr);
+  REQUIRE(values.max_size() == ouly::virtual_vector<int>::default_reserved_bytes / sizeof(int));
+
+  values.push_back(0);
+  int* const first = values.data();
+  REQUIRE(first != nullptr);
+
+  constexpr int count = 3'000'000;
+  for (int i = 1; i < count; ++i)
+  {
+    values.push_back(i);
+  }
+  REQUIRE(values.size() == count);
+  REQUIRE(values.data() == first);
+  REQUIRE(values.capacity() >= values.size());
+  for (int i = 0; i < count; i += 9973)
+  {
+    REQUIRE(values[i] == i);
+  }
+
+  // Arguments may refer into the vector while it grows
+  values.push_back(values.front());
+  REQUIRE(values.back() == 0);
+
+  values.resize(10);
+  REQUIRE(values.size() == 10);
+  values.shrink_to_fit();
+  REQUIRE(values.committed_bytes() < 100 * 1024);
+  REQUIRE(values.data() == first);
+
+  values.resize(20, 7);
+  REQUIRE(values[9] == 9);
+  REQUIRE(values[19] == 7);
+}
+
+TEST_CASE("virtual_vector manages non-trivial elements", "[virtual_vector]")
+{
+  auto counter = std::make_shared<int>(0);
+  {
+    ouly::virtual_vector<std::shared_ptr<int>> values(1024);
+    for (int i = 0; i < 100; ++i)
+    {
+      values.emplace_back(counter);
+    }
+    REQUIRE(counter.use_count() == 101);
+
+    values.pop_back();
+    values.resize(50);
+    REQUIRE(counter.use_count() == 51);
+
+    auto copy = values;
+    REQUIRE(counter.use_count() == 101);
+    REQUIRE(copy == values);
+
+    auto moved = std::move(copy);
+    REQUIRE(copy.empty());
+    REQUIRE(moved.size() == 50);
+
+    values.clear();
+    REQUIRE(counter.use_count() == 51);
+  }
+  REQUIRE(counter.use_count() == 1);
+
+  ouly::virtual_vector<std::string> names{"a", "b", "c"};
+  REQUIRE(names.size() == 3);
+  REQUIRE(names[2] == "c");
+}
+
+TEST_CASE("virtual_vector stops at its reservation", "[virtual_vector]")
+{
+  ouly::virtual_vector<std::uint64_t> values(100);
+  values.resize(100);
+  REQUIRE(values.capacity() == 100);
+  REQUIRE_THROWS_AS(values.push_back(1), std::bad_alloc);
+  REQUIRE_THROWS_AS(values.reserve(101), std::bad_alloc);
+  REQUIRE(values.size() == 100);
+}
+TEST_CASE("virtual_vector copy assignment takes the reservation of its source", "[virtual_vector]")
+{
+  ouly::virtual_vector<std::uint64_t> large(1000);
+  large.resize(500, 3);
+
+  ouly::virtual_vector<std::uint64_t> small(100);
+  small.resize(10);
+  small = large;
+  REQUIRE(small.max_size() == 1000);
+  REQUIRE(small.size() == 500);
+  REQUIRE(small == large);
+
+  ouly::virtual_vector<std::uint64_t> shrunk(100);
+  large = shrunk;
+  REQUIRE(large.max_size() == 100);
+  REQUIRE(large.empty());
+  REQUIRE_THROWS_AS(large.resize(101), std::bad_alloc);
+}
+// NOLINTEND